@@ -0,0 +1,123 @@
+# - Find Zstd (zstd.h, zdict.h, libzstd.a, libzstd.so, libzstd.lib, libzstd.dll)
+# This module defines
+#  Zstd_INCLUDE_DIR, directory containing headers
+#  Zstd_LIBRARY_DIR, directory containing zstd libraries
+#  Zstd_SHARED_LIBS, path to libzstd.so/libzstd.lib
+#  Zstd_STATIC_LIBS, path to libzstd.a/libzstd_static.lib
+#  Zstd_FOUND, whether zstd has been found
+
+if ("${ZSTD_ROOT}" STREQUAL "")
+  set(ZSTD_ROOT "$ENV{ZSTD_ROOT}")
+  if (NOT "${ZSTD_ROOT}" STREQUAL "")
+    string(REPLACE "\"" "" ZSTD_ROOT ${ZSTD_ROOT})
+  endif()
+endif()
+
+if (NOT "${ZSTD_ROOT}" STREQUAL "")
+  set(ZSTD_SEARCH_HEADER_PATHS
+    ${ZSTD_ROOT}
+    ${ZSTD_ROOT}/include
+    ${ZSTD_ROOT}/lib
+  )
+
+  set(ZSTD_SEARCH_LIB_PATHS
+    ${ZSTD_ROOT}
+    ${ZSTD_ROOT}/lib
+  )
+elseif (NOT MSVC)
+  set(ZSTD_SEARCH_HEADER_PATHS
+      "/usr/include"
+      "/usr/include/x86_64-linux-gnu"
+  )
+
+  set(ZSTD_SEARCH_LIB_PATHS
+      "/lib"
+      "/lib/x86_64-linux-gnu"
+      "/usr/lib"
+      "/usr/lib/x86_64-linux-gnu"
+  )
+endif()
+
+find_path(Zstd_INCLUDE_DIR
+  zdict.h
+  PATHS ${ZSTD_SEARCH_HEADER_PATHS}
+  NO_DEFAULT_PATH # make sure we don't accidentally pick up a different version
+)
+
+include(Utils)
+
+# set options for: shared
+if (MSVC)
+  set(ZSTD_LIBRARY_PREFIX "")
+  set(ZSTD_LIBRARY_SUFFIX ".lib")
+elseif(APPLE)
+  set(ZSTD_LIBRARY_PREFIX "lib")
+  set(ZSTD_LIBRARY_SUFFIX ".dylib")
+else()
+  set(ZSTD_LIBRARY_PREFIX "lib")
+  set(ZSTD_LIBRARY_SUFFIX ".so")
+endif()
+set_find_library_options("${ZSTD_LIBRARY_PREFIX}" "${ZSTD_LIBRARY_SUFFIX}")
+
+# find library
+find_library(Zstd_SHARED_LIBS
+  NAMES zstd
+  PATHS ${ZSTD_SEARCH_LIB_PATHS}
+  NO_DEFAULT_PATH
+)
+
+# restore initial options
+restore_find_library_options()
+
+
+# set options for: static
+if (MSVC)
+  set(ZSTD_LIBRARY_PREFIX "")
+  set(ZSTD_LIBRARY_SUFFIX ".lib")
+else()
+  set(ZSTD_LIBRARY_PREFIX "lib")
+  set(ZSTD_LIBRARY_SUFFIX ".a")
+endif()
+set_find_library_options("${ZSTD_LIBRARY_PREFIX}" "${ZSTD_LIBRARY_SUFFIX}")
+
+# find library
+find_library(Zstd_STATIC_LIBS
+  NAMES zstd_static zstd
+  PATHS ${ZSTD_SEARCH_LIB_PATHS}
+  NO_DEFAULT_PATH
+)
+
+# restore initial options
+restore_find_library_options()
+
+
+if (Zstd_INCLUDE_DIR AND Zstd_SHARED_LIBS AND Zstd_STATIC_LIBS)
+  set(Zstd_FOUND TRUE)
+  set(Zstd_LIBRARY_DIR
+    "${ZSTD_SEARCH_LIB_PATHS}"
+    CACHE PATH
+    "Directory containing zstd libraries"
+    FORCE
+  )
+else ()
+  set(Zstd_FOUND FALSE)
+endif()
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Zstd
+  DEFAULT_MSG
+  Zstd_INCLUDE_DIR
+  Zstd_SHARED_LIBS
+  Zstd_STATIC_LIBS
+)
+message("Zstd_INCLUDE_DIR: " ${Zstd_INCLUDE_DIR})
+message("Zstd_LIBRARY_DIR: " ${Zstd_LIBRARY_DIR})
+message("Zstd_SHARED_LIBS: " ${Zstd_SHARED_LIBS})
+message("Zstd_STATIC_LIBS: " ${Zstd_STATIC_LIBS})
+
+mark_as_advanced(
+  Zstd_INCLUDE_DIR
+  Zstd_LIBRARY_DIR
+  Zstd_SHARED_LIBS
+  Zstd_STATIC_LIBS
+)
@@ -83,6 +83,13 @@ document::document() NOEXCEPT:
 REGISTER_ATTRIBUTE(frequency);
 DEFINE_ATTRIBUTE_TYPE(frequency) // DO NOT CHANGE NAME
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   frequency_bound
+// -----------------------------------------------------------------------------
+
+REGISTER_ATTRIBUTE(frequency_bound);
+DEFINE_ATTRIBUTE_TYPE(frequency_bound) // DO NOT CHANGE NAME
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                granularity_prefix
 // -----------------------------------------------------------------------------
@@ -115,6 +115,30 @@ struct IRESEARCH_API frequency : basic_attribute<uint32_t> {
   frequency() = default;
 }; // frequency
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class frequency_bound
+/// @brief upper bounds of the in-document term frequency, allows to estimate
+///        the best possible score of a block of documents without decoding it
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API frequency_bound : public attribute {
+ public:
+  DECLARE_REFERENCE(frequency_bound);
+  DECLARE_TYPE_ID(attribute::type_id);
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @returns max frequency of the term across all documents
+  ////////////////////////////////////////////////////////////////////////////
+  virtual uint32_t max() const NOEXCEPT = 0;
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief moves block boundary to the one containing the specified 'target'
+  ///        without moving an underlying iterator
+  /// @param max max frequency of the term within a block
+  /// @returns the last document of a block
+  ////////////////////////////////////////////////////////////////////////////
+  virtual doc_id_t shallow_seek(doc_id_t target, uint32_t& max) = 0;
+}; // frequency_bound
+
 //////////////////////////////////////////////////////////////////////////////
 /// @class granularity_prefix
 /// @brief indexed tokens are prefixed with one byte indicating granularity
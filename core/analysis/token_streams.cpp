@@ -278,4 +278,85 @@ bool null_token_stream::next() {
   return value;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                              buffered_token_stream implementation
+// -----------------------------------------------------------------------------
+
+void buffered_token_stream::reset(token_stream& src) {
+  auto& attrs = src.attributes();
+  auto& term = attrs.get<term_attribute>();
+  auto& inc = attrs.get<increment>();
+  auto& offs = attrs.get<offset>();
+  auto& pay = attrs.get<payload>();
+
+  // expose the same set of attributes as the source stream
+  attrs_.clear();
+  if (term) attrs_.emplace(term_);
+  if (inc) attrs_.emplace(inc_);
+  if (offs) attrs_.emplace(offset_);
+  if (pay) attrs_.emplace(payload_);
+
+  data_.clear();
+  tokens_.clear();
+  next_ = 0;
+
+  auto capture = [&term, &inc, &offs, &pay, this](token& tok)->void {
+    const auto term_value = term ? term->value() : bytes_ref::NIL;
+    tok.term_offset = data_.size();
+    tok.term_size = term_value.size();
+    data_.append(term_value.c_str(), term_value.size());
+
+    const auto payload_value = pay ? pay->value : bytes_ref::NIL;
+    tok.payload_offset = data_.size();
+    tok.payload_size = payload_value.size();
+    tok.payload_null = payload_value.null();
+    data_.append(payload_value.c_str(), payload_value.size());
+
+    tok.inc = inc ? inc->value : 1U;
+    tok.start = offs ? offs->start : 0;
+    tok.end = offs ? offs->end : 0;
+  };
+
+  while (src.next()) {
+    tokens_.emplace_back();
+    capture(tokens_.back());
+  }
+
+  // some consumers, e.g. field_data::invert(...), access attributes of the
+  // exhausted stream
+  capture(last_);
+}
+
+void buffered_token_stream::clear() NOEXCEPT {
+  bstring().swap(data_);
+  std::vector<token>().swap(tokens_);
+  last_ = token();
+  next_ = 0;
+}
+
+void buffered_token_stream::apply(const token& tok) {
+  term_.value(bytes_ref(data_.c_str() + tok.term_offset, tok.term_size));
+  payload_.value = tok.payload_null
+    ? bytes_ref::NIL
+    : bytes_ref(data_.c_str() + tok.payload_offset, tok.payload_size);
+  inc_.value = tok.inc;
+  offset_.start = tok.start;
+  offset_.end = tok.end;
+}
+
+bool buffered_token_stream::next() {
+  if (next_ >= tokens_.size()) {
+    if (next_ == tokens_.size()) {
+      apply(last_); // state of the exhausted source stream
+      ++next_;
+    }
+
+    return false;
+  }
+
+  apply(tokens_[next_++]);
+
+  return true;
+}
+
 NS_END
\ No newline at end of file
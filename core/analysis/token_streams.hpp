@@ -312,6 +312,72 @@ class IRESEARCH_API null_token_stream final
   IRESEARCH_API_PRIVATE_VARIABLES_END
 };
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class buffered_token_stream
+/// @brief token_stream replaying the tokens captured from another token_stream,
+///        allows to decouple analysis of a field from its inversion, e.g. to
+///        run analysis on a different thread
+/// @note term, increment, offset and payload attributes are captured, each of
+///       them is exposed only if it is provided by the source stream
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API buffered_token_stream final
+    : public token_stream,
+      private util::noncopyable { // attrs_ non-copyable
+ public:
+  buffered_token_stream() = default;
+
+  virtual bool next() override;
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief exhausts 'src' capturing all of its tokens, tokens captured
+  ///        previously are discarded
+  ////////////////////////////////////////////////////////////////////////////
+  void reset(token_stream& src);
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief discards captured tokens releasing the memory reserved for them
+  ////////////////////////////////////////////////////////////////////////////
+  void clear() NOEXCEPT;
+
+  // @returns number of captured tokens
+  size_t size() const NOEXCEPT { return tokens_.size(); }
+
+  // @returns number of bytes reserved for captured tokens
+  size_t memory_reserved() const NOEXCEPT {
+    return data_.capacity() + tokens_.capacity()*sizeof(token);
+  }
+
+  virtual const attribute_view& attributes() const NOEXCEPT override {
+    return attrs_;
+  }
+
+ private:
+  struct token {
+    size_t term_offset; // offset of the term in 'data_'
+    size_t term_size;
+    size_t payload_offset; // offset of the payload in 'data_'
+    size_t payload_size;
+    uint32_t inc;
+    uint32_t start; // start offset
+    uint32_t end; // end offset
+    bool payload_null; // payload is bytes_ref::NIL
+  }; // token
+
+  void apply(const token& tok);
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  attribute_view attrs_;
+  basic_term term_;
+  increment inc_;
+  offset offset_;
+  payload payload_;
+  bstring data_; // bytes of captured terms and payloads
+  std::vector<token> tokens_;
+  token last_{}; // attribute values after the source stream was exhausted
+  size_t next_{};
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // buffered_token_stream
+
 NS_END
 
 #endif
\ No newline at end of file
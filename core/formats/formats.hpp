@@ -28,9 +28,11 @@
 #include "store/data_output.hpp"
 #include "store/directory.hpp"
 
+#include "index/document_mask.hpp"
 #include "index/index_meta.hpp"
 #include "index/iterators.hpp"
 
+#include "utils/compression.hpp"
 #include "utils/io_utils.hpp"
 #include "utils/string.hpp"
 #include "utils/type_id.hpp"
@@ -46,7 +48,6 @@ struct reader_state;
 struct index_output;
 struct data_input;
 struct index_input;
-typedef std::unordered_set<doc_id_t> document_mask;
 struct postings_writer;
 typedef std::vector<doc_id_t> doc_map;
 
@@ -229,6 +230,33 @@ struct IRESEARCH_API field_reader {
   virtual size_t size() const = 0;
 }; // field_reader
 
+////////////////////////////////////////////////////////////////////////////////
+/// @struct column_info
+/// @brief options of a column in a columnstore
+////////////////////////////////////////////////////////////////////////////////
+struct column_info {
+  column_info(
+      compression::type compression = compression::type::LZ4
+  ) NOEXCEPT
+    : compression(compression) {
+  }
+
+  bool operator==(const column_info& rhs) const NOEXCEPT {
+    return compression == rhs.compression;
+  }
+
+  bool operator!=(const column_info& rhs) const NOEXCEPT {
+    return !(*this == rhs);
+  }
+
+  compression::type compression; // codec of the column data blocks
+}; // column_info
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns options of the column with the specified name
+////////////////////////////////////////////////////////////////////////////////
+typedef std::function<column_info(const string_ref& name)> column_info_provider_t;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @struct columnstore_writer
 ////////////////////////////////////////////////////////////////////////////////
@@ -247,7 +275,17 @@ struct IRESEARCH_API columnstore_writer {
   virtual ~columnstore_writer() = default;
 
   virtual void prepare(directory& dir, const segment_meta& meta) = 0;
-  virtual column_t push_column() = 0;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @note options the format can't store are ignored, e.g. a codec of
+  ///       an older columnstore version
+  //////////////////////////////////////////////////////////////////////////////
+  virtual column_t push_column(const column_info& info) = 0;
+
+  column_t push_column() {
+    return push_column(column_info());
+  }
+
   virtual void rollback() NOEXCEPT = 0;
   virtual bool commit() = 0; // @return was anything actually flushed
 }; // columnstore_writer
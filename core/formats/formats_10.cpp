@@ -27,6 +27,7 @@
 #include <cmath>
 #include <deque>
 #include <list>
+#include <map>
 #include <numeric>
 
 #include "shared.hpp"
@@ -57,6 +58,7 @@
 #include "utils/log.hpp"
 #include "utils/memory.hpp"
 #include "utils/memory_pool.hpp"
+#include "utils/metrics.hpp"
 #include "utils/noncopyable.hpp"
 #include "utils/object_pool.hpp"
 #include "utils/timer_utils.hpp"
@@ -277,7 +279,7 @@ class postings_writer final: public irs::postings_writer {
  public:
   static const string_ref TERMS_FORMAT_NAME;
   static const int32_t TERMS_FORMAT_MIN = 0;
-  static const int32_t TERMS_FORMAT_MAX = TERMS_FORMAT_MIN;
+  static const int32_t TERMS_FORMAT_MAX = 1;
 
   static const string_ref DOC_FORMAT_NAME;
   static const string_ref DOC_EXT;
@@ -287,13 +289,13 @@ class postings_writer final: public irs::postings_writer {
   static const string_ref PAY_EXT;
 
   static const int32_t FORMAT_MIN = 0;
-  static const int32_t FORMAT_MAX = FORMAT_MIN;
+  static const int32_t FORMAT_MAX = 1; // max term frequency per skip entry
 
   static const uint32_t MAX_SKIP_LEVELS = 10;
   static const uint32_t BLOCK_SIZE = format_traits::BLOCK_SIZE;
   static const uint32_t SKIP_N = 8;
 
-  explicit postings_writer(bool volatile_attributes);
+  postings_writer(int32_t version, bool volatile_attributes);
 
   // ------------------------------------------
   // const_attributes_provider
@@ -340,14 +342,18 @@ class postings_writer final: public irs::postings_writer {
       stream::reset();
       last = doc_limits::invalid();
       block_last = 0;
+      block_freq = 0;
       size = 0;
+      std::fill_n(skip_freq, MAX_SKIP_LEVELS, 0);
     }
 
     doc_id_t deltas[BLOCK_SIZE]{}; // document deltas
     doc_id_t skip_doc[MAX_SKIP_LEVELS]{};
+    uint32_t skip_freq[MAX_SKIP_LEVELS]{}; // max frequency since the last skip entry on a level
     std::unique_ptr<uint32_t[]> freqs; // document frequencies
     doc_id_t last{ doc_limits::invalid() }; // last buffered document id
     doc_id_t block_last{}; // last document id in a block
+    uint32_t block_freq{}; // max frequency in a block
     uint32_t size{}; // number of buffered elements
   }; // doc_stream
 
@@ -416,6 +422,7 @@ class postings_writer final: public irs::postings_writer {
   size_t docs_count_{};             // count of processed documents
   version10::documents docs_;      // bit set of all processed documents
   features features_;              // features supported by current field
+  int32_t version_;                // format version
   bool volatile_attributes_;       // attribute value memory locations may change after next()
 }; // postings_writer
 
@@ -482,9 +489,11 @@ void postings_writer::pay_stream::flush_offsets(uint32_t* buf) {
   format_traits::write_block(*out, offs_len_buf, BLOCK_SIZE, buf);
 }
 
-postings_writer::postings_writer(bool volatile_attributes)
+postings_writer::postings_writer(int32_t version, bool volatile_attributes)
   : skip_(BLOCK_SIZE, SKIP_N),
+    version_(version),
     volatile_attributes_(volatile_attributes) {
+  assert(version_ >= FORMAT_MIN && version_ <= FORMAT_MAX);
   attrs_.emplace(docs_);
 }
 
@@ -498,7 +507,7 @@ void postings_writer::prepare(index_output& out, const irs::flush_state& state)
   std::string name;
 
   // prepare document stream
-  prepare_output(name, doc_.out, state, DOC_EXT, DOC_FORMAT_NAME, FORMAT_MAX);
+  prepare_output(name, doc_.out, state, DOC_EXT, DOC_FORMAT_NAME, version_);
 
   auto& features = *state.features;
   if (features.check<frequency>() && !doc_.freqs) {
@@ -514,7 +523,7 @@ void postings_writer::prepare(index_output& out, const irs::flush_state& state)
     }
 
     pos_->reset();
-    prepare_output(name, pos_->out, state, POS_EXT, POS_FORMAT_NAME, FORMAT_MAX);
+    prepare_output(name, pos_->out, state, POS_EXT, POS_FORMAT_NAME, version_);
 
     if (features.check<payload>() || features.check<offset>()) {
       // prepare payload stream
@@ -523,7 +532,7 @@ void postings_writer::prepare(index_output& out, const irs::flush_state& state)
       }
 
       pay_->reset();
-      prepare_output(name, pay_->out, state, PAY_EXT, PAY_FORMAT_NAME, FORMAT_MAX);
+      prepare_output(name, pay_->out, state, PAY_EXT, PAY_FORMAT_NAME, version_);
     }
   }
 
@@ -535,7 +544,7 @@ void postings_writer::prepare(index_output& out, const irs::flush_state& state)
   );
 
   // write postings format name
-  format_utils::write_header(out, TERMS_FORMAT_NAME, TERMS_FORMAT_MAX);
+  format_utils::write_header(out, TERMS_FORMAT_NAME, version_);
   // write postings block size
   out.write_vint(BLOCK_SIZE);
 
@@ -612,6 +621,7 @@ irs::postings_writer::state postings_writer::write(irs::doc_iterator& docs) {
     ++meta->docs_count;
     if (tfreq) {
       (*tfreq) += freq->value;
+      meta->max_freq = std::max(meta->max_freq, freq->value);
     }
 
     end_doc();
@@ -656,6 +666,8 @@ void postings_writer::begin_term() {
 
   doc_.last = doc_limits::min(); // for proper delta of 1st id
   doc_.block_last = doc_limits::invalid();
+  doc_.block_freq = 0;
+  std::fill_n(doc_.skip_freq, MAX_SKIP_LEVELS, 0);
   skip_.reset();
 }
 
@@ -674,6 +686,7 @@ void postings_writer::begin_doc(doc_id_t id, const frequency* freq) {
   doc_.doc(id - doc_.last);
   if (freq) {
     doc_.freq(freq->value);
+    doc_.block_freq = std::max(doc_.block_freq, freq->value);
   }
 
   doc_.next(id);
@@ -716,6 +729,13 @@ void postings_writer::end_doc() {
   if (doc_.full()) {
     doc_.block_last = doc_.last;
     doc_.end = doc_.out->file_pointer();
+
+    // propagate max frequency of the block to all skip levels
+    for (auto& freq : doc_.skip_freq) {
+      freq = std::max(freq, doc_.block_freq);
+    }
+    doc_.block_freq = 0;
+
     if (features_.position()) {
       assert(pos_ && pos_->out);
       pos_->end = pos_->out->file_pointer();
@@ -865,6 +885,12 @@ void postings_writer::write_skip(size_t level, index_output& out) {
   doc_.skip_doc[level] = doc_.block_last;
   doc_.skip_ptr[level] = doc_ptr;
 
+  if (version_ > FORMAT_MIN && features_.freq()) {
+    // max frequency of the blocks covered by the skip entry
+    out.write_vint(doc_.skip_freq[level]);
+    doc_.skip_freq[level] = 0;
+  }
+
   if (features_.position()) {
     assert(pos_);
 
@@ -903,6 +929,11 @@ void postings_writer::encode(
   if (meta.freq != integer_traits<uint32_t>::const_max) {
     assert(meta.freq >= meta.docs_count);
     out.write_vint(meta.freq - meta.docs_count);
+
+    // max frequency of a singleton term is equal to its total frequency
+    if (version_ > FORMAT_MIN && meta.docs_count > 1) {
+      out.write_vint(meta.max_freq);
+    }
   }
 
   out.write_vlong(meta.doc_start - last_state_.doc_start);
@@ -945,6 +976,7 @@ struct skip_state {
   size_t pend_pos{}; // positions to skip before new document block
   doc_id_t doc{ doc_limits::invalid() }; // last document in a previous block
   uint32_t pay_pos{}; // payload size to skip before in new document block
+  uint32_t max_freq{}; // max document frequency in a previous block
 }; // skip_state
 
 struct skip_context : skip_state {
@@ -957,6 +989,7 @@ struct doc_state {
   version10::term_meta* term_state;
   uint32_t* freq;
   uint32_t* enc_buf;
+  uint64_t term_freq; // total number of positions of the term
   uint64_t tail_start;
   size_t tail_length;
   ::features features;
@@ -970,6 +1003,55 @@ FORCE_INLINE void skip_positions(index_input& in) {
   format_traits::skip_block(in, postings_writer::BLOCK_SIZE);
 }
 
+// size of the postings data kept prefetched ahead of the reader of a stream
+const uint64_t PREFETCH_WINDOW = 65536;
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class prefetcher
+/// @brief keeps prefetch hints a window ahead of the block reads of a postings
+///        stream: postings are opened with IOAdvice::RANDOM, which disables
+///        OS readahead, so without hints every block past the first one would
+///        be a synchronous read
+/// @note hints are a no-op unless enabled for the directory, see fs_directory
+//////////////////////////////////////////////////////////////////////////////
+class prefetcher {
+ public:
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief restarts prefetching for a term
+  /// @param start offset of the postings data of the term in the stream
+  /// @param end upper bound of the postings data of the term in the stream
+  //////////////////////////////////////////////////////////////////////////////
+  void reset(uint64_t start, uint64_t end) NOEXCEPT {
+    next_ = start;
+    end_ = end;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief to be called before reading a block at the current position of
+  ///        'in', issues a hint once less than half of the window is ahead
+  //////////////////////////////////////////////////////////////////////////////
+  FORCE_INLINE void advance(index_input& in) NOEXCEPT {
+    const uint64_t pos = in.file_pointer();
+
+    if (pos + PREFETCH_WINDOW/2 > next_ && next_ < end_ && pos < end_) {
+      issue(in, pos);
+    }
+  }
+
+ private:
+  void issue(index_input& in, uint64_t pos) NOEXCEPT {
+    const auto start = std::max(pos, next_); // 'pos' is past 'next_' after skips
+    next_ = pos + std::min(PREFETCH_WINDOW, end_ - pos);
+
+    if (start < next_) {
+      in.prefetch(start, size_t(next_ - start));
+    }
+  }
+
+  uint64_t next_{}; // end of the range prefetched so far
+  uint64_t end_{}; // end of the postings data of the term
+}; // prefetcher
+
 FORCE_INLINE void skip_payload(index_input& in) {
   const size_t size = in.read_vint();
   if (size) {
@@ -992,7 +1074,8 @@ class doc_iterator : public irs::doc_iterator {
 
   doc_iterator() NOEXCEPT
     : skip_levels_(1),
-      skip_(postings_writer::BLOCK_SIZE, postings_writer::SKIP_N) {
+      skip_(postings_writer::BLOCK_SIZE, postings_writer::SKIP_N),
+      freq_bound_(*this) {
     std::fill(docs_, docs_ + postings_writer::BLOCK_SIZE, doc_limits::invalid());
   }
 
@@ -1002,7 +1085,8 @@ class doc_iterator : public irs::doc_iterator {
       const irs::attribute_view& attrs,
       const index_input* doc_in,
       const index_input* pos_in,
-      const index_input* pay_in) {
+      const index_input* pay_in,
+      int32_t version) {
     features_ = field; // set field features
     enabled_ = enabled; // set enabled features
 
@@ -1014,6 +1098,13 @@ class doc_iterator : public irs::doc_iterator {
     assert(attrs.contains<version10::term_meta>());
     term_state_ = *attrs.get<version10::term_meta>();
 
+    // skip entries store max frequency of the blocks since version 1
+    skip_freq_ = features_.freq() && version > postings_writer::FORMAT_MIN;
+
+    if (skip_freq_) {
+      attrs_.emplace(freq_bound_);
+    }
+
     // init document stream
     if (term_state_.docs_count > 1) {
       if (!doc_in_) {
@@ -1029,6 +1120,17 @@ class doc_iterator : public irs::doc_iterator {
 
       doc_in_->seek(term_state_.doc_start);
       assert(!doc_in_->eof());
+
+      // a tail block alone holds at most a vint doc delta and frequency per
+      // doc, the first hint lets iterators prepared together fetch their
+      // leading blocks concurrently
+      doc_prefetch_.reset(
+        term_state_.doc_start,
+        term_state_.doc_start + (term_state_.docs_count > postings_writer::BLOCK_SIZE
+          ? term_state_.e_skip_start
+          : 2*bytes_io<uint32_t>::const_max_vsize*uint64_t(term_state_.docs_count))
+      );
+      doc_prefetch_.advance(*doc_in_);
     }
 
     prepare_attributes(enabled, attrs, pos_in, pay_in);
@@ -1086,6 +1188,50 @@ class doc_iterator : public irs::doc_iterator {
   #pragma GCC diagnostic pop
 #endif
 
+  virtual size_t next_batch(
+      doc_id_t* docs,
+      uint32_t* freqs,
+      size_t size) override {
+    size_t count = 0;
+
+    while (count < size) {
+      if (begin_ == end_) {
+        cur_pos_ += relative_pos();
+
+        if (cur_pos_ == term_state_.docs_count) {
+          doc_.value = doc_limits::eof();
+          begin_ = end_ = docs_; // seal the iterator
+          break;
+        }
+
+        refill();
+      }
+
+      // copy decoded documents directly from the block
+      const auto n = std::min(size_t(end_ - begin_), size - count);
+
+      std::memcpy(docs + count, begin_, n*sizeof(doc_id_t));
+
+      if (freqs) {
+        if (enabled_.freq()) {
+          std::memcpy(freqs + count, doc_freq_, n*sizeof(uint32_t));
+        } else {
+          std::fill_n(freqs + count, n, 0);
+        }
+      }
+
+      begin_ += n;
+      doc_freq_ += n;
+      count += n;
+
+      // last document is required by 'refill()' to decode the next block
+      doc_.value = *(begin_ - 1);
+      freq_.value = *(doc_freq_ - 1);
+    }
+
+    return count;
+  }
+
  protected:
   virtual void prepare_attributes(
       const features& enabled,
@@ -1106,7 +1252,9 @@ class doc_iterator : public irs::doc_iterator {
   virtual void seek_notify(const skip_context& /*ctx*/) {
   }
 
+  void prepare_skip();
   void seek_to_block(doc_id_t target);
+  doc_id_t shallow_seek(doc_id_t target, uint32_t& max_freq);
 
   // returns current position in the document block 'docs_'
   size_t relative_pos() NOEXCEPT {
@@ -1118,6 +1266,10 @@ class doc_iterator : public irs::doc_iterator {
     state.doc = in.read_vint();
     state.doc_ptr += in.read_vlong();
 
+    if (skip_freq_) {
+      state.max_freq = in.read_vint();
+    }
+
     if (features_.position()) {
       state.pend_pos = in.read_vint();
       state.pos_ptr += in.read_vlong();
@@ -1153,9 +1305,12 @@ class doc_iterator : public irs::doc_iterator {
   }
 
   void refill() {
+    metrics::increment(metrics::event::POSTINGS_REFILL);
     const auto left = term_state_.docs_count - cur_pos_;
 
     if (left >= postings_writer::BLOCK_SIZE) {
+      doc_prefetch_.advance(*doc_in_);
+
       // read doc deltas
       format_traits::read_block(
         *doc_in_,
@@ -1206,9 +1361,30 @@ class doc_iterator : public irs::doc_iterator {
     doc_freq_ = docs_ + postings_writer::BLOCK_SIZE;
   }
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief upper bounds of the term frequency derived from skip-list
+  //////////////////////////////////////////////////////////////////////////////
+  class frequency_bound final : public irs::frequency_bound {
+   public:
+    explicit frequency_bound(doc_iterator& it) NOEXCEPT
+      : it_(&it) {
+    }
+
+    virtual uint32_t max() const NOEXCEPT override {
+      return it_->term_state_.max_freq;
+    }
+
+    virtual doc_id_t shallow_seek(doc_id_t target, uint32_t& max_freq) override {
+      return it_->shallow_seek(target, max_freq);
+    }
+
+   private:
+    doc_iterator* it_;
+  }; // frequency_bound
+
   std::vector<skip_state> skip_levels_;
   skip_reader skip_;
-  skip_context* skip_ctx_; // pointer to used skip context, will be used by skip reader
+  skip_context last_; // where current skip-list block starts, used by skip reader
   irs::attribute_view attrs_;
   uint32_t enc_buf_[postings_writer::BLOCK_SIZE]; // buffer for encoding
   doc_id_t docs_[postings_writer::BLOCK_SIZE]; // doc values
@@ -1221,120 +1397,118 @@ class doc_iterator : public irs::doc_iterator {
   document doc_;
   frequency freq_;
   index_input::ptr doc_in_;
+  prefetcher doc_prefetch_;
   version10::term_meta term_state_;
   features features_; // field features
   features enabled_; // enabled iterator features
+  frequency_bound freq_bound_;
+  bool skip_freq_{}; // skip entries contain max frequency
 }; // doc_iterator
 
-void doc_iterator::seek_to_block(doc_id_t target) {
-  // check whether it make sense to use skip-list
-  if (skip_levels_.front().doc < target && term_state_.docs_count > postings_writer::BLOCK_SIZE) {
-    skip_context last; // where block starts
-    skip_ctx_ = &last;
+void doc_iterator::prepare_skip() {
+  // init skip reader in lazy fashion
+  if (skip_) {
+    return;
+  }
 
-    // init skip writer in lazy fashion
-    if (!skip_) {
-      auto skip_in = doc_in_->dup();
+  auto skip_in = doc_in_->dup();
 
-      if (!skip_in) {
-        IR_FRMT_ERROR("Failed to duplicate input in: %s", __FUNCTION__);
+  if (!skip_in) {
+    IR_FRMT_ERROR("Failed to duplicate input in: %s", __FUNCTION__);
 
-        throw io_error("Failed to duplicate document input");
-      }
+    throw io_error("Failed to duplicate document input");
+  }
 
-      skip_in->seek(term_state_.doc_start + term_state_.e_skip_start);
+  skip_in->seek(term_state_.doc_start + term_state_.e_skip_start);
 
-      skip_.prepare(
-        std::move(skip_in),
-        [this](size_t level, index_input& in) {
-          skip_state& last = *skip_ctx_;
-          auto& last_level = skip_ctx_->level;
-          auto& next = skip_levels_[level];
+  skip_.prepare(
+    std::move(skip_in),
+    [this](size_t level, index_input& in) {
+      skip_state& last = last_;
+      auto& last_level = last_.level;
+      auto& next = skip_levels_[level];
+
+      if (last_level > level) {
+        // move to the more granular level
+        next = last;
+      } else {
+        // store previous step on the same level
+        last = next;
+      }
 
-          if (last_level > level) {
-            // move to the more granular level
-            next = last;
-          } else {
-            // store previous step on the same level
-            last = next;
-          }
+      last_level = level;
 
-          last_level = level;
+      if (in.eof()) {
+        // stream exhausted
+        return (next.doc = doc_limits::eof());
+      }
 
-          if (in.eof()) {
-            // stream exhausted
-            return (next.doc = doc_limits::eof());
-          }
+      return read_skip(next, in);
+  });
 
-          return read_skip(next, in);
-      });
+  // initialize skip levels
+  const auto num_levels = skip_.num_levels();
+  if (num_levels) {
+    skip_levels_.resize(num_levels);
 
-      // initialize skip levels
-      const auto num_levels = skip_.num_levels();
-      if (num_levels) {
-        skip_levels_.resize(num_levels);
+    // since we store pointer deltas, add postings offset
+    auto& top = skip_levels_.back();
+    top.doc_ptr = term_state_.doc_start;
+    top.pos_ptr = term_state_.pos_start;
+    top.pay_ptr = term_state_.pay_start;
+  }
+}
 
-        // since we store pointer deltas, add postings offset
-        auto& top = skip_levels_.back();
-        top.doc_ptr = term_state_.doc_start;
-        top.pos_ptr = term_state_.pos_start;
-        top.pay_ptr = term_state_.pay_start;
-      }
-    }
+void doc_iterator::seek_to_block(doc_id_t target) {
+  // check whether it make sense to use skip-list, the skip-list
+  // might have already been moved ahead of the iterator by 'shallow_seek'
+  if (term_state_.docs_count > postings_writer::BLOCK_SIZE
+      && (skip_levels_.front().doc < target || doc_.value < last_.doc)) {
+    prepare_skip();
 
+    last_.level = 0;
     const size_t skipped = skip_.seek(target);
-    if (skipped > (cur_pos_ + relative_pos())) {
-      doc_in_->seek(last.doc_ptr);
-      doc_.value = last.doc;
+
+    // skip-list is unable to move backwards
+    if (skipped > (cur_pos_ + relative_pos()) && last_.doc < target) {
+      doc_in_->seek(last_.doc_ptr);
+      doc_.value = last_.doc;
       cur_pos_ = skipped;
       begin_ = end_ = docs_; // will trigger refill in "next"
-      seek_notify(last); // notifies derivatives
+      seek_notify(last_); // notifies derivatives
     }
   }
 }
 
-///////////////////////////////////////////////////////////////////////////////
-/// @class mask_doc_iterator
-///////////////////////////////////////////////////////////////////////////////
-template<typename DocIterator>
-class mask_doc_iterator final: public DocIterator {
- public:
-  typedef DocIterator doc_iterator_t;
+doc_id_t doc_iterator::shallow_seek(doc_id_t target, uint32_t& max_freq) {
+  assert(skip_freq_);
 
-  static_assert(
-    std::is_base_of<irs::doc_iterator, doc_iterator_t>::value,
-    "DocIterator must be derived from irs::doc_iterator"
-   );
-
-  explicit mask_doc_iterator(const document_mask& mask)
-    : mask_(mask) {
+  if (term_state_.docs_count <= postings_writer::BLOCK_SIZE) {
+    // there is no skip-list for a single block
+    max_freq = term_state_.max_freq;
+    return doc_limits::eof();
   }
 
-  virtual bool next() override {
-    while (doc_iterator_t::next()) {
-      if (mask_.find(this->value()) == mask_.end()) {
-        return true;
-      }
-    }
+  prepare_skip();
 
-    return false;
+  if (target <= last_.doc) {
+    // skip-list has already been moved beyond the 'target'
+    max_freq = term_state_.max_freq;
+    return last_.doc;
   }
 
-  virtual doc_id_t seek(doc_id_t target) override {
-    const auto doc = doc_iterator_t::seek(target);
+  last_.level = 0;
+  skip_.seek(target);
 
-    if (mask_.find(doc) == mask_.end()) {
-      return doc;
-    }
+  const auto& block = skip_levels_.front();
 
-    this->next();
-
-    return this->value();
-  }
+  // the tail block isn't covered by skip-list
+  max_freq = doc_limits::eof(block.doc)
+    ? term_state_.max_freq
+    : block.max_freq;
 
- private:
-  const document_mask& mask_; /* excluded document ids */
-}; // mask_doc_iterator
+  return block.doc;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 /// @class pos_iterator
@@ -1387,6 +1561,12 @@ class pos_iterator: public position {
     }
 
     pos_in_->seek(state.term_state->pos_start);
+    pos_prefetch_.reset(
+      state.term_state->pos_start,
+      state.term_state->pos_start
+        + bytes_io<uint32_t>::const_max_vsize*state.term_freq
+    );
+    pos_prefetch_.advance(*pos_in_);
     freq_ = state.freq;
     features_ = state.features;
     enc_buf_ = reinterpret_cast<uint32_t*>(state.enc_buf);
@@ -1429,6 +1609,7 @@ class pos_iterator: public position {
         }
       }
     } else {
+      pos_prefetch_.advance(*pos_in_);
       format_traits::read_block(*pos_in_, postings_writer::BLOCK_SIZE, enc_buf_, pos_deltas_);
     }
   }
@@ -1463,6 +1644,7 @@ class pos_iterator: public position {
   uint32_t value_{ pos_limits::invalid() }; // current position
   uint32_t buf_pos_{ postings_writer::BLOCK_SIZE } ; /* current position in pos_deltas_ buffer */
   index_input::ptr pos_in_;
+  prefetcher pos_prefetch_;
   features features_; /* field features */
 
  private:
@@ -1501,6 +1683,10 @@ class offs_pay_iterator final: public pos_iterator {
     }
 
     pay_in_->seek(state.term_state->pay_start);
+    pay_prefetch_.reset(
+      state.term_state->pay_start,
+      std::numeric_limits<uint64_t>::max() // payload size isn't known upfront
+    );
   }
 
   virtual void prepare(const skip_state& state) override {
@@ -1584,8 +1770,11 @@ class offs_pay_iterator final: public pos_iterator {
         }
       }
     } else {
+      pos_prefetch_.advance(*pos_in_);
       format_traits::read_block(*pos_in_, postings_writer::BLOCK_SIZE, enc_buf_, pos_deltas_);
 
+      pay_prefetch_.advance(*pay_in_);
+
       // read payloads
       const uint32_t size = pay_in_->read_vint();
       if (size) {
@@ -1609,6 +1798,7 @@ class offs_pay_iterator final: public pos_iterator {
   }
 
   index_input::ptr pay_in_;
+  prefetcher pay_prefetch_;
   offset offs_;
   payload pay_;
   uint32_t offs_start_deltas_[postings_writer::BLOCK_SIZE]{}; /* buffer to store offset starts */
@@ -1647,6 +1837,10 @@ class offs_iterator final : public pos_iterator {
     }
 
     pay_in_->seek(state.term_state->pay_start);
+    pay_prefetch_.reset(
+      state.term_state->pay_start,
+      std::numeric_limits<uint64_t>::max() // payload size isn't known upfront
+    );
   }
 
   virtual void prepare(const skip_state& state) override {
@@ -1685,8 +1879,11 @@ class offs_iterator final : public pos_iterator {
         }
       }
     } else {
+      pos_prefetch_.advance(*pos_in_);
       format_traits::read_block(*pos_in_, postings_writer::BLOCK_SIZE, enc_buf_, pos_deltas_);
 
+      pay_prefetch_.advance(*pay_in_);
+
       // skip payload
       if (features_.payload()) {
         skip_payload(*pay_in_);
@@ -1724,6 +1921,7 @@ class offs_iterator final : public pos_iterator {
   }
 
   index_input::ptr pay_in_;
+  prefetcher pay_prefetch_;
   offset offs_;
   uint32_t offs_start_deltas_[postings_writer::BLOCK_SIZE]; /* buffer to store offset starts */
   uint32_t offs_lengts_[postings_writer::BLOCK_SIZE]; /* buffer to store offset lengths */
@@ -1758,6 +1956,10 @@ class pay_iterator final : public pos_iterator {
     }
 
     pay_in_->seek(state.term_state->pay_start);
+    pay_prefetch_.reset(
+      state.term_state->pay_start,
+      std::numeric_limits<uint64_t>::max() // payload size isn't known upfront
+    );
   }
 
   virtual void prepare(const skip_state& state) override {
@@ -1842,8 +2044,11 @@ class pay_iterator final : public pos_iterator {
         }
       }
     } else {
+      pos_prefetch_.advance(*pos_in_);
       format_traits::read_block(*pos_in_, postings_writer::BLOCK_SIZE, enc_buf_, pos_deltas_);
 
+      pay_prefetch_.advance(*pay_in_);
+
       /* read payloads */
       const uint32_t size = pay_in_->read_vint();
       if (size) {
@@ -1868,6 +2073,7 @@ class pay_iterator final : public pos_iterator {
   }
 
   index_input::ptr pay_in_;
+  prefetcher pay_prefetch_;
   payload pay_;
   uint32_t pay_lengths_[postings_writer::BLOCK_SIZE]{}; /* buffer to store payload lengths */
   uint64_t pay_data_pos_{}; /* current postition in payload buffer */
@@ -1906,6 +2112,14 @@ class pos_doc_iterator final: public doc_iterator {
     return true;
   }
 
+  virtual size_t next_batch(
+      doc_id_t* docs,
+      uint32_t* freqs,
+      size_t size) override {
+    // positions of every document have to be accounted
+    return irs::doc_iterator::next_batch(docs, freqs, size);
+  }
+
  protected:
   virtual void prepare_attributes(
     const ::features& features,
@@ -1944,6 +2158,7 @@ void pos_doc_iterator<PosItrType>::prepare_attributes(
   state.freq = &freq_.value;
   state.features = features_;
   state.enc_buf = enc_buf_;
+  state.term_freq = term_freq_;
 
   if (term_freq_ < postings_writer::BLOCK_SIZE) {
     state.tail_start = term_state_.pos_start;
@@ -2384,7 +2599,13 @@ class document_mask_writer final: public irs::document_mask_writer {
   static const string_ref FORMAT_NAME;
 
   static const int32_t FORMAT_MIN = 0;
-  static const int32_t FORMAT_MAX = FORMAT_MIN;
+  static const int32_t FORMAT_BITMAP = 1; // sparse/dense encoding
+  static const int32_t FORMAT_MAX = FORMAT_BITMAP;
+
+  explicit document_mask_writer(int32_t version) NOEXCEPT
+    : version_(version) {
+    assert(version_ >= FORMAT_MIN && version_ <= FORMAT_MAX);
+  }
 
   virtual ~document_mask_writer() = default;
 
@@ -2397,6 +2618,9 @@ class document_mask_writer final: public irs::document_mask_writer {
     const segment_meta& meta,
     const document_mask& docs_mask
   ) override;
+
+ private:
+  int32_t version_;
 }; // document_mask_writer
 
 template<>
@@ -2433,11 +2657,49 @@ void document_mask_writer::write(
   assert(docs_mask.size() <= integer_traits<uint32_t>::const_max);
   const auto count = static_cast<uint32_t>(docs_mask.size());
 
-  format_utils::write_header(*out, FORMAT_NAME, FORMAT_MAX);
+  format_utils::write_header(*out, FORMAT_NAME, version_);
   out->write_vint(count);
 
+  if (version_ < FORMAT_BITMAP) {
+    for (auto mask : docs_mask) {
+      out->write_vint(mask);
+    }
+
+    format_utils::write_footer(*out);
+
+    return;
+  }
+
+  // choose the most compact encoding: delta-encoded list of masked
+  // documents or a bitmap up to the word of the largest masked document
+  typedef document_mask::word_t word_t;
+  static_assert(sizeof(word_t) == sizeof(uint64_t), "sizeof(word_t) != sizeof(uint64_t)");
+
+  size_t sparse_size = 0;
+  doc_id_t prev = 0;
+
   for (auto mask : docs_mask) {
-    out->write_vint(mask);
+    sparse_size += bytes_io<uint32_t>::vsize(mask - prev);
+    prev = mask;
+  }
+
+  const bitset& set = docs_mask;
+  const size_t words = count ? bitset::word(prev) + 1 : 0;
+
+  if (words*sizeof(word_t) < sparse_size) {
+    out->write_vint(uint32_t(words));
+
+    for (auto* begin = set.begin(), *end = begin + words; begin != end; ++begin) {
+      out->write_long(*begin);
+    }
+  } else {
+    out->write_vint(0); // sparse
+    prev = 0;
+
+    for (auto mask : docs_mask) {
+      out->write_vint(mask - prev);
+      prev = mask;
+    }
   }
 
   format_utils::write_footer(*out);
@@ -2492,22 +2754,62 @@ bool document_mask_reader::read(
 
   const auto checksum = format_utils::checksum(*in);
 
-  format_utils::check_header(
+  const auto version = format_utils::check_header(
     *in,
     document_mask_writer::FORMAT_NAME,
     document_mask_writer::FORMAT_MIN,
     document_mask_writer::FORMAT_MAX
   );
 
+  static_assert(
+    sizeof(doc_id_t) == sizeof(decltype(in->read_vint())),
+    "sizeof(doc_id) != sizeof(decltype(id))"
+  );
+
   auto count = in->read_vint();
 
-  while (count--) {
-    static_assert(
-      sizeof(doc_id_t) == sizeof(decltype(in->read_vint())),
-      "sizeof(doc_id) != sizeof(decltype(id))"
-    );
+  if (version < document_mask_writer::FORMAT_BITMAP) {
+    while (count--) {
+      docs_mask.insert(in->read_vint());
+    }
+  } else if (const auto words = in->read_vint()) {
+    // dense, the bitmap can't span past the word of the last segment document,
+    // check before allocating since the checksum is verified in the end only
+    const auto max_words = bitset::word(
+      size_t(doc_limits::min()) + meta.docs_count - 1
+    ) + 1;
+
+    if (words > max_words) {
+      throw index_error(string_utils::to_string(
+        "while reading document mask '%s', error: bitmap of %u words exceeds the limit of " IR_SIZE_T_SPECIFIER " words for " IR_UINT64_T_SPECIFIER " documents",
+        in_name.c_str(), words, max_words, meta.docs_count
+      ));
+    }
 
-    docs_mask.insert(in->read_vint());
+    std::vector<document_mask::word_t> set(words);
+    size_t masked = 0;
+
+    for (auto& word : set) {
+      word = in->read_long();
+      masked += math::math_traits<document_mask::word_t>::pop(word);
+    }
+
+    if (masked != count) {
+      throw index_error(string_utils::to_string(
+        "while reading document mask '%s', error: bitmap holds " IR_SIZE_T_SPECIFIER " documents while %u expected",
+        in_name.c_str(), masked, count
+      ));
+    }
+
+    docs_mask.merge(set.data(), set.size());
+  } else {
+    // sparse
+    doc_id_t doc = 0;
+
+    while (count--) {
+      doc += in->read_vint();
+      docs_mask.insert(doc);
+    }
   }
 
   format_utils::check_footer(*in, checksum);
@@ -2766,6 +3068,7 @@ bool meta_reader::read(column_meta& column) {
 
 const uint32_t INDEX_BLOCK_SIZE = 1024;
 const size_t MAX_DATA_BLOCK_SIZE = 8192;
+const size_t MAX_DICTIONARY_SIZE = 4096;
 
 // By default we treat columns as a variable length sparse columns
 enum ColumnProperty : uint32_t {
@@ -2779,7 +3082,7 @@ ENABLE_BITMASK_ENUM(ColumnProperty);
 
 ColumnProperty write_compact(
     irs::index_output& out,
-    irs::compressor& compressor,
+    irs::compression::compressor& compressor,
     const irs::bytes_ref& data) {
   if (data.empty()) {
     out.write_byte(0); // zig_zag_encode32(0) == 0
@@ -2787,12 +3090,12 @@ ColumnProperty write_compact(
   }
 
   // compressor can only handle size of int32_t, so can use the negative flag as a compression flag
-  compressor.compress(reinterpret_cast<const char*>(data.c_str()), data.size());
+  const auto compressed = compressor.compress(data.c_str(), data.size());
 
-  if (compressor.size() < data.size()) {
-    assert(compressor.size() <= irs::integer_traits<int32_t>::const_max);
-    irs::write_zvint(out, int32_t(compressor.size())); // compressed size
-    out.write_bytes(compressor.c_str(), compressor.size());
+  if (!compressed.empty() && compressed.size() < data.size()) {
+    assert(compressed.size() <= irs::integer_traits<int32_t>::const_max);
+    irs::write_zvint(out, int32_t(compressed.size())); // compressed size
+    out.write_bytes(compressed.c_str(), compressed.size());
     irs::write_zvlong(out, data.size() - MAX_DATA_BLOCK_SIZE); // original size
   } else {
     assert(data.size() <= irs::integer_traits<int32_t>::const_max);
@@ -2805,7 +3108,7 @@ ColumnProperty write_compact(
 
 void read_compact(
     irs::index_input& in,
-    const irs::decompressor& decompressor,
+    const irs::compression::decompressor& decompressor,
     irs::bstring& encode_buf,
     irs::bstring& decode_buf) {
   const auto size = irs::read_zvint(in);
@@ -2843,10 +3146,10 @@ void read_compact(
   // ensure that we have enough space to store decompressed data
   decode_buf.resize(irs::read_zvlong(in) + MAX_DATA_BLOCK_SIZE);
 
-  buf_size = decompressor.deflate(
-    reinterpret_cast<const char*>(encode_buf.c_str()),
+  buf_size = decompressor.decompress(
+    encode_buf.c_str(),
     buf_size,
-    reinterpret_cast<char*>(&decode_buf[0]),
+    &decode_buf[0],
     decode_buf.size()
   );
 
@@ -2920,6 +3223,11 @@ class index_block {
     return *(offset_-1);
   }
 
+  // returns offsets of the items to be flushed
+  const uint64_t* offsets() const NOEXCEPT {
+    return offsets_;
+  }
+
   ColumnProperty flush(data_output& out, uint64_t* buf) {
     if (empty()) {
       return CP_DENSE | CP_FIXED;
@@ -2991,22 +3299,30 @@ class index_block {
 class writer final : public irs::columnstore_writer {
  public:
   static const int32_t FORMAT_MIN = 0;
-  static const int32_t FORMAT_MAX = FORMAT_MIN;
+  static const int32_t FORMAT_MAX = 1; // per column compression
 
   static const string_ref FORMAT_NAME;
   static const string_ref FORMAT_EXT;
 
+  explicit writer(int32_t version) NOEXCEPT
+    : version_(version) {
+    assert(version >= FORMAT_MIN && version <= FORMAT_MAX);
+  }
+
+  using irs::columnstore_writer::push_column;
+
   virtual void prepare(directory& dir, const segment_meta& meta) override;
-  virtual column_t push_column() override;
+  virtual column_t push_column(const column_info& info) override;
   virtual bool commit() override;
   virtual void rollback() NOEXCEPT override;
 
  private:
   class column final : public irs::columnstore_writer::column_output {
    public:
-    explicit column(writer& ctx)
+    column(writer& ctx, compression::type codec)
       : ctx_(&ctx),
-        blocks_index_(*ctx.alloc_) {
+        blocks_index_(*ctx.alloc_),
+        codec_(codec) {
     }
 
     void prepare(doc_id_t key) {
@@ -3020,6 +3336,11 @@ class writer final : public irs::columnstore_writer {
       // flush block if we've overcome MAX_DATA_BLOCK_SIZE size
       // or reached the end of the index block
       if (block_buf_.size() >= MAX_DATA_BLOCK_SIZE || block_index_.full()) {
+        if (!comp_) {
+          // the first block is big enough to train a dictionary on
+          prepare_compressor(true);
+        }
+
         flush_block();
       }
 
@@ -3033,6 +3354,11 @@ class writer final : public irs::columnstore_writer {
     void finish() {
       auto& out = *ctx_->data_out_;
       write_enum(out, ColumnProperty(((column_props_ & CP_DENSE) << 3) | blocks_props_)); // column properties
+
+      if (ctx_->version_ > FORMAT_MIN) {
+        write_enum(out, codec_); // column codec
+        write_string(out, dict_); // dictionary of the codec
+      }
       out.write_vint(block_index_.total()); // total number of items
       out.write_vint(max_); // max column key
       out.write_vint(avg_block_size_); // avg data block size
@@ -3047,6 +3373,11 @@ class writer final : public irs::columnstore_writer {
       avg_block_count_ = block_index_.flushed() / blocks_count;
       avg_block_size_ = length_ / blocks_count;
 
+      if (!comp_) {
+        // too little data for a dictionary to pay off
+        prepare_compressor(false);
+      }
+
       // commit and flush remain blocks
       flush_block();
 
@@ -3079,6 +3410,34 @@ class writer final : public irs::columnstore_writer {
     }
 
    private:
+    void prepare_compressor(bool train) {
+      assert(!comp_);
+
+      if (train && !block_index_.empty()) {
+        // every value of the block is a separate sample
+        const auto* offsets = block_index_.offsets();
+        std::vector<size_t> sizes(block_index_.size());
+
+        for (size_t i = 1, size = sizes.size(); i < size; ++i) {
+          sizes[i - 1] = offsets[i] - offsets[i - 1];
+        }
+        sizes.back() = block_buf_.size() - offsets[sizes.size() - 1];
+
+        dict_ = compression::train_dictionary(
+          codec_, block_buf_, sizes, MAX_DICTIONARY_SIZE
+        );
+      }
+
+      if (dict_.empty()) {
+        comp_ = &ctx_->compressor(codec_); // share compressor among columns
+      } else {
+        dict_comp_ = compression::get_compressor(codec_, dict_);
+        comp_ = dict_comp_.get();
+      }
+
+      assert(comp_);
+    }
+
     void flush_block() {
       if (block_index_.empty()) {
         // nothing to flush
@@ -3115,7 +3474,8 @@ class writer final : public irs::columnstore_writer {
       //   const auto res = expr0() | expr1();
       // otherwise it would violate format layout
       auto block_props = block_index_.flush(out, buf);
-      block_props |= write_compact(out, ctx_->comp_, static_cast<bytes_ref>(block_buf_));
+      assert(comp_);
+      block_props |= write_compact(out, *comp_, static_cast<bytes_ref>(block_buf_));
       length_ += block_buf_.size();
 
       // refresh blocks properties
@@ -3141,15 +3501,32 @@ class writer final : public irs::columnstore_writer {
     ColumnProperty column_props_{ CP_DENSE }; // aggregated column block index properties
     uint32_t avg_block_count_{}; // average number of items per block (tail block is not taken into account since it may skew distribution)
     uint32_t avg_block_size_{}; // average size of the block (tail block is not taken into account since it may skew distribution)
+    compression::type codec_; // codec of the data blocks
+    compression::compressor* comp_{}; // compressor of the data blocks
+    compression::compressor::ptr dict_comp_; // compressor with a dictionary of the column
+    bstring dict_; // dictionary trained on the first data block
   }; // column
 
+  // returns compressor shared by the columns without a dictionary
+  compression::compressor& compressor(compression::type codec) {
+    auto& comp = comps_[codec];
+
+    if (!comp) {
+      comp = compression::get_compressor(codec);
+      assert(comp); // codec is checked in push_column(...)
+    }
+
+    return *comp;
+  }
+
   memory_allocator* alloc_{ &memory_allocator::global() };
   uint64_t buf_[INDEX_BLOCK_SIZE]; // reusable temporary buffer for packing
   std::deque<column> columns_; // pointers remain valid
-  compressor comp_{ 2*MAX_DATA_BLOCK_SIZE };
+  std::map<compression::type, compression::compressor::ptr> comps_;
   index_output::ptr data_out_;
   std::string filename_;
   directory* dir_;
+  int32_t version_;
 }; // writer
 
 template<>
@@ -3178,7 +3555,7 @@ void writer::prepare(directory& dir, const segment_meta& meta) {
     ));
   }
 
-  format_utils::write_header(*data_out, FORMAT_NAME, FORMAT_MAX);
+  format_utils::write_header(*data_out, FORMAT_NAME, version_);
 
   alloc_ = &directory_utils::get_allocator(dir);
 
@@ -3188,9 +3565,24 @@ void writer::prepare(directory& dir, const segment_meta& meta) {
   filename_ = std::move(filename);
 }
 
-columnstore_writer::column_t writer::push_column() {
+columnstore_writer::column_t writer::push_column(const column_info& info) {
+  auto codec = compression::type::LZ4; // the only codec of FORMAT_MIN
+
+  if (version_ > FORMAT_MIN) {
+    codec = info.compression;
+
+    if (!compression::supported(codec)) {
+      IR_FRMT_WARN(
+        "Compression codec '%u' is not supported, using LZ4 instead",
+        static_cast<uint32_t>(codec)
+      );
+
+      codec = compression::type::LZ4;
+    }
+  }
+
   const auto id = columns_.size();
-  columns_.emplace_back(*this);
+  columns_.emplace_back(*this, codec);
   auto& column = columns_.back();
 
   return std::make_pair(id, [&column] (doc_id_t doc) -> column_output& {
@@ -3252,36 +3644,236 @@ void writer::rollback() NOEXCEPT {
   columns_.clear(); // ensure next flush (without prepare(...)) will use the section without 'data_out_'
 }
 
-template<typename Block, typename Allocator>
-class block_cache : irs::util::noncopyable {
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       Block cache
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class block_cache_entry
+/// @brief a column block reference which may be tracked by the 'block_cache'
+/// @note all members except 'referenced_' are guarded by the cache mutex
+////////////////////////////////////////////////////////////////////////////////
+class block_cache_entry : util::noncopyable {
  public:
-  block_cache(const Allocator& alloc = Allocator())
-    : cache_(alloc) {
+  block_cache_entry() = default;
+
+  block_cache_entry(block_cache_entry&& other) NOEXCEPT {
+    // entries are only moved while the column index is being read
+    assert(!other.linked());
+    UNUSED(other);
   }
-  block_cache(block_cache&& rhs) NOEXCEPT
-    : cache_(std::move(rhs.cache_)) {
+
+  virtual ~block_cache_entry() = default;
+
+  // marks entry as recently used
+  void touch() const NOEXCEPT {
+    referenced_.store(true, std::memory_order_relaxed);
   }
 
-  template<typename... Args>
-  Block& emplace_back(Args&&... args) {
-    cache_.emplace_back(std::forward<Args>(args)...);
-    return cache_.back();
+ private:
+  friend class block_cache;
+
+  // drops the cached block, existing holders remain valid
+  virtual void reset() NOEXCEPT = 0;
+
+  bool linked() const NOEXCEPT { return nullptr != next_; }
+
+  block_cache_entry* prev_{};
+  block_cache_entry* next_{};
+  size_t size_{}; // memory accounted for the cached block
+  mutable std::atomic<bool> referenced_{ false }; // CLOCK reference bit
+}; // block_cache_entry
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class cached_block
+/// @brief a column block reference holding a cached block of the specified type
+////////////////////////////////////////////////////////////////////////////////
+template<typename Block>
+class cached_block
+    : public block_cache_entry,
+      private atomic_shared_ptr_helper<const Block> {
+ public:
+  typedef Block block_t;
+  typedef std::shared_ptr<const block_t> block_ptr;
+  typedef atomic_shared_ptr_helper<const block_t> atomic_utils;
+
+  cached_block() = default;
+
+  cached_block(cached_block&& other) NOEXCEPT
+    : block_cache_entry(std::move(other)) {
+    atomic_utils::atomic_store(
+      &block_, other.atomic_exchange(&other.block_, nullptr)
+    );
   }
 
-  void pop_back() NOEXCEPT {
-    cache_.pop_back();
+  block_ptr block() const NOEXCEPT {
+    return atomic_utils::atomic_load(&block_);
   }
 
  private:
-  std::deque<Block, Allocator> cache_; // pointers remain valid
-}; // block_cache
+  friend class block_cache;
 
-template<typename Block, typename Allocator>
-struct block_cache_traits {
-  typedef Block block_t;
-  typedef typename std::allocator_traits<Allocator>::template rebind_alloc<block_t> allocator_t;
-  typedef block_cache<Block, allocator_t> cache_t;
-};
+  void store(const block_ptr& block) NOEXCEPT {
+    atomic_utils::atomic_store(&block_, block);
+  }
+
+  virtual void reset() NOEXCEPT override {
+    atomic_utils::atomic_store(&block_, nullptr);
+  }
+
+  block_ptr block_;
+}; // cached_block
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class block_cache
+/// @brief memory-bounded cache of decoded column blocks shared by all
+///        columnstore readers, uses CLOCK eviction policy
+////////////////////////////////////////////////////////////////////////////////
+class block_cache : util::noncopyable {
+ public:
+  static block_cache& instance() {
+    static block_cache INSTANCE;
+    return INSTANCE;
+  }
+
+  void hit() NOEXCEPT { hits_.fetch_add(1, std::memory_order_relaxed); }
+  void miss() NOEXCEPT { misses_.fetch_add(1, std::memory_order_relaxed); }
+
+  void limit(size_t limit) {
+    SCOPED_LOCK(mutex_);
+    limit_ = limit;
+    shrink();
+  }
+
+  version10::columnstore_cache_stats stats() const {
+    version10::columnstore_cache_stats stats;
+
+    {
+      SCOPED_LOCK(mutex_);
+      stats.limit = limit_;
+      stats.size = size_;
+      stats.blocks = count_;
+      stats.evictions = evictions_;
+    }
+
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.misses = misses_.load(std::memory_order_relaxed);
+
+    return stats;
+  }
+
+  // publishes the specified 'block' via 'entry' unless another thread
+  // has already done that, returns the block held by 'entry'
+  template<typename Block>
+  typename cached_block<Block>::block_ptr emplace(
+      cached_block<Block>& entry,
+      typename cached_block<Block>::block_ptr&& block) {
+    assert(block);
+    SCOPED_LOCK(mutex_);
+
+    auto cached = entry.block();
+
+    if (cached) {
+      // already cached by another thread
+      return cached;
+    }
+
+    entry.store(block);
+    entry.size_ = block->memory();
+    link(entry);
+    shrink();
+
+    return std::move(block);
+  }
+
+  // stops tracking entries in the specified range, must be called
+  // before the entries are destroyed
+  template<typename Iterator>
+  void erase(Iterator begin, Iterator end) NOEXCEPT {
+    SCOPED_LOCK(mutex_);
+
+    for (; begin != end; ++begin) {
+      block_cache_entry& entry = *begin;
+
+      if (entry.linked()) {
+        unlink(entry);
+        entry.reset();
+      }
+    }
+  }
+
+ private:
+  block_cache() = default;
+
+  void link(block_cache_entry& entry) NOEXCEPT {
+    assert(!entry.linked());
+
+    if (!hand_) {
+      entry.prev_ = entry.next_ = &entry;
+      hand_ = &entry;
+    } else {
+      // insert right behind the hand, i.e. examine last
+      entry.next_ = hand_;
+      entry.prev_ = hand_->prev_;
+      entry.prev_->next_ = &entry;
+      hand_->prev_ = &entry;
+    }
+
+    entry.referenced_.store(false, std::memory_order_relaxed);
+    size_ += entry.size_;
+    ++count_;
+  }
+
+  void unlink(block_cache_entry& entry) NOEXCEPT {
+    assert(entry.linked());
+
+    if (entry.next_ == &entry) {
+      hand_ = nullptr;
+    } else {
+      entry.prev_->next_ = entry.next_;
+      entry.next_->prev_ = entry.prev_;
+
+      if (hand_ == &entry) {
+        hand_ = entry.next_;
+      }
+    }
+
+    entry.prev_ = entry.next_ = nullptr;
+    size_ -= entry.size_;
+    --count_;
+  }
+
+  void shrink() NOEXCEPT {
+    size_t skipped = 0;
+
+    while (size_ > limit_ && hand_) {
+      auto* entry = hand_;
+
+      // give recently used entries a second chance, but don't
+      // loop forever in case of concurrent lookups
+      if (skipped < count_
+          && entry->referenced_.exchange(false, std::memory_order_relaxed)) {
+        hand_ = entry->next_;
+        ++skipped;
+        continue;
+      }
+
+      unlink(*entry);
+      entry->reset();
+      ++evictions_;
+      skipped = 0;
+    }
+  }
+
+  mutable std::mutex mutex_;
+  block_cache_entry* hand_{}; // CLOCK hand, next candidate for eviction
+  size_t limit_{ integer_traits<size_t>::const_max }; // byte budget
+  size_t size_{}; // bytes held by cached blocks
+  size_t count_{}; // number of cached blocks
+  size_t evictions_{};
+  std::atomic<size_t> hits_{};
+  std::atomic<size_t> misses_{};
+}; // block_cache
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                            Blocks
@@ -3368,7 +3960,7 @@ class sparse_block : util::noncopyable {
     const bstring* data_{};
   }; // iterator
 
-  void load(index_input& in, decompressor& decomp, bstring& buf) {
+  void load(index_input& in, const compression::decompressor& decomp, bstring& buf) {
     const uint32_t size = in.read_vint(); // total number of entries in a block
 
     if (!size) {
@@ -3462,6 +4054,11 @@ class sparse_block : util::noncopyable {
     return visitor(begin->key, value);
   }
 
+  // memory occupied by a block
+  size_t memory() const NOEXCEPT {
+    return sizeof(*this) + data_.capacity();
+  }
+
  private:
   // TODO: use single memory block for both index & data
 
@@ -3551,7 +4148,7 @@ class dense_block : util::noncopyable {
     doc_id_t base_{};
   }; // iterator
 
-  void load(index_input& in, decompressor& decomp, bstring& buf) {
+  void load(index_input& in, const compression::decompressor& decomp, bstring& buf) {
     const uint32_t size = in.read_vint(); // total number of entries in a block
 
     if (!size) {
@@ -3636,6 +4233,11 @@ class dense_block : util::noncopyable {
     return visitor(key, value);
   }
 
+  // memory occupied by a block
+  size_t memory() const NOEXCEPT {
+    return sizeof(*this) + data_.capacity();
+  }
+
  private:
   // TODO: use single memory block for both index & data
 
@@ -3728,7 +4330,7 @@ class dense_fixed_offset_block : util::noncopyable {
     doc_id_t value_back_{}; // last valid doc id
   }; // iterator
 
-  void load(index_input& in, decompressor& decomp, bstring& buf) {
+  void load(index_input& in, const compression::decompressor& decomp, bstring& buf) {
     size_ = in.read_vint(); // total number of entries in a block
 
     if (!size_) {
@@ -3802,6 +4404,11 @@ class dense_fixed_offset_block : util::noncopyable {
     return visitor(key, value);
   }
 
+  // memory occupied by a block
+  size_t memory() const NOEXCEPT {
+    return sizeof(*this) + data_.capacity();
+  }
+
  private:
   doc_id_t base_key_{}; // base key
   uint32_t base_offset_{}; // base offset
@@ -3868,7 +4475,7 @@ class sparse_mask_block : util::noncopyable {
     );
   }
 
-  void load(index_input& in, decompressor& /*decomp*/, bstring& buf) {
+  void load(index_input& in, const compression::decompressor& /*decomp*/, bstring& buf) {
     size_ = in.read_vint(); // total number of entries in a block
 
     if (!size_) {
@@ -3911,6 +4518,11 @@ class sparse_mask_block : util::noncopyable {
     return true;
   }
 
+  // memory occupied by a block
+  size_t memory() const NOEXCEPT {
+    return sizeof(*this);
+  }
+
  private:
   // all blocks except the tail one are going to be fully filled,
   // so we store keys in a fixed length array since we could
@@ -3985,7 +4597,7 @@ class dense_mask_block {
       max_(doc_limits::invalid()) {
   }
 
-  void load(index_input& in, decompressor& /*decomp*/, bstring& /*buf*/) {
+  void load(index_input& in, const compression::decompressor& /*decomp*/, bstring& /*buf*/) {
     const auto size = in.read_vint(); // total number of entries in a block
 
     if (!size) {
@@ -4023,18 +4635,17 @@ class dense_mask_block {
     return true;
   }
 
+  // memory occupied by a block
+  size_t memory() const NOEXCEPT {
+    return sizeof(*this);
+  }
+
  private:
   doc_id_t min_;
   doc_id_t max_;
 }; // dense_mask_block
 
-template<typename Allocator = std::allocator<sparse_block>>
-class read_context
-  : public block_cache_traits<sparse_block, Allocator>::cache_t,
-    public block_cache_traits<dense_block, Allocator>::cache_t,
-    public block_cache_traits<dense_fixed_offset_block, Allocator>::cache_t,
-    public block_cache_traits<sparse_mask_block, Allocator>::cache_t,
-    public block_cache_traits<dense_mask_block, Allocator>::cache_t {
+class read_context {
  public:
   DECLARE_SHARED_PTR(read_context);
 
@@ -4051,54 +4662,26 @@ class read_context
     return memory::make_shared<read_context>(std::move(clone));
   }
 
-  read_context(index_input::ptr&& in = index_input::ptr(), const Allocator& alloc = Allocator())
-    : block_cache_traits<sparse_block, Allocator>::cache_t(typename block_cache_traits<sparse_block, Allocator>::allocator_t(alloc)),
-      block_cache_traits<dense_block, Allocator>::cache_t(typename block_cache_traits<dense_block, Allocator>::allocator_t(alloc)),
-      block_cache_traits<dense_fixed_offset_block, Allocator>::cache_t(typename block_cache_traits<dense_fixed_offset_block, Allocator>::allocator_t(alloc)),
-      block_cache_traits<sparse_mask_block, Allocator>::cache_t(typename block_cache_traits<sparse_mask_block, Allocator>::allocator_t(alloc)),
-      block_cache_traits<dense_mask_block, Allocator>::cache_t(typename block_cache_traits<dense_mask_block, Allocator>::allocator_t(alloc)),
-      buf_(INDEX_BLOCK_SIZE*sizeof(uint32_t), 0),
+  explicit read_context(index_input::ptr&& in = index_input::ptr())
+    : buf_(INDEX_BLOCK_SIZE*sizeof(uint32_t), 0),
       stream_(std::move(in)) {
   }
 
-  template<typename Block, typename... Args>
-  Block& emplace_back(uint64_t offset, Args&&... args) {
-    typename block_cache_traits<Block, Allocator>::cache_t& cache = *this;
-
-    // add cache entry
-    auto& block = cache.emplace_back(std::forward<Args>(args)...);
-
-    try {
-      load(block, offset);
-    } catch (...) {
-      // failed to load block
-      pop_back<Block>();
-
-      throw;
-    }
-
-    return block;
-  }
-
   template<typename Block>
-  void load(Block& block, uint64_t offset) {
+  void load(
+      Block& block,
+      const compression::decompressor& decomp,
+      uint64_t offset) {
     stream_->seek(offset); // seek to the offset
-    block.load(*stream_, decomp_, buf_);
-  }
-
-  template<typename Block>
-  void pop_back() NOEXCEPT {
-    typename block_cache_traits<Block, Allocator>::cache_t& cache = *this;
-    cache.pop_back();
+    block.load(*stream_, decomp, buf_);
   }
 
  private:
-  decompressor decomp_; // decompressor
   bstring buf_; // temporary buffer for decoding/unpacking
   index_input::ptr stream_;
 }; // read_context
 
-typedef read_context<> read_context_t;
+typedef read_context read_context_t;
 
 class context_provider: private util::noncopyable {
  public:
@@ -4119,56 +4702,64 @@ class context_provider: private util::noncopyable {
   index_input::ptr stream_;
 }; // context_provider
 
-// in case of success caches block pointed
-// instance, nullptr otherwise
+// returns a block pointed by 'ref', loads and caches
+// the block in the shared block cache if necessary
 template<typename BlockRef>
-const typename BlockRef::block_t& load_block(
+typename BlockRef::block_ptr load_block(
     const context_provider& ctxs,
-    BlockRef& ref) {
+    const compression::decompressor& decomp,
+    const BlockRef& ref) {
   typedef typename BlockRef::block_t block_t;
 
-  const auto* cached = ref.pblock.load();
+  auto& cache = block_cache::instance();
+  auto cached = ref.block();
+
+  if (cached) {
+    cache.hit();
+    ref.touch();
+    return cached;
+  }
+
+  cache.miss();
+
+  auto block = memory::make_shared<block_t>();
 
-  if (!cached) {
+  {
+    SCOPED_METRIC(metrics::event::COLUMN_BLOCK_LOAD);
     auto ctx = ctxs.get_context();
     assert(ctx);
 
     // load block
-    const auto& block = ctx->template emplace_back<block_t>(ref.offset);
-
-    // mark block as loaded
-    if (ref.pblock.compare_exchange_strong(cached, &block)) {
-      cached = &block;
-    } else {
-      // already cached by another thread
-      ctx->template pop_back<block_t>();
-    }
+    ctx->load(*block, decomp, ref.offset);
   }
 
-  return *cached;
+  return cache.emplace(const_cast<BlockRef&>(ref), std::move(block));
 }
 
-// in case of success caches block pointed
-// by 'ref' in the specified 'block' and
-// retuns a pointer to cached instance,
-// nullptr otherwise
+// returns a block pointed by 'ref' in case if it's
+// already cached, loads block into the specified
+// 'block' and returns it otherwise, 'cached' holds
+// cached block for the lifetime of a returned value
 template<typename BlockRef>
 const typename BlockRef::block_t& load_block(
     const context_provider& ctxs,
+    const compression::decompressor& decomp,
     const BlockRef& ref,
-    typename BlockRef::block_t& block) {
-  const auto* cached = ref.pblock.load();
+    typename BlockRef::block_t& block,
+    typename BlockRef::block_ptr& cached) {
+  cached = ref.block();
 
-  if (!cached) {
-    auto ctx = ctxs.get_context();
-    assert(ctx);
+  if (cached) {
+    return *cached;
+  }
 
-    ctx->load(block, ref.offset);
+  SCOPED_METRIC(metrics::event::COLUMN_BLOCK_LOAD);
+  auto ctx = ctxs.get_context();
+  assert(ctx);
 
-    cached = &block;
-  }
+  ctx->load(block, decomp, ref.offset);
 
-  return *cached;
+  return block;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4203,6 +4794,15 @@ class column
   uint32_t avg_block_count() const NOEXCEPT { return avg_block_count_; }
   ColumnProperty props() const NOEXCEPT { return props_; }
 
+  const compression::decompressor& decompressor() const NOEXCEPT {
+    assert(decomp_);
+    return *decomp_;
+  }
+
+  void decompressor(compression::decompressor::ptr&& decomp) NOEXCEPT {
+    decomp_ = std::move(decomp);
+  }
+
  protected:
   // same as size() but returns uint32_t to avoid type convertions
   uint32_t count() const NOEXCEPT { return count_; }
@@ -4213,6 +4813,7 @@ class column
   uint32_t avg_block_size_{};
   uint32_t avg_block_count_{};
   ColumnProperty props_{ CP_SPARSE };
+  compression::decompressor::ptr decomp_;
 }; // column
 
 template<typename Column>
@@ -4275,6 +4876,7 @@ class column_iterator final: public irs::doc_iterator {
     if (begin_ == end_) {
       // reached the end of the column
       block_.seal();
+      cached_.reset();
       seek_origin_ = end_;
       payload_.clear();
 
@@ -4282,14 +4884,16 @@ class column_iterator final: public irs::doc_iterator {
     }
 
     try {
-      const auto& cached = load_block(*column_->ctxs_, *begin_);
+      auto cached = load_block(*column_->ctxs_, column_->decompressor(), *begin_);
 
-      if (block_ != cached) {
-        block_.reset(cached, payload_);
+      if (block_ != *cached) {
+        block_.reset(*cached, payload_);
+        cached_ = std::move(cached); // hold block while iterating over it
       }
     } catch (...) {
       // unable to load block, seal the iterator
       block_.seal();
+      cached_.reset();
       begin_ = end_;
       payload_.clear();
 
@@ -4302,6 +4906,7 @@ class column_iterator final: public irs::doc_iterator {
   }
 
   irs::attribute_view attrs_;
+  typename column_t::block_ref::block_ptr cached_; // current block
   block_iterator_t block_;
   irs::payload payload_;
   const typename column_t::block_ref* begin_;
@@ -4325,6 +4930,22 @@ if (column.empty()) {
   };
 }
 
+// the returned reader holds the most recently accessed block, so that
+// the value remains valid until the next call even if the block has been
+// evicted from the block cache in the meantime
+template<typename Column>
+columnstore_reader::values_reader_f cached_column_values(const Column& column) {
+  if (column.empty()) {
+    return columnstore_reader::empty_reader();
+  }
+
+  typename Column::block_ptr cached;
+
+  return [&column, cached](doc_id_t key, bytes_ref& value) mutable {
+    return column.value(key, value, cached);
+  };
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @class sparse_column
 ////////////////////////////////////////////////////////////////////////////////
@@ -4333,6 +4954,7 @@ class sparse_column final : public column {
  public:
   typedef sparse_column column_t;
   typedef Block block_t;
+  typedef std::shared_ptr<const block_t> block_ptr;
 
   static column::ptr make(const context_provider& ctxs, ColumnProperty props) {
     return memory::make_unique<column_t>(ctxs, props);
@@ -4342,6 +4964,10 @@ class sparse_column final : public column {
     : column(props), ctxs_(&ctxs) {
   }
 
+  virtual ~sparse_column() {
+    block_cache::instance().erase(refs_.begin(), refs_.end());
+  }
+
   virtual void read(data_input& in, uint64_t* buf) override {
     column::read(in, buf); // read common header
 
@@ -4399,7 +5025,7 @@ class sparse_column final : public column {
     refs_ = std::move(refs);
   }
 
-  bool value(doc_id_t key, bytes_ref& value) const {
+  bool value(doc_id_t key, bytes_ref& value, block_ptr& cached) const {
     // find the right block
     const auto rbegin = refs_.rbegin(); // upper bound
     const auto rend = refs_.rend();
@@ -4413,17 +5039,18 @@ class sparse_column final : public column {
       return false;
     }
 
-    const auto& cached = load_block(*ctxs_, *it);
+    cached = load_block(*ctxs_, decompressor(), *it);
 
-    return cached.value(key, value);
+    return cached->value(key, value);
   };
 
   virtual bool visit(
       const columnstore_reader::values_visitor_f& visitor
   ) const override {
     block_t block; // don't cache new blocks
+    block_ptr pinned;
     for (auto begin = refs_.begin(), end = refs_.end()-1; begin != end; ++begin) { // -1 for upper bound
-      const auto& cached = load_block(*ctxs_, *begin, block);
+      const auto& cached = load_block(*ctxs_, decompressor(), *begin, block, pinned);
 
       if (!cached.visit(visitor)) {
         return false;
@@ -4445,25 +5072,23 @@ class sparse_column final : public column {
   }
 
   virtual columnstore_reader::values_reader_f values() const override {
-    return column_values<column_t>(*this);
+    return cached_column_values<column_t>(*this);
   }
 
  private:
   friend class column_iterator<column_t>;
 
-  struct block_ref : util::noncopyable {
-    typedef typename column_t::block_t block_t;
-
+  struct block_ref : cached_block<block_t> {
     block_ref() = default;
 
     block_ref(block_ref&& other) NOEXCEPT
-      : key(std::move(other.key)), offset(std::move(other.offset)) {
-      pblock = other.pblock.exchange(nullptr); // no std::move(...) for std::atomic<...>
+      : cached_block<block_t>(std::move(other)),
+        key(std::move(other.key)),
+        offset(std::move(other.offset)) {
     }
 
     doc_id_t key; // min key in a block
     uint64_t offset; // block offset
-    mutable std::atomic<const block_t*> pblock; // pointer to cached block
   }; // block_ref
 
   typedef std::vector<block_ref> refs_t;
@@ -4525,6 +5150,7 @@ class dense_fixed_offset_column final : public column {
  public:
   typedef dense_fixed_offset_column column_t;
   typedef Block block_t;
+  typedef std::shared_ptr<const block_t> block_ptr;
 
   static column::ptr make(const context_provider& ctxs, ColumnProperty props) {
     return memory::make_unique<column_t>(ctxs, props);
@@ -4534,6 +5160,10 @@ class dense_fixed_offset_column final : public column {
     : column(prop), ctxs_(&ctxs) {
   }
 
+  virtual ~dense_fixed_offset_column() {
+    block_cache::instance().erase(refs_.begin(), refs_.end());
+  }
+
   virtual void read(data_input& in, uint64_t* buf) override {
     column::read(in, buf); // read common header
 
@@ -4582,7 +5212,7 @@ class dense_fixed_offset_column final : public column {
     min_ = this->max() - this->count() + 1;
   }
 
-  bool value(doc_id_t key, bytes_ref& value) const {
+  bool value(doc_id_t key, bytes_ref& value, block_ptr& cached) const {
     const auto base_key = key - min_;
 
     if (base_key >= this->count()) {
@@ -4592,19 +5222,18 @@ class dense_fixed_offset_column final : public column {
     const auto block_idx = base_key / this->avg_block_count();
     assert(block_idx < refs_.size());
 
-    auto& ref = const_cast<block_ref&>(refs_[block_idx]);
+    cached = load_block(*ctxs_, decompressor(), refs_[block_idx]);
 
-    const auto& cached = load_block(*ctxs_, ref);
-
-    return cached.value(key, value);
+    return cached->value(key, value);
   }
 
   virtual bool visit(
       const columnstore_reader::values_visitor_f& visitor
   ) const override {
     block_t block; // don't cache new blocks
+    block_ptr pinned;
     for (auto& ref : refs_) {
-      const auto& cached = load_block(*ctxs_, ref, block);
+      const auto& cached = load_block(*ctxs_, decompressor(), ref, block, pinned);
 
       if (!cached.visit(visitor)) {
         return false;
@@ -4628,24 +5257,21 @@ class dense_fixed_offset_column final : public column {
   }
 
   virtual columnstore_reader::values_reader_f values() const override {
-    return column_values<column_t>(*this);
+    return cached_column_values<column_t>(*this);
   }
 
  private:
   friend class column_iterator<column_t>;
 
-  struct block_ref {
-    typedef typename column_t::block_t block_t;
-
+  struct block_ref : cached_block<block_t> {
     block_ref() = default;
 
     block_ref(block_ref&& other) NOEXCEPT
-      : offset(std::move(other.offset)) {
-      pblock = other.pblock.exchange(nullptr); // no std::move(...) for std::atomic<...>
+      : cached_block<block_t>(std::move(other)),
+        offset(std::move(other.offset)) {
     }
 
     uint64_t offset; // need to store base offset since blocks may not be located sequentially
-    mutable std::atomic<const block_t*> pblock;
   }; // block_ref
 
   typedef std::vector<block_ref> refs_t;
@@ -4912,7 +5538,7 @@ bool reader::prepare(
   }
 
   // check header
-  format_utils::check_header(
+  const auto version = format_utils::check_header(
     *stream,
     writer::FORMAT_NAME,
     writer::FORMAT_MIN,
@@ -4967,6 +5593,26 @@ bool reader::prepare(
       ));
     }
 
+    // read column codec
+    auto codec = compression::type::LZ4; // the only codec of FORMAT_MIN
+    bstring dict;
+
+    if (version > writer::FORMAT_MIN) {
+      codec = read_enum<compression::type>(*stream);
+      dict = read_string<bstring>(*stream);
+    }
+
+    auto decomp = compression::get_decompressor(codec, dict);
+
+    if (!decomp) {
+      throw index_error(string_utils::to_string(
+        "Failed to load column id=" IR_SIZE_T_SPECIFIER ", unsupported compression codec '%u'",
+        i, static_cast<uint32_t>(codec)
+      ));
+    }
+
+    column->decompressor(std::move(decomp));
+
     try {
       column->read(*stream, buf);
     } catch (...) {
@@ -5023,6 +5669,7 @@ class postings_reader final: public irs::postings_reader {
   index_input::ptr doc_in_;
   index_input::ptr pos_in_;
   index_input::ptr pay_in_;
+  int32_t version_{ postings_writer::FORMAT_MIN };
 }; // postings_reader
 
 void postings_reader::prepare(
@@ -5084,7 +5731,7 @@ void postings_reader::prepare(
   }
 
   // check postings format
-  format_utils::check_header(in,
+  version_ = format_utils::check_header(in,
     postings_writer::TERMS_FORMAT_NAME,
     postings_writer::TERMS_FORMAT_MIN,
     postings_writer::TERMS_FORMAT_MAX
@@ -5117,6 +5764,13 @@ void postings_reader::decode(
   term_meta.docs_count = in.read_vint();
   if (term_freq) {
     term_freq->value = term_meta.docs_count + in.read_vint();
+
+    if (version_ > postings_writer::FORMAT_MIN) {
+      // max frequency of a singleton term is equal to its total frequency
+      term_meta.max_freq = term_meta.docs_count > 1
+        ? in.read_vint()
+        : term_freq->value;
+    }
   }
 
   term_meta.doc_start += in.read_vlong();
@@ -5176,7 +5830,8 @@ irs::doc_iterator::ptr postings_reader::iterator(
 
   it->prepare(
     features, enabled, attrs,
-    doc_in_.get(), pos_in_.get(), pay_in_.get()
+    doc_in_.get(), pos_in_.get(), pay_in_.get(),
+    version_
   );
 
   return it;
@@ -5204,7 +5859,7 @@ class format10 : public irs::version10::format {
   virtual segment_meta_writer::ptr get_segment_meta_writer() const override;
   virtual segment_meta_reader::ptr get_segment_meta_reader() const override final;
 
-  virtual document_mask_writer::ptr get_document_mask_writer() const override final;
+  virtual document_mask_writer::ptr get_document_mask_writer() const override;
   virtual document_mask_reader::ptr get_document_mask_reader() const override final;
 
   virtual field_writer::ptr get_field_writer(bool volatile_state) const override;
@@ -5213,7 +5868,7 @@ class format10 : public irs::version10::format {
   virtual column_meta_writer::ptr get_column_meta_writer() const override;
   virtual column_meta_reader::ptr get_column_meta_reader() const override final;
 
-  virtual columnstore_writer::ptr get_columnstore_writer() const override final;
+  virtual columnstore_writer::ptr get_columnstore_writer() const override;
   virtual columnstore_reader::ptr get_columnstore_reader() const override final;
 
   virtual postings_writer::ptr get_postings_writer(bool volatile_state) const override;
@@ -5252,7 +5907,7 @@ segment_meta_reader::ptr format10::get_segment_meta_reader() const {
 
 document_mask_writer::ptr format10::get_document_mask_writer() const {
   // can reuse stateless writer
-  static ::document_mask_writer INSTANCE;
+  static ::document_mask_writer INSTANCE(::document_mask_writer::FORMAT_MIN);
 
   return memory::make_managed<irs::document_mask_writer, false>(&INSTANCE);
 }
@@ -5289,7 +5944,9 @@ column_meta_reader::ptr format10::get_column_meta_reader() const {
 }
 
 columnstore_writer::ptr format10::get_columnstore_writer() const {
-  return memory::make_unique<columns::writer>();
+  return memory::make_unique<columns::writer>(
+    int32_t(columns::writer::FORMAT_MIN)
+  );
 }
 
 columnstore_reader::ptr format10::get_columnstore_reader() const {
@@ -5297,7 +5954,10 @@ columnstore_reader::ptr format10::get_columnstore_reader() const {
 }
 
 irs::postings_writer::ptr format10::get_postings_writer(bool volatile_state) const {
-  return irs::postings_writer::make<::postings_writer>(volatile_state);
+  return irs::postings_writer::make<::postings_writer>(
+    int32_t(::postings_writer::FORMAT_MIN),
+    volatile_state
+  );
 }
 
 irs::postings_reader::ptr format10::get_postings_reader() const {
@@ -5329,7 +5989,13 @@ class format11 final : public format10 {
 
   virtual segment_meta_writer::ptr get_segment_meta_writer() const override final;
 
+  virtual document_mask_writer::ptr get_document_mask_writer() const override final;
+
   virtual column_meta_writer::ptr get_column_meta_writer() const override final;
+
+  virtual columnstore_writer::ptr get_columnstore_writer() const override final;
+
+  virtual postings_writer::ptr get_postings_writer(bool volatile_state) const override final;
 }; // format10
 
 field_writer::ptr format11::get_field_writer(bool volatile_state) const {
@@ -5347,12 +6013,32 @@ segment_meta_writer::ptr format11::get_segment_meta_writer() const {
   return memory::make_managed<irs::segment_meta_writer, false>(&INSTANCE);
 }
 
+document_mask_writer::ptr format11::get_document_mask_writer() const {
+  // can reuse stateless writer
+  static ::document_mask_writer INSTANCE(::document_mask_writer::FORMAT_MAX);
+
+  return memory::make_managed<irs::document_mask_writer, false>(&INSTANCE);
+}
+
 column_meta_writer::ptr format11::get_column_meta_writer() const {
   return memory::make_unique<columns::meta_writer>(
     int32_t(columns::meta_writer::FORMAT_MAX)
   );
 }
 
+columnstore_writer::ptr format11::get_columnstore_writer() const {
+  return memory::make_unique<columns::writer>(
+    int32_t(columns::writer::FORMAT_MAX)
+  );
+}
+
+irs::postings_writer::ptr format11::get_postings_writer(bool volatile_state) const {
+  return irs::postings_writer::make<::postings_writer>(
+    int32_t(::postings_writer::FORMAT_MAX),
+    volatile_state
+  );
+}
+
 /*static*/ irs::format::ptr format11::make() {
   static const ::format11 INSTANCE;
 
@@ -5375,6 +6061,18 @@ void init() {
 #endif
 }
 
+// ----------------------------------------------------------------------------
+// --SECTION--                                                      block cache
+// ----------------------------------------------------------------------------
+
+void columnstore_cache_limit(size_t limit) {
+  ::columns::block_cache::instance().limit(limit);
+}
+
+columnstore_cache_stats columnstore_cache_statistics() {
+  return ::columns::block_cache::instance().stats();
+}
+
 // ----------------------------------------------------------------------------
 // --SECTION--                                                           format
 // ----------------------------------------------------------------------------
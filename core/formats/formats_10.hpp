@@ -31,6 +31,32 @@ NS_BEGIN(version10)
 
 void init();
 
+//////////////////////////////////////////////////////////////////////////////
+/// @struct columnstore_cache_stats
+/// @brief snapshot of the decoded block cache shared by all 1.0 columnstore
+///        readers
+//////////////////////////////////////////////////////////////////////////////
+struct columnstore_cache_stats {
+  size_t limit; // configured memory budget in bytes
+  size_t size; // memory currently occupied by cached blocks in bytes
+  size_t blocks; // number of cached blocks
+  size_t hits; // number of lookups served from the cache
+  size_t misses; // number of lookups which caused block loading
+  size_t evictions; // number of blocks evicted due to memory budget
+}; // columnstore_cache_stats
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief sets memory budget (in bytes) of the block cache shared by all
+///        1.0 columnstore readers, least recently used blocks are evicted
+///        once the budget is exceeded, cache is unbounded by default
+//////////////////////////////////////////////////////////////////////////////
+IRESEARCH_PLUGIN void columnstore_cache_limit(size_t limit);
+
+//////////////////////////////////////////////////////////////////////////////
+/// @return statistics of the block cache shared by all 1.0 columnstore readers
+//////////////////////////////////////////////////////////////////////////////
+IRESEARCH_PLUGIN columnstore_cache_stats columnstore_cache_statistics();
+
 //////////////////////////////////////////////////////////////////////////////
 /// @class format
 //////////////////////////////////////////////////////////////////////////////
@@ -34,6 +34,7 @@
 #include "index/index_meta.hpp"
 
 #include "utils/directory_utils.hpp"
+#include "utils/metrics.hpp"
 #include "utils/timer_utils.hpp"
 #include "utils/fst.hpp"
 #include "utils/bit_utils.hpp"
@@ -1199,6 +1200,7 @@ bool term_iterator::seek_to_block(const bytes_ref& term, size_t& prefix) {
 }
 
 SeekResult term_iterator::seek_equal(const bytes_ref& term) {
+  metrics::increment(metrics::event::TERM_SEEK);
   size_t prefix;
   if (seek_to_block(term, prefix)) {
     return SeekResult::FOUND;
@@ -1217,6 +1219,7 @@ SeekResult term_iterator::seek_equal(const bytes_ref& term) {
 }
 
 SeekResult term_iterator::seek_ge(const bytes_ref& term) {
+  metrics::increment(metrics::event::TERM_SEEK);
   size_t prefix;
   if (seek_to_block(term, prefix)) {
     return SeekResult::FOUND;
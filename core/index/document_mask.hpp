@@ -0,0 +1,256 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2019 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_DOCUMENT_MASK_H
+#define IRESEARCH_DOCUMENT_MASK_H
+
+#include "shared.hpp"
+#include "utils/bitset.hpp"
+#include "utils/math_utils.hpp"
+#include "utils/type_limits.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+NS_ROOT
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class document_mask
+/// @brief set of excluded (e.g. removed) document identifiers backed by
+///        a bitmap indexed by document identifier, the bitmap spans up to
+///        the largest masked document only
+////////////////////////////////////////////////////////////////////////////////
+class document_mask {
+ public:
+  typedef bitset::word_t word_t;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @class const_iterator
+  /// @brief iterates over masked document identifiers in ascending order
+  //////////////////////////////////////////////////////////////////////////////
+  class const_iterator
+      : public std::iterator<std::forward_iterator_tag, doc_id_t> {
+   public:
+    const_iterator(const word_t* begin, const word_t* end) NOEXCEPT
+      : begin_(begin), word_(begin), end_(end),
+        value_(begin == end ? 0 : *begin) {
+      next_word();
+    }
+
+    doc_id_t operator*() const NOEXCEPT {
+      return doc_id_t(
+        bitset::bit_offset(std::distance(begin_, word_))
+        + math::math_traits<word_t>::ctz(value_)
+      );
+    }
+
+    const_iterator& operator++() NOEXCEPT {
+      value_ &= value_ - 1; // unset the lowest bit
+      next_word();
+      return *this;
+    }
+
+    const_iterator operator++(int) NOEXCEPT {
+      const auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const const_iterator& rhs) const NOEXCEPT {
+      return word_ == rhs.word_ && value_ == rhs.value_;
+    }
+
+    bool operator!=(const const_iterator& rhs) const NOEXCEPT {
+      return !(*this == rhs);
+    }
+
+   private:
+    void next_word() NOEXCEPT {
+      while (!value_ && word_ != end_) {
+        if (++word_ != end_) {
+          value_ = *word_;
+        }
+      }
+    }
+
+    const word_t* begin_;
+    const word_t* word_;
+    const word_t* end_;
+    word_t value_; // not yet visited bits of the current word
+  }; // const_iterator
+
+  document_mask() = default;
+  document_mask(document_mask&&) = default;
+  document_mask(const document_mask& other) { *this = other; }
+
+  document_mask& operator=(document_mask&&) = default;
+  document_mask& operator=(const document_mask& other) {
+    if (this != &other) {
+      set_.reset(other.set_.size());
+
+      if (other.set_.words()) {
+        set_.memset(other.set_.data(), other.set_.words()*sizeof(word_t));
+      }
+
+      size_ = other.size_;
+    }
+
+    return *this;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns true if the document wasn't masked before
+  //////////////////////////////////////////////////////////////////////////////
+  bool insert(doc_id_t doc) {
+    if (doc >= set_.size()) {
+      grow(size_t(doc) + 1);
+    } else if (set_.test(doc)) {
+      return false;
+    }
+
+    set_.set(doc);
+    ++size_;
+
+    return true;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief masks documents corresponding to the bits set in the specified
+  ///        words, i.e. bit 'i' of word 'j' denotes document 'j*64 + i'
+  //////////////////////////////////////////////////////////////////////////////
+  void merge(const word_t* words, size_t count) {
+    reserve(bitset::bit_offset(count));
+
+    for (size_t i = 0; i < count; ++i) {
+      auto value = words[i] & ~set_.data()[i]; // not yet masked documents
+
+      for (; value; value &= value - 1) {
+        set_.set(bitset::bit_offset(i) + math::math_traits<word_t>::ctz(value));
+        ++size_;
+      }
+    }
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns true if the document was masked
+  //////////////////////////////////////////////////////////////////////////////
+  bool erase(doc_id_t doc) NOEXCEPT {
+    if (!contains(doc)) {
+      return false;
+    }
+
+    set_.unset(doc);
+    --size_;
+
+    return true;
+  }
+
+  bool contains(doc_id_t doc) const NOEXCEPT {
+    return doc < set_.size() && set_.test(doc);
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns the smallest document identifier not less than 'doc' that
+  ///          isn't masked, runs of masked documents are skipped a word
+  ///          at a time
+  //////////////////////////////////////////////////////////////////////////////
+  doc_id_t next_unmasked(doc_id_t doc) const NOEXCEPT {
+    if (doc >= set_.size()) {
+      return doc;
+    }
+
+    auto* word = set_.begin() + bitset::word(doc);
+    auto value = ~*word & (~word_t(0) << bitset::bit(doc));
+
+    while (!value) {
+      if (++word == set_.end()) {
+        // every document past the bitmap isn't masked
+        return doc_id_t(std::min(set_.capacity(), size_t(doc_limits::eof())));
+      }
+
+      value = ~*word;
+    }
+
+    return doc_id_t(std::min(
+      bitset::bit_offset(std::distance(set_.begin(), word))
+        + math::math_traits<word_t>::ctz(value),
+      size_t(doc_limits::eof())
+    ));
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief ensure the mask is able to hold documents less than 'docs'
+  ///        without reallocation
+  //////////////////////////////////////////////////////////////////////////////
+  void reserve(size_t docs) {
+    if (docs > set_.size()) {
+      grow(docs);
+    }
+  }
+
+  void clear() NOEXCEPT {
+    set_.clear();
+    size_ = 0;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns number of masked documents
+  //////////////////////////////////////////////////////////////////////////////
+  size_t size() const NOEXCEPT { return size_; }
+  bool empty() const NOEXCEPT { return 0 == size_; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns underlying bitmap, trailing words may be empty
+  //////////////////////////////////////////////////////////////////////////////
+  operator const bitset&() const NOEXCEPT { return set_; }
+
+  const_iterator begin() const NOEXCEPT {
+    return const_iterator(set_.begin(), set_.end());
+  }
+
+  const_iterator end() const NOEXCEPT {
+    return const_iterator(set_.end(), set_.end());
+  }
+
+ private:
+  void grow(size_t docs) {
+    // grow in blocks of power-of-2 to amortize reallocations
+    bitset set(std::max(
+      math::roundup_power2(docs),
+      size_t(bits_required<word_t>())
+    ));
+
+    if (set_.words()) {
+      set.memset(set_.data(), set_.words()*sizeof(word_t));
+    }
+
+    set_ = std::move(set);
+  }
+
+  bitset set_;
+  size_t size_{}; // number of masked documents
+}; // document_mask
+
+NS_END // ROOT
+
+#endif // IRESEARCH_DOCUMENT_MASK_H
@@ -581,14 +581,21 @@ class term_iterator : public irs::term_iterator {
       const doc_map* docmap,
       const bytes_ref*& min,
       const bytes_ref*& max) {
-    // refill postings
-    postings_.clear();
-    postings_.insert(field.terms_.begin(), field.terms_.end());
+    // postings are sorted by fields_data::flush(...)
+    auto& terms = field.terms_;
+    assert(std::is_sorted(
+      terms.begin(), terms.end(),
+      [](const postings::value_type& lhs, const postings::value_type& rhs) {
+        return memcmp_less(lhs.first, rhs.first);
+    }));
+
+    begin_ = terms.begin();
+    end_ = terms.end();
 
     max = min = &irs::bytes_ref::NIL;
-    if (!postings_.empty()) {
-      min = &(postings_.begin()->first);
-      max = &((--postings_.end())->first);
+    if (begin_ != end_) {
+      min = &(begin_->first);
+      max = &((--postings::const_iterator(end_))->first);
     }
 
     field_ = &field;
@@ -600,12 +607,12 @@ class term_iterator : public irs::term_iterator {
     }
 
     // reset state
-    it_ = postings_.begin();
-    next_ = postings_.begin();
+    it_ = begin_;
+    next_ = begin_;
   }
 
   virtual const bytes_ref& value() const NOEXCEPT override {
-    assert(it_ != postings_.end());
+    assert(it_ != end_);
     return it_->first;
   }
 
@@ -619,13 +626,13 @@ class term_iterator : public irs::term_iterator {
 
   virtual irs::doc_iterator::ptr postings(const flags& /*features*/) const override {
     REGISTER_TIMER_DETAILED();
-    assert(it_ != postings_.end());
+    assert(it_ != end_);
 
     return (this->*POSTINGS[size_t(field_->prox_random_access())])(it_->second);
   }
 
   virtual bool next() override {   
-    if (next_ == postings_.end()) {
+    if (next_ == end_) {
       return false;
     }
 
@@ -639,18 +646,6 @@ class term_iterator : public irs::term_iterator {
   }
 
  private:
-  struct less_t {
-    bool operator()(const bytes_ref& lhs, const bytes_ref& rhs) const NOEXCEPT {
-      return memcmp_less(lhs, rhs);
-    }
-  };
-
-  typedef std::map<
-    bytes_ref,
-    std::reference_wrapper<const posting>,
-    less_t
-  > map_t;
-
   typedef irs::doc_iterator::ptr(term_iterator::*postings_f)(const posting&) const;
 
   static const postings_f POSTINGS[2];
@@ -687,9 +682,10 @@ class term_iterator : public irs::term_iterator {
     return doc_iterator::ptr(doc_iterator::ptr(), &sorting_doc_itr_); // aliasing ctor
   }
 
-  map_t postings_;
-  map_t::iterator next_{ postings_.end() };
-  map_t::iterator it_{ postings_.end() };
+  postings::const_iterator begin_{};
+  postings::const_iterator end_{};
+  postings::const_iterator next_{};
+  postings::const_iterator it_{};
   const field_data* field_{};
   const doc_map* doc_map_;
   mutable detail::doc_iterator doc_itr_;
@@ -1127,7 +1123,7 @@ bool field_data::invert(
 
     const auto res = terms_.emplace(term->value());
 
-    if (terms_.end() == res.first) {
+    if (!res.first) {
       IR_FRMT_ERROR("field '%s' has invalid term '%s'", meta_.name.c_str(), ref_cast<char>(term->value()).c_str());
       continue;
     }
@@ -1194,7 +1190,7 @@ void fields_data::flush(field_writer& fw, flush_state& state) {
     }
   };
 
-  std::set<const field_data*, less_t> fields;
+  std::set<field_data*, less_t> fields;
 
   // ensure fields are sorted
   for (auto& entry : fields_) {
@@ -1208,6 +1204,9 @@ void fields_data::flush(field_writer& fw, flush_state& state) {
   for (auto* field : fields) {
     auto& meta = field->meta();
 
+    // ensure terms are sorted
+    field->terms_.sort();
+
     // reset reader
     terms.reset(*field, state.docmap);
 
@@ -31,6 +31,7 @@
 #include "utils/bitvector.hpp"
 #include "utils/directory_utils.hpp"
 #include "utils/index_utils.hpp"
+#include "utils/metrics.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/timer_utils.hpp"
 #include "utils/type_limits.hpp"
@@ -141,7 +142,7 @@ bool add_document_mask_modified_records(
       // if the indexed doc_id was insert()ed after the request for modification
       // or the indexed doc_id was already masked then it should be skipped
       if (modification.generation < min_modification_generation
-          || !docs_mask.insert(doc_id).second) {
+          || !docs_mask.insert(doc_id)) {
         continue; // the current modification query does not match any records
       }
 
@@ -215,7 +216,7 @@ bool add_document_mask_modified_records(
       // if the indexed doc_id was insert()ed after the request for modification
       // or the indexed doc_id was already masked then it should be skipped
       if (modification.generation < doc_ctx.generation
-          || !ctx.docs_mask_.insert(doc_id).second) {
+          || !ctx.docs_mask_.insert(doc_id)) {
         continue; // the current modification query does not match any records
       }
 
@@ -262,7 +263,7 @@ bool add_document_mask_unused_updates(flush_segment_context& ctx) {
 
     // if it's an update record placeholder who's query already match some record
     if (ctx.modification_contexts_[doc_ctx.update_id].seen
-        || !ctx.docs_mask_.insert(doc_id).second) {
+        || !ctx.docs_mask_.insert(doc_id)) {
       continue; // the current placeholder record is in-use and valid
     }
 
@@ -1016,7 +1017,9 @@ void index_writer::flush_context::reset() NOEXCEPT {
 index_writer::segment_context::segment_context(
     directory& dir,
     segment_meta_generator_t&& meta_generator,
-    const comparer* comparator
+    const column_info_provider_t& column_info,
+    const comparer* comparator,
+    async_utils::thread_pool* analysis_pool
 ): active_count_(0),
    buffered_docs_(0),
    dirty_(false),
@@ -1025,7 +1028,7 @@ index_writer::segment_context::segment_context(
    uncomitted_doc_id_begin_(doc_limits::min()),
    uncomitted_generation_offset_(0),
    uncomitted_modification_queries_(0),
-   writer_(segment_writer::make(dir_, comparator)) {
+   writer_(segment_writer::make(dir_, comparator, column_info, analysis_pool)) {
   assert(meta_generator_);
 }
 
@@ -1070,9 +1073,13 @@ void index_writer::segment_context::flush() {
 index_writer::segment_context::ptr index_writer::segment_context::make(
     directory& dir,
     segment_meta_generator_t&& meta_generator,
-    const comparer* comparator
+    const column_info_provider_t& column_info,
+    const comparer* comparator,
+    async_utils::thread_pool* analysis_pool
 ) {
-  return memory::make_shared<segment_context>(dir, std::move(meta_generator), comparator);
+  return memory::make_shared<segment_context>(
+    dir, std::move(meta_generator), column_info, comparator, analysis_pool
+  );
 }
 
 segment_writer::update_context index_writer::segment_context::make_update_context() {
@@ -1189,14 +1196,20 @@ index_writer::index_writer(
     size_t segment_pool_size,
     const segment_options& segment_limits,
     const comparer* comparator,
+    async_utils::thread_pool* merge_pool,
+    async_utils::thread_pool* analysis_pool,
+    column_info_provider_t&& column_info,
     index_meta&& meta,
     committed_state_t&& committed_state
 ) NOEXCEPT :
     comparator_(comparator),
     cached_readers_(dir),
     codec_(codec),
+    column_info_(std::move(column_info)),
     committed_state_(std::move(committed_state)),
     dir_(dir),
+    merge_pool_(merge_pool),
+    analysis_pool_(analysis_pool),
     flush_context_pool_(2), // 2 because just swap them due to common commit lock
     meta_(std::move(meta)),
     segment_limits_(segment_limits),
@@ -1340,6 +1353,9 @@ index_writer::ptr index_writer::make(
     opts.segment_pool_size,
     segment_options(opts),
     opts.comparator,
+    opts.merge_pool,
+    opts.analysis_pool,
+    column_info_provider_t(opts.column_info),
     std::move(meta),
     std::move(comitted_state)
   );
@@ -1479,7 +1495,7 @@ bool index_writer::consolidate(
   consolidation_segment.meta.name = file_name(meta_.increment()); // increment active meta, not fn arg
 
   ref_tracking_directory dir(dir_); // track references for new segment
-  merge_writer merger(dir, comparator_);
+  merge_writer merger(dir, comparator_, merge_pool_, column_info_);
   merger.reserve(candidates.size());
 
   // add consolidated segments to the merge_writer
@@ -1674,7 +1690,7 @@ bool index_writer::import(
   segment.meta.name = file_name(meta_.increment());
   segment.meta.codec = codec;
 
-  merge_writer merger(dir);
+  merge_writer merger(dir, nullptr, merge_pool_, column_info_);
   merger.reserve(reader.size());
 
   for (auto& segment : reader) {
@@ -1799,13 +1815,13 @@ index_writer::active_segment_context index_writer::get_segment_context(
     return segment_meta(file_name(meta_.increment()), codec_);
   };
   auto segment_ctx =
-    segment_writer_pool_.emplace(dir_, std::move(meta_generator), comparator_).release();
+    segment_writer_pool_.emplace(dir_, std::move(meta_generator), column_info_, comparator_, analysis_pool_).release();
   auto segment_memory_max = segment_limits_.segment_memory_max.load();
 
   // recreate writer if it reserved more memory than allowed by current limits
   if (segment_memory_max &&
       segment_memory_max < segment_ctx->writer_->memory_reserved()) {
-    segment_ctx->writer_ = segment_writer::make(segment_ctx->dir_, comparator_);
+    segment_ctx->writer_ = segment_writer::make(segment_ctx->dir_, comparator_, column_info_, analysis_pool_);
   }
 
   return active_segment_context(segment_ctx, segments_active_);
@@ -2176,7 +2192,7 @@ index_writer::pending_context_t index_writer::flush_all() {
              doc_id < valid_doc_id_begin;
              ++doc_id) {
           assert(integer_traits<doc_id_t>::const_max >= doc_id);
-          if (flush_segment_ctx.docs_mask_.emplace(doc_id_t(doc_id)).second) {
+          if (flush_segment_ctx.docs_mask_.insert(doc_id_t(doc_id))) {
             assert(flush_segment_ctx.segment_.meta.live_docs_count);
             --flush_segment_ctx.segment_.meta.live_docs_count; // decrement count of live docs
           }
@@ -2188,7 +2204,7 @@ index_writer::pending_context_t index_writer::flush_all() {
              doc_id < doc_id_end;
              ++doc_id) {
           assert(integer_traits<doc_id_t>::const_max >= doc_id);
-          if (flush_segment_ctx.docs_mask_.emplace(doc_id_t(doc_id)).second) {
+          if (flush_segment_ctx.docs_mask_.insert(doc_id_t(doc_id))) {
             assert(flush_segment_ctx.segment_.meta.live_docs_count);
             --flush_segment_ctx.segment_.meta.live_docs_count; // decrement count of live docs
           }
@@ -2261,6 +2277,7 @@ bool index_writer::start() {
   assert(!commit_lock_.try_lock()); // already locked
 
   REGISTER_TIMER_DETAILED();
+  SCOPED_METRIC(metrics::event::COMMIT_START);
 
   if (pending_state_) {
     // begin has been already called
@@ -2338,6 +2355,7 @@ void index_writer::finish() {
   assert(!commit_lock_.try_lock()); // already locked
 
   REGISTER_TIMER_DETAILED();
+  SCOPED_METRIC(metrics::event::COMMIT_FINISH);
 
   if (!pending_state_) {
     return;
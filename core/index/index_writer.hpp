@@ -429,6 +429,29 @@ class IRESEARCH_API index_writer:
     ////////////////////////////////////////////////////////////////////////////
     const comparer* comparator{nullptr};
 
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief thread pool used for writing of the segments produced by
+    ///        consolidation and import, must outlive the index_writer
+    ///        nullptr == write segments on the calling thread
+    ////////////////////////////////////////////////////////////////////////////
+    async_utils::thread_pool* merge_pool{nullptr};
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief thread pool used for analysis of the indexed fields inserted into
+    ///        a document as a range, fields are still inverted in the order
+    ///        of the range, must outlive the index_writer
+    ///        nullptr == analyze fields on the calling thread
+    /// @note token streams of a range are consumed concurrently, hence fields
+    ///       of a range must not share token stream instances
+    ////////////////////////////////////////////////////////////////////////////
+    async_utils::thread_pool* analysis_pool{nullptr};
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief returns options of a stored column, e.g. its compression codec
+    ///        empty == use default options for every column
+    ////////////////////////////////////////////////////////////////////////////
+    column_info_provider_t column_info;
+
     ////////////////////////////////////////////////////////////////////////////
     /// @brief number of memory blocks to cache by the internal memory pool
     ///        0 == use default from memory_allocator::global()
@@ -791,8 +814,8 @@ class IRESEARCH_API index_writer:
     segment_writer::ptr writer_;
     index_meta::index_segment_t writer_meta_; // the segment_meta this writer was initialized with
 
-    DECLARE_FACTORY(directory& dir, segment_meta_generator_t&& meta_generator, const comparer* comparator);
-    segment_context(directory& dir, segment_meta_generator_t&& meta_generator, const comparer* comparator);
+    DECLARE_FACTORY(directory& dir, segment_meta_generator_t&& meta_generator, const column_info_provider_t& column_info, const comparer* comparator, async_utils::thread_pool* analysis_pool);
+    segment_context(directory& dir, segment_meta_generator_t&& meta_generator, const column_info_provider_t& column_info, const comparer* comparator, async_utils::thread_pool* analysis_pool);
 
     ////////////////////////////////////////////////////////////////////////////
     /// @brief flush current writer state into a materialized segment
@@ -1001,6 +1024,9 @@ class IRESEARCH_API index_writer:
     size_t segment_pool_size,
     const segment_options& segment_limits,
     const comparer* comparator,
+    async_utils::thread_pool* merge_pool,
+    async_utils::thread_pool* analysis_pool,
+    column_info_provider_t&& column_info,
     index_meta&& meta, 
     committed_state_t&& committed_state
   ) NOEXCEPT;
@@ -1018,11 +1044,14 @@ class IRESEARCH_API index_writer:
   const comparer* comparator_;
   readers_cache cached_readers_; // readers by segment name
   format::ptr codec_;
+  column_info_provider_t column_info_; // options of the stored columns
   std::mutex commit_lock_; // guard for cached_segment_readers_, commit_pool_, meta_ (modification during commit()/defragment())
   committed_state_t committed_state_; // last successfully committed state
   std::recursive_mutex consolidation_lock_;
   consolidating_segments_t consolidating_segments_; // segments that are under consolidation
   directory& dir_; // directory used for initialization of readers
+  async_utils::thread_pool* merge_pool_; // pool used by merge_writer
+  async_utils::thread_pool* analysis_pool_; // pool used by segment_writer
   std::vector<flush_context> flush_context_pool_; // collection of contexts that collect data to be flushed, 2 because just swap them
   std::atomic<flush_context*> flush_context_; // currently active context accumulating data to be processed during the next flush
   index_meta meta_; // latest/active state of index metadata
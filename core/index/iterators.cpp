@@ -23,6 +23,7 @@
 
 #include "iterators.hpp"
 #include "field_meta.hpp"
+#include "analysis/token_attributes.hpp"
 #include "formats/formats.hpp"
 #include "search/cost.hpp"
 #include "utils/type_limits.hpp"
@@ -177,6 +178,27 @@ doc_iterator::ptr doc_iterator::empty() {
   );
 }
 
+size_t doc_iterator::next_batch(doc_id_t* docs, uint32_t* freqs, size_t size) {
+  size_t count = 0;
+
+  if (!freqs) {
+    for (; count < size && next(); ++count) {
+      docs[count] = value();
+    }
+
+    return count;
+  }
+
+  const auto& freq = attributes().get<frequency>();
+
+  for (; count < size && next(); ++count) {
+    docs[count] = value();
+    freqs[count] = freq ? freq->value : 0;
+  }
+
+  return count;
+}
+
 // ----------------------------------------------------------------------------
 // --SECTION--                                                   field_iterator 
 // ----------------------------------------------------------------------------
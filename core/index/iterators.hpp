@@ -70,6 +70,19 @@ struct IRESEARCH_API doc_iterator
   /// (for more information see class description)
   //////////////////////////////////////////////////////////////////////////////
   virtual doc_id_t seek(doc_id_t target) = 0;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief moves iterator over up to 'size' subsequent documents at once,
+  ///        e.g. to evaluate documents in bulk rather than one by one
+  /// @param docs buffer for at least 'size' document identifiers
+  /// @param freqs nullptr or buffer for at least 'size' document frequencies,
+  ///        filled with 0 if the iterator doesn't expose 'frequency'
+  /// @returns number of documents stored, less than 'size' only if the
+  ///          iterator has become exhausted
+  /// @note once returned 'value()' and attributes correspond to the last
+  ///       stored document, the default implementation calls 'next()'
+  //////////////////////////////////////////////////////////////////////////////
+  virtual size_t next_batch(doc_id_t* docs, uint32_t* freqs, size_t size);
 }; // doc_iterator
 
 // ----------------------------------------------------------------------------
@@ -31,13 +31,17 @@
 #include "index/segment_reader.hpp"
 #include "index/heap_iterator.hpp"
 #include "index/comparer.hpp"
+#include "utils/async_utils.hpp"
 #include "utils/directory_utils.hpp"
 #include "utils/log.hpp"
+#include "utils/metrics.hpp"
+#include "utils/thread_utils.hpp"
 #include "utils/type_limits.hpp"
 #include "utils/version_utils.hpp"
 #include "store/store_utils.hpp"
 
 #include <array>
+#include <future>
 
 #include <boost/iterator/filter_iterator.hpp>
 
@@ -1010,9 +1014,11 @@ class columnstore {
     return true;
   }
 
-  void reset() {
-    if (!empty_) {
-      column_ = writer_->push_column();
+  // an empty column is reused unless it has different options
+  void reset(const irs::column_info& info = irs::column_info()) {
+    if (!empty_ || info != info_) {
+      column_ = writer_->push_column(info);
+      info_ = info;
       empty_ = true;
     }
   }
@@ -1035,9 +1041,16 @@ class columnstore {
   progress_tracker progress_;
   irs::columnstore_writer::ptr writer_;
   irs::columnstore_writer::column_t column_{};
+  irs::column_info info_; // options of the current column
   bool empty_{ false };
 }; // columnstore
 
+irs::column_info get_column_info(
+    const irs::column_info_provider_t& column_info,
+    const irs::string_ref& name) {
+  return column_info ? column_info(name) : irs::column_info();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 /// @struct sorting_compound_column_iterator
 //////////////////////////////////////////////////////////////////////////////
@@ -1127,9 +1140,9 @@ template<typename CompoundIterator>
 bool write_columns(
     columnstore& cs,
     CompoundIterator& columns,
-    irs::directory& dir,
-    const irs::segment_meta& meta,
+    irs::column_meta_writer& column_meta_writer,
     compound_column_meta_iterator_t& column_meta_itr,
+    const irs::column_info_provider_t& column_info,
     const irs::merge_writer::flush_progress_t& progress
 ) {
   REGISTER_TIMER_DETAILED();
@@ -1155,11 +1168,8 @@ bool write_columns(
     return column_meta_itr.visit(add_iterators);
   };
 
-  auto column_meta_writer = meta.codec->get_column_meta_writer();
-  column_meta_writer->prepare(dir, meta);
-
   while (column_meta_itr.next()) {
-    cs.reset();
+    cs.reset(get_column_info(column_info, (*column_meta_itr).name));
 
     // visit matched columns from merging segments and
     // write all survived values to the new segment
@@ -1172,11 +1182,11 @@ bool write_columns(
     }
 
     if (!cs.empty()) {
-      column_meta_writer->write((*column_meta_itr).name, cs.id());
+      column_meta_writer.write((*column_meta_itr).name, cs.id());
     }
   }
 
-  column_meta_writer->flush();
+  column_meta_writer.flush();
 
   return true;
 }
@@ -1186,9 +1196,9 @@ bool write_columns(
 //////////////////////////////////////////////////////////////////////////////
 bool write_columns(
     columnstore& cs,
-    irs::directory& dir,
-    const irs::segment_meta& meta,
+    irs::column_meta_writer& cmw,
     compound_column_meta_iterator_t& column_itr,
+    const irs::column_info_provider_t& column_info,
     const irs::merge_writer::flush_progress_t& progress
 ) {
   REGISTER_TIMER_DETAILED();
@@ -1202,12 +1212,8 @@ bool write_columns(
     return cs.insert(segment, column.id, doc_map);
   };
 
-  auto cmw = meta.codec->get_column_meta_writer();
-
-  cmw->prepare(dir, meta);
-
   while (column_itr.next()) {
-    cs.reset();  
+    cs.reset(get_column_info(column_info, (*column_itr).name));
 
     // visit matched columns from merging segments and
     // write all survived values to the new segment 
@@ -1216,11 +1222,11 @@ bool write_columns(
     }
 
     if (!cs.empty()) {
-      cmw->write((*column_itr).name, cs.id());
+      cmw.write((*column_itr).name, cs.id());
     } 
   }
 
-  cmw->flush();
+  cmw.flush();
 
   return true;
 }
@@ -1370,6 +1376,279 @@ bool write_fields(
   return !field_itr.aborted();
 }
 
+//////////////////////////////////////////////////////////////////////////////
+/// @returns true if any live document of the specified segment has a value
+///          in the specified column
+//////////////////////////////////////////////////////////////////////////////
+bool has_live_values(
+    const irs::sub_reader& segment,
+    irs::field_id column,
+    const doc_map_f& doc_map) {
+  const auto* reader = segment.column_reader(column);
+
+  if (!reader) {
+    return false;
+  }
+
+  // usually the very first document is a live one
+  for (auto it = reader->iterator(); it->next();) {
+    if (!irs::doc_limits::eof(doc_map(it->value()))) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief computes identifiers of the norm columns as they are assigned by
+///        'write_columns' followed by 'write_fields'
+/// @param first identifier of the first column pushed by 'columnstore'
+//////////////////////////////////////////////////////////////////////////////
+void compute_norm_ids(
+    std::vector<irs::field_id>& norms,
+    irs::field_id first,
+    compound_column_meta_iterator_t& column_itr,
+    compound_field_iterator& field_itr,
+    const irs::column_info_provider_t& column_info) {
+  REGISTER_TIMER_DETAILED();
+
+  // mimics identifier assignment of 'columnstore'
+  irs::field_id next = first;
+  irs::field_id id = irs::field_limits::invalid();
+  irs::column_info current;
+  bool empty = false;
+
+  auto reset = [&next, &id, &current, &empty](const irs::column_info& info) NOEXCEPT {
+    if (!empty || info != current) {
+      id = next++;
+      current = info;
+      empty = true;
+    }
+  };
+
+  auto columns_visitor = [&empty](
+      const irs::sub_reader& segment,
+      const doc_map_f& doc_map,
+      const irs::column_meta& column) {
+    empty = empty && !has_live_values(segment, column.id, doc_map);
+    return true;
+  };
+
+  while (column_itr.next()) {
+    reset(get_column_info(column_info, (*column_itr).name));
+    column_itr.visit(columns_visitor);
+  }
+
+  auto norms_visitor = [&empty](
+      const irs::sub_reader& segment,
+      const doc_map_f& doc_map,
+      const irs::field_meta& field) {
+    empty = empty
+      && !(irs::field_limits::valid(field.norm)
+           && has_live_values(segment, field.norm, doc_map));
+    return true;
+  };
+
+  norms.clear();
+
+  while (field_itr.next()) {
+    reset(irs::column_info());
+    field_itr.visit(norms_visitor);
+    norms.emplace_back(empty ? irs::field_limits::invalid() : id);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief merge field norms
+/// @param norms receives identifier of the norm column of every field
+//////////////////////////////////////////////////////////////////////////////
+bool write_norms(
+    columnstore& cs,
+    compound_field_iterator& field_itr,
+    std::vector<irs::field_id>& norms,
+    const irs::merge_writer::flush_progress_t& progress
+) {
+  REGISTER_TIMER_DETAILED();
+  assert(cs);
+
+  auto merge_norms = [&cs] (
+      const irs::sub_reader& segment,
+      const doc_map_f& doc_map,
+      const irs::field_meta& field) {
+    // merge field norms if present
+    if (irs::field_limits::valid(field.norm)
+        && !cs.insert(segment, field.norm, doc_map)) {
+      return false;
+    }
+
+    return true;
+  };
+
+  norms.clear();
+
+  while (field_itr.next()) {
+    cs.reset();
+
+    // remap merge norms
+    if (!progress() || !field_itr.visit(merge_norms)) {
+      return false;
+    }
+
+    norms.emplace_back(cs.empty() ? irs::field_limits::invalid() : cs.id());
+  }
+
+  return !field_itr.aborted();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief merge field norms
+/// @param norms receives identifier of the norm column of every field
+//////////////////////////////////////////////////////////////////////////////
+template<typename CompoundIterator>
+bool write_norms(
+    columnstore& cs,
+    CompoundIterator& norms_itr,
+    compound_field_iterator& field_itr,
+    std::vector<irs::field_id>& norms,
+    const irs::merge_writer::flush_progress_t& progress
+) {
+  REGISTER_TIMER_DETAILED();
+  assert(cs);
+
+  auto add_iterators = [&field_itr](compound_doc_iterator::iterators_t& itrs) {
+    auto add_iterators = [&itrs](
+        const irs::sub_reader& segment,
+        const doc_map_f& doc_map,
+        const irs::field_meta& field) {
+      if (!irs::field_limits::valid(field.norm)) {
+        // field has no norms
+        return true;
+      }
+
+      auto* reader = segment.column_reader(field.norm);
+
+      if (!reader) {
+        return false;
+      }
+
+      itrs.emplace_back(reader->iterator(), &doc_map);
+      return true;
+    };
+
+    itrs.clear();
+    return field_itr.visit(add_iterators);
+  };
+
+  norms.clear();
+
+  while (field_itr.next()) {
+    cs.reset();
+
+    // remap merge norms
+    if (!progress() || !norms_itr.reset(add_iterators)) {
+      return false;
+    }
+
+    if (!cs.insert(norms_itr)) {
+      return false; // failed to insert all values
+    }
+
+    norms.emplace_back(cs.empty() ? irs::field_limits::invalid() : cs.id());
+  }
+
+  return !field_itr.aborted();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief write field term data using precomputed norm column identifiers
+//////////////////////////////////////////////////////////////////////////////
+bool write_terms(
+    irs::field_writer::ptr&& field_writer,
+    compound_field_iterator& field_itr,
+    const std::vector<irs::field_id>& norms,
+    const irs::merge_writer::flush_progress_t& progress
+) {
+  REGISTER_TIMER_DETAILED();
+  assert(field_writer);
+
+  for (size_t i = 0; field_itr.next(); ++i) {
+    if (!progress() || i >= norms.size()) {
+      return false;
+    }
+
+    auto& field_meta = field_itr.meta();
+
+    // write field terms
+    auto terms = field_itr.iterator();
+
+    field_writer->write(
+      field_meta.name,
+      norms[i],
+      field_meta.features,
+      *terms
+    );
+  }
+
+  field_writer->end();
+  field_writer.reset();
+
+  return !field_itr.aborted();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief write columnstore (via 'write_columns') and field term data
+///        concurrently, norm column identifiers must be known in advance
+/// @note all files are created by the calling thread since directories
+///       aren't required to be thread-safe
+//////////////////////////////////////////////////////////////////////////////
+template<typename ColumnsWriter>
+bool write_concurrently(
+    irs::async_utils::thread_pool& pool,
+    irs::directory& dir,
+    const irs::segment_meta& meta,
+    compound_field_iterator& field_itr,
+    const irs::flags& fields_features,
+    const std::vector<irs::field_id>& norms,
+    ColumnsWriter&& write_columns,
+    const irs::merge_writer::flush_progress_t& progress
+) {
+  REGISTER_TIMER_DETAILED();
+
+  irs::flush_state flush_state;
+  flush_state.dir = &dir;
+  flush_state.doc_count = meta.docs_count;
+  flush_state.features = &fields_features;
+  flush_state.name = meta.name;
+
+  auto field_writer = meta.codec->get_field_writer(true);
+  field_writer->prepare(flush_state);
+
+  std::vector<irs::field_id> actual_norms;
+  irs::async_utils::pooled_task columns(&pool, [&write_columns, &actual_norms]()->bool {
+    return write_columns(actual_norms);
+  });
+
+  const bool terms_written = write_terms(
+    std::move(field_writer), field_itr, norms, progress
+  );
+
+  if (!columns.get() || !terms_written) {
+    return false;
+  }
+
+  if (norms != actual_norms) {
+    IR_FRMT_ERROR(
+      "Norm columns of segment '%s' differ from the precomputed ones",
+      meta.name.c_str()
+    );
+
+    return false;
+  }
+
+  return true;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 /// @brief computes doc_id_map and docs_count
 //////////////////////////////////////////////////////////////////////////////
@@ -1441,6 +1720,7 @@ bool merge_writer::flush(
   irs::flags fields_features;
 
   doc_id_t base_id = irs::doc_limits::min(); // next valid doc_id
+  std::vector<std::unique_ptr<irs::async_utils::pooled_task>> doc_maps; // pending doc maps
 
   // collect field meta and field term data
   for (auto& reader_ctx : readers_) {
@@ -1457,7 +1737,22 @@ bool merge_writer::flush(
       };
     } else { // segment has some deleted docs
       auto& doc_id_map = reader_ctx.doc_id_map;
-      base_id = compute_doc_ids(doc_id_map , reader, base_id);
+
+      if (pool_) {
+        // next base is defined by the number of live docs,
+        // so doc maps of the segments are independent
+        const doc_id_t next_id = base_id + doc_id_t(reader.live_docs_count());
+
+        doc_maps.emplace_back(memory::make_unique<irs::async_utils::pooled_task>(
+          pool_,
+          [&doc_id_map, &reader, base_id, next_id]()->bool {
+            return next_id == compute_doc_ids(doc_id_map, reader, base_id);
+        }));
+
+        base_id = next_id;
+      } else {
+        base_id = compute_doc_ids(doc_id_map , reader, base_id);
+      }
 
       reader_ctx.doc_map = [&doc_id_map](doc_id_t doc) NOEXCEPT {
         return doc >= doc_id_map.size()
@@ -1478,6 +1773,12 @@ bool merge_writer::flush(
     columns_meta_itr.add(reader, reader_ctx.doc_map);
   }
 
+  for (auto& doc_map : doc_maps) {
+    if (!doc_map->get()) {
+      return false; // failed to compute doc_id_map
+    }
+  }
+
   segment.meta.docs_count = base_id - irs::doc_limits::min(); // total number of doc_ids
   segment.meta.live_docs_count = segment.meta.docs_count; // all merged documents are live
 
@@ -1495,22 +1796,55 @@ bool merge_writer::flush(
     return false; // flush failure
   }
 
+  auto column_meta_writer = segment.meta.codec->get_column_meta_writer();
+  column_meta_writer->prepare(dir, segment.meta);
+
   if (!progress()) {
     return false; // progress callback requested termination
   }
 
-  // write columns
-  if (!write_columns(cs, dir, segment.meta, columns_meta_itr, progress)) {
-    return false; // flush failure
-  }
+  if (pool_) {
+    std::vector<field_id> norms;
+    compound_field_iterator norms_itr(progress);
 
-  if (!progress()) {
-    return false; // progress callback requested termination
-  }
+    {
+      compound_column_meta_iterator_t columns_itr;
+      compound_field_iterator fields_itr(progress);
 
-  // write field meta and field term data
-  if (!write_fields(cs, dir, segment.meta, fields_itr, fields_features, progress)) {
-    return false; // flush failure
+      for (auto& reader_ctx : readers_) {
+        columns_itr.add(*reader_ctx.reader, reader_ctx.doc_map);
+        fields_itr.add(*reader_ctx.reader, reader_ctx.doc_map);
+        norms_itr.add(*reader_ctx.reader, reader_ctx.doc_map);
+      }
+
+      compute_norm_ids(norms, 0, columns_itr, fields_itr, column_info_);
+    }
+
+    // write columns and norms along with field meta and field term data
+    auto write_columnstore = [&](std::vector<field_id>& norms)->bool {
+      return write_columns(cs, *column_meta_writer, columns_meta_itr, column_info_, progress)
+        && progress()
+        && write_norms(cs, norms_itr, norms, progress);
+    };
+
+    if (!write_concurrently(*pool_, dir, segment.meta, fields_itr,
+                            fields_features, norms, write_columnstore, progress)) {
+      return false; // flush failure
+    }
+  } else {
+    // write columns
+    if (!write_columns(cs, *column_meta_writer, columns_meta_itr, column_info_, progress)) {
+      return false; // flush failure
+    }
+
+    if (!progress()) {
+      return false; // progress callback requested termination
+    }
+
+    // write field meta and field term data
+    if (!write_fields(cs, dir, segment.meta, fields_itr, fields_features, progress)) {
+      return false; // flush failure
+    }
   }
 
   if (!progress()) {
@@ -1669,22 +2003,56 @@ bool merge_writer::flush_sorted(
     return false; // flush failure
   }
 
+  auto column_meta_writer = segment.meta.codec->get_column_meta_writer();
+  column_meta_writer->prepare(dir, segment.meta);
+
   if (!progress()) {
     return false; // progress callback requested termination
   }
 
-  // write columns
-  if (!write_columns(cs, sorting_doc_it, dir, segment.meta, columns_meta_itr, progress)) {
-    return false; // flush failure
-  }
+  if (pool_) {
+    std::vector<field_id> norms;
+    compound_field_iterator norms_itr(progress, comparator_);
 
-  if (!progress()) {
-    return false; // progress callback requested termination
-  }
+    {
+      compound_column_meta_iterator_t columns_itr;
+      compound_field_iterator fields_itr(progress, comparator_);
 
-  // write field meta and field term data
-  if (!write_fields(cs, sorting_doc_it, dir, segment.meta, fields_itr, fields_features, progress)) {
-    return false; // flush failure
+      for (auto& reader_ctx : readers_) {
+        columns_itr.add(*reader_ctx.reader, reader_ctx.doc_map);
+        fields_itr.add(*reader_ctx.reader, reader_ctx.doc_map);
+        norms_itr.add(*reader_ctx.reader, reader_ctx.doc_map);
+      }
+
+      // sort column is the first one
+      compute_norm_ids(norms, column.first + 1, columns_itr, fields_itr, column_info_);
+    }
+
+    // write columns and norms along with field meta and field term data
+    auto write_columnstore = [&](std::vector<field_id>& norms)->bool {
+      return write_columns(cs, sorting_doc_it, *column_meta_writer, columns_meta_itr, column_info_, progress)
+        && progress()
+        && write_norms(cs, sorting_doc_it, norms_itr, norms, progress);
+    };
+
+    if (!write_concurrently(*pool_, dir, segment.meta, fields_itr,
+                            fields_features, norms, write_columnstore, progress)) {
+      return false; // flush failure
+    }
+  } else {
+    // write columns
+    if (!write_columns(cs, sorting_doc_it, *column_meta_writer, columns_meta_itr, column_info_, progress)) {
+      return false; // flush failure
+    }
+
+    if (!progress()) {
+      return false; // progress callback requested termination
+    }
+
+    // write field meta and field term data
+    if (!write_fields(cs, sorting_doc_it, dir, segment.meta, fields_itr, fields_features, progress)) {
+      return false; // flush failure
+    }
   }
 
   if (!progress()) {
@@ -1703,6 +2071,7 @@ bool merge_writer::flush(
     const flush_progress_t& progress /*= {}*/
 ) {
   REGISTER_TIMER_DETAILED();
+  SCOPED_METRIC(metrics::event::SEGMENT_MERGE);
   assert(segment.meta.codec); // must be set outside
 
   bool result = false; // overall flush result
@@ -1727,11 +2096,18 @@ bool merge_writer::flush(
 
   const auto& progress_callback = progress ? progress : PROGRESS_NOOP;
 
+  // progress may be reported concurrently if a pool is used
+  std::mutex progress_lock;
+  const flush_progress_t synchronized_progress = [&progress_callback, &progress_lock]()->bool {
+    SCOPED_LOCK(progress_lock);
+    return progress_callback();
+  };
+
   tracking_directory track_dir(dir_); // track writer created files
 
   result = comparator_
-    ? flush_sorted(track_dir, segment, progress_callback)
-    : flush(track_dir, segment, progress_callback);
+    ? flush_sorted(track_dir, segment, pool_ ? synchronized_progress : progress_callback)
+    : flush(track_dir, segment, pool_ ? synchronized_progress : progress_callback);
 
   track_dir.flush_tracked(segment.meta.files);
 
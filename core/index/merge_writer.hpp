@@ -27,6 +27,7 @@
 #include <vector>
 
 #include "index_meta.hpp"
+#include "formats/formats.hpp"
 #include "utils/memory.hpp"
 #include "utils/noncopyable.hpp"
 #include "utils/string.hpp"
@@ -38,6 +39,10 @@ struct tracking_directory;
 struct sub_reader;
 class comparer;
 
+NS_BEGIN(async_utils)
+class thread_pool;
+NS_END // async_utils
+
 class IRESEARCH_API merge_writer: public util::noncopyable {
  public:
   typedef std::shared_ptr<const irs::sub_reader> sub_reader_ptr;
@@ -53,16 +58,26 @@ class IRESEARCH_API merge_writer: public util::noncopyable {
 
   merge_writer() NOEXCEPT;
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @param pool if specified, the term dictionary and the columnstore of
+  ///        the merged segment are written concurrently using the pool,
+  ///        the output is the same as of sequential merge
+  /// @param column_info options of the merged stored columns
+  //////////////////////////////////////////////////////////////////////////////
   explicit merge_writer(
       directory& dir,
-      const comparer* comparator = nullptr) NOEXCEPT
-    : dir_(dir), comparator_(comparator) {
+      const comparer* comparator = nullptr,
+      async_utils::thread_pool* pool = nullptr,
+      const column_info_provider_t& column_info = column_info_provider_t())
+    : dir_(dir), comparator_(comparator), pool_(pool), column_info_(column_info) {
   }
 
   merge_writer(merge_writer&& rhs) NOEXCEPT
     : dir_(rhs.dir_),
       readers_(std::move(rhs.readers_)),
-      comparator_(rhs.comparator_){
+      comparator_(rhs.comparator_),
+      pool_(rhs.pool_),
+      column_info_(std::move(rhs.column_info_)) {
   }
 
   merge_writer& operator=(merge_writer&&) = delete;
@@ -119,6 +134,8 @@ class IRESEARCH_API merge_writer: public util::noncopyable {
   directory& dir_;
   std::vector<reader_ctx> readers_;
   const comparer* comparator_{};
+  async_utils::thread_pool* pool_{};
+  column_info_provider_t column_info_; // empty == default options
   IRESEARCH_API_PRIVATE_VARIABLES_END
 }; // merge_writer
 
@@ -21,13 +21,36 @@
 /// @author Vasiliy Nabatchikov
 ////////////////////////////////////////////////////////////////////////////////
 
-#include "utils/map_utils.hpp"
 #include "utils/timer_utils.hpp"
 #include "utils/type_limits.hpp"
+#include "field_data.hpp" // for memcmp_less(...)
 #include "postings.hpp"
 
+#include <algorithm>
+
+NS_LOCAL
+
+const uint32_t EMPTY = irs::integer_traits<uint32_t>::const_max; // free slot
+const uint32_t MOVED = EMPTY - 1; // slot moved to a larger table
+
+// initial number of slots, must be a power of 2
+const size_t INITIAL_SLOTS = 64;
+
+// number of slots of the previous table moved on every insertion, the new
+// table is twice as large as the previous one so the move is complete long
+// before the new table reaches its load factor
+const size_t MIGRATE_STEP = 4;
+
+NS_END
+
 NS_ROOT
 
+// postings are neither destroyed on clear() nor on reuse of the storage
+static_assert(
+  std::is_trivially_destructible<postings::value_type>::value,
+  "postings must be trivially destructible"
+);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                           postings implementation
 // -----------------------------------------------------------------------------
@@ -36,6 +59,86 @@ postings::postings(writer_t& writer):
   writer_(writer) {
 }
 
+postings::slot* postings::find(
+    slots_t& slots,
+    size_t hash,
+    const bytes_ref& term) NOEXCEPT {
+  if (slots.empty()) {
+    return nullptr;
+  }
+
+  const auto mask = slots.size() - 1;
+
+  // tables always have free slots, see grow()
+  for (auto i = size_t(uint32_t(hash)) & mask;; i = (i + 1) & mask) {
+    auto& entry = slots[i];
+
+    if (EMPTY == entry.value) {
+      return nullptr;
+    }
+
+    if (MOVED != entry.value
+        && uint32_t(hash) == entry.hash
+        && static_cast<const bytes_ref&>(at(entry.value).first) == term) {
+      return &entry;
+    }
+  }
+}
+
+/*static*/ void postings::insert(slots_t& slots, const slot& value) NOEXCEPT {
+  const auto mask = slots.size() - 1;
+
+  for (auto i = size_t(value.hash) & mask;; i = (i + 1) & mask) {
+    if (EMPTY == slots[i].value) {
+      slots[i] = value;
+      return;
+    }
+  }
+}
+
+void postings::migrate(size_t count) NOEXCEPT {
+  for (const auto size = prev_slots_.size(); count && prev_pos_ < size; ++prev_pos_) {
+    auto& entry = prev_slots_[prev_pos_];
+
+    if (EMPTY != entry.value && MOVED != entry.value) {
+      insert(slots_, entry);
+      entry.value = MOVED; // keep probe sequences of the remaining slots
+      --count;
+    }
+  }
+
+  if (prev_pos_ == prev_slots_.size() && !prev_slots_.empty()) {
+    slots_t().swap(prev_slots_); // release memory
+    prev_pos_ = 0;
+  }
+}
+
+void postings::grow() {
+  if (slots_.empty()) {
+    slots_.resize(INITIAL_SLOTS, slot{ 0, EMPTY });
+    return;
+  }
+
+  // max load factor is 0.5
+  if (2*(size_ + 1) <= slots_.size()) {
+    return;
+  }
+
+  migrate(prev_slots_.size()); // finish previous resize if any
+
+  prev_slots_ = std::move(slots_);
+  prev_pos_ = 0;
+  slots_.assign(2*prev_slots_.size(), slot{ 0, EMPTY });
+}
+
+void postings::clear() NOEXCEPT {
+  size_ = 0;
+  std::fill(slots_.begin(), slots_.end(), slot{ 0, EMPTY });
+  prev_slots_.clear();
+  prev_pos_ = 0;
+  sorted_ = true;
+}
+
 postings::emplace_result postings::emplace(const bytes_ref& term) {
   REGISTER_TIMER_DETAILED();
   auto& parent = writer_.parent();
@@ -46,7 +149,21 @@ postings::emplace_result postings::emplace(const bytes_ref& term) {
   if (writer_t::container::block_type::SIZE < max_term_len) {
     // TODO: maybe move big terms it to a separate storage
     // reject terms that do not fit in a block
-    return std::make_pair(map_.end(), false);
+    return std::make_pair(nullptr, false);
+  }
+
+  const auto hash = std::hash<irs::bytes_ref>()(term);
+
+  migrate(MIGRATE_STEP);
+
+  auto* entry = find(slots_, hash, term);
+
+  if (!entry && !prev_slots_.empty()) {
+    entry = find(prev_slots_, hash, term);
+  }
+
+  if (entry) {
+    return std::make_pair(&at(entry->value), false);
   }
 
   const auto slice_end = writer_.pool_offset() + max_term_len;
@@ -60,25 +177,77 @@ postings::emplace_result postings::emplace(const bytes_ref& term) {
   }
 
   assert(size() < doc_limits::eof()); // not larger then the static flag
+  assert(size() < MOVED);
+
+  grow();
+
+  // for new terms also write out their value
+  writer_.write(term.c_str(), term.size());
 
-  auto generator = [&term, this](const hashed_bytes_ref& key, const posting&) {
-    // for new terms also write out their value
-    writer_.write(term.c_str(), term.size());
-
-    // reuse hash but point ref at data in pool
-    return hashed_bytes_ref(
-      key.hash(),
-      (writer_.position() - term.size()).buffer(), term.size()
-    );
-  };
-
-  // replace original reference to 'term' provided by the caller
-  // with a reference to the cached copy in 'writer_'
-  return map_utils::try_emplace_update_key(
-    map_,                                     // container
-    generator,                                // key generator
-    make_hashed_ref(term, std::hash<irs::bytes_ref>()) // key
+  if (size_ == BLOCK_SIZE*blocks_.size()) {
+    blocks_.emplace_back(new value_storage[BLOCK_SIZE]); // postings stay in place
+  }
+
+  // reuse hash but point ref at data in pool
+  auto& value = *new (&at(size_)) value_type(
+    std::piecewise_construct,
+    std::forward_as_tuple(hash, (writer_.position() - term.size()).buffer(), term.size()),
+    std::forward_as_tuple()
   );
+
+  insert(slots_, slot{ uint32_t(hash), uint32_t(size_) });
+  ++size_;
+  sorted_ = false;
+
+  return std::make_pair(&value, true);
+}
+
+void postings::sort() {
+  if (sorted_) {
+    return;
+  }
+
+  // sort offsets rather than the postings themselves, then move every
+  // posting at most once following the cycles of the permutation
+  std::vector<uint32_t> order(size_);
+
+  for (size_t i = 0; i < size_; ++i) {
+    order[i] = uint32_t(i);
+  }
+
+  std::sort(
+    order.begin(), order.end(),
+    [this](uint32_t lhs, uint32_t rhs) NOEXCEPT {
+      return memcmp_less(at(lhs).first, at(rhs).first);
+  });
+
+  for (size_t i = 0; i < size_; ++i) {
+    if (order[i] == i) {
+      continue; // already in place
+    }
+
+    auto value = std::move(at(i));
+    auto pos = i;
+
+    for (auto src = order[pos]; src != i; src = order[pos]) {
+      at(pos) = std::move(at(src));
+      order[pos] = uint32_t(pos);
+      pos = src;
+    }
+
+    at(pos) = std::move(value);
+    order[pos] = uint32_t(pos);
+  }
+
+  // offsets of the values have changed, rebuild the table
+  migrate(prev_slots_.size());
+  std::fill(slots_.begin(), slots_.end(), slot{ 0, EMPTY });
+
+  for (size_t i = 0; i < size_; ++i) {
+    insert(slots_, slot{ uint32_t(at(i).first.hash()), uint32_t(i) });
+  }
+
+  sorted_ = true;
 }
 
 NS_END
@@ -24,7 +24,10 @@
 #ifndef IRESEARCH_POSTINGS_H
 #define IRESEARCH_POSTINGS_H
 
-#include <unordered_map>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
 
 #include "shared.hpp"
 #include "utils/block_pool.hpp"
@@ -53,31 +56,141 @@ struct posting {
   doc_id_t size{ 1 }; // length of postings
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @class postings
+/// @brief open-addressing hash table of the terms of a field, term data is
+///        stored in the byte pool, table slots only refer to the postings
+///        stored in fixed-size blocks in the order of insertion, i.e. postings
+///        never move while new terms are inserted
+/// @note the table grows incrementally, i.e. once the load factor is
+///       exceeded a table of double size is allocated and the slots of the
+///       previous table are moved to it during subsequent insertions
+////////////////////////////////////////////////////////////////////////////////
 class IRESEARCH_API postings: util::noncopyable {
  public:
-  typedef std::unordered_map<hashed_bytes_ref, posting> map_t;
-  typedef std::pair<map_t::iterator, bool> emplace_result;
+  typedef std::pair<hashed_bytes_ref, posting> value_type;
+  typedef value_type* iterator;
+  typedef std::pair<iterator, bool> emplace_result;
   typedef byte_block_pool::inserter writer_t;
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @class const_iterator
+  /// @brief iterates over postings in the order of insertion or in the order
+  ///        of terms after sort()
+  //////////////////////////////////////////////////////////////////////////////
+  class const_iterator
+      : public std::iterator<std::bidirectional_iterator_tag, const value_type> {
+   public:
+    const_iterator() = default;
+    const_iterator(const postings& values, size_t offset) NOEXCEPT
+      : values_(&values), offset_(offset) {
+    }
+
+    const value_type& operator*() const NOEXCEPT {
+      return values_->at(offset_);
+    }
+
+    const value_type* operator->() const NOEXCEPT { return &**this; }
+
+    const_iterator& operator++() NOEXCEPT { ++offset_; return *this; }
+    const_iterator& operator--() NOEXCEPT { --offset_; return *this; }
+
+    const_iterator operator++(int) NOEXCEPT {
+      const auto it = *this;
+      ++offset_;
+      return it;
+    }
+
+    const_iterator operator--(int) NOEXCEPT {
+      const auto it = *this;
+      --offset_;
+      return it;
+    }
+
+    bool operator==(const const_iterator& rhs) const NOEXCEPT {
+      assert(values_ == rhs.values_);
+      return offset_ == rhs.offset_;
+    }
+
+    bool operator!=(const const_iterator& rhs) const NOEXCEPT {
+      return !(*this == rhs);
+    }
+
+   private:
+    const postings* values_{};
+    size_t offset_{};
+  }; // const_iterator
+
   postings(writer_t& writer);
 
-  inline map_t::const_iterator begin() const { return map_.begin(); }
+  inline const_iterator begin() const { return const_iterator(*this, 0); }
 
-  inline void clear() { map_.clear(); }
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief removes all postings, allocated blocks are reused
+  //////////////////////////////////////////////////////////////////////////////
+  void clear() NOEXCEPT;
 
-  // on error returns std::ptr(end(), false)
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns posting of the specified term and true if the term is new,
+  ///          (nullptr, false) if the term is too long to be stored
+  /// @note returned pointer remains valid until clear() or sort()
+  //////////////////////////////////////////////////////////////////////////////
   emplace_result emplace(const bytes_ref& term);
 
-  inline bool empty() const { return map_.empty(); }
+  inline bool empty() const { return 0 == size_; }
+
+  inline const_iterator end() const { return const_iterator(*this, size_); }
 
-  inline map_t::const_iterator end() const { return map_.end(); }
+  inline size_t size() const { return size_; }
 
-  inline size_t size() const { return map_.size(); }
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief order postings by term, i.e. [begin(), end()) becomes sorted
+  ///        until the next insertion of a new term
+  //////////////////////////////////////////////////////////////////////////////
+  void sort();
 
  private:
+  struct slot {
+    uint32_t hash; // lower bits of the term hash
+    uint32_t value; // offset in 'blocks_'
+  }; // slot
+
+  typedef std::vector<slot> slots_t;
+
+  // number of postings per block, must be a power of 2
+  static const size_t BLOCK_SIZE = 1024;
+
+  typedef std::aligned_storage<
+    sizeof(value_type), alignof(value_type)
+  >::type value_storage;
+  typedef std::unique_ptr<value_storage[]> block_t;
+
+  value_type& at(size_t offset) NOEXCEPT {
+    assert(offset / BLOCK_SIZE < blocks_.size());
+    return reinterpret_cast<value_type&>(
+      blocks_[offset / BLOCK_SIZE][offset % BLOCK_SIZE]
+    );
+  }
+
+  const value_type& at(size_t offset) const NOEXCEPT {
+    return const_cast<postings*>(this)->at(offset);
+  }
+
+  slot* find(slots_t& slots, size_t hash, const bytes_ref& term) NOEXCEPT;
+
+  static void insert(slots_t& slots, const slot& value) NOEXCEPT;
+
+  void grow();
+  void migrate(size_t count) NOEXCEPT;
+
   IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
-  map_t map_;
+  std::vector<block_t> blocks_; // postings storage, reused after clear()
+  size_t size_{}; // number of postings in 'blocks_'
+  slots_t slots_; // power-of-2 size
+  slots_t prev_slots_; // slots being moved to 'slots_'
+  size_t prev_pos_{}; // next slot of 'prev_slots_' to move
   writer_t& writer_;
+  bool sorted_{ true };
   IRESEARCH_API_PRIVATE_VARIABLES_END
 };
 
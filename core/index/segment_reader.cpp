@@ -77,36 +77,73 @@ class mask_doc_iterator final : public irs::doc_iterator {
   }
 
   virtual bool next() override {
-    while (it_->next()) {
-      if (mask_.find(value()) == mask_.end()) {
-        return true;
-      }
-    }
-
-    return false;
+    return it_->next() && !irs::doc_limits::eof(skip_masked(it_->value()));
   }
 
   virtual irs::doc_id_t seek(irs::doc_id_t target) override {
-    const auto doc = it_->seek(target);
-
-    if (mask_.find(doc) == mask_.end()) {
-      return doc;
-    }
-
-    next();
-
-    return value();
+    return skip_masked(it_->seek(target));
   }
 
   virtual irs::doc_id_t value() const override {
     return it_->value();
   }
 
+  virtual size_t next_batch(
+      irs::doc_id_t* docs,
+      uint32_t* freqs,
+      size_t size) override {
+    size_t count = 0;
+
+    while (count < size) {
+      const auto requested = size - count;
+      const auto fetched = it_->next_batch(
+        docs + count, freqs ? freqs + count : nullptr, requested
+      );
+
+      // compact unmasked documents in place, the batch ends with a fetched
+      // unmasked document unless exhausted, so 'value()' stays consistent
+      for (size_t i = count, end = count + fetched; i < end; ++i) {
+        if (!mask_.contains(docs[i])) {
+          docs[count] = docs[i];
+
+          if (freqs) {
+            freqs[count] = freqs[i];
+          }
+
+          ++count;
+        }
+      }
+
+      if (fetched < requested) {
+        break; // exhausted
+      }
+    }
+
+    return count;
+  }
+
   virtual const irs::attribute_view& attributes() const NOEXCEPT override {
     return it_->attributes();
   }
 
  private:
+  // moves the iterator past masked documents, a run of masked
+  // documents is skipped via a single seek
+  irs::doc_id_t skip_masked(irs::doc_id_t doc) {
+    while (mask_.contains(doc)) {
+      const auto target = mask_.next_unmasked(doc);
+
+      if (target == doc + 1) {
+        it_->next();
+        doc = it_->value();
+      } else {
+        doc = it_->seek(target);
+      }
+    }
+
+    return doc;
+  }
+
   const irs::document_mask& mask_; // excluded document ids
   irs::doc_iterator::ptr it_;
 }; // mask_doc_iterator
@@ -129,12 +166,15 @@ class masked_docs_iterator
   virtual ~masked_docs_iterator() {}
 
   virtual bool next() override {
-    while (next_ < end_) {
-      current_ = next_++;
+    if (next_ < end_) {
+      current_ = docs_mask_.next_unmasked(next_);
 
-      if (docs_mask_.find(current_) == docs_mask_.end()) {
+      if (current_ < end_) {
+        next_ = current_ + 1;
         return true;
       }
+
+      next_ = end_;
     }
 
     current_ = irs::doc_limits::eof();
@@ -27,9 +27,11 @@
 #include "index_meta.hpp"
 #include "analysis/token_stream.hpp"
 #include "analysis/token_attributes.hpp"
+#include "utils/async_utils.hpp"
 #include "utils/index_utils.hpp"
 #include "utils/log.hpp"
 #include "utils/map_utils.hpp"
+#include "utils/metrics.hpp"
 #include "utils/timer_utils.hpp"
 #include "utils/type_limits.hpp"
 #include "utils/version_utils.hpp"
@@ -37,15 +39,95 @@
 #include <math.h>
 #include <set>
 
+NS_LOCAL
+
+// ranges with fewer fields are analyzed sequentially
+const size_t MIN_POOLED_FIELDS = 2;
+
+// documents with fewer tokens do not amortize handing their fields over
+// to the analysis pool
+const size_t MIN_POOLED_TOKENS = 1024;
+
+// number of documents analyzed sequentially before the pool is tried again,
+// the volume of documents may change over time
+const size_t POOLED_SAMPLE_INTERVAL = 64;
+
+// analysis buffers reserving more memory are released after inversion
+const size_t MAX_ANALYSIS_BUFFER_SIZE = 1 << 20;
+
+NS_END
+
 NS_ROOT
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                  segment_writer::analysis_job
+// -----------------------------------------------------------------------------
+
+struct segment_writer::analysis_job : util::noncopyable {
+  // analyzes pending fields until there are none left
+  // @param pooled the call is made by a task of the pool
+  void run(bool pooled) NOEXCEPT {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    if (pooled) {
+      assert(queued);
+      --queued;
+    }
+
+    ++active;
+
+    for (size_t i; (i = next) < count; ) {
+      ++next;
+      lock.unlock();
+
+      std::exception_ptr failure;
+
+      try {
+        (*buffers)[i]->reset(*(*sources)[i]);
+      } catch (...) {
+        failure = std::current_exception();
+      }
+
+      lock.lock();
+
+      if (failure) {
+        if (!error) {
+          error = failure;
+        }
+
+        next = count; // skip the rest of the fields
+      }
+    }
+
+    if (!--active) {
+      cond.notify_all();
+    }
+  }
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::exception_ptr error; // first exception thrown during analysis
+  const std::vector<token_stream*>* sources{};
+  const std::vector<std::unique_ptr<buffered_token_stream>>* buffers{};
+  size_t count{}; // number of fields to analyze
+  size_t next{}; // next field to analyze
+  size_t active{}; // number of threads analyzing fields
+  size_t queued{}; // number of tasks submitted to the pool but not started
+}; // analysis_job
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        segment_writer
+// -----------------------------------------------------------------------------
+
 segment_writer::stored_column::stored_column(
     const string_ref& name, 
     columnstore_writer& columnstore,
+    const column_info_provider_t& column_info,
     bool cache
-) : name(name.c_str(), name.size()) {
+) : name(name.c_str(), name.size()),
+    stream(column_info ? column_info(name) : irs::column_info()) {
   if (!cache) {
-    std::tie(id, writer) = columnstore.push_column();
+    std::tie(id, writer) = columnstore.push_column(stream.info());
   } else {
     writer = [this](irs::doc_id_t doc)->columnstore_writer::column_output& {
       this->stream.prepare(doc);
@@ -77,8 +159,14 @@ doc_id_t segment_writer::begin(
   return doc_id_t(docs_cached() + doc_limits::min() - 1); // -1 for 0-based offset
 }
 
-segment_writer::ptr segment_writer::make(directory& dir, const comparer* comparator) {
-  return memory::maker<segment_writer>::make(dir, comparator);
+segment_writer::ptr segment_writer::make(
+    directory& dir,
+    const comparer* comparator,
+    const column_info_provider_t& column_info /*= column_info_provider_t()*/,
+    async_utils::thread_pool* analysis_pool /*= nullptr*/) {
+  return memory::maker<segment_writer>::make(
+    dir, comparator, column_info, analysis_pool
+  );
 }
 
 size_t segment_writer::memory_active() const NOEXCEPT {
@@ -108,12 +196,19 @@ size_t segment_writer::memory_reserved() const NOEXCEPT {
       return lhs + rhs.second.stream.memory_reserved();
   });
 
+  const auto analysis_reserved = std::accumulate(
+    analysis_buffers_.begin(), analysis_buffers_.end(), size_t(0),
+    [](size_t lhs, const std::unique_ptr<buffered_token_stream>& rhs) NOEXCEPT {
+      return lhs + sizeof(buffered_token_stream) + rhs->memory_reserved();
+  });
+
   return sizeof(segment_writer)
     + (sizeof(update_contexts::value_type) * docs_context_.size())
     + (sizeof(bitvector) + docs_mask_.size() / 8 + docs_mask_extra)
     + fields_.memory_reserved()
     + sort_.stream.memory_reserved()
-    + column_cache_reserved;
+    + column_cache_reserved
+    + analysis_reserved;
 }
 
 bool segment_writer::remove(doc_id_t doc_id) {
@@ -130,13 +225,118 @@ bool segment_writer::remove(doc_id_t doc_id) {
 
 segment_writer::segment_writer(
     directory& dir,
-    const comparer* comparator
-) NOEXCEPT
+    const comparer* comparator,
+    const column_info_provider_t& column_info,
+    async_utils::thread_pool* analysis_pool)
   : fields_(comparator),
+    column_info_(column_info),
     dir_(dir),
+    analysis_pool_(analysis_pool),
+    analysis_tokens_(MIN_POOLED_TOKENS), // sample the first document
     initialized_(false) {
 }
 
+bool segment_writer::analyze_pooled(size_t fields) NOEXCEPT {
+  assert(analysis_pool_);
+
+  if (fields < MIN_POOLED_FIELDS) {
+    return false;
+  }
+
+  if (analysis_tokens_ >= MIN_POOLED_TOKENS
+      || ++analysis_skipped_ >= POOLED_SAMPLE_INTERVAL) {
+    analysis_skipped_ = 0;
+    return true;
+  }
+
+  return false;
+}
+
+void segment_writer::analyze() {
+  REGISTER_TIMER_DETAILED();
+  assert(analysis_pool_);
+
+  const auto count = analysis_sources_.size();
+  assert(count);
+
+  while (analysis_buffers_.size() < count) {
+    analysis_buffers_.emplace_back(
+      memory::make_unique<buffered_token_stream>()
+    );
+  }
+
+  if (!analysis_job_) {
+    analysis_job_ = std::make_shared<analysis_job>();
+  }
+
+  auto& job = *analysis_job_;
+  size_t tasks_count;
+
+  {
+    std::lock_guard<std::mutex> lock(job.mutex);
+    assert(!job.active);
+    job.sources = &analysis_sources_;
+    job.buffers = &analysis_buffers_;
+    job.count = count;
+    job.next = 0;
+
+    // the calling thread takes one share, tasks still queued since
+    // the previous documents pick up fields of this one
+    tasks_count = std::min(count - 1, analysis_pool_->max_threads());
+    tasks_count -= std::min(tasks_count, job.queued);
+    job.queued += tasks_count;
+  }
+
+  // fields are picked dynamically since analysis cost varies a lot, tasks
+  // which are not started by the time the calling thread is done do nothing
+  for (size_t i = 0; i < tasks_count; ++i) {
+    auto shared_job = analysis_job_; // tasks may outlive the writer
+    bool started = false;
+
+    try {
+      started = analysis_pool_->run([shared_job]()->void {
+        shared_job->run(true);
+      });
+    } catch (...) {
+      // the calling thread analyzes all remaining fields anyway
+    }
+
+    if (!started) {
+      std::lock_guard<std::mutex> lock(job.mutex);
+      job.queued -= tasks_count - i;
+      break;
+    }
+  }
+
+  job.run(false);
+
+  std::exception_ptr error;
+
+  {
+    std::unique_lock<std::mutex> lock(job.mutex);
+    job.cond.wait(lock, [&job]()->bool { return !job.active; });
+    std::swap(error, job.error);
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  analysis_tokens_ = std::accumulate(
+    analysis_buffers_.begin(), analysis_buffers_.begin() + count, size_t(0),
+    [](size_t lhs, const std::unique_ptr<buffered_token_stream>& rhs) NOEXCEPT {
+      return lhs + rhs->size();
+  });
+}
+
+void segment_writer::shrink_analysis_buffers() NOEXCEPT {
+  for (auto& buffer : analysis_buffers_) {
+    if (buffer->memory_reserved() > MAX_ANALYSIS_BUFFER_SIZE) {
+      buffer->clear(); // release memory captured from a huge document
+    }
+  }
+}
+
 bool segment_writer::index(
     const hashed_string_ref& name,
     const doc_id_t doc,
@@ -184,7 +384,7 @@ columnstore_writer::column_output& segment_writer::stream(
     columns_,                                           // container
     generator,                                          // key generator
     name,                                               // key
-    name, *col_writer_, nullptr != fields_.comparator() // value // FIXME
+    name, *col_writer_, column_info_, nullptr != fields_.comparator() // value // FIXME
   ).first->second.writer(doc_id);
 }
 
@@ -251,14 +451,14 @@ void segment_writer::flush_fields(const doc_map& docmap) {
 
 size_t segment_writer::flush_doc_mask(const segment_meta &meta) {
   document_mask docs_mask;
-  docs_mask.reserve(docs_mask_.size());
+  docs_mask.reserve(docs_mask_.size() + doc_limits::min());
 
   for (size_t doc_id = 0, doc_id_end = docs_mask_.size();
        doc_id < doc_id_end;
        ++doc_id) {
     if (docs_mask_.test(doc_id)) {
       assert(size_t(integer_traits<doc_id_t>::const_max) >= doc_id + doc_limits::min());
-      docs_mask.emplace(doc_id_t(doc_id + doc_limits::min()));
+      docs_mask.insert(doc_id_t(doc_id + doc_limits::min()));
     }
   }
 
@@ -270,6 +470,7 @@ size_t segment_writer::flush_doc_mask(const segment_meta &meta) {
 
 void segment_writer::flush(index_meta::index_segment_t& segment) {
   REGISTER_TIMER_DETAILED();
+  SCOPED_METRIC(metrics::event::SEGMENT_FLUSH);
 
   auto& meta = segment.meta;
 
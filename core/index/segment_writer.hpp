@@ -27,18 +27,25 @@
 #include "field_data.hpp"
 #include "sorted_column.hpp"
 #include "analysis/token_stream.hpp"
+#include "analysis/token_streams.hpp"
 #include "formats/formats.hpp"
 #include "utils/bitvector.hpp"
 #include "utils/directory_utils.hpp"
 #include "utils/noncopyable.hpp"
 #include "utils/type_limits.hpp"
 
+#include <algorithm>
+
 NS_ROOT
 
 class comparer;
 struct segment_meta;
 class segment_writer;
 
+NS_BEGIN(async_utils)
+class thread_pool;
+NS_END // async_utils
+
 //////////////////////////////////////////////////////////////////////////////
 /// @enum Action
 /// @brief defines how the inserting field should be processed
@@ -85,6 +92,16 @@ struct action_helper {
     assert(false);
     return false;
   }
+
+  template<typename Field>
+  static bool insert(
+      segment_writer& /*writer*/,
+      Field& /*field*/,
+      token_stream& /*tokens*/) {
+    // unsupported action
+    assert(false);
+    return false;
+  }
 }; // action_helper
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -146,17 +163,16 @@ class IRESEARCH_API segment_writer: util::noncopyable {
     /// @brief inserts the specified range of fields, denoted by the [begin;end)
     ///        into the document according to the specified ACTION
     /// @note 'Iterator' underline value type must satisfy the Field concept
+    /// @note if the writer has an analysis pool, token streams of the indexed
+    ///       fields are analyzed concurrently, hence fields of the range must
+    ///       not share token stream instances
     /// @param begin the beginning of the fields range
     /// @param end the end of the fields range
     /// @return true, if the range was successfully insterted
     ////////////////////////////////////////////////////////////////////////////
     template<Action action, typename Iterator>
     bool insert(Iterator begin, Iterator end) const {
-      for (; writer_.valid() && begin != end; ++begin) {
-        insert<action>(*begin);
-      }
-
-      return writer_.valid();
+      return writer_.insert<action>(begin, end);
     }
 
    private:
@@ -164,7 +180,19 @@ class IRESEARCH_API segment_writer: util::noncopyable {
   }; // document
 
   DECLARE_UNIQUE_PTR(segment_writer);
-  DECLARE_FACTORY(directory& dir, const comparer* comparator);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @param analysis_pool if specified, token streams of the indexed fields
+  ///        inserted as a range are analyzed concurrently using the pool and
+  ///        then inverted in the order of the range, the output is the same
+  ///        as of sequential insertion
+  //////////////////////////////////////////////////////////////////////////////
+  DECLARE_FACTORY(
+    directory& dir,
+    const comparer* comparator,
+    const column_info_provider_t& column_info = column_info_provider_t(),
+    async_utils::thread_pool* analysis_pool = nullptr
+  );
 
   struct update_context {
     size_t generation;
@@ -190,6 +218,20 @@ class IRESEARCH_API segment_writer: util::noncopyable {
     return valid_ = valid_ && action_helper<action>::insert(*this, field);
   }
 
+  template<Action action, typename Field>
+  bool insert(Field* field) {
+    return insert<action>(*field);
+  }
+
+  template<Action action, typename Iterator>
+  bool insert(Iterator begin, Iterator end) {
+    typedef std::integral_constant<
+      bool, Action::INDEX == (action & Action::INDEX)
+    > indexed_t;
+
+    return insert<action>(begin, end, indexed_t());
+  }
+
   // commit document-write transaction
   void commit() {
     if (valid_) {
@@ -235,6 +277,7 @@ class IRESEARCH_API segment_writer: util::noncopyable {
     stored_column(
       const string_ref& name,
       columnstore_writer& columnstore,
+      const column_info_provider_t& column_info,
       bool cache
     );
 
@@ -251,7 +294,103 @@ class IRESEARCH_API segment_writer: util::noncopyable {
     field_id id{ field_limits::invalid() };
   }; // sorted_column
 
-  segment_writer(directory& dir, const comparer* comparator) NOEXCEPT;
+  struct analysis_job; // state shared with tasks of 'analysis_pool_'
+
+  segment_writer(
+    directory& dir,
+    const comparer* comparator,
+    const column_info_provider_t& column_info,
+    async_utils::thread_pool* analysis_pool
+  );
+
+  template<typename Field>
+  static Field& deref(Field& field) NOEXCEPT { return field; }
+
+  template<typename Field>
+  static Field& deref(Field* field) NOEXCEPT { return *field; }
+
+  // @returns true if a range of the specified number of fields is worth
+  //          being analyzed using 'analysis_pool_'
+  bool analyze_pooled(size_t fields) NOEXCEPT;
+
+  // captures tokens of 'analysis_sources_' into 'analysis_buffers_'
+  // using 'analysis_pool_' and the calling thread
+  void analyze();
+
+  // releases buffers grown too large by the last analyzed document
+  void shrink_analysis_buffers() NOEXCEPT;
+
+  template<Action action, typename Iterator>
+  bool insert(Iterator begin, Iterator end, std::false_type /*indexed*/) {
+    for (; valid_ && begin != end; ++begin) {
+      insert<action>(*begin);
+    }
+
+    return valid_;
+  }
+
+  template<Action action, typename Iterator>
+  bool insert(Iterator begin, Iterator end, std::true_type /*indexed*/) {
+    if (!analysis_pool_ || !valid_) {
+      return insert<action>(begin, end, std::false_type());
+    }
+
+    typedef typename std::remove_reference<
+      decltype(deref(*begin))
+    >::type field_t;
+
+    // type-erased to reuse the same buffer for every document
+    auto field = [this](size_t i)->field_t& {
+      return *static_cast<field_t*>(const_cast<void*>(analysis_fields_[i]));
+    };
+
+    analysis_fields_.clear();
+
+    for (; begin != end; ++begin) {
+      analysis_fields_.emplace_back(&deref(*begin));
+    }
+
+    const auto count = analysis_fields_.size();
+
+    if (!analyze_pooled(count)) {
+      for (size_t i = 0; valid_ && i < count; ++i) {
+        insert<action>(field(i));
+      }
+
+      return valid_;
+    }
+
+    analysis_sources_.clear();
+
+    for (size_t i = 0; i < count; ++i) {
+      analysis_sources_.emplace_back(
+        &static_cast<token_stream&>(field(i).get_tokens())
+      );
+    }
+
+#ifdef IRESEARCH_DEBUG
+    // streams are consumed concurrently, hence fields of the range must not
+    // share token stream instances
+    {
+      auto sources = analysis_sources_;
+      std::sort(sources.begin(), sources.end());
+      assert(sources.end() == std::adjacent_find(sources.begin(), sources.end()));
+    }
+#endif
+
+    analyze(); // fills 'analysis_buffers_', one buffer per field
+
+    // invert in the order of the range, as sequential insertion would do
+    for (size_t i = 0; valid_ && i < count; ++i) {
+      valid_ = action_helper<action>::insert(
+        *this, field(i), *analysis_buffers_[i]
+      );
+    }
+
+    shrink_analysis_buffers();
+
+    return valid_;
+  }
 
   bool index(
     const hashed_string_ref& name,
@@ -330,6 +469,12 @@ class IRESEARCH_API segment_writer: util::noncopyable {
   // adds document field
   template<typename Field>
   bool index_worker(Field& field) {
+    return index_worker(field, static_cast<token_stream&>(field.get_tokens()));
+  }
+
+  // adds document field using the specified tokens instead of field tokens
+  template<typename Field>
+  bool index_worker(Field& field, token_stream& tokens) {
     REGISTER_TIMER_DETAILED();
 
     const auto name = make_hashed_ref(
@@ -337,7 +482,6 @@ class IRESEARCH_API segment_writer: util::noncopyable {
       std::hash<irs::string_ref>()
     );
 
-    auto& tokens = static_cast<token_stream&>(field.get_tokens());
     const auto& features = static_cast<const flags&>(field.features());
 
     assert(docs_cached() + doc_limits::min() - 1 < doc_limits::eof()); // user should check return of begin() != eof()
@@ -348,6 +492,13 @@ class IRESEARCH_API segment_writer: util::noncopyable {
 
   template<bool Sorted, typename Field>
   bool index_and_store_worker(Field& field) {
+    return index_and_store_worker<Sorted>(
+      field, static_cast<token_stream&>(field.get_tokens())
+    );
+  }
+
+  template<bool Sorted, typename Field>
+  bool index_and_store_worker(Field& field, token_stream& tokens) {
     REGISTER_TIMER_DETAILED();
 
     const auto name = make_hashed_ref(
@@ -355,7 +506,6 @@ class IRESEARCH_API segment_writer: util::noncopyable {
       std::hash<irs::string_ref>()
     );
 
-    auto& tokens = static_cast<token_stream&>(field.get_tokens());
     const auto& features = static_cast<const flags&>(field.features());
 
     assert(docs_cached() + doc_limits::min() - 1 < doc_limits::eof()); // user should check return of begin() != eof()
@@ -398,7 +548,15 @@ class IRESEARCH_API segment_writer: util::noncopyable {
   field_writer::ptr field_writer_;
   column_meta_writer::ptr col_meta_writer_;
   columnstore_writer::ptr col_writer_;
+  column_info_provider_t column_info_; // empty == default options
   tracking_directory dir_;
+  async_utils::thread_pool* analysis_pool_; // pool used for field analysis
+  std::vector<const void*> analysis_fields_; // fields of the range being inserted
+  std::vector<token_stream*> analysis_sources_; // streams pending analysis
+  std::vector<std::unique_ptr<buffered_token_stream>> analysis_buffers_; // reused across documents
+  std::shared_ptr<analysis_job> analysis_job_; // shared with tasks of 'analysis_pool_'
+  size_t analysis_tokens_; // tokens of the last document analyzed by the pool
+  size_t analysis_skipped_{}; // documents analyzed sequentially since then
   bool initialized_;
   bool valid_{ true }; // current state
   IRESEARCH_API_PRIVATE_VARIABLES_END
@@ -410,6 +568,11 @@ struct action_helper<Action::INDEX> {
   static bool insert(segment_writer& writer, Field& field) {
     return writer.index_worker(field);
   }
+
+  template<typename Field>
+  static bool insert(segment_writer& writer, Field& field, token_stream& tokens) {
+    return writer.index_worker(field, tokens);
+  }
 }; // action_helper
 
 template<>
@@ -434,6 +597,11 @@ struct action_helper<Action::INDEX_AND_STORE> {
   static bool insert(segment_writer& writer, Field& field) {
     return writer.index_and_store_worker<false>(field);
   }
+
+  template<typename Field>
+  static bool insert(segment_writer& writer, Field& field, token_stream& tokens) {
+    return writer.index_and_store_worker<false>(field, tokens);
+  }
 }; // action_helper
 
 template<>
@@ -442,6 +610,11 @@ struct action_helper<Action::INDEX_AND_STORE_SORTED> {
   static bool insert(segment_writer& writer, Field& field) {
     return writer.index_and_store_worker<true>(field);
   }
+
+  template<typename Field>
+  static bool insert(segment_writer& writer, Field& field, token_stream& tokens) {
+    return writer.index_and_store_worker<true>(field, tokens);
+  }
 }; // action_helper
 
 NS_END
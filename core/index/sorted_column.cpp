@@ -93,7 +93,7 @@ std::pair<doc_map, field_id> sorted_column::flush(
   }
 
   // flush sorted data
-  auto column = writer.push_column();
+  auto column = writer.push_column(info_);
   auto& column_writer = column.second;
 
   new_doc_id = doc_limits::min();
@@ -194,7 +194,7 @@ field_id sorted_column::flush(
     return field_limits::invalid();
   }
 
-  auto column = writer.push_column();
+  auto column = writer.push_column(info_);
   auto& column_writer = column.second;
 
   // temporarily push sentinel
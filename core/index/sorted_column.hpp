@@ -39,7 +39,13 @@ class sorted_column final : public irs::columnstore_writer::column_output {
  public:
   typedef std::vector<std::pair<doc_id_t, doc_id_t>> flush_buffer_t;
 
-  sorted_column() = default;
+  explicit sorted_column(const column_info& info = column_info()) NOEXCEPT
+    : info_(info) {
+  }
+
+  const column_info& info() const NOEXCEPT {
+    return info_;
+  }
 
   void prepare(doc_id_t key) {
     assert(index_.empty() || key >= index_.back().first);
@@ -133,6 +139,7 @@ class sorted_column final : public irs::columnstore_writer::column_output {
 
   bytes_output data_buf_; // FIXME use memory_file or block_pool instead
   std::vector<std::pair<irs::doc_id_t, size_t>> index_; // doc_id + offset in 'data_buf_'
+  column_info info_; // options of the flushed column
 }; // sorted_column
 
 NS_END // ROOT
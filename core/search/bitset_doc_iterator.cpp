@@ -26,6 +26,8 @@
 #include "utils/bitset.hpp"
 #include "utils/math_utils.hpp"
 
+#include <algorithm>
+
 NS_ROOT
 
 bitset_doc_iterator::bitset_doc_iterator(
@@ -68,6 +70,11 @@ bitset_doc_iterator::bitset_doc_iterator(
   }
 }
 
+bitset_doc_iterator::bitset_doc_iterator(std::shared_ptr<const bitset>&& set)
+  : bitset_doc_iterator(*set) {
+  set_ = std::move(set);
+}
+
 bool bitset_doc_iterator::next() NOEXCEPT {
   return !doc_limits::eof(
     seek(doc_.value + irs::doc_id_t(doc_.value < size_))
@@ -107,6 +114,61 @@ doc_id_t bitset_doc_iterator::seek(doc_id_t target) NOEXCEPT {
   return doc_.value;
 }
 
+size_t bitset_doc_iterator::next_batch(
+    doc_id_t* docs,
+    uint32_t* freqs,
+    size_t size) NOEXCEPT {
+  if (!size || doc_limits::eof(doc_.value)) {
+    return 0;
+  }
+
+  typedef bitset::word_t word_t;
+
+  const size_t target = size_t(doc_.value) + 1;
+  const auto* pword = begin_ + bitset::word(target);
+
+  if (pword >= end_) {
+    doc_.value = doc_limits::eof();
+
+    return 0;
+  }
+
+  word_t word = *pword & (~word_t(0) << bitset::bit(target));
+
+  size_t count = 0;
+
+  // extract set bits a word at a time
+  while (count < size) {
+    while (!word) {
+      if (++pword >= end_) {
+        doc_.value = doc_limits::eof();
+
+        if (freqs) {
+          std::fill_n(freqs, count, 0);
+        }
+
+        return count;
+      }
+
+      word = *pword;
+    }
+
+    docs[count++] = doc_id_t(
+      bitset::bit_offset(std::distance(begin_, pword))
+      + math::math_traits<word_t>::ctz(word)
+    );
+    word &= word - 1; // unset the lowest bit
+  }
+
+  doc_.value = docs[count - 1];
+
+  if (freqs) {
+    std::fill_n(freqs, count, 0);
+  }
+
+  return count;
+}
+
 NS_END // ROOT
 
 // -----------------------------------------------------------------------------
@@ -29,6 +29,8 @@
 #include "utils/type_limits.hpp"
 #include "utils/bitset.hpp"
 
+#include <memory>
+
 NS_ROOT
 
 class bitset_doc_iterator final: public doc_iterator_base, util::noncopyable {
@@ -45,11 +47,28 @@ class bitset_doc_iterator final: public doc_iterator_base, util::noncopyable {
     const order::prepared& order
   );
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief iterator sharing the ownership of the specified bitset
+  //////////////////////////////////////////////////////////////////////////////
+  explicit bitset_doc_iterator(std::shared_ptr<const bitset>&& set);
+
   virtual bool next() NOEXCEPT override;
   virtual doc_id_t seek(doc_id_t target) NOEXCEPT override;
   virtual doc_id_t value() const NOEXCEPT override { return doc_.value; }
+  virtual size_t next_batch(
+    doc_id_t* docs,
+    uint32_t* freqs,
+    size_t size
+  ) NOEXCEPT override;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns words of the underlying bitset
+  //////////////////////////////////////////////////////////////////////////////
+  const bitset::word_t* begin() const NOEXCEPT { return begin_; }
+  const bitset::word_t* end() const NOEXCEPT { return end_; }
 
  private:
+  std::shared_ptr<const bitset> set_; // nullptr if the bitset isn't owned
   document doc_;
   const bitset::word_t* begin_;
   const bitset::word_t* end_;
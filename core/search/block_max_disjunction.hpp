@@ -0,0 +1,304 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_BLOCK_MAX_DISJUNCTION_H
+#define IRESEARCH_BLOCK_MAX_DISJUNCTION_H
+
+#include "disjunction.hpp"
+
+NS_ROOT
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class block_max_disjunction
+/// @brief disjunction which skips documents unable to beat the score threshold
+///        set by a consumer via 'score_threshold' attribute (WAND), the
+///        per-block score bounds of the sub-iterators are used to skip entire
+///        blocks of documents (block-max WAND)
+/// ----------------------------------------------------------------------------
+///   lead_:  [0]        <-- the least document
+///           ...         | sorted by document
+///           [pivot]    <-- accumulated bound of lead_ beats the threshold
+///   heap_:  min-heap of the remaining iterators ordered by document
+/// ----------------------------------------------------------------------------
+/// @note only the iterators preceding the pivot are taken out of the heap,
+///       i.e. a step costs O(k*log(n)) for k iterators behind the target
+/// @note applicable only if all sub-iterators provide score bounds and
+///       all buckets of the order are in descending order
+////////////////////////////////////////////////////////////////////////////////
+class block_max_disjunction final : public doc_iterator_base {
+ public:
+  typedef score_iterator_adapter doc_iterator_t;
+  typedef std::vector<doc_iterator_t> doc_iterators_t;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns true if the specified sub-iterators can be evaluated by
+  ///          block_max_disjunction for the specified order
+  //////////////////////////////////////////////////////////////////////////////
+  static bool applicable(
+      const doc_iterators_t& itrs,
+      const order::prepared& ord) {
+    if (ord.empty()) {
+      return false;
+    }
+
+    // bounds are meaningful only if the greatest scores are the best ones
+    for (auto& bucket : ord) {
+      if (!bucket.reverse) {
+        return false;
+      }
+    }
+
+    return std::all_of(
+      itrs.begin(), itrs.end(),
+      [](const doc_iterator_t& it) {
+        return it->attributes().contains<score_bound>();
+    });
+  }
+
+  block_max_disjunction(
+      doc_iterators_t&& itrs,
+      const order::prepared& ord,
+      cost::cost_t est)
+    : block_max_disjunction(std::move(itrs), ord, resolve_overload_tag()) {
+    // estimate disjunction
+    estimate(est);
+  }
+
+  block_max_disjunction(
+      doc_iterators_t&& itrs,
+      const order::prepared& ord)
+    : block_max_disjunction(std::move(itrs), ord, resolve_overload_tag()) {
+    // estimate disjunction
+    estimate([this](){
+      return std::accumulate(
+        itrs_.begin(), itrs_.end(), cost::cost_t(0),
+        [](cost::cost_t lhs, const entry& rhs) {
+          return lhs + cost::extract(rhs.it->attributes(), 0);
+      });
+    });
+  }
+
+  virtual doc_id_t value() const NOEXCEPT override {
+    return doc_;
+  }
+
+  virtual bool next() override {
+    if (doc_limits::eof(doc_)) {
+      return false;
+    }
+
+    return !doc_limits::eof(advance(doc_ + 1));
+  }
+
+  virtual doc_id_t seek(doc_id_t target) override {
+    if (doc_limits::eof(doc_) || target <= doc_) {
+      return doc_;
+    }
+
+    return advance(target);
+  }
+
+ private:
+  struct resolve_overload_tag { };
+
+  struct entry {
+    entry(doc_iterator_t&& it, const score_bound* bound) NOEXCEPT
+      : it(std::move(it)), bound(bound) {
+    }
+
+    doc_iterator_t it;
+    const score_bound* bound;
+  }; // entry
+
+  block_max_disjunction(
+      doc_iterators_t&& itrs,
+      const order::prepared& ord,
+      resolve_overload_tag)
+    : doc_iterator_base(ord),
+      doc_(itrs.empty()
+        ? doc_limits::eof()
+        : doc_limits::invalid()) {
+    assert(applicable(itrs, ord));
+
+    itrs_.reserve(itrs.size());
+    for (auto& it : itrs) {
+      const auto* bound = it->attributes().get<score_bound>().get();
+      itrs_.emplace_back(std::move(it), bound);
+    }
+
+    // iterators aren't positioned yet, they are moved on the first advance
+    lead_.reserve(itrs_.size());
+    heap_.reserve(itrs_.size());
+    for (auto& entry : itrs_) {
+      lead_.emplace_back(&entry);
+    }
+
+    max_.resize(ord.size());
+    block_.resize(ord.size());
+
+    // prepare score
+    prepare_score([this](byte_type* score) {
+      ord_->prepare_score(score);
+      score_impl(score);
+    });
+
+    attrs_.emplace(threshold_);
+  }
+
+  static bool greater(const entry* lhs, const entry* rhs) NOEXCEPT {
+    return lhs->it->value() > rhs->it->value();
+  }
+
+  doc_id_t top() const NOEXCEPT {
+    return heap_.front()->it->value();
+  }
+
+  entry* pop() {
+    std::pop_heap(heap_.begin(), heap_.end(), &greater);
+    auto* top = heap_.back();
+    heap_.pop_back();
+    return top;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief moves the iterator to the 'target' and puts it back into the heap
+  ///        unless exhausted
+  //////////////////////////////////////////////////////////////////////////////
+  void push(entry* entry, doc_id_t target) {
+    if (entry->it->value() < target
+        && doc_limits::eof(entry->it->seek(target))) {
+      return; // exhausted
+    }
+
+    heap_.emplace_back(entry);
+    std::push_heap(heap_.begin(), heap_.end(), &greater);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief moves all iterators behind the 'target' and finds the first
+  ///        document not less than 'target' which can beat the threshold
+  ////////////////////////////////////////////////////////////////////////////
+  doc_id_t advance(doc_id_t target) {
+    for (;;) {
+      // move lagging iterators to the 'target'
+      for (auto* entry : lead_) {
+        push(entry, target);
+      }
+      lead_.clear();
+
+      while (!heap_.empty() && top() < target) {
+        push(pop(), target);
+      }
+
+      if (heap_.empty()) {
+        return doc_ = doc_limits::eof();
+      }
+
+      const byte_type* threshold = threshold_.value;
+
+      if (!threshold) {
+        // no threshold, behave as a regular disjunction
+        doc_ = top();
+
+        do {
+          lead_.emplace_back(pop());
+        } while (!heap_.empty() && top() == doc_);
+
+        return doc_;
+      }
+
+      // find pivot, i.e. the first iterator such that accumulated
+      // score bound of the preceding iterators beats the threshold
+      auto* max = &max_[0];
+
+      ord_->prepare_score(max);
+      do {
+        lead_.emplace_back(pop());
+        ord_->add(max, lead_.back()->bound->max());
+      } while (!ord_->less(max, threshold) && !heap_.empty());
+
+      if (!ord_->less(max, threshold)) {
+        // none of the remaining documents can beat the threshold
+        lead_.clear();
+        return doc_ = doc_limits::eof();
+      }
+
+      const auto pivot_doc = lead_.back()->it->value();
+
+      // include all iterators positioned at the pivot document
+      while (!heap_.empty() && top() == pivot_doc) {
+        lead_.emplace_back(pop());
+      }
+
+      // check whether the blocks containing pivot document can beat threshold
+      auto* block = &block_[0];
+      doc_id_t block_end = doc_limits::eof();
+
+      ord_->prepare_score(block);
+      for (auto* entry : lead_) {
+        auto& bound = *entry->bound;
+        block_end = std::min(block_end, bound.shallow_seek(pivot_doc));
+        ord_->add(block, bound.block());
+      }
+
+      if (!ord_->less(block, threshold)) {
+        // skip blocks, up to the next iterator at most
+        target = doc_limits::eof(block_end) ? block_end : block_end + 1;
+
+        if (!heap_.empty()) {
+          target = std::min(target, top());
+        }
+
+        continue;
+      }
+
+      if (lead_.front()->it->value() == pivot_doc) {
+        // pivot document is a candidate
+        return doc_ = pivot_doc;
+      }
+
+      // documents preceding pivot can't beat threshold
+      target = pivot_doc;
+    }
+  }
+
+  void score_impl(byte_type* lhs) {
+    // iterators positioned at the current document are in 'lead_'
+    for (auto* entry : lead_) {
+      assert(entry->it->value() == doc_);
+      detail::score_add(lhs, *ord_, entry->it);
+    }
+  }
+
+  std::vector<entry> itrs_;
+  std::vector<entry*> lead_; // iterators taken out of the heap
+  std::vector<entry*> heap_; // min-heap by document
+  bstring max_; // accumulated max score bounds
+  bstring block_; // accumulated block score bounds
+  score_threshold threshold_;
+  doc_id_t doc_;
+}; // block_max_disjunction
+
+NS_END // ROOT
+
+#endif // IRESEARCH_BLOCK_MAX_DISJUNCTION_H
@@ -313,6 +313,15 @@ class const_scorer final : public irs::sort::scorer_base<bm25::score_t> {
     score_cast(score_buf) = boost_;
   }
 
+  virtual bool bound(byte_type* score_buf, uint32_t /*freq*/) const NOEXCEPT override {
+    if (boost_ < 0.f) {
+      return false;
+    }
+
+    score_cast(score_buf) = boost_;
+    return true;
+  }
+
  private:
   const irs::boost::boost_t boost_;
 }; // const_scorer
@@ -337,6 +346,16 @@ class scorer : public irs::sort::scorer_base<bm25::score_t> {
     score_cast(score_buf) = num_ * freq / (norm_const_ + freq);
   }
 
+  virtual bool bound(byte_type* score_buf, uint32_t freq) const NOEXCEPT override {
+    if (num_ < 0.f || norm_const_ < 0.f) {
+      return false;
+    }
+
+    const float_t max_freq = float_t(std::sqrt(freq));
+    score_cast(score_buf) = max_freq ? num_ * max_freq / (norm_const_ + max_freq) : 0.f;
+    return true;
+  }
+
  protected:
   FORCE_INLINE float_t tf() const NOEXCEPT {
     return float_t(std::sqrt(freq_->value));
@@ -373,6 +392,11 @@ class norm_scorer final : public scorer {
     score_cast(score_buf) = num_ * freq / (norm_const_ + norm_length_ * norm_->read() + freq);
   }
 
+  // score is maximal for the shortest possible document
+  virtual bool bound(byte_type* score_buf, uint32_t freq) const NOEXCEPT override {
+    return norm_length_ >= 0.f && scorer::bound(score_buf, freq);
+  }
+
  private:
   const irs::norm* norm_;
   float_t norm_length_{ 0.f }; // precomputed 'k*b/avgD' if norms presetn, '0' otherwise
@@ -22,6 +22,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "all_filter.hpp"
+#include "block_max_disjunction.hpp"
 #include "boolean_filter.hpp"
 #include "conjunction.hpp"
 #include "disjunction.hpp"
@@ -77,6 +78,16 @@ irs::doc_iterator::ptr make_disjunction(
     }
   }
 
+  // skip documents unable to beat the threshold score if the consumer
+  // is going to provide one, the heap based disjunction is cheaper otherwise
+  if (itrs.size() > 1
+      && ctx.contains<irs::score_threshold>()
+      && irs::block_max_disjunction::applicable(itrs, ord)) {
+    return irs::doc_iterator::make<irs::block_max_disjunction>(
+      std::move(itrs), ord, std::forward<Args>(args)...
+    );
+  }
+
   return irs::make_disjunction<irs::disjunction>(
     std::move(itrs), ord, std::forward<Args>(args)...
   );
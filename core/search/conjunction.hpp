@@ -24,11 +24,15 @@
 #ifndef IRESEARCH_CONJUNCTION_H
 #define IRESEARCH_CONJUNCTION_H
 
+#include "bitset_doc_iterator.hpp"
 #include "cost.hpp"
 #include "score_doc_iterators.hpp"
 #include "analysis/token_attributes.hpp"
 #include "utils/type_limits.hpp"
 
+#include <algorithm>
+#include <memory>
+
 NS_ROOT
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -78,6 +82,10 @@ struct score_iterator_adapter {
 /// t |  ...    |
 ///   V  [n] <-- end
 ///-----------------------------------------------------------------------------
+/// the order above is the initial one, since cost estimates might be off
+/// (e.g. skewed queries) iterators are reordered while iterating according
+/// to the observed skip distances, i.e. iterators skipping farther are
+/// tried earlier and the one skipping the farthest eventually leads
 ////////////////////////////////////////////////////////////////////////////////
 class conjunction : public doc_iterator_base {
  public:
@@ -85,6 +93,9 @@ class conjunction : public doc_iterator_base {
   typedef std::vector<doc_iterator_t> doc_iterators_t;
   typedef doc_iterators_t::const_iterator iterator;
 
+  // number of matches between elections of the lead iterator
+  static const size_t ADAPT_INTERVAL = 64;
+
   conjunction(
       doc_iterators_t&& itrs,
       const order::prepared& ord = order::prepared::unordered())
@@ -92,6 +103,9 @@ class conjunction : public doc_iterator_base {
       itrs_(std::move(itrs)) {
     assert(!itrs_.empty());
 
+    // replace unscored bitsets with their intersection
+    intersect_bitsets();
+
     // sort subnodes in ascending order by their cost
     std::sort(itrs_.begin(), itrs_.end(),
       [](const doc_iterator_t& lhs, const doc_iterator_t& rhs) {
@@ -104,6 +118,8 @@ class conjunction : public doc_iterator_base {
     // estimate iterator (front's cost is already cached)
     estimate(cost::extract(front_->attributes(), cost::MAX));
 
+    skips_.resize(itrs_.size());
+
     // copy scores into separate container
     // to avoid extra checks
     scores_.reserve(itrs_.size());
@@ -139,11 +155,16 @@ class conjunction : public doc_iterator_base {
   }
 
   virtual bool next() override {
+    const auto prev = front_->value();
+
     if (!front_->next()) {
       return false;
     }
 
-    return !doc_limits::eof(converge(front_->value()));
+    const auto doc = front_->value();
+    skips_.front().add(doc - prev);
+
+    return !doc_limits::eof(converge(doc));
   }
 
   virtual doc_id_t seek(doc_id_t target) override {
@@ -163,6 +184,10 @@ class conjunction : public doc_iterator_base {
       rest = seek_rest(target);
     }
 
+    if (!doc_limits::eof(target) && 0 == --adapt_countdown_) {
+      elect_lead();
+    }
+
     return target;
   }
 
@@ -173,10 +198,20 @@ class conjunction : public doc_iterator_base {
       return target;
     }
 
-    for (auto it = itrs_.begin()+1, end = itrs_.end(); it != end; ++it) {
-      const auto doc = (*it)->seek(target);
+    for (size_t i = 1, size = itrs_.size(); i < size; ++i) {
+      const auto doc = itrs_[i]->seek(target);
+
+      skips_[i].add(doc - target);
 
       if (target < doc) {
+        // try the iterator earlier next time if it skips farther
+        // than its predecessor (the lead is never swapped here since
+        // it's the only one positioned at 'target')
+        if (i > 1 && skips_[i - 1].avg() < skips_[i].avg()) {
+          std::swap(itrs_[i - 1], itrs_[i]);
+          std::swap(skips_[i - 1], skips_[i]);
+        }
+
         return doc;
       }
     }
@@ -184,9 +219,107 @@ class conjunction : public doc_iterator_base {
     return target;
   }
 
+  // makes the iterator skipping the farthest the lead,
+  // must be called when all iterators are on the same document
+  void elect_lead() {
+    adapt_countdown_ = ADAPT_INTERVAL;
+
+    size_t lead = 0;
+
+    for (size_t i = 1, size = itrs_.size(); i < size; ++i) {
+      if (skips_[lead].avg() < skips_[i].avg()) {
+        lead = i;
+      }
+    }
+
+    if (lead) {
+      std::swap(itrs_.front(), itrs_[lead]);
+      std::swap(skips_.front(), skips_[lead]);
+      front_ = itrs_.front().it.get();
+    }
+
+    // decay statistics to favor recent observations
+    for (auto& skip : skips_) {
+      skip.decay();
+    }
+  }
+
+  // replaces unscored bitset iterators with a single iterator
+  // over their intersection computed word by word
+  void intersect_bitsets() {
+    auto is_bitset = [](const doc_iterator_t& it) {
+      return &irs::score::no_score() == it.score
+        && doc_limits::invalid() == it->value()
+        && nullptr != dynamic_cast<const bitset_doc_iterator*>(it.it.get());
+    };
+
+    const auto begin = std::stable_partition(
+      itrs_.begin(), itrs_.end(),
+      [&is_bitset](const doc_iterator_t& it) { return !is_bitset(it); }
+    );
+
+    if (std::distance(begin, itrs_.end()) < 2) {
+      return;
+    }
+
+    auto words_of = [](const doc_iterator_t& it) {
+      return static_cast<const bitset_doc_iterator*>(it.it.get());
+    };
+
+    size_t words = integer_traits<size_t>::const_max;
+
+    for (auto it = begin; it != itrs_.end(); ++it) {
+      auto* set = words_of(*it);
+      words = std::min(words, size_t(std::distance(set->begin(), set->end())));
+    }
+
+    std::vector<bitset::word_t> intersection(
+      words_of(*begin)->begin(), words_of(*begin)->begin() + words
+    );
+
+    for (auto it = begin + 1; it != itrs_.end(); ++it) {
+      const auto* word = words_of(*it)->begin();
+
+      for (auto& value : intersection) {
+        value &= *word++;
+      }
+    }
+
+    auto set = std::make_shared<bitset>(bitset::bit_offset(words));
+    set->memset(intersection.data(), intersection.size()*sizeof(bitset::word_t));
+
+    itrs_.erase(begin, itrs_.end());
+    itrs_.emplace_back(memory::make_unique<bitset_doc_iterator>(std::move(set)));
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @struct skip_stats
+  /// @brief distances an iterator has moved by, per seek/next
+  //////////////////////////////////////////////////////////////////////////////
+  struct skip_stats {
+    void add(doc_id_t distance) NOEXCEPT {
+      total += distance;
+      ++count;
+    }
+
+    void decay() NOEXCEPT {
+      total /= 2;
+      count /= 2;
+    }
+
+    double avg() const NOEXCEPT {
+      return count ? double(total) / count : 0.;
+    }
+
+    uint64_t total{};
+    uint64_t count{};
+  }; // skip_stats
+
   doc_iterators_t itrs_;
+  std::vector<skip_stats> skips_; // parallel to 'itrs_'
   std::vector<const irs::score*> scores_; // valid sub-scores
   irs::doc_iterator* front_;
+  size_t adapt_countdown_{ ADAPT_INTERVAL };
 }; // conjunction
 
 //////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,286 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "shared.hpp"
+#include "edit_distance_filter.hpp"
+#include "range_query.hpp"
+#include "analysis/token_attributes.hpp"
+#include "index/index_reader.hpp"
+#include "utils/automaton_utils.hpp"
+
+#include <boost/functional/hash.hpp>
+
+NS_LOCAL
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief splits UTF-8 encoded string into characters, invalid sequences are
+///        split into single bytes
+////////////////////////////////////////////////////////////////////////////////
+void utf8_split(const irs::bytes_ref& str, std::vector<irs::bytes_ref>& chars) {
+  chars.clear();
+
+  for (auto begin = str.begin(), end = str.end(); begin != end;) {
+    size_t size = 1;
+
+    if (*begin >= 0xF0) {
+      size = 4;
+    } else if (*begin >= 0xE0) {
+      size = 3;
+    } else if (*begin >= 0xC0) {
+      size = 2;
+    }
+
+    size = std::min(size, size_t(std::distance(begin, end)));
+    chars.emplace_back(begin, size);
+    begin += size;
+  }
+}
+
+// adds a chain of transitions over the bytes of 'label'
+void add_chain(
+    irs::automaton::builder& builder,
+    irs::automaton::state_id from,
+    irs::automaton::state_id to,
+    const irs::bytes_ref& label) {
+  assert(!label.empty());
+
+  for (size_t i = 0, last = label.size() - 1; i < last; ++i) {
+    const auto next = builder.add_state();
+    builder.add_arc(from, next, label[i]);
+    from = next;
+  }
+
+  builder.add_arc(from, to, label[label.size() - 1]);
+}
+
+NS_END
+
+NS_ROOT
+
+automaton from_edit_distance(
+    const bytes_ref& term,
+    byte_type max_distance,
+    bool with_transpositions) {
+  std::vector<bytes_ref> chars;
+  utf8_split(term, chars);
+
+  // state (i, e) corresponds to 'i' matched characters and 'e' edits
+  const size_t size = chars.size();
+  const size_t edits = size_t(max_distance) + 1;
+  auto state = [edits](size_t i, size_t e) {
+    return automaton::state_id(i*edits + e);
+  };
+
+  automaton::builder builder;
+
+  for (size_t i = 0; i <= size; ++i) {
+    for (size_t e = 0; e < edits; ++e) {
+      builder.add_state(i == size); // (i, e), the first one is the start state
+    }
+  }
+
+  for (size_t i = 0; i <= size; ++i) {
+    for (size_t e = 0; e < edits; ++e) {
+      const auto from = state(i, e);
+
+      if (i < size) {
+        add_chain(builder, from, state(i + 1, e), chars[i]); // match
+      }
+
+      if (e + 1 == edits) {
+        continue; // no edits left
+      }
+
+      builder.add_utf8_arc(from, state(i, e + 1)); // insertion
+
+      if (i < size) {
+        builder.add_utf8_arc(from, state(i + 1, e + 1)); // substitution
+        builder.add_epsilon(from, state(i + 1, e + 1)); // deletion
+      }
+
+      if (with_transpositions && i + 1 < size) {
+        const auto swapped = builder.add_state();
+        add_chain(builder, from, swapped, chars[i + 1]);
+        add_chain(builder, swapped, state(i + 2, e + 1), chars[i]);
+      }
+    }
+  }
+
+  return builder.build();
+}
+
+size_t edit_distance(
+    const bytes_ref& lhs,
+    const bytes_ref& rhs,
+    size_t max_distance,
+    bool with_transpositions) {
+  std::vector<bytes_ref> lhs_chars, rhs_chars;
+  utf8_split(lhs, lhs_chars);
+  utf8_split(rhs, rhs_chars);
+
+  const size_t lhs_size = lhs_chars.size();
+  const size_t rhs_size = rhs_chars.size();
+
+  if (std::max(lhs_size, rhs_size) - std::min(lhs_size, rhs_size) > max_distance) {
+    return max_distance + 1;
+  }
+
+  // the last 3 rows of the distance matrix
+  std::vector<size_t> prev_prev(rhs_size + 1), prev(rhs_size + 1), cur(rhs_size + 1);
+
+  for (size_t j = 0; j <= rhs_size; ++j) {
+    prev[j] = j;
+  }
+
+  for (size_t i = 1; i <= lhs_size; ++i) {
+    cur[0] = i;
+    auto row_min = cur[0];
+
+    for (size_t j = 1; j <= rhs_size; ++j) {
+      const size_t cost = lhs_chars[i - 1] == rhs_chars[j - 1] ? 0 : 1;
+
+      cur[j] = std::min({ prev[j] + 1, cur[j - 1] + 1, prev[j - 1] + cost });
+
+      if (with_transpositions
+          && i > 1 && j > 1
+          && lhs_chars[i - 1] == rhs_chars[j - 2]
+          && lhs_chars[i - 2] == rhs_chars[j - 1]) {
+        cur[j] = std::min(cur[j], prev_prev[j - 2] + 1);
+      }
+
+      row_min = std::min(row_min, cur[j]);
+    }
+
+    if (row_min > max_distance) {
+      return max_distance + 1; // distance can't decrease in the next rows
+    }
+
+    std::swap(prev_prev, prev);
+    std::swap(prev, cur);
+  }
+
+  return std::min(prev[rhs_size], max_distance + 1);
+}
+
+filter::prepared::ptr by_edit_distance::prepare(
+    const index_reader& rdr,
+    const order::prepared& ord,
+    boost_t boost,
+    const attribute_view& ctx) const {
+  boost *= this->boost();
+
+  if (!max_distance_) {
+    return by_term().field(field()).term(term()).prepare(rdr, ord, boost, ctx);
+  }
+
+  const auto acceptor = from_edit_distance(term(), max_distance_, with_transpositions_);
+  limited_sample_scorer scorer(ord.empty() ? 0 : scored_terms_limit_); // object for collecting order stats
+  range_query::states_t states(rdr.size());
+
+  /* iterate over the segments */
+  const string_ref field = this->field();
+  for (const auto& sr : rdr) {
+    /* get term dictionary for field */
+    const term_reader* tr = sr.field(field);
+    if (!tr) {
+      continue;
+    }
+
+    seek_term_iterator::ptr terms = tr->iterator();
+
+    /* get term metadata */
+    auto& meta = terms->attributes().get<term_meta>();
+    range_state* state = nullptr;
+
+    auto visitor = [&](seek_term_iterator& terms) {
+      terms.read();
+
+      if (!state) {
+        /* get state for current segment */
+        state = &states.insert(sr);
+        state->reader = tr;
+        state->min_term = terms.value();
+        state->min_cookie = terms.cookie();
+        state->unscored_docs.reset((type_limits<type_t::doc_id_t>::min)() + sr.docs_count()); // highest valid doc_id in reader
+        state->sparse = true; // matching terms aren't adjacent
+      }
+
+      // closer terms are boosted higher, exact match gets the full boost
+      const auto distance = edit_distance(
+        term(), terms.value(), max_distance_, with_transpositions_
+      );
+      assert(distance <= max_distance_);
+      const auto term_boost = boost_t(max_distance_ + 1 - distance) / (max_distance_ + 1);
+
+      // fill scoring candidates
+      scorer.collect(meta ? meta->docs_count : 0, state->count, *state, sr, terms, boost * term_boost);
+      ++state->count;
+
+      /* collect cost */
+      if (meta) {
+        state->estimation += meta->docs_count;
+      }
+    };
+
+    visit(*terms, acceptor, visitor);
+  }
+
+  scorer.score(rdr, ord);
+
+  auto q = memory::make_shared<range_query>(std::move(states));
+
+  // apply boost
+  irs::boost::apply(q->attributes(), boost);
+
+  return q;
+}
+
+DEFINE_FILTER_TYPE(by_edit_distance)
+DEFINE_FACTORY_DEFAULT(by_edit_distance)
+
+by_edit_distance::by_edit_distance() NOEXCEPT
+  : by_term(by_edit_distance::type()) {
+}
+
+size_t by_edit_distance::hash() const NOEXCEPT {
+  size_t seed = 0;
+  ::boost::hash_combine(seed, by_term::hash());
+  ::boost::hash_combine(seed, scored_terms_limit_);
+  ::boost::hash_combine(seed, max_distance_);
+  ::boost::hash_combine(seed, with_transpositions_);
+  return seed;
+}
+
+bool by_edit_distance::equals(const filter& rhs) const NOEXCEPT {
+  const auto& trhs = static_cast<const by_edit_distance&>(rhs);
+  return by_term::equals(rhs)
+    && scored_terms_limit_ == trhs.scored_terms_limit_
+    && max_distance_ == trhs.max_distance_
+    && with_transpositions_ == trhs.with_transpositions_;
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
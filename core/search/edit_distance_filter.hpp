@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_EDIT_DISTANCE_FILTER_H
+#define IRESEARCH_EDIT_DISTANCE_FILTER_H
+
+#include "term_filter.hpp"
+
+NS_ROOT
+
+class automaton;
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class by_edit_distance
+/// @brief user-side fuzzy filter, matches the terms of a field within the
+///        specified Levenshtein distance (in UTF-8 characters) of the term,
+///        matching terms are boosted according to their distance
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API by_edit_distance final : public by_term {
+ public:
+  DECLARE_FILTER_TYPE();
+  DECLARE_FACTORY();
+
+  by_edit_distance() NOEXCEPT;
+
+  using by_term::field;
+
+  by_edit_distance& field(std::string fld) {
+    by_term::field(std::move(fld));
+    return *this;
+  }
+
+  using filter::prepare;
+
+  virtual filter::prepared::ptr prepare(
+    const index_reader& rdr,
+    const order::prepared& ord,
+    boost_t boost,
+    const attribute_view& ctx
+  ) const override;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief the maximum allowed number of edits, 0 means exact match
+  /// @note the cost of the query grows quickly with the distance, values
+  ///       above 2 are rarely reasonable
+  //////////////////////////////////////////////////////////////////////////////
+  by_edit_distance& max_distance(byte_type distance) NOEXCEPT {
+    max_distance_ = distance;
+    return *this;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief the maximum allowed number of edits, 0 means exact match
+  //////////////////////////////////////////////////////////////////////////////
+  byte_type max_distance() const NOEXCEPT {
+    return max_distance_;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief consider transposition of the adjacent characters as a single
+  ///        edit (Damerau-Levenshtein distance)
+  //////////////////////////////////////////////////////////////////////////////
+  by_edit_distance& with_transpositions(bool value) NOEXCEPT {
+    with_transpositions_ = value;
+    return *this;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief consider transposition of the adjacent characters as a single
+  ///        edit (Damerau-Levenshtein distance)
+  //////////////////////////////////////////////////////////////////////////////
+  bool with_transpositions() const NOEXCEPT {
+    return with_transpositions_;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief the maximum number of most frequent terms to consider for scoring
+  //////////////////////////////////////////////////////////////////////////////
+  by_edit_distance& scored_terms_limit(size_t limit) NOEXCEPT {
+    scored_terms_limit_ = limit;
+    return *this;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief the maximum number of most frequent terms to consider for scoring
+  //////////////////////////////////////////////////////////////////////////////
+  size_t scored_terms_limit() const NOEXCEPT {
+    return scored_terms_limit_;
+  }
+
+  virtual size_t hash() const NOEXCEPT override;
+
+ protected:
+  virtual bool equals(const filter& rhs) const NOEXCEPT override;
+
+ private:
+  size_t scored_terms_limit_{1024};
+  byte_type max_distance_{0};
+  bool with_transpositions_{false};
+}; // by_edit_distance
+
+////////////////////////////////////////////////////////////////////////////////
+/// @returns automaton accepting the terms within the specified distance of
+///          'term'
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API automaton from_edit_distance(
+  const bytes_ref& term,
+  byte_type max_distance,
+  bool with_transpositions
+);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @returns edit distance (in UTF-8 characters) between the specified terms
+///          or a value greater than 'max_distance' if it exceeds the limit
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API size_t edit_distance(
+  const bytes_ref& lhs,
+  const bytes_ref& rhs,
+  size_t max_distance,
+  bool with_transpositions
+);
+
+NS_END
+
+#endif
@@ -0,0 +1,544 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2019 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "filter_cache.hpp"
+#include "formats/empty_term_reader.hpp"
+#include "index/segment_reader.hpp"
+#include "search/bitset_doc_iterator.hpp"
+#include "search/score_doc_iterators.hpp"
+
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+NS_LOCAL
+
+// approximate memory occupied by a node of the cache
+const size_t ENTRY_OVERHEAD = 96;
+
+// caches smaller than 2*MIN_SHARD_MEMORY aren't sharded
+const size_t MIN_SHARD_MEMORY = 1 << 20;
+const size_t MAX_SHARDS = 16; // power of 2
+
+//////////////////////////////////////////////////////////////////////////////
+/// @returns shared pointer identifying a segment or nullptr if the reader
+///          doesn't denote a segment, e.g. is a custom 'sub_reader'
+//////////////////////////////////////////////////////////////////////////////
+irs::sub_reader::ptr segment_identity(const irs::sub_reader& reader) NOEXCEPT {
+  const auto* segment = dynamic_cast<const irs::segment_reader*>(&reader);
+
+  return segment ? irs::sub_reader::ptr(*segment) : nullptr;
+}
+
+size_t segment_hash(const irs::sub_reader* segment, const irs::filter& filter) {
+  size_t seed = 0;
+  ::boost::hash_combine(seed, segment);
+  ::boost::hash_combine<const irs::filter&>(seed, filter);
+  return seed;
+}
+
+size_t docs_memory(const irs::bitset& docs) NOEXCEPT {
+  return sizeof(irs::bitset) + docs.words()*sizeof(irs::bitset::word_t);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class cached_iterator
+/// @brief scores documents of the underlying iterator as 'all' does
+//////////////////////////////////////////////////////////////////////////////
+class cached_iterator final : public irs::doc_iterator_base {
+ public:
+  cached_iterator(
+      const irs::sub_reader& reader,
+      const irs::attribute_store& prepared_filter_attrs,
+      irs::doc_iterator::ptr&& it,
+      const irs::order::prepared& ord)
+    : doc_iterator_base(ord),
+      it_(std::move(it)) {
+    assert(it_);
+
+    const auto docs_count = irs::cost::extract(
+      it_->attributes(), reader.docs_count()
+    );
+
+    // make doc_id accessible via attribute
+    attrs_.emplace(doc_);
+
+    // set estimation value
+    estimate(docs_count);
+
+    // set scorers
+    scorers_ = ord_->prepare_scorers(
+      reader,
+      irs::empty_term_reader(docs_count),
+      prepared_filter_attrs,
+      attributes() // doc_iterator attributes
+    );
+
+    prepare_score([this](irs::byte_type* score) {
+      value(); // ensure doc_id is updated before scoring
+      scorers_.score(*ord_, score);
+    });
+  }
+
+  virtual bool next() override {
+    return it_->next();
+  }
+
+  virtual irs::doc_id_t seek(irs::doc_id_t target) override {
+    it_->seek(target);
+
+    return value();
+  }
+
+  virtual irs::doc_id_t value() const NOEXCEPT override {
+    doc_.value = it_->value();
+
+    return doc_.value;
+  }
+
+ private:
+  mutable irs::document doc_; // modified during value()
+  irs::doc_iterator::ptr it_;
+  irs::order::prepared::scorers scorers_;
+}; // cached_iterator
+
+class cached_query final : public irs::filter::prepared {
+ public:
+  cached_query(
+    std::shared_ptr<const irs::filter> filter,
+    irs::filter_cache* cache,
+    irs::attribute_store&& attrs
+  ): irs::filter::prepared(std::move(attrs)),
+     filter_(std::move(filter)),
+     cache_(cache) {
+  }
+
+  virtual irs::doc_iterator::ptr execute(
+      const irs::sub_reader& segment,
+      const irs::order::prepared& ord,
+      const irs::attribute_view& ctx
+  ) const override {
+    bool admit = false;
+    auto docs = cache_ ? cache_->get(segment, filter_, admit) : nullptr;
+
+    if (!docs) {
+      // scores are produced by the wrapper, no need to collect statistics
+      auto it = filter_->prepare(
+        segment, irs::order::prepared::unordered(), ctx
+      )->execute(segment, irs::order::prepared::unordered(), ctx);
+
+      if (!admit) {
+        return make_iterator(segment, std::move(it), ord);
+      }
+
+      docs = cache_->emplace(segment, filter_, materialize(*it));
+    }
+
+    // iterator keeps cached documents alive even if evicted meanwhile
+    irs::doc_iterator::ptr it = irs::memory::make_unique<irs::bitset_doc_iterator>(
+      std::move(docs)
+    );
+
+    return make_iterator(segment, std::move(it), ord);
+  }
+
+ private:
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns bitset of the matched documents spanning up to the last one
+  //////////////////////////////////////////////////////////////////////////////
+  static irs::filter_cache::docs_ptr materialize(irs::doc_iterator& it) {
+    const size_t BATCH_SIZE = 128;
+    std::vector<irs::doc_id_t> docs;
+
+    for (size_t count = BATCH_SIZE; count == BATCH_SIZE;) {
+      const auto offset = docs.size();
+      docs.resize(offset + BATCH_SIZE);
+      count = it.next_batch(&docs[offset], nullptr, BATCH_SIZE);
+      docs.resize(offset + count);
+    }
+
+    auto set = std::make_shared<irs::bitset>(docs.empty() ? 0 : docs.back() + 1);
+
+    for (auto doc : docs) {
+      set->set(doc);
+    }
+
+    return set;
+  }
+
+  irs::doc_iterator::ptr make_iterator(
+      const irs::sub_reader& segment,
+      irs::doc_iterator::ptr&& it,
+      const irs::order::prepared& ord) const {
+    if (ord.empty()) {
+      return std::move(it);
+    }
+
+    return irs::doc_iterator::make<cached_iterator>(
+      segment,
+      attributes(), // prepared_filter attributes
+      std::move(it),
+      ord
+    );
+  }
+
+  std::shared_ptr<const irs::filter> filter_;
+  irs::filter_cache* cache_;
+}; // cached_query
+
+NS_END
+
+NS_ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                       filter_cache implementation
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief independently locked part of the cache, entries are kept in the
+///        least recently used order, lookups are counted in a count-min
+///        sketch of saturating counters that are halved every SAMPLE_SIZE
+///        lookups so that formerly hot filters fade out eventually
+////////////////////////////////////////////////////////////////////////////////
+struct filter_cache::shard {
+  static const size_t SKETCH_DEPTH = 4;
+  static const size_t SKETCH_WIDTH = 1024; // power of 2
+  static const size_t SAMPLE_SIZE = 10*SKETCH_WIDTH;
+
+  struct entry {
+    size_t hash;
+    std::weak_ptr<const sub_reader> segment;
+    std::shared_ptr<const irs::filter> filter;
+    docs_ptr docs;
+  }; // entry
+
+  typedef std::list<entry> entries_t; // most recently used first
+
+  std::list<entry>::iterator find(
+      size_t hash,
+      const sub_reader& segment,
+      const irs::filter& filter) {
+    auto range = index.equal_range(hash);
+
+    for (; range.first != range.second; ++range.first) {
+      auto& entry = *range.first->second;
+
+      // an expired segment never matches since the reader is still referenced
+      if (entry.segment.lock().get() == &segment && *entry.filter == filter) {
+        return range.first->second;
+      }
+    }
+
+    return entries.end();
+  }
+
+  void erase(entries_t::iterator it) {
+    auto range = index.equal_range(it->hash);
+
+    for (; range.first != range.second; ++range.first) {
+      if (range.first->second == it) {
+        index.erase(range.first);
+        break;
+      }
+    }
+
+    memory -= entry_memory(*it);
+    entries.erase(it);
+  }
+
+  void clear() {
+    index.clear();
+    entries.clear();
+    memory = 0;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief counts a lookup of 'hash'
+  /// @returns estimated number of lookups of 'hash' including the current one
+  //////////////////////////////////////////////////////////////////////////////
+  size_t touch(size_t hash) NOEXCEPT {
+    size_t frequency = std::numeric_limits<uint8_t>::max();
+
+    for (size_t i = 0; i < SKETCH_DEPTH; ++i) {
+      auto& counter = sketch[i][slot(hash, i)];
+
+      if (counter < std::numeric_limits<uint8_t>::max()) {
+        ++counter;
+      }
+
+      frequency = std::min(frequency, size_t(counter));
+    }
+
+    if (++lookups >= SAMPLE_SIZE) {
+      age();
+    }
+
+    return frequency;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns estimated number of lookups of 'hash'
+  //////////////////////////////////////////////////////////////////////////////
+  size_t frequency(size_t hash) const NOEXCEPT {
+    size_t frequency = std::numeric_limits<uint8_t>::max();
+
+    for (size_t i = 0; i < SKETCH_DEPTH; ++i) {
+      frequency = std::min(frequency, size_t(sketch[i][slot(hash, i)]));
+    }
+
+    return frequency;
+  }
+
+  void age() NOEXCEPT {
+    for (auto& row : sketch) {
+      for (auto& counter : row) {
+        counter /= 2;
+      }
+    }
+
+    lookups = 0;
+  }
+
+  static size_t entry_memory(const entry& entry) NOEXCEPT {
+    return ENTRY_OVERHEAD + docs_memory(*entry.docs);
+  }
+
+  static size_t slot(size_t hash, size_t row) NOEXCEPT {
+    // double hashing, the low bits of 'hash' select the shard
+    const size_t step = (hash >> (sizeof(size_t)*4)) | 1;
+    return ((hash >> 4) + row*step) & (SKETCH_WIDTH - 1);
+  }
+
+  std::mutex mutex;
+  entries_t entries;
+  std::unordered_multimap<size_t, entries_t::iterator> index;
+  size_t memory_limit{};
+  size_t memory{}; // memory occupied by entries
+  size_t lookups{}; // number of lookups since the last aging
+  uint8_t sketch[SKETCH_DEPTH][SKETCH_WIDTH]{};
+}; // shard
+
+filter_cache::filter_cache(size_t memory_limit, size_t min_hits /*= 2*/)
+  : shards_count_(1),
+    min_hits_(std::min(min_hits, size_t(std::numeric_limits<uint8_t>::max()))) {
+  // small caches aren't sharded, otherwise a single large result wouldn't fit
+  while (shards_count_ < MAX_SHARDS
+         && memory_limit / (2*shards_count_) >= MIN_SHARD_MEMORY) {
+    shards_count_ *= 2;
+  }
+
+  shards_.reset(new shard[shards_count_]);
+
+  for (size_t i = 0; i < shards_count_; ++i) {
+    shards_[i].memory_limit = memory_limit / shards_count_;
+  }
+}
+
+filter_cache::~filter_cache() { }
+
+filter_cache::shard& filter_cache::get_shard(size_t hash) const NOEXCEPT {
+  return shards_[hash & (shards_count_ - 1)];
+}
+
+filter_cache::docs_ptr filter_cache::get(
+    const sub_reader& reader,
+    const std::shared_ptr<const irs::filter>& filter,
+    bool& admit) {
+  assert(filter);
+  admit = false;
+
+  const auto segment = segment_identity(reader);
+
+  if (!segment) {
+    return nullptr; // not a segment, nothing to cache
+  }
+
+  const auto hash = segment_hash(segment.get(), *filter);
+  auto& shard = get_shard(hash);
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  const auto frequency = shard.touch(hash);
+  auto it = shard.find(hash, *segment, *filter);
+
+  if (it != shard.entries.end()) {
+    shard.entries.splice(shard.entries.begin(), shard.entries, it);
+
+    return it->docs;
+  }
+
+  admit = frequency >= min_hits_;
+
+  return nullptr;
+}
+
+filter_cache::docs_ptr filter_cache::emplace(
+    const sub_reader& reader,
+    const std::shared_ptr<const irs::filter>& filter,
+    docs_ptr&& docs) {
+  assert(filter && docs);
+
+  const auto segment = segment_identity(reader);
+
+  if (!segment) {
+    return std::move(docs); // not a segment, nothing to cache
+  }
+
+  const auto hash = segment_hash(segment.get(), *filter);
+  const auto memory = ENTRY_OVERHEAD + docs_memory(*docs);
+  auto& shard = get_shard(hash);
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.find(hash, *segment, *filter);
+
+  if (it != shard.entries.end()) {
+    // cached by another thread in the meantime
+    return it->docs;
+  }
+
+  if (memory > shard.memory_limit) {
+    return std::move(docs); // never fits
+  }
+
+  // find least recently used victims, unless any of them is more frequent
+  const auto frequency = shard.frequency(hash);
+  auto victims = shard.entries.end();
+
+  for (auto freed = shard.memory_limit - shard.memory;
+       freed < memory && victims != shard.entries.begin();) {
+    auto& victim = *--victims;
+
+    // entries of the released segments go first regardless of their hits
+    if (!victim.segment.expired() && shard.frequency(victim.hash) >= frequency) {
+      return std::move(docs);
+    }
+
+    freed += shard::entry_memory(victim);
+  }
+
+  while (victims != shard.entries.end()) {
+    shard.erase(victims++);
+  }
+
+  shard.entries.emplace_front();
+  it = shard.entries.begin();
+  it->hash = hash;
+  it->segment = segment;
+  it->filter = filter;
+  it->docs = docs;
+  shard.index.emplace(hash, it);
+  shard.memory += memory;
+
+  return std::move(docs);
+}
+
+void filter_cache::clear() {
+  for (size_t i = 0; i < shards_count_; ++i) {
+    auto& shard = shards_[i];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.clear();
+  }
+}
+
+size_t filter_cache::memory() const {
+  size_t memory = 0;
+
+  for (size_t i = 0; i < shards_count_; ++i) {
+    auto& shard = shards_[i];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    memory += shard.memory;
+  }
+
+  return memory;
+}
+
+size_t filter_cache::size() const {
+  size_t size = 0;
+
+  for (size_t i = 0; i < shards_count_; ++i) {
+    auto& shard = shards_[i];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    size += shard.entries.size();
+  }
+
+  return size;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                          by_cached implementation
+// -----------------------------------------------------------------------------
+
+DEFINE_FILTER_TYPE(by_cached)
+DEFINE_FACTORY_DEFAULT(by_cached)
+
+by_cached::by_cached() NOEXCEPT
+  : irs::filter(by_cached::type()) {
+}
+
+filter::prepared::ptr by_cached::prepare(
+    const index_reader& reader,
+    const order::prepared& order,
+    boost_t filter_boost,
+    const attribute_view& /*ctx*/
+) const {
+  if (!filter_) {
+    return prepared::empty();
+  }
+
+  attribute_store attrs;
+
+  // the wrapped filter is evaluated per segment and the cached results carry
+  // no term statistics, hence collect index-level statistics only
+  order.prepare_collectors(attrs, reader);
+
+  irs::boost::apply(attrs, boost() * filter_boost); // apply boost
+
+  return filter::prepared::make<cached_query>(filter_, cache_, std::move(attrs));
+}
+
+size_t by_cached::hash() const NOEXCEPT {
+  size_t seed = 0;
+  ::boost::hash_combine(seed, irs::filter::hash());
+  if (filter_) {
+    ::boost::hash_combine<const irs::filter&>(seed, *filter_);
+  }
+  return seed;
+}
+
+bool by_cached::equals(const irs::filter& rhs) const NOEXCEPT {
+  const auto& trhs = static_cast<const by_cached&>(rhs);
+
+  return irs::filter::equals(rhs)
+    && ((filter_ && trhs.filter_ && *filter_ == *trhs.filter_)
+        || (!filter_ && !trhs.filter_));
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
@@ -0,0 +1,172 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2019 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_FILTER_CACHE_H
+#define IRESEARCH_FILTER_CACHE_H
+
+#include "filter.hpp"
+#include "utils/bitset.hpp"
+#include "utils/noncopyable.hpp"
+
+#include <memory>
+
+NS_ROOT
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class filter_cache
+/// @brief cache of documents matched by filters, kept per segment and shared
+///        between queries, entries of a segment become unreachable as soon as
+///        the segment reader is released since segments are immutable
+/// @note lookups are counted in a fixed-size frequency sketch that is halved
+///       periodically, i.e. filters that aren't cached occupy no memory,
+///       a result is cached only if it is looked up more frequently than the
+///       least recently used entries it would displace
+/// @note thread-safe, entries are spread over independently locked shards
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API filter_cache : private util::noncopyable {
+ public:
+  typedef std::shared_ptr<const bitset> docs_ptr;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @param memory_limit upper bound of the memory occupied by cached entries
+  /// @param min_hits number of lookups of a filter in a segment before its
+  ///        result gets cached, i.e. one-off filters aren't materialized
+  //////////////////////////////////////////////////////////////////////////////
+  explicit filter_cache(size_t memory_limit, size_t min_hits = 2);
+  ~filter_cache();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief looks up documents matched by 'filter' in 'segment' and counts
+  ///        the lookup towards admission of the result
+  /// @param admit set to true if the result isn't cached but is frequent
+  ///        enough to be put into the cache via emplace(...)
+  /// @returns cached documents or nullptr
+  //////////////////////////////////////////////////////////////////////////////
+  docs_ptr get(
+    const sub_reader& segment,
+    const std::shared_ptr<const filter>& filter,
+    bool& admit
+  );
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief caches documents matched by 'filter' in 'segment' unless the
+  ///        entries to be evicted to stay within the memory limit are used
+  ///        more frequently
+  /// @returns cached documents, may differ from 'docs' if another thread has
+  ///          cached the same result in the meantime
+  //////////////////////////////////////////////////////////////////////////////
+  docs_ptr emplace(
+    const sub_reader& segment,
+    const std::shared_ptr<const filter>& filter,
+    docs_ptr&& docs
+  );
+
+  void clear();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns memory occupied by cached entries in bytes
+  //////////////////////////////////////////////////////////////////////////////
+  size_t memory() const;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns number of cached results
+  //////////////////////////////////////////////////////////////////////////////
+  size_t size() const;
+
+ private:
+  struct shard;
+
+  shard& get_shard(size_t hash) const NOEXCEPT;
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  std::unique_ptr<shard[]> shards_;
+  size_t shards_count_; // power of 2
+  size_t min_hits_;
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // filter_cache
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class by_cached
+/// @brief evaluates the wrapped filter through a filter_cache, matched
+///        documents are scored as by 'all' since the cached results carry
+///        no term statistics, i.e. intended for restricting filters such as
+///        tenant or ACL terms
+/// @note the wrapped filter must not be modified once it was executed
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API by_cached final : public filter {
+ public:
+  DECLARE_FILTER_TYPE();
+  DECLARE_FACTORY();
+
+  by_cached() NOEXCEPT;
+
+  filter_cache* cache() const NOEXCEPT { return cache_; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @param cache nullptr to evaluate the wrapped filter without caching
+  //////////////////////////////////////////////////////////////////////////////
+  by_cached& cache(filter_cache* cache) NOEXCEPT {
+    cache_ = cache;
+    return *this;
+  }
+
+  const irs::filter* filter() const NOEXCEPT {
+    return filter_.get();
+  }
+
+  template<typename T>
+  T& filter() {
+    typedef typename std::enable_if <
+      std::is_base_of< iresearch::filter, T >::value, T
+    >::type type;
+
+    auto filter = type::make();
+    auto& ref = static_cast<type&>(*filter);
+    filter_ = std::move(filter);
+    return ref;
+  }
+
+  using filter::prepare;
+
+  virtual filter::prepared::ptr prepare(
+    const index_reader& rdr,
+    const order::prepared& ord,
+    boost_t boost,
+    const attribute_view& ctx
+  ) const override;
+
+  virtual size_t hash() const NOEXCEPT override;
+
+ protected:
+  virtual bool equals(const irs::filter& rhs) const NOEXCEPT override;
+
+ private:
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  std::shared_ptr<const irs::filter> filter_;
+  filter_cache* cache_{};
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // by_cached
+
+NS_END // ROOT
+
+#endif // IRESEARCH_FILTER_CACHE_H
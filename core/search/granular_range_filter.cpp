@@ -527,7 +527,7 @@ filter::prepared::ptr by_granular_range::prepare(
     const index_reader& rdr,
     const order::prepared& ord,
     boost_t boost,
-    const attribute_view& //ctx
+    const attribute_view& ctx
 ) const {
   if (!rng_.min.empty() && !rng_.max.empty()) {
     const auto& min = rng_.min.begin()->second;
@@ -536,7 +536,7 @@ filter::prepared::ptr by_granular_range::prepare(
     if (min == max) { // compare the most precise terms
       if (rng_.min_type == rng_.max_type && rng_.min_type == Bound_Type::INCLUSIVE) {
         // degenerated case
-        return term_query::make(rdr, ord, boost*this->boost(), fld_, min);
+        return term_query::make(rdr, ord, boost*this->boost(), fld_, min, ctx);
       }
 
       // can't satisfy condition
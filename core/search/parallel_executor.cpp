@@ -0,0 +1,296 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "shared.hpp"
+#include "parallel_executor.hpp"
+#include "top_k_collector.hpp"
+#include "index/index_reader.hpp"
+#include "utils/memory.hpp"
+#include "utils/misc.hpp"
+#include "utils/thread_utils.hpp"
+#include "utils/type_limits.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+
+NS_LOCAL
+
+using namespace irs;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief iterator over documents in range [begin, end) of the underlying
+///        iterator
+////////////////////////////////////////////////////////////////////////////////
+class range_doc_iterator final : public doc_iterator {
+ public:
+  range_doc_iterator(doc_iterator::ptr&& it, doc_id_t begin, doc_id_t end)
+    : it_(std::move(it)), begin_(begin), end_(end) {
+    assert(it_);
+  }
+
+  virtual doc_id_t value() const override {
+    return doc_;
+  }
+
+  virtual bool next() override {
+    if (!doc_limits::valid(doc_)) {
+      return reset(it_->seek(begin_));
+    }
+
+    if (doc_limits::eof(doc_)) {
+      return false;
+    }
+
+    return reset(it_->next() ? it_->value() : doc_limits::eof());
+  }
+
+  virtual doc_id_t seek(doc_id_t target) override {
+    if (doc_limits::eof(doc_) || target <= doc_) {
+      return doc_;
+    }
+
+    reset(it_->seek(std::max(target, begin_)));
+    return doc_;
+  }
+
+  virtual const attribute_view& attributes() const NOEXCEPT override {
+    return it_->attributes();
+  }
+
+ private:
+  bool reset(doc_id_t doc) NOEXCEPT {
+    doc_ = doc < end_ ? doc : doc_limits::eof();
+    return !doc_limits::eof(doc_);
+  }
+
+  doc_iterator::ptr it_;
+  doc_id_t begin_;
+  doc_id_t end_;
+  doc_id_t doc_{ doc_limits::invalid() };
+}; // range_doc_iterator
+
+struct chunk {
+  size_t segment;
+  doc_id_t begin;
+  doc_id_t end;
+}; // chunk
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief state shared between the workers of a single execution, tasks
+///        which start after all chunks are claimed don't access anything
+///        but the state itself
+////////////////////////////////////////////////////////////////////////////////
+struct execution_state {
+  std::vector<chunk> chunks;
+  std::atomic<size_t> next{ 0 }; // next chunk to claim
+  std::mutex mutex;
+  std::condition_variable cond;
+  size_t active{}; // number of workers processing a chunk
+  std::exception_ptr error; // the first exception thrown by a worker
+  const index_reader* index{};
+  const irs::filter::prepared* query{};
+  const order::prepared* ord{};
+  const parallel_executor::visitor_f* visitor{};
+}; // execution_state
+
+void run_worker(execution_state& state, size_t worker) {
+  for (;;) {
+    {
+      SCOPED_LOCK(state.mutex);
+      ++state.active;
+    }
+
+    auto release = make_finally([&state]()->void {
+      SCOPED_LOCK(state.mutex);
+      --state.active;
+      state.cond.notify_all();
+    });
+
+    const auto i = state.next++;
+
+    if (i >= state.chunks.size()) {
+      return; // nothing left
+    }
+
+    const auto& chunk = state.chunks[i];
+
+    try {
+      auto& segment = (*state.index)[chunk.segment];
+      range_doc_iterator docs(
+        state.query->execute(segment, *state.ord),
+        chunk.begin, chunk.end
+      );
+
+      (*state.visitor)(worker, chunk.segment, docs);
+    } catch (...) {
+      SCOPED_LOCK(state.mutex);
+
+      if (!state.error) {
+        state.error = std::current_exception();
+      }
+
+      state.next = state.chunks.size(); // skip remaining chunks
+    }
+  }
+}
+
+NS_END
+
+NS_ROOT
+
+parallel_executor::parallel_executor(
+    async_utils::thread_pool& pool,
+    size_t concurrency /*= 0*/,
+    size_t chunk_size /*= DEFAULT_CHUNK_SIZE*/)
+  : pool_(&pool),
+    concurrency_(concurrency ? concurrency : pool.max_threads() + 1) {
+  // chunks never share a bitset word
+  const size_t word_bits = bits_required<bitset::word_t>();
+  chunk_size_ = std::max(size_t(1), (chunk_size + word_bits - 1) / word_bits)*word_bits;
+}
+
+void parallel_executor::execute(
+    const index_reader& index,
+    const filter::prepared& filter,
+    const order::prepared& ord,
+    const visitor_f& visitor) {
+  auto state = std::make_shared<execution_state>();
+  state->index = &index;
+  state->query = &filter;
+  state->ord = &ord;
+  state->visitor = &visitor;
+
+  // split segments into chunks
+  for (size_t i = 0, size = index.size(); i < size; ++i) {
+    const uint64_t end = doc_limits::min() + index[i].docs_count();
+
+    for (uint64_t begin = doc_limits::min(); begin < end;) {
+      const auto next = std::min(end, (begin/chunk_size_ + 1)*chunk_size_);
+      state->chunks.emplace_back(chunk{ i, doc_id_t(begin), doc_id_t(next) });
+      begin = next;
+    }
+  }
+
+  if (state->chunks.empty()) {
+    return;
+  }
+
+  const auto tasks = std::min(concurrency_, state->chunks.size()) - 1;
+
+  for (size_t worker = 1; worker <= tasks; ++worker) {
+    if (!pool_->run([state, worker]()->void { run_worker(*state, worker); })) {
+      break; // pool isn't active, remaining chunks are processed below
+    }
+  }
+
+  run_worker(*state, 0);
+
+  // wait for chunks claimed by other workers
+  {
+    SCOPED_LOCK_NAMED(state->mutex, lock);
+    state->cond.wait(lock, [&state]()->bool { return !state->active; });
+  }
+
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+uint64_t parallel_executor::count(
+    const index_reader& index,
+    const filter::prepared& filter) {
+  std::vector<uint64_t> counts(concurrency_, 0);
+
+  execute(
+    index, filter, order::prepared::unordered(),
+    [&counts](size_t worker, size_t, doc_iterator& docs)->void {
+      auto& count = counts[worker];
+
+      while (docs.next()) {
+        ++count;
+      }
+  });
+
+  return std::accumulate(counts.begin(), counts.end(), uint64_t(0));
+}
+
+void parallel_executor::matches(
+    const index_reader& index,
+    const filter::prepared& filter,
+    std::vector<bitset>& docs) {
+  docs.resize(index.size());
+
+  for (size_t i = 0, size = index.size(); i < size; ++i) {
+    docs[i].reset(doc_limits::min() + index[i].docs_count());
+  }
+
+  // chunks are aligned to bitset words, no synchronization required
+  execute(
+    index, filter, order::prepared::unordered(),
+    [&docs](size_t, size_t segment, doc_iterator& it)->void {
+      auto& set = docs[segment];
+
+      while (it.next()) {
+        set.set(it.value());
+      }
+  });
+}
+
+void parallel_executor::collect(
+    const index_reader& index,
+    const filter::prepared& filter,
+    top_k_collector& collector) {
+  std::vector<std::unique_ptr<top_k_collector>> collectors(concurrency_);
+
+  for (auto& worker : collectors) {
+    worker = collector.comparator()
+      ? memory::make_unique<top_k_collector>(
+          collector.ord(), collector.k(), *collector.comparator())
+      : memory::make_unique<top_k_collector>(
+          collector.ord(), collector.k(), collector.tie_breaker());
+  }
+
+  execute(
+    index, filter, collector.ord(),
+    [&index, &collectors](size_t worker, size_t segment, doc_iterator& docs)->void {
+      collectors[worker]->collect(index[segment], docs);
+  });
+
+  // register segments in order of their appearance in the index,
+  // so that ties are resolved as in case of sequential collection
+  for (auto& segment : index) {
+    collector.collect(segment, *doc_iterator::empty());
+  }
+
+  for (auto& worker : collectors) {
+    collector.merge(*worker);
+  }
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
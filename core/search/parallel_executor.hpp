@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_PARALLEL_EXECUTOR_H
+#define IRESEARCH_PARALLEL_EXECUTOR_H
+
+#include "filter.hpp"
+#include "sort.hpp"
+#include "utils/async_utils.hpp"
+#include "utils/bitset.hpp"
+#include "utils/noncopyable.hpp"
+
+#include <functional>
+
+NS_ROOT
+
+struct index_reader;
+class top_k_collector;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class parallel_executor
+/// @brief executes a prepared filter against all segments of an index using
+///        a thread pool, segments are split into chunks of documents claimed
+///        by workers on demand so that a single large segment doesn't
+///        serialize the query
+/// @note the calling thread participates in the execution as worker '0'
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API parallel_executor : private util::noncopyable {
+ public:
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief default number of documents per chunk
+  //////////////////////////////////////////////////////////////////////////////
+  static const size_t DEFAULT_CHUNK_SIZE = 65536;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief visitor of a chunk of documents
+  /// @param worker worker identifier in range [0, concurrency())
+  /// @param segment offset of the segment in the index
+  /// @param docs iterator over documents of the chunk
+  //////////////////////////////////////////////////////////////////////////////
+  typedef std::function<void(
+    size_t worker,
+    size_t segment,
+    doc_iterator& docs
+  )> visitor_f;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @param pool thread pool used for execution
+  /// @param concurrency max number of workers including the calling thread,
+  ///        0 == use 'pool.max_threads() + 1'
+  /// @param chunk_size number of documents per chunk, rounded up to the
+  ///        number of bits in a bitset word
+  //////////////////////////////////////////////////////////////////////////////
+  explicit parallel_executor(
+    async_utils::thread_pool& pool,
+    size_t concurrency = 0,
+    size_t chunk_size = DEFAULT_CHUNK_SIZE
+  );
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns max number of workers including the calling thread
+  //////////////////////////////////////////////////////////////////////////////
+  size_t concurrency() const NOEXCEPT { return concurrency_; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief execute filter against every chunk of the index and pass the
+  ///        resulting iterator to the visitor, blocks until all chunks are
+  ///        visited
+  /// @note visitor is called concurrently, but never concurrently for the
+  ///       same worker
+  /// @note the first exception thrown by the visitor is rethrown, remaining
+  ///       chunks are skipped
+  //////////////////////////////////////////////////////////////////////////////
+  void execute(
+    const index_reader& index,
+    const filter::prepared& filter,
+    const order::prepared& ord,
+    const visitor_f& visitor
+  );
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns total number of documents matched by the filter
+  //////////////////////////////////////////////////////////////////////////////
+  uint64_t count(const index_reader& index, const filter::prepared& filter);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief mark documents matched by the filter, one bitset per segment
+  //////////////////////////////////////////////////////////////////////////////
+  void matches(
+    const index_reader& index,
+    const filter::prepared& filter,
+    std::vector<bitset>& docs
+  );
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief collect the best documents matched by the filter into the
+  ///        specified collector, results are the same as of sequential
+  ///        collection of the index by 'collector'
+  //////////////////////////////////////////////////////////////////////////////
+  void collect(
+    const index_reader& index,
+    const filter::prepared& filter,
+    top_k_collector& collector
+  );
+
+ private:
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  async_utils::thread_pool* pool_;
+  size_t concurrency_;
+  size_t chunk_size_;
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // parallel_executor
+
+NS_END // ROOT
+
+#endif // IRESEARCH_PARALLEL_EXECUTOR_H
@@ -196,7 +196,7 @@ filter::prepared::ptr by_phrase::prepare(
     const index_reader& rdr,
     const order::prepared& ord,
     boost_t boost,
-    const attribute_view& /*ctx*/) const {
+    const attribute_view& ctx) const {
   if (fld_.empty() || phrase_.empty()) {
     // empty field or phrase
     return filter::prepared::empty();
@@ -205,7 +205,7 @@ filter::prepared::ptr by_phrase::prepare(
   if (1 == phrase_.size()) {
     // similar to `term_query`
     const irs::bytes_ref term = phrase_.begin()->second;
-    return term_query::make(rdr, ord, boost*this->boost(), fld_, term);
+    return term_query::make(rdr, ord, boost*this->boost(), fld_, term, ctx);
   }
 
   // per segment phrase states 
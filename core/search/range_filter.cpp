@@ -106,7 +106,7 @@ filter::prepared::ptr by_range::prepare(
     const index_reader& index,
     const order::prepared& ord,
     boost_t boost,
-    const attribute_view& /*ctx*/) const {
+    const attribute_view& ctx) const {
   //TODO: optimize unordered case
   // - seek to min
   // - get ordinal position of the term
@@ -119,7 +119,7 @@ filter::prepared::ptr by_range::prepare(
 
     if (rng_.min_type == rng_.max_type && rng_.min_type == Bound_Type::INCLUSIVE) {
       // degenerated case
-      return term_query::make(index, ord, boost*this->boost(), fld_, rng_.min);
+      return term_query::make(index, ord, boost*this->boost(), fld_, rng_.min, ctx);
     }
 
     // can't satisfy conditon
@@ -56,7 +56,8 @@ void limited_sample_scorer::collect(
   size_t scored_state_id, // state identifier used for querying of attributes
   iresearch::range_state& scored_state, // state containing this scored term
   const iresearch::sub_reader& reader, // segment reader for the current term
-  const seek_term_iterator& term_itr // term-iterator positioned at the current term
+  const seek_term_iterator& term_itr, // term-iterator positioned at the current term
+  boost::boost_t boost // boost of the current term
 ) {
   if (!scored_terms_limit_) {
     assert(scored_state.unscored_docs.size() >= (doc_limits::min)() + reader.docs_count()); // otherwise set will fail
@@ -68,7 +69,7 @@ void limited_sample_scorer::collect(
   scored_states_.emplace(
     std::piecewise_construct,
     std::forward_as_tuple(priority),
-    std::forward_as_tuple(reader, scored_state, scored_state_id, term_itr)
+    std::forward_as_tuple(reader, scored_state, scored_state_id, term_itr, boost)
   );
 
   if (scored_states_.size() <= scored_terms_limit_) {
@@ -156,9 +157,17 @@ void limited_sample_scorer::score(
     assert(itr != state_stats.end() && itr->second); // values set just above
 
     // filter attribute_store is copied since it's shared among multiple states
-    scored_state.state.scored_states.emplace(
+    auto& attrs = scored_state.state.scored_states.emplace(
       scored_state.state_offset, itr->second->filter_attrs
-    );
+    ).first->second;
+
+    irs::boost::apply(attrs, scored_state.term_boost);
+
+    if (scored_state.state.sparse) {
+      scored_state.state.scored_cookies.emplace(
+        scored_state.state_offset, std::move(scored_state.cookie)
+      );
+    }
   }
 }
 
@@ -208,7 +217,16 @@ doc_iterator::ptr range_query::execute(
     auto& stats = entry.second;
     assert(offset >= last_offset);
 
-    if (!skip(*terms, offset - last_offset)) {
+    if (state->sparse) {
+      // jump to the term using its cached state
+      auto cookie = state->scored_cookies.find(offset);
+
+      if (cookie == state->scored_cookies.end()
+          || !cookie->second
+          || !terms->seek(bytes_ref::NIL, *cookie->second)) {
+        continue; // some internal error that caused the term to disapear
+      }
+    } else if (!skip(*terms, offset - last_offset)) {
       continue; // reached end of iterator
     }
 
@@ -58,7 +58,9 @@ struct range_state : private util::noncopyable {
     estimation = std::move(other.estimation);
     count = std::move(other.count);
     scored_states = std::move(other.scored_states);
+    scored_cookies = std::move(other.scored_cookies);
     unscored_docs = std::move(other.unscored_docs);
+    sparse = other.sparse;
     other.reader = nullptr;
     other.count = 0;
     other.estimation = 0;
@@ -76,8 +78,17 @@ struct range_state : private util::noncopyable {
   // range_query::execute(...) expects an orderd map
   std::map<size_t, attribute_store> scored_states;
 
+  // cookies of the scored terms by their offset in range_state, filled for
+  // sparse states only since offset can't be used for skipping there
+  std::map<size_t, seek_term_iterator::cookie_ptr> scored_cookies;
+
   // matching doc_ids that may have been skipped while collecting statistics and should not be scored by the disjunction
   bitset unscored_docs;
+
+  // matching terms aren't adjacent in the term dictionary (e.g. wildcard),
+  // i.e. offset is the ordinal of the matching term rather than the distance
+  // from 'min_term'
+  bool sparse{};
 }; // reader_state
 
 //////////////////////////////////////////////////////////////////////////////
@@ -91,7 +102,8 @@ class limited_sample_scorer {
     size_t scored_state_id, // state identifier used for querying of attributes
     iresearch::range_state& scored_state, // state containing this scored term
     const iresearch::sub_reader& reader, // segment reader for the current term
-    const seek_term_iterator& term_itr // term-iterator positioned at the current term
+    const seek_term_iterator& term_itr, // term-iterator positioned at the current term
+    boost::boost_t boost = irs::boost::no_boost() // boost of the current term
   );
   void score(const index_reader& index, const order::prepared& order);
 
@@ -105,18 +117,21 @@ class limited_sample_scorer {
     size_t state_offset;
     const iresearch::sub_reader& sub_reader; // segment reader for the current term
     bstring term; // actual term value this state is for
+    boost::boost_t term_boost; // boost of the term
 
     scored_term_state_t(
       const iresearch::sub_reader& sr,
       iresearch::range_state& scored_state,
       size_t scored_state_offset,
-      const seek_term_iterator& term_itr
+      const seek_term_iterator& term_itr,
+      boost::boost_t boost_value
     ):
       cookie(term_itr.cookie()),
       state(scored_state),
       state_offset(scored_state_offset),
       sub_reader(sr),
-      term(term_itr.value()) {
+      term(term_itr.value()),
+      term_boost(boost_value) {
     }
   };
 
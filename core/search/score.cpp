@@ -46,6 +46,18 @@ score::score() NOEXCEPT
   : func_([](byte_type*){}) {
 }
 
+// ----------------------------------------------------------------------------
+// --SECTION--                                                      score_bound
+// ----------------------------------------------------------------------------
+
+DEFINE_ATTRIBUTE_TYPE(iresearch::score_bound)
+
+// ----------------------------------------------------------------------------
+// --SECTION--                                                  score_threshold
+// ----------------------------------------------------------------------------
+
+DEFINE_ATTRIBUTE_TYPE(iresearch::score_threshold)
+
 NS_END // ROOT
 
 // -----------------------------------------------------------------------------
@@ -88,6 +88,96 @@ class IRESEARCH_API score : public attribute {
   IRESEARCH_API_PRIVATE_VARIABLES_END
 }; // score
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class score_bound
+/// @brief represents upper bounds of a score produced by an iterator, both
+///        across all documents and within a block of documents
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API score_bound : public attribute {
+ public:
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief moves block boundary to the one containing the specified 'target'
+  ///        and stores the best possible score within a block to 'bound'
+  /// @returns the last document of a block
+  ////////////////////////////////////////////////////////////////////////////
+  typedef std::function<doc_id_t(doc_id_t target, byte_type* bound)> seek_f;
+
+  DECLARE_ATTRIBUTE_TYPE();
+
+  score_bound() = default;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns the best possible score across all documents
+  //////////////////////////////////////////////////////////////////////////////
+  const byte_type* max() const NOEXCEPT {
+    return max_.c_str();
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns the best possible score within the current block
+  //////////////////////////////////////////////////////////////////////////////
+  const byte_type* block() const NOEXCEPT {
+    return block_.c_str();
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief moves block boundary without moving an underlying iterator
+  /// @returns the last document of a block containing 'target'
+  //////////////////////////////////////////////////////////////////////////////
+  doc_id_t shallow_seek(doc_id_t target) const {
+    assert(func_);
+    return func_(target, leak(block_));
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief initialize bounds, 'max' will be filled with the best possible
+  ///        score across all documents
+  /// @returns false if bound can't be provided for a specified order
+  //////////////////////////////////////////////////////////////////////////////
+  template<typename MaxFunc>
+  bool prepare(const order::prepared& ord, const MaxFunc& max, seek_f&& func) {
+    if (ord.empty()) {
+      return false;
+    }
+
+    max_.resize(ord.size());
+    ord.prepare_score(leak(max_));
+
+    if (!max(leak(max_))) {
+      return false;
+    }
+
+    block_ = max_;
+    func_ = std::move(func);
+    return true;
+  }
+
+ private:
+  static byte_type* leak(const bstring& value) {
+    return const_cast<byte_type*>(&(value[0]));
+  }
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  bstring max_;
+  bstring block_;
+  seek_f func_;
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // score_bound
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class score_threshold
+/// @brief the score a document has to beat in order to be collected, allows
+///        iterators to skip documents which can't be competitive,
+///        nullptr means no threshold
+//////////////////////////////////////////////////////////////////////////////
+struct IRESEARCH_API score_threshold : attribute {
+  DECLARE_ATTRIBUTE_TYPE();
+
+  score_threshold() = default;
+
+  const byte_type* value{};
+}; // score_threshold
+
 NS_END // ROOT
 
 #endif // IRESEARCH_SCORE_H
@@ -60,6 +60,33 @@ basic_doc_iterator::basic_doc_iterator(
   prepare_score([this](byte_type* score) {
     scorers_.score(*ord_, score);
   });
+
+  prepare_bound();
+}
+
+void basic_doc_iterator::prepare_bound() {
+  // upper bounds are derived from the term frequencies stored in postings
+  auto* freq = it_->attributes().get<frequency_bound>().get();
+
+  if (!freq || scorers_.empty()) {
+    return;
+  }
+
+  const bool bounded = bound_.prepare(
+    *ord_,
+    [this, freq](byte_type* max) {
+      return scorers_.bound(*ord_, max, freq->max());
+    },
+    [this, freq](doc_id_t target, byte_type* bound) {
+      uint32_t max;
+      const auto doc = freq->shallow_seek(target, max);
+      scorers_.bound(*ord_, bound, max); // checked in 'prepare'
+      return doc;
+  });
+
+  if (bounded) {
+    attrs_.emplace(bound_);
+  }
 }
 
 #if defined(_MSC_VER)
@@ -92,9 +92,12 @@ class basic_doc_iterator final : public doc_iterator_base {
   }
 
  private:
+  void prepare_bound();
+
   order::prepared::scorers scorers_;
   doc_iterator::ptr it_;
   const attribute_store* stats_;
+  irs::score_bound bound_;
 }; // basic_doc_iterator
 
 NS_END // ROOT
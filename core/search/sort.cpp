@@ -310,6 +310,21 @@ void order::prepared::scorers::score(
   }
 }
 
+bool order::prepared::scorers::bound(
+    const order::prepared& /*ord*/,
+    byte_type* scr,
+    uint32_t freq
+) const {
+  for (auto& scorer : scorers_) {
+    assert(scorer.first);
+    if (!scorer.first->bound(scr + scorer.second, freq)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 order::prepared::prepared() : size_(0) { }
 
 order::prepared::collectors order::prepared::prepare_collectors(
@@ -144,6 +144,16 @@ class IRESEARCH_API sort {
     /// @brief set the document score based on the stored state
     ////////////////////////////////////////////////////////////////////////////////
     virtual void score(byte_type* score_buf) = 0;
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief set the max possible score of a document with the term frequency
+    ///        not greater than the specified 'freq'
+    /// @returns false if scorer is unable to provide such a bound, the bound
+    ///          must be non-negative and score aggregation must be monotonic
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual bool bound(byte_type* /*score_buf*/, uint32_t /*freq*/) const {
+      return false;
+    }
   }; // scorer
 
   template <typename T>
@@ -578,6 +588,15 @@ class IRESEARCH_API order final {
 
       void score(const prepared& ord, byte_type* score) const;
 
+      //////////////////////////////////////////////////////////////////////////
+      /// @brief evaluate the max possible score of a document with the term
+      ///        frequency not greater than the specified 'freq'
+      /// @returns false if any of the scorers is unable to provide such a bound
+      //////////////////////////////////////////////////////////////////////////
+      bool bound(const prepared& ord, byte_type* score, uint32_t freq) const;
+
+      bool empty() const NOEXCEPT { return scorers_.empty(); }
+
      private:
       IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
       std::vector<std::pair<sort::scorer::ptr, size_t>> scorers_; // scorer + offset
@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2019 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "term_cache.hpp"
+#include "index/segment_reader.hpp"
+#include "utils/hash_utils.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+NS_LOCAL
+
+// approximate memory occupied by an entry apart from the field and the term,
+// i.e. list/index nodes and a term state
+const size_t ENTRY_OVERHEAD = 192;
+
+//////////////////////////////////////////////////////////////////////////////
+/// @returns shared pointer identifying a segment or nullptr if the reader
+///          doesn't denote a segment, e.g. is a custom 'sub_reader'
+//////////////////////////////////////////////////////////////////////////////
+irs::sub_reader::ptr segment_identity(const irs::sub_reader& reader) NOEXCEPT {
+  const auto* segment = dynamic_cast<const irs::segment_reader*>(&reader);
+
+  return segment ? irs::sub_reader::ptr(*segment) : nullptr;
+}
+
+size_t term_hash(
+    const irs::sub_reader* segment,
+    const irs::string_ref& field,
+    const irs::bytes_ref& term) {
+  auto seed = irs::hash_combine(0, segment);
+  seed = irs::hash_combine(seed, field);
+  return irs::hash_combine(seed, term);
+}
+
+NS_END
+
+NS_ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                         term_cache implementation
+// -----------------------------------------------------------------------------
+
+DEFINE_ATTRIBUTE_TYPE(iresearch::term_cache)
+
+term_cache::term_cache(size_t memory_limit, size_t shards /*= 16*/)
+  : shards_(std::max(size_t(1), shards)),
+    shard_memory_limit_(memory_limit / shards_.size()) {
+}
+
+term_cache::entries_t::iterator term_cache::find(
+    shard& shard,
+    size_t hash,
+    const sub_reader& segment,
+    const string_ref& field,
+    const bytes_ref& term) {
+  const auto range = shard.index.equal_range(hash);
+
+  for (auto it = range.first; it != range.second; ++it) {
+    auto& entry = *it->second;
+
+    // an expired segment never matches, its address might have been reused
+    if (entry.segment_key == &segment
+        && entry.field == field
+        && entry.term == term
+        && !entry.segment.expired()) {
+      return it->second;
+    }
+  }
+
+  return shard.entries.end();
+}
+
+void term_cache::erase(shard& shard, entries_t::iterator it) {
+  const auto range = shard.index.equal_range(it->hash);
+
+  for (auto index_it = range.first; index_it != range.second; ++index_it) {
+    if (index_it->second == it) {
+      shard.index.erase(index_it);
+      break;
+    }
+  }
+
+  shard.memory -= ENTRY_OVERHEAD + it->field.size() + it->term.size();
+  shard.entries.erase(it);
+}
+
+bool term_cache::get(
+    const sub_reader& reader,
+    const string_ref& field,
+    const bytes_ref& term,
+    cookie_ptr& cookie) {
+  const auto segment = segment_identity(reader);
+
+  if (!segment) {
+    return false; // not a segment, nothing to cache
+  }
+
+  const auto hash = term_hash(segment.get(), field, term);
+  auto& shard = shards_[hash % shards_.size()];
+
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto it = find(shard, hash, *segment, field, term);
+
+    if (it != shard.entries.end()) {
+      // move to the head of the LRU list
+      shard.entries.splice(shard.entries.begin(), shard.entries, it);
+      cookie = it->cookie;
+      hits_.fetch_add(1, std::memory_order_relaxed);
+
+      return true;
+    }
+  }
+
+  misses_.fetch_add(1, std::memory_order_relaxed);
+
+  return false;
+}
+
+void term_cache::put(
+    const sub_reader& reader,
+    const string_ref& field,
+    const bytes_ref& term,
+    cookie_ptr cookie) {
+  const auto segment = segment_identity(reader);
+
+  if (!segment) {
+    return; // not a segment, nothing to cache
+  }
+
+  const auto memory = ENTRY_OVERHEAD + field.size() + term.size();
+
+  if (memory > shard_memory_limit_) {
+    return; // would never fit
+  }
+
+  const auto hash = term_hash(segment.get(), field, term);
+  auto& shard = shards_[hash % shards_.size()];
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = find(shard, hash, *segment, field, term);
+
+  if (it != shard.entries.end()) {
+    // cached by another thread in the meantime
+    it->cookie = std::move(cookie);
+    shard.entries.splice(shard.entries.begin(), shard.entries, it);
+
+    return;
+  }
+
+  // evict least recently used entries
+  while (shard.memory + memory > shard_memory_limit_) {
+    assert(!shard.entries.empty());
+    erase(shard, std::prev(shard.entries.end()));
+  }
+
+  shard.entries.emplace_front();
+  it = shard.entries.begin();
+  it->segment = segment;
+  it->segment_key = segment.get();
+  it->field.assign(field.c_str(), field.size());
+  it->term.assign(term.c_str(), term.size());
+  it->cookie = std::move(cookie);
+  it->hash = hash;
+  shard.index.emplace(hash, it);
+  shard.memory += memory;
+}
+
+void term_cache::clear() {
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.index.clear();
+    shard.entries.clear();
+    shard.memory = 0;
+  }
+
+  hits_ = 0;
+  misses_ = 0;
+}
+
+term_cache::stats term_cache::statistics() const {
+  term_cache::stats stats;
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    stats.entries += shard.entries.size();
+    stats.memory += shard.memory;
+  }
+
+  return stats;
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2019 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_TERM_CACHE_H
+#define IRESEARCH_TERM_CACHE_H
+
+#include "index/iterators.hpp"
+#include "utils/attributes.hpp"
+#include "utils/noncopyable.hpp"
+#include "utils/string.hpp"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+NS_ROOT
+
+struct sub_reader;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class term_cache
+/// @brief bounded cache of term dictionary lookups per segment/field/term,
+///        allows hot terms to skip the FST traversal and the block decoding,
+///        entries of a released segment are never served again and are
+///        evicted in least recently used order along with the others
+/// @note opt-in, i.e. the cache is used by the queries prepared with the
+///       cache present in the 'ctx' attributes passed to filter::prepare(...)
+/// @note thread-safe
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API term_cache : public attribute, private util::noncopyable {
+ public:
+  typedef std::shared_ptr<const seek_term_iterator::seek_cookie> cookie_ptr;
+
+  DECLARE_ATTRIBUTE_TYPE();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @struct stats
+  //////////////////////////////////////////////////////////////////////////////
+  struct stats {
+    size_t hits{};
+    size_t misses{};
+    size_t entries{};
+    size_t memory{}; // memory occupied by entries in bytes
+
+    double hit_rate() const NOEXCEPT {
+      const auto lookups = hits + misses;
+      return lookups ? double(hits) / lookups : 0.;
+    }
+  }; // stats
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @param memory_limit upper bound of the memory occupied by cached entries
+  /// @param shards number of independently locked parts of the cache
+  //////////////////////////////////////////////////////////////////////////////
+  explicit term_cache(size_t memory_limit, size_t shards = 16);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief looks up a result of seeking to 'term' in 'field' of 'segment'
+  /// @param cookie set to the cached term state, nullptr denotes that the
+  ///        term is absent from the segment
+  /// @returns false if nothing is cached for the specified term
+  //////////////////////////////////////////////////////////////////////////////
+  bool get(
+    const sub_reader& segment,
+    const string_ref& field,
+    const bytes_ref& term,
+    cookie_ptr& cookie
+  );
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief caches a result of seeking to 'term' in 'field' of 'segment'
+  /// @param cookie term state or nullptr if the term is absent
+  //////////////////////////////////////////////////////////////////////////////
+  void put(
+    const sub_reader& segment,
+    const string_ref& field,
+    const bytes_ref& term,
+    cookie_ptr cookie
+  );
+
+  void clear();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns lookup counters accumulated since the last clear() along with
+  ///          the current occupancy of the cache
+  //////////////////////////////////////////////////////////////////////////////
+  stats statistics() const;
+
+ private:
+  struct entry {
+    std::weak_ptr<const sub_reader> segment;
+    const sub_reader* segment_key; // valid only while 'segment' isn't expired
+    std::string field;
+    bstring term;
+    cookie_ptr cookie;
+    size_t hash;
+  }; // entry
+
+  typedef std::list<entry> entries_t; // most recently used first
+
+  struct shard {
+    mutable std::mutex mutex;
+    entries_t entries;
+    std::unordered_multimap<size_t, entries_t::iterator> index;
+    size_t memory{};
+  }; // shard
+
+  entries_t::iterator find(
+    shard& shard,
+    size_t hash,
+    const sub_reader& segment,
+    const string_ref& field,
+    const bytes_ref& term
+  );
+
+  void erase(shard& shard, entries_t::iterator it);
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  std::vector<shard> shards_;
+  size_t shard_memory_limit_;
+  std::atomic<size_t> hits_{};
+  std::atomic<size_t> misses_{};
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // term_cache
+
+NS_END // ROOT
+
+#endif // IRESEARCH_TERM_CACHE_H
@@ -63,8 +63,8 @@ filter::prepared::ptr by_term::prepare(
     const index_reader& rdr,
     const order::prepared& ord,
     boost_t boost,
-    const attribute_view& /*ctx*/) const {
-  return term_query::make(rdr, ord, boost*this->boost(), fld_, term_);
+    const attribute_view& ctx) const {
+  return term_query::make(rdr, ord, boost*this->boost(), fld_, term_, ctx);
 }
 
 NS_END // ROOT
@@ -24,6 +24,7 @@
 #include "shared.hpp"
 #include "term_query.hpp"
 #include "score_doc_iterators.hpp"
+#include "term_cache.hpp"
 
 #include "index/index_reader.hpp"
 
@@ -38,8 +39,10 @@ term_query::ptr term_query::make(
     const order::prepared& ord,
     filter::boost_t boost,
     const string_ref& field,
-    const bytes_ref& term) {
+    const bytes_ref& term,
+    const attribute_view& ctx /*= attribute_view::empty_instance()*/) {
   term_query::states_t states(index.size());
+  auto& cache = ctx.get<term_cache>();
   attribute_store attrs;
   auto collectors = ord.prepare_collectors(1);
 
@@ -56,23 +59,37 @@ term_query::ptr term_query::make(
 
     // find term
     auto terms = reader->iterator();
-
-    if (!terms->seek(term)) {
-      continue;
+    term_cache::cookie_ptr cookie;
+
+    if (cache && cache->get(segment, field, term, cookie)) {
+      // restore term attributes from the cached state, no FST traversal
+      if (!cookie || !terms->seek(term, *cookie)) {
+        continue;
+      }
+    } else {
+      if (terms->seek(term)) {
+        terms->read(); // read term attributes
+        cookie = terms->cookie();
+      }
+
+      if (cache) {
+        cache->put(segment, field, term, cookie); // cache absent terms as well
+      }
+
+      if (!cookie) {
+        continue;
+      }
     }
 
     // get term metadata
     auto& meta = terms->attributes().get<term_meta>();
 
-    // read term attributes
-    terms->read();
-
     // Cache term state in prepared query attributes.
     // Later, using cached state we could easily "jump" to
     // postings without relatively expensive FST traversal
     auto& state = states.insert(segment);
     state.reader = reader;
-    state.cookie = terms->cookie();
+    state.cookie = std::move(cookie);
 
     // collect cost
     if (meta) {
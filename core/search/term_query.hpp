@@ -49,7 +49,7 @@ struct reader_term_state {
   }
 
   const term_reader* reader{};
-  seek_term_iterator::cookie_ptr cookie;
+  std::shared_ptr<const seek_term_iterator::seek_cookie> cookie;
   cost::cost_t estimation{};
 }; // term_state
 
@@ -63,12 +63,16 @@ class term_query : public filter::prepared {
 
   DECLARE_SHARED_PTR(term_query);
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @param ctx query context, term lookups go through 'term_cache' if present
+  //////////////////////////////////////////////////////////////////////////////
   static ptr make(
     const index_reader& rdr,
     const order::prepared& ord,
     filter::boost_t boost,
     const string_ref& field,
-    const bytes_ref& term
+    const bytes_ref& term,
+    const attribute_view& ctx = attribute_view::empty_instance()
   );
 
   explicit term_query(states_t&& states, attribute_store&& attrs);
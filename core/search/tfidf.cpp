@@ -256,6 +256,15 @@ class const_scorer final : public irs::sort::scorer_base<tfidf::score_t> {
     score_cast(score_buf) = boost_;
   }
 
+  virtual bool bound(byte_type* score_buf, uint32_t /*freq*/) const NOEXCEPT override {
+    if (boost_ < 0.f) {
+      return false;
+    }
+
+    score_cast(score_buf) = boost_;
+    return true;
+  }
+
  private:
   const irs::boost::boost_t boost_;
 }; // const_scorer
@@ -277,6 +286,16 @@ class scorer : public irs::sort::scorer_base<tfidf::score_t> {
     score_cast(score_buf) = tfidf();
   }
 
+  // normalization factor never exceeds 1, see norm::read()
+  virtual bool bound(byte_type* score_buf, uint32_t freq) const NOEXCEPT override {
+    if (idf_ < 0.f) {
+      return false;
+    }
+
+    score_cast(score_buf) = idf_ * float_t(std::sqrt(freq));
+    return true;
+  }
+
  protected:
   FORCE_INLINE float_t tfidf() const NOEXCEPT {
    return idf_ * float_t(std::sqrt(freq_->value));
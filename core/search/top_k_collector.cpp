@@ -0,0 +1,325 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "shared.hpp"
+#include "top_k_collector.hpp"
+#include "score.hpp"
+#include "index/comparer.hpp"
+#include "index/index_reader.hpp"
+
+#include <algorithm>
+
+NS_ROOT
+
+top_k_collector::top_k_collector(
+    const order::prepared& ord,
+    size_t k,
+    const string_ref& tie_breaker /*= string_ref::NIL*/)
+  : ord_(&ord),
+    k_(k),
+    scores_(k*ord.size(), 0),
+    slots_(k),
+    no_score_(ord.size(), 0) {
+  ord.prepare_score(&no_score_[0]);
+
+  if (!tie_breaker.null()) {
+    tie_breaker_.assign(tie_breaker.c_str(), tie_breaker.size());
+  }
+
+  heap_.reserve(k);
+}
+
+top_k_collector::top_k_collector(
+    const order::prepared& ord,
+    size_t k,
+    const comparer& comparator)
+  : top_k_collector(ord, k) {
+  comparator_ = &comparator;
+}
+
+void top_k_collector::clear() NOEXCEPT {
+  heap_.clear();
+  segments_.clear();
+  hits_ = 0;
+  sorted_ = false;
+}
+
+void top_k_collector::collect(
+    const index_reader& index,
+    const filter::prepared& filter) {
+  for (auto& segment : index) {
+    collect(segment, filter);
+  }
+}
+
+void top_k_collector::collect(
+    const sub_reader& segment,
+    const filter::prepared& filter) {
+  attribute_view ctx;
+  score_threshold threshold;
+
+  // let the filter know the threshold is going to be provided,
+  // so that iterators able to skip documents are preferred
+  if (!comparator_ && tie_breaker_.empty()) {
+    ctx.emplace(threshold);
+  }
+
+  auto docs = filter.execute(segment, *ord_, ctx);
+  assert(docs);
+
+  collect(segment, *docs);
+}
+
+void top_k_collector::collect(const sub_reader& reader, doc_iterator& docs) {
+  assert(!sorted_);
+  const auto segment = add_segment(reader);
+  const auto& score = irs::score::extract(docs.attributes());
+  const byte_type* value = &score == &irs::score::no_score()
+    ? no_score_.c_str() // iterator doesn't produce scores
+    : score.c_str();
+
+  if (comparator_) {
+    // rank doesn't depend on score, evaluate only competitive documents
+    const bool sorted = segments_[segment].sorted;
+
+    while (docs.next()) {
+      ++hits_;
+      const auto doc = docs.value();
+
+      if (!competitive(segment, doc)) {
+        if (sorted) {
+          // documents are ordered by the sort column within the segment,
+          // none of the remaining ones is able to beat the current one
+          break;
+        }
+
+        continue;
+      }
+
+      score.evaluate();
+      push(value, segment, doc);
+    }
+
+    return;
+  }
+
+  // documents having scores equal to the threshold may still be collected
+  // if ties are resolved by a stored column, can't prune them
+  auto* threshold = tie_breaker_.empty()
+    ? docs.attributes().get<score_threshold>().get()
+    : nullptr;
+
+  if (threshold) {
+    threshold->value = this->threshold();
+  }
+
+  while (docs.next()) {
+    ++hits_;
+    score.evaluate();
+
+    push(value, segment, docs.value());
+
+    if (threshold) {
+      threshold->value = this->threshold();
+    }
+  }
+}
+
+void top_k_collector::merge(const top_k_collector& other) {
+  assert(!sorted_ && ord_->size() == other.ord_->size());
+
+  // remap segments of the other collector, segments already known to
+  // this collector keep their positions so ties are resolved consistently
+  std::vector<size_t> mapping;
+  mapping.reserve(other.segments_.size());
+
+  for (auto& segment : other.segments_) {
+    auto it = std::find_if(
+      segments_.begin(), segments_.end(),
+      [&segment](const top_k_collector::segment& lhs) {
+        return lhs.reader == segment.reader;
+    });
+
+    if (it == segments_.end()) {
+      segments_.emplace_back(segment);
+      it = segments_.end() - 1;
+    }
+
+    mapping.emplace_back(size_t(std::distance(segments_.begin(), it)));
+  }
+
+  for (auto slot : other.heap_) {
+    auto& entry = other.slots_[slot];
+    push(other.score(slot), mapping[entry.segment], entry.doc);
+  }
+
+  hits_ += other.hits_;
+}
+
+size_t top_k_collector::add_segment(const sub_reader& reader) {
+  if (!segments_.empty() && segments_.back().reader == &reader) {
+    return segments_.size() - 1;
+  }
+
+  columnstore_reader::values_reader_f values;
+  bool sorted = false;
+
+  if (comparator_) {
+    // the segment is sorted by the comparer the index was created with
+    auto* column = reader.sort();
+    sorted = nullptr != column;
+
+    values = column
+      ? column->values()
+      : columnstore_reader::empty_reader();
+  } else if (!tie_breaker_.empty()) {
+    auto* column = reader.column_reader(tie_breaker_);
+
+    values = column
+      ? column->values()
+      : columnstore_reader::empty_reader();
+  }
+
+  segments_.emplace_back(segment{ &reader, std::move(values), sorted });
+
+  return segments_.size() - 1;
+}
+
+bool top_k_collector::less(
+    const byte_type* lhs_score, size_t lhs_segment, doc_id_t lhs_doc,
+    const byte_type* rhs_score, size_t rhs_segment, doc_id_t rhs_doc) const {
+  if (!comparator_) {
+    if (ord_->less(lhs_score, rhs_score)) {
+      return true;
+    }
+
+    if (ord_->less(rhs_score, lhs_score)) {
+      return false;
+    }
+  }
+
+  if (comparator_ || !tie_breaker_.empty()) {
+    bytes_ref lhs_value, rhs_value;
+    const bool has_lhs = segments_[lhs_segment].values(lhs_doc, lhs_value);
+
+    // values may share the same buffer if both documents are from
+    // the same segment
+    tie_value_.assign(lhs_value.c_str(), lhs_value.size());
+    lhs_value = tie_value_;
+
+    const bool has_rhs = segments_[rhs_segment].values(rhs_doc, rhs_value);
+
+    if (comparator_) {
+      // missing values are passed as NIL, the same way as during sorting
+      if (!has_lhs) {
+        lhs_value = bytes_ref::NIL;
+      }
+
+      if (!has_rhs) {
+        rhs_value = bytes_ref::NIL;
+      }
+
+      if ((*comparator_)(lhs_value, rhs_value)) {
+        return true;
+      }
+
+      if ((*comparator_)(rhs_value, lhs_value)) {
+        return false;
+      }
+    } else if (has_lhs != has_rhs) {
+      return has_lhs; // documents without values go last
+    } else if (lhs_value != rhs_value) {
+      return lhs_value < rhs_value;
+    }
+  }
+
+  return lhs_segment == rhs_segment
+    ? lhs_doc < rhs_doc
+    : lhs_segment < rhs_segment;
+}
+
+bool top_k_collector::competitive(size_t segment, doc_id_t doc) const {
+  if (heap_.size() < k_) {
+    return 0 != k_;
+  }
+
+  // the worst collected document is on top
+  const auto top = heap_.front();
+
+  return less(
+    no_score_.c_str(), segment, doc,
+    score(top), slots_[top].segment, slots_[top].doc
+  );
+}
+
+void top_k_collector::push(
+    const byte_type* score,
+    size_t segment,
+    doc_id_t doc) {
+  if (!k_) {
+    return;
+  }
+
+  const auto size = ord_->size();
+  const auto comparer = [this](size_t lhs, size_t rhs) {
+    return less(lhs, rhs);
+  };
+
+  size_t slot;
+
+  if (heap_.size() < k_) {
+    slot = heap_.size();
+    heap_.push_back(slot);
+  } else {
+    // the worst collected document is on top
+    const auto top = heap_.front();
+
+    if (!less(score, segment, doc, this->score(top), slots_[top].segment, slots_[top].doc)) {
+      return;
+    }
+
+    std::pop_heap(heap_.begin(), heap_.end(), comparer);
+    slot = heap_.back();
+  }
+
+  slots_[slot].segment = segment;
+  slots_[slot].doc = doc;
+  std::memcpy(&scores_[0] + slot*size, score, size);
+  std::push_heap(heap_.begin(), heap_.end(), comparer);
+}
+
+void top_k_collector::finish() {
+  if (!sorted_) {
+    std::sort_heap(
+      heap_.begin(), heap_.end(),
+      [this](size_t lhs, size_t rhs) { return less(lhs, rhs); }
+    );
+    sorted_ = true;
+  }
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
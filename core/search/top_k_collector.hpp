@@ -0,0 +1,240 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_TOP_K_COLLECTOR_H
+#define IRESEARCH_TOP_K_COLLECTOR_H
+
+#include "filter.hpp"
+#include "sort.hpp"
+#include "formats/formats.hpp"
+#include "utils/noncopyable.hpp"
+
+NS_ROOT
+
+class comparer;
+struct index_reader;
+struct sub_reader;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class top_k_collector
+/// @brief collects the best 'k' documents according to the specified order
+///        across all segments of an index
+/// @note scores are kept in a single preallocated buffer, the collector
+///       doesn't allocate memory per hit
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API top_k_collector : private util::noncopyable {
+ public:
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief collected document
+  //////////////////////////////////////////////////////////////////////////////
+  struct entry {
+    const sub_reader* segment;
+    doc_id_t doc;
+    const byte_type* score; // ord.size() bytes
+  }; // entry
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @param ord order used for both scoring and ranking of the documents
+  /// @param k max number of documents to collect
+  /// @param tie_breaker name of the stored column used for ordering of
+  ///        the documents having equal scores, documents are ordered by
+  ///        their segment and identifier if not specified
+  //////////////////////////////////////////////////////////////////////////////
+  top_k_collector(
+    const order::prepared& ord,
+    size_t k,
+    const string_ref& tie_breaker = string_ref::NIL
+  );
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @param ord order used for scoring of the documents
+  /// @param k max number of documents to collect
+  /// @param comparator comparer the index was sorted with, i.e.
+  ///        'index_writer::init_options::comparator', documents are ranked
+  ///        by the values of the segment sort column and then by their
+  ///        segment and identifier
+  /// @note collection of a segment sorted by the same comparer stops once
+  ///       'k' competitive documents are found, the rest of the postings
+  ///       are neither evaluated nor scored
+  //////////////////////////////////////////////////////////////////////////////
+  top_k_collector(
+    const order::prepared& ord,
+    size_t k,
+    const comparer& comparator
+  );
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief execute the specified filter against every segment of the index
+  ///        and collect matched documents
+  //////////////////////////////////////////////////////////////////////////////
+  void collect(const index_reader& index, const filter::prepared& filter);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief execute the specified filter against a segment and collect
+  ///        matched documents
+  /// @note the filter is executed with 'score_threshold' in the context if
+  ///       the collector is going to drive the threshold
+  //////////////////////////////////////////////////////////////////////////////
+  void collect(const sub_reader& segment, const filter::prepared& filter);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief collect documents matched by the specified iterator, iterator
+  ///        is notified about the current threshold via 'score_threshold'
+  ///        attribute if any
+  /// @note segments must be collected in the order of their appearance in
+  ///       the index for ties to be resolved consistently
+  //////////////////////////////////////////////////////////////////////////////
+  void collect(const sub_reader& segment, doc_iterator& docs);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief merge documents collected by another collector with the same
+  ///        order and tie breaker, e.g. the one used for another segment
+  /// @note segments unknown to this collector are appended in the order of
+  ///       their appearance in 'other'
+  //////////////////////////////////////////////////////////////////////////////
+  void merge(const top_k_collector& other);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns the score a document has to beat in order to be collected,
+  ///          nullptr if less than 'k' documents have been collected so far
+  ///          or documents are ranked by the segment sort column
+  //////////////////////////////////////////////////////////////////////////////
+  const byte_type* threshold() const NOEXCEPT {
+    return heap_.size() < k_ || !k_ || comparator_
+      ? nullptr
+      : score(heap_.front());
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief visit collected documents, the best document first
+  /// @note further collection is not allowed until 'clear()' is called
+  //////////////////////////////////////////////////////////////////////////////
+  template<typename Visitor>
+  bool visit(const Visitor& visitor) {
+    finish();
+
+    for (auto slot : heap_) {
+      const entry doc{ segments_[slots_[slot].segment].reader, slots_[slot].doc, score(slot) };
+
+      if (!visitor(doc)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief reset collector to the initial state, allocated memory is reused
+  //////////////////////////////////////////////////////////////////////////////
+  void clear() NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns order used by the collector
+  //////////////////////////////////////////////////////////////////////////////
+  const order::prepared& ord() const NOEXCEPT { return *ord_; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns max number of documents to collect
+  //////////////////////////////////////////////////////////////////////////////
+  size_t k() const NOEXCEPT { return k_; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns name of the tie breaker column, empty if not specified
+  //////////////////////////////////////////////////////////////////////////////
+  const std::string& tie_breaker() const NOEXCEPT { return tie_breaker_; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns comparer used for ranking by the segment sort column,
+  ///          nullptr if documents are ranked by their scores
+  //////////////////////////////////////////////////////////////////////////////
+  const comparer* comparator() const NOEXCEPT { return comparator_; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns number of collected documents
+  //////////////////////////////////////////////////////////////////////////////
+  size_t size() const NOEXCEPT { return heap_.size(); }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns total number of evaluated documents
+  /// @note may be less than the number of matched documents if iterators
+  ///       skip documents unable to beat the threshold or collection
+  ///       of a sorted segment was terminated early
+  //////////////////////////////////////////////////////////////////////////////
+  size_t hits() const NOEXCEPT { return hits_; }
+
+ private:
+  struct slot {
+    size_t segment; // offset in 'segments_'
+    doc_id_t doc;
+  }; // slot
+
+  struct segment {
+    const sub_reader* reader;
+    columnstore_reader::values_reader_f values; // tie breaker/sort values
+    bool sorted; // segment is sorted by 'comparator_'
+  }; // segment
+
+  size_t add_segment(const sub_reader& reader);
+
+  bool less(
+    const byte_type* lhs_score, size_t lhs_segment, doc_id_t lhs_doc,
+    const byte_type* rhs_score, size_t rhs_segment, doc_id_t rhs_doc
+  ) const;
+
+  bool less(size_t lhs, size_t rhs) const {
+    return less(
+      score(lhs), slots_[lhs].segment, slots_[lhs].doc,
+      score(rhs), slots_[rhs].segment, slots_[rhs].doc
+    );
+  }
+
+  bool competitive(size_t segment, doc_id_t doc) const;
+
+  void push(const byte_type* score, size_t segment, doc_id_t doc);
+
+  void finish();
+
+  const byte_type* score(size_t slot) const NOEXCEPT {
+    return scores_.c_str() + slot*ord_->size();
+  }
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  const order::prepared* ord_;
+  size_t k_;
+  std::string tie_breaker_;
+  const comparer* comparator_{};
+  bstring scores_; // k_ * ord_->size() bytes
+  std::vector<slot> slots_; // k_ slots
+  std::vector<size_t> heap_; // slot offsets, the worst document on top
+  std::vector<segment> segments_;
+  bstring no_score_; // default score
+  mutable bstring tie_value_; // buffer for the tie breaker/sort value
+  size_t hits_{};
+  bool sorted_{};
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // top_k_collector
+
+NS_END // ROOT
+
+#endif // IRESEARCH_TOP_K_COLLECTOR_H
@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "shared.hpp"
+#include "wildcard_filter.hpp"
+#include "prefix_filter.hpp"
+#include "range_query.hpp"
+#include "analysis/token_attributes.hpp"
+#include "index/index_reader.hpp"
+#include "utils/automaton_utils.hpp"
+
+#include <boost/functional/hash.hpp>
+
+NS_LOCAL
+
+const irs::byte_type WILDCARD_ANY_STRING = '*';
+const irs::byte_type WILDCARD_ANY_CHAR = '?';
+const irs::byte_type WILDCARD_ESCAPE = '\\';
+
+enum class pattern_type {
+  TERM, // no wildcards at all
+  PREFIX, // wildcards are trailing '*' only
+  WILDCARD
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief determines the kind of the pattern
+/// @param literal pattern without escape characters up to the first wildcard
+////////////////////////////////////////////////////////////////////////////////
+pattern_type classify(const irs::bytes_ref& pattern, irs::bstring& literal) {
+  literal.clear();
+
+  for (auto begin = pattern.begin(), end = pattern.end(); begin != end; ++begin) {
+    switch (*begin) {
+      case WILDCARD_ANY_STRING:
+        for (; begin != end && WILDCARD_ANY_STRING == *begin; ++begin) { }
+        return begin == end ? pattern_type::PREFIX : pattern_type::WILDCARD;
+      case WILDCARD_ANY_CHAR:
+        return pattern_type::WILDCARD;
+      case WILDCARD_ESCAPE:
+        if (begin + 1 != end) {
+          ++begin; // trailing escape character is treated literally
+        }
+      // intentional fallthrough
+      default:
+        literal.push_back(*begin);
+    }
+  }
+
+  return pattern_type::TERM;
+}
+
+NS_END
+
+NS_ROOT
+
+automaton from_wildcard(const bytes_ref& pattern) {
+  automaton::builder builder;
+  auto state = builder.add_state();
+
+  for (auto begin = pattern.begin(), end = pattern.end(); begin != end; ++begin) {
+    switch (*begin) {
+      case WILDCARD_ANY_STRING:
+        builder.add_arc(state, state, 0x00, 0xFF);
+        break;
+      case WILDCARD_ANY_CHAR: {
+        const auto next = builder.add_state();
+        builder.add_utf8_arc(state, next);
+        state = next;
+      } break;
+      case WILDCARD_ESCAPE:
+        if (begin + 1 != end) {
+          ++begin; // trailing escape character is treated literally
+        }
+      // intentional fallthrough
+      default: {
+        const auto next = builder.add_state();
+        builder.add_arc(state, next, *begin);
+        state = next;
+      }
+    }
+  }
+
+  builder.final(state);
+
+  return builder.build();
+}
+
+filter::prepared::ptr by_wildcard::prepare(
+    const index_reader& rdr,
+    const order::prepared& ord,
+    boost_t boost,
+    const attribute_view& ctx) const {
+  boost *= this->boost();
+
+  bstring literal;
+
+  // patterns without wildcards or with trailing '*' only are cheaper to
+  // evaluate as a term or a prefix
+  switch (classify(term(), literal)) {
+    case pattern_type::TERM:
+      return by_term().field(field()).term(std::move(literal)).prepare(
+        rdr, ord, boost, ctx
+      );
+    case pattern_type::PREFIX: {
+      by_prefix filter;
+      filter.field(field()).term(std::move(literal));
+      filter.scored_terms_limit(scored_terms_limit_);
+
+      return filter.prepare(rdr, ord, boost, ctx);
+    }
+    case pattern_type::WILDCARD:
+      break;
+  }
+
+  const auto acceptor = from_wildcard(term());
+  limited_sample_scorer scorer(ord.empty() ? 0 : scored_terms_limit_); // object for collecting order stats
+  range_query::states_t states(rdr.size());
+
+  /* iterate over the segments */
+  const string_ref field = this->field();
+  for (const auto& sr : rdr) {
+    /* get term dictionary for field */
+    const term_reader* tr = sr.field(field);
+    if (!tr) {
+      continue;
+    }
+
+    seek_term_iterator::ptr terms = tr->iterator();
+
+    /* get term metadata */
+    auto& meta = terms->attributes().get<term_meta>();
+    range_state* state = nullptr;
+
+    auto visitor = [&](seek_term_iterator& terms) {
+      terms.read();
+
+      if (!state) {
+        /* get state for current segment */
+        state = &states.insert(sr);
+        state->reader = tr;
+        state->min_term = terms.value();
+        state->min_cookie = terms.cookie();
+        state->unscored_docs.reset((type_limits<type_t::doc_id_t>::min)() + sr.docs_count()); // highest valid doc_id in reader
+        state->sparse = true; // matching terms aren't adjacent
+      }
+
+      // fill scoring candidates
+      scorer.collect(meta ? meta->docs_count : 0, state->count, *state, sr, terms);
+      ++state->count;
+
+      /* collect cost */
+      if (meta) {
+        state->estimation += meta->docs_count;
+      }
+    };
+
+    visit(*terms, acceptor, visitor);
+  }
+
+  scorer.score(rdr, ord);
+
+  auto q = memory::make_shared<range_query>(std::move(states));
+
+  // apply boost
+  irs::boost::apply(q->attributes(), boost);
+
+  return q;
+}
+
+DEFINE_FILTER_TYPE(by_wildcard)
+DEFINE_FACTORY_DEFAULT(by_wildcard)
+
+by_wildcard::by_wildcard() NOEXCEPT
+  : by_term(by_wildcard::type()) {
+}
+
+size_t by_wildcard::hash() const NOEXCEPT {
+  size_t seed = 0;
+  ::boost::hash_combine(seed, by_term::hash());
+  ::boost::hash_combine(seed, scored_terms_limit_);
+  return seed;
+}
+
+bool by_wildcard::equals(const filter& rhs) const NOEXCEPT {
+  const auto& trhs = static_cast<const by_wildcard&>(rhs);
+  return by_term::equals(rhs) && scored_terms_limit_ == trhs.scored_terms_limit_;
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
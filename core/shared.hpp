@@ -334,6 +334,20 @@
 #define IRESEARCH_AVX2
 #endif
 
+// kernels compiled for an instruction set regardless of the build flags,
+// must only be called after a corresponding 'cpuinfo' check
+#if defined(__x86_64__) || defined(_M_X64)
+  #define IRESEARCH_SIMD_DISPATCH
+
+  #if defined(_MSC_VER)
+    #define IRESEARCH_TARGET_AVX2
+    #define IRESEARCH_TARGET_AVX512
+  #else
+    #define IRESEARCH_TARGET_AVX2 __attribute__((target("avx2")))
+    #define IRESEARCH_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+  #endif
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 #ifdef IRESEARCH_DEBUG
@@ -101,6 +101,13 @@ struct IRESEARCH_API index_input : public data_input {
   // specified offset without changing current position
   virtual int64_t checksum(size_t offset) const = 0;
 
+  // hints that the specified range is about to be read, so implementations
+  // may start fetching it asynchronously, must not change current position
+  virtual void prefetch(size_t offset, size_t length) NOEXCEPT {
+    UNUSED(offset);
+    UNUSED(length);
+  }
+
  private:
   index_input& operator=( const index_input& ) = delete;
 }; // index_input
@@ -65,8 +65,9 @@ class IRESEARCH_API memory_allocator : public stored_attribute {
 
 //////////////////////////////////////////////////////////////////////////////
 /// @class fd_pool_size
-/// @brief the size of file descriptor pools
-///        where applicable, e.g. fs_directory
+/// @brief the size of file descriptor pools where applicable
+/// @note fs_directory doesn't pool descriptors, all of its inputs share a
+///       single descriptor per opened file
 //////////////////////////////////////////////////////////////////////////////
 struct IRESEARCH_API fd_pool_size: public stored_attribute {
   DECLARE_ATTRIBUTE_TYPE();
@@ -24,6 +24,11 @@
 #include "directory.hpp"
 #include "directory_attributes.hpp"
 #include "directory_cleaner.hpp"
+#include "utils/log.hpp"
+#include "utils/thread_utils.hpp"
+
+#include <algorithm>
+#include <vector>
 
 NS_ROOT
 
@@ -67,4 +72,147 @@ NS_ROOT
   return remove_count;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                      background_directory_cleaner
+// -----------------------------------------------------------------------------
+
+background_directory_cleaner::background_directory_cleaner(
+    directory& dir,
+    uint64_t bytes_per_second,
+    std::chrono::milliseconds interval /*= std::chrono::milliseconds(1000)*/,
+    const directory_cleaner::removal_acceptor_t& acceptor /*= ...*/)
+  : dir_(dir),
+    refs_(directory_cleaner::init(dir)),
+    acceptor_(acceptor),
+    interval_(interval),
+    bytes_per_second_(bytes_per_second),
+    thread_(&background_directory_cleaner::run, this) {
+}
+
+background_directory_cleaner::~background_directory_cleaner() {
+  stop();
+}
+
+void background_directory_cleaner::notify() {
+  SCOPED_LOCK(mutex_);
+  notified_ = true;
+  cond_.notify_all();
+}
+
+void background_directory_cleaner::stop() {
+  {
+    SCOPED_LOCK(mutex_);
+    stopped_ = true;
+    cond_.notify_all();
+  }
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+background_directory_cleaner::stats_t background_directory_cleaner::stats() const {
+  SCOPED_LOCK(mutex_);
+  auto result = stats_;
+  result.pending = queue_.size();
+
+  return result;
+}
+
+void background_directory_cleaner::collect(std::unique_lock<std::mutex>& lock) {
+  std::vector<std::string> candidates;
+
+  lock.unlock();
+
+  try {
+    // only the tracked refs are visited, not the directory itself
+    refs_.visit([this, &candidates](const std::string& name, size_t count)->bool {
+      if (!count && acceptor_(name)) {
+        candidates.emplace_back(name);
+      }
+
+      return true;
+    });
+  } catch (...) {
+    lock.lock();
+    throw;
+  }
+
+  lock.lock();
+
+  for (auto& name : candidates) {
+    if (queued_.emplace(name).second) {
+      queue_.emplace_back(std::move(name));
+    }
+  }
+}
+
+void background_directory_cleaner::run() {
+  auto next = clock_type::now(); // earliest time of the next removal
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (!stopped_) {
+    if (queue_.empty()) {
+      if (!notified_) {
+        cond_.wait_for(lock, interval_);
+      }
+
+      notified_ = false;
+
+      if (!stopped_) {
+        try {
+          collect(lock);
+        } catch (...) {
+          IR_FRMT_ERROR("caught exception while collecting unreferenced files");
+        }
+      }
+
+      continue;
+    }
+
+    // stay within the budget
+    if (clock_type::now() < next) {
+      cond_.wait_until(lock, next);
+      continue; // may have been stopped
+    }
+
+    auto name = std::move(queue_.front());
+    queue_.pop_front();
+    queued_.erase(name);
+    lock.unlock();
+
+    uint64_t length = 0;
+    bool removed = false;
+
+    try {
+      // the file might have been referenced since collection, the ref is
+      // dropped even if the file is missing as done by directory_cleaner
+      refs_.remove_unused(name, [this, &length, &removed](const std::string& name)->bool {
+        if (!dir_.length(length, name)) {
+          length = 0; // e.g. file doesn't exist
+        }
+
+        removed = dir_.remove(name);
+
+        return true;
+      });
+    } catch (...) {
+      IR_FRMT_ERROR("caught exception while removing file '%s'", name.c_str());
+    }
+
+    if (removed && bytes_per_second_) {
+      next = (std::max)(next, clock_type::now()) + std::chrono::duration_cast<clock_type::duration>(
+        std::chrono::duration<double>(double(length) / bytes_per_second_)
+      );
+    }
+
+    lock.lock();
+
+    if (removed) {
+      ++stats_.removed;
+      stats_.reclaimed += length;
+    }
+  }
+}
+
 NS_END
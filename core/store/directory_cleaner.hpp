@@ -24,10 +24,17 @@
 #ifndef IRESEARCH_DIRECTORY_CLEANER_H
 #define IRESEARCH_DIRECTORY_CLEANER_H
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 
 #include "shared.hpp"
 #include "store/directory_attributes.hpp"
+#include "utils/noncopyable.hpp"
 #include "utils/string.hpp"
 
 NS_ROOT
@@ -53,6 +60,68 @@ class IRESEARCH_API directory_cleaner {
   static iresearch::index_file_refs::counter_t& init(directory& dir);
 };
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class background_directory_cleaner
+/// @brief removes directory files without any references on a dedicated
+///        thread, unreferenced files are collected from the tracked refs
+///        (see directory_cleaner::init(...)) periodically or on notify() and
+///        queued, queued files are removed no faster than the configured
+///        number of bytes per second to avoid I/O spikes, e.g. after
+///        consolidation of large segments
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API background_directory_cleaner : private util::noncopyable {
+ public:
+  struct stats_t {
+    size_t removed{}; // number of removed files
+    uint64_t reclaimed{}; // total length of removed files in bytes
+    size_t pending{}; // number of files queued for removal
+  }; // stats_t
+
+  // @param bytes_per_second removal budget, 0 to remove without limits
+  // @param interval period between collections of unreferenced files
+  // @param acceptor returns if removal candidates should actually be removed
+  background_directory_cleaner(
+    directory& dir,
+    uint64_t bytes_per_second,
+    std::chrono::milliseconds interval = std::chrono::milliseconds(1000),
+    const directory_cleaner::removal_acceptor_t& acceptor =
+      [](const std::string&)->bool { return true; }
+  );
+
+  ~background_directory_cleaner();
+
+  // @brief collect unreferenced files without waiting for the next period,
+  //        e.g. after commit or consolidation
+  void notify();
+
+  // @brief stops the cleaner, queued files are left in the directory
+  void stop();
+
+  stats_t stats() const;
+
+ private:
+  typedef std::chrono::steady_clock clock_type;
+
+  void collect(std::unique_lock<std::mutex>& lock);
+  void run();
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  directory& dir_;
+  index_file_refs::counter_t& refs_;
+  directory_cleaner::removal_acceptor_t acceptor_;
+  std::chrono::milliseconds interval_;
+  uint64_t bytes_per_second_;
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<std::string> queue_; // files to remove in order of collection
+  std::unordered_set<std::string> queued_; // files from 'queue_'
+  stats_t stats_;
+  bool notified_{};
+  bool stopped_{};
+  std::thread thread_;
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // background_directory_cleaner
+
 NS_END
 
 #endif
@@ -25,9 +25,9 @@
 #include "directory_attributes.hpp"
 #include "fs_directory.hpp"
 #include "error/error.hpp"
+#include "utils/async_utils.hpp"
 #include "utils/locale_utils.hpp"
 #include "utils/log.hpp"
-#include "utils/object_pool.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/utf8_path.hpp"
 #include "utils/file_utils.hpp"
@@ -66,11 +66,11 @@ inline int get_posix_fadvice(irs::IOAdvice advice) {
     case irs::IOAdvice::RANDOM:
       return IR_FADVICE_RANDOM;
     case irs::IOAdvice::READONCE:
-      return IR_FADVICE_DONTNEED;
+      return IR_FADVICE_NORMAL; // pages are dropped once the file is closed
     case irs::IOAdvice::READONCE_SEQUENTIAL:
-      return IR_FADVICE_SEQUENTIAL | IR_FADVICE_NOREUSE;
+      return IR_FADVICE_SEQUENTIAL;
     case irs::IOAdvice::READONCE_RANDOM:
-      return IR_FADVICE_RANDOM | IR_FADVICE_NOREUSE;
+      return IR_FADVICE_RANDOM;
   }
 
   IR_FRMT_ERROR(
@@ -248,14 +248,15 @@ class fs_index_output : public buffered_index_output {
 
 //////////////////////////////////////////////////////////////////////////////
 /// @class fs_index_input
+/// @brief reads the file with positional reads, so every clone shares the
+///        same descriptor and carries nothing but its own position
 //////////////////////////////////////////////////////////////////////////////
-class pooled_fs_index_input; // predeclaration used by fs_index_input
 class fs_index_input : public buffered_index_input {
  public:
   using buffered_index_input::read_internal;
 
   virtual int64_t checksum(size_t offset) const override final {
-    const auto begin = handle_->pos;
+    const auto begin = file_pointer();
     const auto end = (std::min)(begin + offset, handle_->size);
 
     crc32c crc;
@@ -263,8 +264,9 @@ class fs_index_input : public buffered_index_input {
 
     for (auto pos = begin; pos < end; ) {
       const auto to_read = (std::min)(end - pos, sizeof buf);
-      pos += const_cast<fs_index_input*>(this)->read_internal(buf, to_read);
+      read(buf, pos, to_read);
       crc.process_bytes(buf, to_read);
+      pos += to_read;
     }
 
     return crc.checksum();
@@ -275,14 +277,23 @@ class fs_index_input : public buffered_index_input {
   }
 
   static index_input::ptr open(
-    const file_path_t name, size_t pool_size, IOAdvice /*advice*/
+    const file_path_t name,
+    IOAdvice advice,
+    bool prefetch,
+    async_utils::thread_pool* prefetch_pool
   ) NOEXCEPT {
-    // FIXME honor IOAdvice
     // FIXME On Windows use FILE_FLAG_SEQUENTIAL_SCAN in CreateFile
 
     assert(name);
 
-    auto handle = file_handle::make();
+    file_handle::ptr handle;
+
+    try {
+      handle = file_handle::make();
+    } catch (...) {
+      IR_LOG_EXCEPTION();
+      return nullptr;
+    }
 
     handle->handle = file_open(name, "rb");
 
@@ -300,9 +311,11 @@ class fs_index_input : public buffered_index_input {
     }
 
     // convert file descriptor to POSIX
+    handle->fd = file_no(handle->handle.get());
+
     uint64_t size;
 
-    if (!file_utils::byte_size(size, file_no(*handle))) {
+    if (!file_utils::byte_size(size, handle->fd)) {
       typedef std::remove_pointer<file_path_t>::type char_t;
       auto locale = irs::locale_utils::locale(irs::string_ref::NIL, "utf8", true); // utf8 internal and external
       std::string path;
@@ -321,14 +334,31 @@ class fs_index_input : public buffered_index_input {
     }
 
     handle->size = size;
+    handle->prefetch = prefetch;
+    handle->prefetch_pool = prefetch_pool;
+
+#if !defined(__APPLE__)
+    const int padvice = get_posix_fadvice(advice);
+
+    if (IR_FADVICE_NORMAL != padvice) {
+      const int err = file_utils::fadvise(handle->fd, 0, 0, padvice);
+
+      if (err) {
+        IR_FRMT_ERROR("Failed to fadvise input file, path: " IR_FILEPATH_SPECIFIER ", error %d", name, err);
+      }
+    }
+
+    handle->dontneed = bool(advice & IOAdvice::READONCE);
+#else
+    UNUSED(advice);
+#endif
 
     const auto buf_size = ::buffer_size(handle->handle.get());
 
     try {
       return fs_index_input::make<fs_index_input>(
         std::move(handle),
-        buf_size,
-        pool_size
+        buf_size
       );
     } catch(...) {
       IR_LOG_EXCEPTION();
@@ -341,7 +371,30 @@ class fs_index_input : public buffered_index_input {
     return handle_->size;
   }
 
-  virtual ptr reopen() const override;
+  // positional reads don't touch the descriptor state, so the shared
+  // descriptor is safe to use from any number of threads
+  virtual ptr reopen() const override {
+    return dup();
+  }
+
+  // the kernel reads the range into the page cache in background,
+  // or the prefetch pool does if specified
+  virtual void prefetch(size_t offset, size_t length) NOEXCEPT override {
+    if (!handle_->prefetch || offset >= handle_->size) {
+      return;
+    }
+
+    length = (std::min)(length, handle_->size - offset);
+
+    if (handle_->prefetch_pool) {
+      prefetch_pooled(offset, length);
+      return;
+    }
+
+#if !defined(__APPLE__)
+    file_utils::fadvise(handle_->fd, offset, length, IR_FADVICE_WILLNEED);
+#endif
+  }
 
  protected:
   virtual void seek_internal(size_t pos) override {
@@ -357,68 +410,40 @@ class fs_index_input : public buffered_index_input {
 
   virtual size_t read_internal(byte_type* b, size_t len) override {
     assert(b);
-    assert(handle_->handle);
-
-    FILE* stream = *handle_;
-
-    if (handle_->pos != pos_) {
-      if (fseek(stream, static_cast<long>(pos_), SEEK_SET) != 0) {
-        throw io_error(string_utils::to_string(
-          "failed to seek to '" IR_SIZE_T_SPECIFIER "' for input file, error '%d'",
-          pos_, ferror(stream)
-        ));
-      }
-
-      handle_->pos = pos_;
-    }
 
-    size_t read = fread_unlocked(b, sizeof(byte_type), len, stream);
-    pos_ = handle_->pos += read;
-
-    if (read != len) {
-      if (feof_unlocked(stream)) {
-        //eof(true);
-        // read past eof
-        throw eof_error();
-      }
-
-      // read error
-      throw io_error(string_utils::to_string(
-        "failed to read from input file, read '" IR_SIZE_T_SPECIFIER "' out of '" IR_SIZE_T_SPECIFIER "' bytes, error '%d'",
-        read, len, ferror(stream)
-      ));
-    }
+    read(b, pos_, len);
+    pos_ += len;
 
-    assert(handle_->pos == pos_);
-    return read;
+    return len;
   }
 
  private:
-  friend pooled_fs_index_input;
-
-  /* use shared wrapper here since we don't want to
-  * call "ftell" every time we need to know current 
-  * position */
   struct file_handle {
     DECLARE_SHARED_PTR(file_handle);
     DECLARE_FACTORY();
 
-    operator FILE*() const { return handle.get(); }
+    ~file_handle() {
+#if !defined(__APPLE__)
+      if (dontneed && handle) {
+        // drop the pages of the file read only once from the page cache
+        file_utils::fadvise(fd, 0, 0, IR_FADVICE_DONTNEED);
+      }
+#endif
+    }
 
-    file_utils::handle_t handle; /* native file handle */
-    size_t size{}; /* file size */
-    size_t pos{}; /* current file position*/
+    file_utils::handle_t handle; // native file handle
+    int fd{ -1 }; // POSIX descriptor of 'handle'
+    size_t size{}; // file size
+    bool dontneed{}; // file is read only once
+    bool prefetch{}; // honor prefetch hints
+    async_utils::thread_pool* prefetch_pool{}; // pool reading hinted ranges
   }; // file_handle
 
   DEFINE_FACTORY_INLINE(index_input)
 
-  fs_index_input(
-      file_handle::ptr&& handle,
-      size_t buffer_size,
-      size_t pool_size) NOEXCEPT
+  fs_index_input(file_handle::ptr&& handle, size_t buffer_size) NOEXCEPT
     : buffered_index_input(buffer_size),
       handle_(std::move(handle)),
-      pool_size_(pool_size),
       pos_(0) {
     assert(handle_);
   }
@@ -426,94 +451,74 @@ class fs_index_input : public buffered_index_input {
   fs_index_input(const fs_index_input&) = default;
   fs_index_input& operator=(const fs_index_input&) = delete;
 
-  file_handle::ptr handle_; // shared file handle
-  size_t pool_size_; // size of pool for instances of pooled_fs_index_input
-  size_t pos_; // current input stream position
-}; // fs_index_input
-
-DEFINE_FACTORY_DEFAULT(fs_index_input::file_handle)
-
-class pooled_fs_index_input final : public fs_index_input {
- public:
-  DECLARE_UNIQUE_PTR(pooled_fs_index_input); // allow private construction
-
-  explicit pooled_fs_index_input(const fs_index_input& in);
-  virtual ~pooled_fs_index_input() NOEXCEPT;
-  virtual index_input::ptr dup() const override {
-    return index_input::make<pooled_fs_index_input>(*this);
-  }
-  virtual index_input::ptr reopen() const override;
-
- private:
-  typedef unbounded_object_pool<file_handle> fd_pool_t;
-  std::shared_ptr<fd_pool_t> fd_pool_;
-
-  pooled_fs_index_input(const pooled_fs_index_input& in) = default;
-  file_handle::ptr reopen(const file_handle& src) const;
-}; // pooled_fs_index_input
+  // reads exactly 'len' bytes at 'pos' or throws
+  void read(byte_type* b, size_t pos, size_t len) const {
+    assert(handle_->handle);
 
-index_input::ptr fs_index_input::reopen() const {
-  return index_input::make<pooled_fs_index_input>(*this);
-}
+    // positional reads may legitimately return fewer bytes than requested
+    for (size_t read = 0; read < len; ) {
+      const auto chunk = file_utils::read_at(
+        handle_->fd, pos + read, b + read, len - read
+      );
 
-pooled_fs_index_input::pooled_fs_index_input(const fs_index_input& in)
-  : fs_index_input(in),
-    fd_pool_(memory::make_shared<fd_pool_t>(pool_size_)) {
-  handle_ = reopen(*handle_);
-}
+      if (chunk < 0) {
+        throw io_error(string_utils::to_string(
+          "failed to read from input file, read '" IR_SIZE_T_SPECIFIER "' out of '" IR_SIZE_T_SPECIFIER "' bytes, error '%d'",
+          read, len, errno
+        ));
+      }
 
-pooled_fs_index_input::~pooled_fs_index_input() NOEXCEPT {
-  handle_.reset(); // release handle before the fs_pool_ is deallocated
-}
+      if (!chunk) {
+        // read past eof
+        throw eof_error();
+      }
 
-index_input::ptr pooled_fs_index_input::reopen() const {
-  auto ptr = dup();
-  assert(ptr);
+      read += size_t(chunk);
+    }
+  }
 
-  auto& in = static_cast<pooled_fs_index_input&>(*ptr);
-  in.handle_ = reopen(*handle_); // reserve a new handle from pool
-  assert(in.handle_ && in.handle_->handle);
+  // reads the range on the prefetch pool, which populates the page cache
+  void prefetch_pooled(size_t offset, size_t length) NOEXCEPT {
+    auto handle = handle_; // keeps the descriptor open until the task is done
 
-  return ptr;
-}
+    try {
+      handle_->prefetch_pool->run([handle, offset, length]()->void {
+        byte_type buf[16384];
 
-fs_index_input::file_handle::ptr pooled_fs_index_input::reopen(
-  const file_handle& src
-) const {
-  // reserve a new handle from the pool
-  auto handle = const_cast<pooled_fs_index_input*>(this)->fd_pool_->emplace().release();
+        for (size_t read = 0; read < length; ) {
+          const auto chunk = file_utils::read_at(
+            handle->fd, offset + read, buf, (std::min)(sizeof buf, length - read)
+          );
 
-  if (!handle->handle) {
-    handle->handle = file_open(src, "rb"); // same permission as in fs_index_input::open(...)
+          if (chunk <= 0) {
+            return; // just a hint, the reader reports errors if any
+          }
 
-    if (!handle->handle) {
-      // even win32 uses 'errno' for error codes in calls to file_open(...)
-      throw io_error(string_utils::to_string(
-        "Failed to reopen input file, error: %d", errno
-      ));
+          read += size_t(chunk);
+        }
+      });
+    } catch (...) {
+      // just a hint
     }
   }
 
-  const auto pos = ::ftell(handle->handle.get()); // match position of file descriptor
-
-  if (pos < 0) {
-    throw io_error(string_utils::to_string(
-      "Failed to obtain currnt position of input file, error: %d", errno
-    ));
-  }
-
-  handle->pos = pos;
-  handle->size = src.size;
+  file_handle::ptr handle_; // shared file handle
+  size_t pos_; // current input stream position
+}; // fs_index_input
 
-  return handle;
-}
+DEFINE_FACTORY_DEFAULT(fs_index_input::file_handle)
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                       fs_directory implementation
 // -----------------------------------------------------------------------------
 
-fs_directory::fs_directory(const std::string& dir)
-  : dir_(dir) {
+fs_directory::fs_directory(
+    const std::string& dir,
+    bool prefetch /*= false*/,
+    async_utils::thread_pool* prefetch_pool /*= nullptr*/)
+  : dir_(dir),
+    prefetch_(prefetch),
+    prefetch_pool_(prefetch_pool) {
 }
 
 attribute_store& fs_directory::attributes() NOEXCEPT {
@@ -585,12 +590,10 @@ index_input::ptr fs_directory::open(
     IOAdvice advice) const NOEXCEPT {
   try {
     utf8_path path;
-    auto pool_size =
-      const_cast<attribute_store&>(attributes()).emplace<fd_pool_size>()->size;
 
     (path/=dir_)/=name;
 
-    return fs_index_input::open(path.c_str(), pool_size, advice);
+    return fs_index_input::open(path.c_str(), advice, prefetch_, prefetch_pool_);
   } catch(...) {
     IR_LOG_EXCEPTION();
   }
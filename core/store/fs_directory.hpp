@@ -30,12 +30,30 @@
 
 NS_ROOT
 
+NS_BEGIN(async_utils)
+class thread_pool;
+NS_END // async_utils
+
 //////////////////////////////////////////////////////////////////////////////
 /// @class fs_directory
 //////////////////////////////////////////////////////////////////////////////
 class IRESEARCH_API fs_directory : public directory {
  public:
-  explicit fs_directory(const std::string& dir);
+  //////////////////////////////////////////////////////////////////////////////
+  /// @param prefetch honor index_input::prefetch(...) hints of the readers,
+  ///        worth a syscall per hint only if the index isn't expected to be
+  ///        in the page cache, otherwise hints are ignored
+  /// @param prefetch_pool if specified, hinted ranges are read into the page
+  ///        cache by the pool instead of posix_fadvise(...), e.g. on platforms
+  ///        without it, the pool must outlive the directory and its inputs
+  /// @note there is no io_uring based implementation, for buffered reads
+  ///       POSIX_FADV_WILLNEED already queues asynchronous kernel readahead
+  //////////////////////////////////////////////////////////////////////////////
+  explicit fs_directory(
+    const std::string& dir,
+    bool prefetch = false,
+    async_utils::thread_pool* prefetch_pool = nullptr
+  );
 
   using directory::attributes;
 
@@ -45,6 +63,8 @@ class IRESEARCH_API fs_directory : public directory {
 
   const std::string& directory() const NOEXCEPT;
 
+  bool prefetch() const NOEXCEPT { return prefetch_; }
+
   virtual bool exists(
     bool& result, const std::string& name
   ) const NOEXCEPT override;
@@ -78,6 +98,8 @@ class IRESEARCH_API fs_directory : public directory {
   IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
   attribute_store attributes_;
   std::string dir_;
+  bool prefetch_;
+  async_utils::thread_pool* prefetch_pool_;
   IRESEARCH_API_PRIVATE_VARIABLES_END
 }; // fs_directory
 
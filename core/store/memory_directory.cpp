@@ -167,6 +167,28 @@ size_t memory_index_input::length() const {
   return file_->length();
 }
 
+bytes_ref memory_index_input::read_view(size_t size) {
+  if (!size) {
+    return bytes_ref::EMPTY;
+  }
+
+  if (begin_ >= end_) {
+    if (eof()) {
+      return bytes_ref::NIL;
+    }
+    switch_buffer(file_pointer());
+  }
+
+  if (remain() < size) {
+    return bytes_ref::NIL; // range spans multiple buffers
+  }
+
+  const bytes_ref view(begin_, size);
+  begin_ += size;
+
+  return view;
+}
+
 size_t memory_index_input::file_pointer() const {
   return start_ + std::distance(buf_, begin_);
 }
@@ -387,10 +409,20 @@ memory_directory::memory_directory(size_t pool_size /* = 0*/) {
 }
 
 memory_directory::~memory_directory() NOEXCEPT {
-  async_utils::read_write_mutex::write_mutex mutex(flock_);
-  SCOPED_LOCK(mutex);
+  for (auto& stripe : stripes_) {
+    async_utils::read_write_mutex::write_mutex mutex(stripe.mutex);
+    SCOPED_LOCK(mutex);
 
-  files_.clear();
+    stripe.files.clear();
+  }
+}
+
+memory_directory::stripe& memory_directory::get_stripe(
+    const std::string& name
+) const NOEXCEPT {
+  // use a hash function distinct from the one of 'file_map' to avoid
+  // correlation between stripes and hash table buckets
+  return stripes_[hash_utils::hash(string_ref(name)) & (NUM_STRIPES - 1)];
 }
 
 attribute_store& memory_directory::attributes() NOEXCEPT {
@@ -400,20 +432,22 @@ attribute_store& memory_directory::attributes() NOEXCEPT {
 bool memory_directory::exists(
   bool& result, const std::string& name
 ) const NOEXCEPT {
-  async_utils::read_write_mutex::read_mutex mutex(flock_);
+  auto& stripe = get_stripe(name);
+  async_utils::read_write_mutex::read_mutex mutex(stripe.mutex);
   SCOPED_LOCK(mutex);
 
-  result = files_.find(name) != files_.end();
+  result = stripe.files.find(name) != stripe.files.end();
 
   return true;
 }
 
 index_output::ptr memory_directory::create(const std::string& name) NOEXCEPT {
   try {
-    async_utils::read_write_mutex::write_mutex mutex(flock_);
+    auto& stripe = get_stripe(name);
+    async_utils::read_write_mutex::write_mutex mutex(stripe.mutex);
     SCOPED_LOCK(mutex);
 
-    auto res = files_.emplace(
+    auto res = stripe.files.emplace(
       std::piecewise_construct,
       std::forward_as_tuple(name),
       std::forward_as_tuple()
@@ -438,12 +472,13 @@ index_output::ptr memory_directory::create(const std::string& name) NOEXCEPT {
 bool memory_directory::length(
     uint64_t& result, const std::string& name
 ) const NOEXCEPT {
-  async_utils::read_write_mutex::read_mutex mutex(flock_);
+  auto& stripe = get_stripe(name);
+  async_utils::read_write_mutex::read_mutex mutex(stripe.mutex);
   SCOPED_LOCK(mutex);
 
-  const auto it = files_.find(name);
+  const auto it = stripe.files.find(name);
 
-  if (it == files_.end()) {
+  if (it == stripe.files.end()) {
     return false;
   }
 
@@ -465,16 +500,50 @@ index_lock::ptr memory_directory::make_lock(
   return nullptr;
 }
 
+bool memory_directory::memory(
+    uint64_t& result, const std::string& name
+) const NOEXCEPT {
+  auto& stripe = get_stripe(name);
+  async_utils::read_write_mutex::read_mutex mutex(stripe.mutex);
+  SCOPED_LOCK(mutex);
+
+  const auto it = stripe.files.find(name);
+
+  if (it == stripe.files.end()) {
+    return false;
+  }
+
+  result = it->second->memory();
+
+  return true;
+}
+
+uint64_t memory_directory::memory() const NOEXCEPT {
+  uint64_t result = 0;
+
+  for (auto& stripe : stripes_) {
+    async_utils::read_write_mutex::read_mutex mutex(stripe.mutex);
+    SCOPED_LOCK(mutex);
+
+    for (auto& entry : stripe.files) {
+      result += entry.second->memory();
+    }
+  }
+
+  return result;
+}
+
 bool memory_directory::mtime(
     std::time_t& result,
     const std::string& name
 ) const NOEXCEPT {
-  async_utils::read_write_mutex::read_mutex mutex(flock_);
+  auto& stripe = get_stripe(name);
+  async_utils::read_write_mutex::read_mutex mutex(stripe.mutex);
   SCOPED_LOCK(mutex);
 
-  const auto it = files_.find(name);
+  const auto it = stripe.files.find(name);
 
-  if (it == files_.end()) {
+  if (it == stripe.files.end()) {
     return false;
   }
 
@@ -488,12 +557,13 @@ index_input::ptr memory_directory::open(
     IOAdvice /*advice*/
 ) const NOEXCEPT {
   try {
-    async_utils::read_write_mutex::read_mutex mutex(flock_);
+    auto& stripe = get_stripe(name);
+    async_utils::read_write_mutex::read_mutex mutex(stripe.mutex);
     SCOPED_LOCK(mutex);
 
-    const auto it = files_.find(name);
+    const auto it = stripe.files.find(name);
 
-    if (it != files_.end()) {
+    if (it != stripe.files.end()) {
       return index_input::make<memory_index_input>(*it->second);
     }
 
@@ -509,10 +579,11 @@ index_input::ptr memory_directory::open(
 
 bool memory_directory::remove(const std::string& name) NOEXCEPT {
   try {
-    async_utils::read_write_mutex::write_mutex mutex(flock_);
+    auto& stripe = get_stripe(name);
+    async_utils::read_write_mutex::write_mutex mutex(stripe.mutex);
     SCOPED_LOCK(mutex);
 
-    return files_.erase(name) > 0;
+    return stripe.files.erase(name) > 0;
   } catch (...) {
     IR_LOG_EXCEPTION();
   }
@@ -524,18 +595,32 @@ bool memory_directory::rename(
     const std::string& src, const std::string& dst
 ) NOEXCEPT {
   try {
-    async_utils::read_write_mutex::write_mutex mutex(flock_);
-    SCOPED_LOCK(mutex);
+    auto& src_stripe = get_stripe(src);
+    auto& dst_stripe = get_stripe(dst);
+
+    // always lock stripes in the same order to avoid deadlocks between
+    // concurrent renames
+    auto* first = std::min(&src_stripe, &dst_stripe);
+    auto* second = std::max(&src_stripe, &dst_stripe);
+
+    async_utils::read_write_mutex::write_mutex first_mutex(first->mutex);
+    SCOPED_LOCK(first_mutex);
+    async_utils::read_write_mutex::write_mutex second_mutex(second->mutex);
+    std::unique_lock<decltype(second_mutex)> second_lock(second_mutex, std::defer_lock);
+
+    if (first != second) {
+      second_lock.lock();
+    }
 
-    auto it = files_.find(src);
+    auto it = src_stripe.files.find(src);
 
-    if (it == files_.end()) {
+    if (it == src_stripe.files.end()) {
       return false;
     }
 
-    files_.erase(dst); // emplace() will not overwrite as per spec
-    files_.emplace(dst, std::move(it->second));
-    files_.erase(it);
+    dst_stripe.files.erase(dst); // emplace() will not overwrite as per spec
+    dst_stripe.files.emplace(dst, std::move(it->second));
+    src_stripe.files.erase(it);
 
     return true;
   } catch (...) {
@@ -554,13 +639,13 @@ bool memory_directory::visit(const directory::visitor_f& visitor) const {
 
   // take a snapshot of existing files in directory
   // to avoid potential recursive read locks in visitor
-  {
-    async_utils::read_write_mutex::read_mutex mutex(flock_);
+  for (auto& stripe : stripes_) {
+    async_utils::read_write_mutex::read_mutex mutex(stripe.mutex);
     SCOPED_LOCK(mutex);
 
-    files.reserve(files_.size());
+    files.reserve(files.size() + stripe.files.size());
 
-    for (auto& entry : files_) {
+    for (auto& entry : stripe.files) {
       files.emplace_back(entry.first);
     }
   }
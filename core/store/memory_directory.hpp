@@ -30,6 +30,7 @@
 #include "utils/string.hpp"
 #include "utils/async_utils.hpp"
 
+#include <atomic>
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
@@ -65,7 +66,8 @@ class IRESEARCH_API memory_file
   memory_file(memory_file&& rhs) NOEXCEPT
     : raw_block_vector_t(std::move(rhs)),
       meta_(rhs.meta_),
-      len_(rhs.len_) {
+      len_(rhs.len_),
+      memory_(rhs.memory_.exchange(0)) {
     rhs.len_ = 0;
   }
 
@@ -112,6 +114,26 @@ class IRESEARCH_API memory_file
     return meta_.mtime;
   }
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns total size of the allocated buffers, may exceed length()
+  /// @note safe to call while the file is being written to
+  //////////////////////////////////////////////////////////////////////////////
+  size_t memory() const NOEXCEPT {
+    return memory_.load(std::memory_order_relaxed);
+  }
+
+  buffer_t& push_buffer() {
+    auto& buf = raw_block_vector_t::push_buffer();
+    memory_.fetch_add(buf.size, std::memory_order_relaxed);
+    return buf;
+  }
+
+  void pop_buffer() {
+    assert(!empty());
+    memory_.fetch_sub(get_buffer(buffer_count() - 1).size, std::memory_order_relaxed);
+    raw_block_vector_t::pop_buffer();
+  }
+
   void reset() NOEXCEPT {
     len_ = 0;
   }
@@ -124,6 +146,7 @@ class IRESEARCH_API memory_file
 
   void clear() NOEXCEPT {
     raw_block_vector_t::clear();
+    memory_.store(0, std::memory_order_relaxed);
     reset();
   }
 
@@ -156,6 +179,7 @@ class IRESEARCH_API memory_file
 
   meta meta_;
   size_t len_{};
+  std::atomic<size_t> memory_{}; // total size of allocated buffers
 }; // memory_file
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -178,6 +202,18 @@ class IRESEARCH_API memory_index_input final : public index_input {
 
   virtual size_t file_pointer() const override;
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief zero-copy read of 'size' bytes starting at the current position
+  /// @returns view of the underlying file buffer and advances the position,
+  ///          or bytes_ref::NIL if the requested range is not contiguous,
+  ///          i.e. spans multiple buffers or reaches past eof(), in which case
+  ///          the position is left intact, callers are expected to check
+  ///          null() and fall back to read_bytes(...), a zero 'size' yields
+  ///          bytes_ref::EMPTY
+  /// @note the view stays valid while the file is alive and not truncated
+  //////////////////////////////////////////////////////////////////////////////
+  bytes_ref read_view(size_t size);
+
   virtual void seek(size_t pos) override;
 
   virtual int32_t read_int() override;
@@ -307,17 +343,38 @@ class IRESEARCH_API memory_directory final : public directory {
 
   virtual bool visit(const visitor_f& visitor) const override;
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief memory occupied by the file denoted by 'name', i.e. the total size
+  ///        of its allocated buffers, which may exceed the file length
+  /// @returns call success
+  //////////////////////////////////////////////////////////////////////////////
+  bool memory(uint64_t& result, const std::string& name) const NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns memory occupied by all files in the directory
+  //////////////////////////////////////////////////////////////////////////////
+  uint64_t memory() const NOEXCEPT;
+
  private:
   friend class single_instance_lock;
   typedef std::unordered_map<std::string, std::unique_ptr<memory_file>> file_map; // unique_ptr because of rename
   typedef std::unordered_set<std::string> lock_map;
 
+  // number of independently locked partitions of the file table (power of 2)
+  static const size_t NUM_STRIPES = 16;
+
+  struct stripe {
+    mutable async_utils::read_write_mutex mutex;
+    file_map files;
+  };
+
+  stripe& get_stripe(const std::string& name) const NOEXCEPT;
+
   IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
   const memory_allocator* alloc_;
-  mutable async_utils::read_write_mutex flock_;
   std::mutex llock_;
   attribute_store attributes_;
-  file_map files_;
+  mutable stripe stripes_[NUM_STRIPES]; // files partitioned by name hash
   lock_map locks_;
   IRESEARCH_API_PRIVATE_VARIABLES_END
 };
@@ -68,7 +68,8 @@ class mmap_index_input : public irs::bytes_ref_input {
  public:
   static irs::index_input::ptr open(
       const file_path_t file,
-      irs::IOAdvice advice) NOEXCEPT {
+      irs::IOAdvice advice,
+      bool prefetch) NOEXCEPT {
     assert(file);
 
     mmap_handle_ptr handle;
@@ -94,7 +95,7 @@ class mmap_index_input : public irs::bytes_ref_input {
     handle->dontneed(bool(advice & irs::IOAdvice::READONCE));
 
     try {
-      return mmap_index_input::make<mmap_index_input>(std::move(handle));
+      return mmap_index_input::make<mmap_index_input>(std::move(handle), prefetch);
     } catch (...) {
       IR_LOG_EXCEPTION();
       return nullptr;
@@ -109,11 +110,21 @@ class mmap_index_input : public irs::bytes_ref_input {
     return dup();
   }
 
+  // pages are faulted in by the kernel in background
+  virtual void prefetch(size_t offset, size_t length) NOEXCEPT override {
+    assert(handle_);
+
+    if (prefetch_) {
+      handle_->advise(offset, length, IR_MADVICE_WILLNEED);
+    }
+  }
+
  private:
   DEFINE_FACTORY_INLINE(index_input)
 
-  mmap_index_input(mmap_handle_ptr&& handle) NOEXCEPT
-    : handle_(std::move(handle)) {
+  mmap_index_input(mmap_handle_ptr&& handle, bool prefetch) NOEXCEPT
+    : handle_(std::move(handle)),
+      prefetch_(prefetch) {
     if (handle_) {
       const auto* begin = reinterpret_cast<irs::byte_type*>(handle_->addr());
       bytes_ref_input::reset(begin, handle_->size());
@@ -122,12 +133,14 @@ class mmap_index_input : public irs::bytes_ref_input {
 
   mmap_index_input(const mmap_index_input& rhs) NOEXCEPT
     : bytes_ref_input(rhs),
-      handle_(rhs.handle_) {
+      handle_(rhs.handle_),
+      prefetch_(rhs.prefetch_) {
   }
 
   mmap_index_input& operator=(const mmap_index_input&) = delete;
 
   mmap_handle_ptr handle_;
+  bool prefetch_; // honor prefetch hints
 }; // mmap_index_input
 
 NS_END // LOCAL
@@ -138,8 +151,10 @@ NS_ROOT
 // --SECTION--                                     mmap_directory implementation
 // -----------------------------------------------------------------------------
 
-mmap_directory::mmap_directory(const std::string& path)
-  : fs_directory(path) {
+mmap_directory::mmap_directory(
+    const std::string& path,
+    bool prefetch /*= false*/)
+  : fs_directory(path, prefetch) {
 }
 
 index_input::ptr mmap_directory::open(
@@ -154,7 +169,70 @@ index_input::ptr mmap_directory::open(
     return nullptr;
   }
 
-  return mmap_index_input::open(path.c_str(), advice);
+  return mmap_index_input::open(path.c_str(), advice, prefetch());
+}
+
+bool mmap_directory::warmup(
+    const std::string& name,
+    bool wait /*= false*/) const NOEXCEPT {
+  utf8_path path;
+
+  try {
+    (path/=directory())/=name;
+  } catch(...) {
+    IR_LOG_EXCEPTION();
+    return false;
+  }
+
+  // pages stay in the page cache after the mapping is gone
+  mmap_handle handle;
+
+  if (!handle.open(path.c_str())) {
+    IR_FRMT_ERROR("Failed to open mmapped input file, path: " IR_FILEPATH_SPECIFIER, path.c_str());
+    return false;
+  }
+
+  if (wait) {
+    handle.touch();
+  } else if (!handle.advise(IR_MADVICE_WILLNEED)) {
+    IR_FRMT_ERROR("Failed to madvise input file, path: " IR_FILEPATH_SPECIFIER ", error %d", path.c_str(), errno);
+    return false;
+  }
+
+  return true;
+}
+
+bool mmap_directory::residency(
+    residency_stats& result,
+    const std::string& name) const NOEXCEPT {
+  utf8_path path;
+
+  try {
+    (path/=directory())/=name;
+  } catch(...) {
+    IR_LOG_EXCEPTION();
+    return false;
+  }
+
+  mmap_handle handle;
+
+  if (!handle.open(path.c_str())) {
+    IR_FRMT_ERROR("Failed to open mmapped input file, path: " IR_FILEPATH_SPECIFIER, path.c_str());
+    return false;
+  }
+
+  size_t resident;
+
+  if (!handle.resident(resident)) {
+    return false;
+  }
+
+  const auto page_size = mmap_utils::page_size();
+
+  result.pages = (handle.size() + page_size - 1) / page_size;
+  result.resident = resident;
+
+  return true;
 }
 
 NS_END // ROOT
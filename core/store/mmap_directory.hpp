@@ -33,12 +33,39 @@ NS_ROOT
 //////////////////////////////////////////////////////////////////////////////
 class IRESEARCH_API mmap_directory : public fs_directory {
  public:
-  explicit mmap_directory(const std::string& dir);
+  ////////////////////////////////////////////////////////////////////////////
+  /// @struct residency_stats
+  /// @brief page cache residency of a file or a set of files
+  ////////////////////////////////////////////////////////////////////////////
+  struct residency_stats {
+    size_t pages{}; // total number of pages
+    size_t resident{}; // number of pages in the page cache
+  }; // residency_stats
+
+  explicit mmap_directory(const std::string& dir, bool prefetch = false);
 
   virtual index_input::ptr open(
     const std::string& name,
     IOAdvice advice
   ) const NOEXCEPT override final;
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief brings the specified file into the page cache ahead of the
+  ///        first query hitting it
+  /// @param wait fault every page in the calling thread and return once the
+  ///        whole file is resident, otherwise return right after asking the
+  ///        kernel for readahead via MADV_WILLNEED
+  ////////////////////////////////////////////////////////////////////////////
+  bool warmup(const std::string& name, bool wait = false) const NOEXCEPT;
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief reports page cache residency of the specified file
+  /// @returns false if the file can't be mapped or residency can't be
+  ///          determined on the current platform
+  ////////////////////////////////////////////////////////////////////////////
+  bool residency(
+    residency_stats& result, const std::string& name
+  ) const NOEXCEPT;
 }; // mmap_directory
 
 NS_END // ROOT
@@ -24,11 +24,66 @@
 #include "shared.hpp"
 #include "store_utils.hpp"
 
+#include "utils/cpuinfo.hpp"
 #include "utils/crc.hpp"
 #include "utils/std.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/memory.hpp"
 
+#ifdef IRESEARCH_SIMD_DISPATCH
+  #include <immintrin.h>
+#endif
+
+NS_LOCAL
+
+void delta_decode(uint32_t* begin, uint32_t* end) NOEXCEPT {
+  std::transform(begin + 1, end, begin, begin + 1, std::plus<uint32_t>());
+}
+
+#ifdef IRESEARCH_SIMD_DISPATCH
+
+IRESEARCH_TARGET_AVX2
+void delta_decode_avx2(uint32_t* begin, uint32_t* end) NOEXCEPT {
+  const auto last = _mm256_set1_epi32(7);
+  auto carry = _mm256_setzero_si256();
+
+  for (; end - begin >= 8; begin += 8) {
+    auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+
+    // prefix sums within 128-bit lanes
+    v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+    v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+
+    // add the last sum of the low lane to the high lane
+    const auto low = _mm256_shuffle_epi32(v, 0xFF);
+    v = _mm256_add_epi32(v, _mm256_permute2x128_si256(low, low, 0x08));
+
+    v = _mm256_add_epi32(v, carry);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(begin), v);
+    carry = _mm256_permutevar8x32_epi32(v, last);
+  }
+
+  for (auto sum = uint32_t(_mm256_cvtsi256_si32(carry)); begin != end; ++begin) {
+    sum = (*begin += sum);
+  }
+}
+
+#endif // IRESEARCH_SIMD_DISPATCH
+
+typedef void(*delta_decode_f)(uint32_t*, uint32_t*);
+
+delta_decode_f delta_decode_kernel() {
+#ifdef IRESEARCH_SIMD_DISPATCH
+  if (irs::cpuinfo::support_avx2()) {
+    return &delta_decode_avx2;
+  }
+#endif
+
+  return &delta_decode;
+}
+
+NS_END
+
 NS_ROOT
 
 // ----------------------------------------------------------------------------
@@ -297,6 +352,23 @@ uint32_t write_block(
 }
 
 NS_END // bitpack
+
+// ----------------------------------------------------------------------------
+// --SECTION--                                      delta encode/decode helpers
+// ----------------------------------------------------------------------------
+
+NS_BEGIN(delta)
+
+void decode(uint32_t* begin, uint32_t* end) {
+  assert(std::distance(begin, end) > 0);
+
+  static const auto kernel = delta_decode_kernel();
+  kernel(begin, end);
+
+  assert(std::is_sorted(begin, end));
+}
+
+NS_END // delta
 NS_END // encode
 
 // ----------------------------------------------------------------------------
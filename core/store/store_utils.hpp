@@ -633,6 +633,10 @@ NS_END
 
 NS_BEGIN(delta)
 
+// decodes delta encoded 32-bit values in-place using the best instruction set
+// supported by the CPU, e.g. document blocks of postings
+IRESEARCH_API void decode(uint32_t* begin, uint32_t* end);
+
 template<typename Iterator>
 inline void decode(Iterator begin, Iterator end) {
   assert(std::distance(begin, end) > 0);
@@ -27,6 +27,8 @@
 #include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <future>
+#include <memory>
 #include <queue>
 #include <thread>
 
@@ -153,6 +155,59 @@ class IRESEARCH_API thread_pool {
   void run();
 }; // thread_pool
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class pooled_task
+/// @brief task executed either by a thread pool or by the thread waiting for
+///        its result, whichever comes first, so that waiting on a saturated
+///        pool never deadlocks
+//////////////////////////////////////////////////////////////////////////////
+class pooled_task : util::noncopyable {
+ public:
+  pooled_task(
+      thread_pool* pool,
+      std::function<bool()>&& fn)
+    : state_(std::make_shared<state>(std::move(fn))),
+      result_(state_->task.get_future()) {
+    if (pool) {
+      auto state = state_;
+
+      // if the pool is not active the task is executed by 'get()'
+      pool->run([state]()->void { state->run(); });
+    }
+  }
+
+  ~pooled_task() {
+    if (result_.valid() && state_->started.exchange(true)) {
+      result_.wait(); // task captures caller's state by reference
+    }
+  }
+
+  // @returns result of the task, rethrows exception thrown by the task
+  bool get() {
+    state_->run();
+    return result_.get();
+  }
+
+ private:
+  struct state {
+    explicit state(std::function<bool()>&& fn)
+      : task(std::move(fn)) {
+    }
+
+    void run() {
+      if (!started.exchange(true)) {
+        task();
+      }
+    }
+
+    std::packaged_task<bool()> task;
+    std::atomic<bool> started{ false };
+  }; // state
+
+  std::shared_ptr<state> state_;
+  std::future<bool> result_;
+}; // pooled_task
+
 NS_END // async_utils
 NS_END // NS_ROOT
 
@@ -0,0 +1,316 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "shared.hpp"
+#include "automaton.hpp"
+
+#include <algorithm>
+#include <map>
+
+NS_ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                         automaton::builder
+// -----------------------------------------------------------------------------
+
+automaton::state_id automaton::builder::add_state(bool final) {
+  states_.emplace_back();
+  states_.back().final = final;
+  return state_id(states_.size() - 1);
+}
+
+void automaton::builder::add_arc(
+    state_id from, state_id to, byte_type min, byte_type max) {
+  assert(from < states_.size() && to < states_.size() && min <= max);
+  states_[from].arcs.push_back(arc{ to, min, max });
+}
+
+void automaton::builder::add_utf8_arc(state_id from, state_id to) {
+  assert(from < states_.size() && to < states_.size());
+
+  auto it = utf8_tails_.find(to);
+
+  if (it == utf8_tails_.end()) {
+    std::array<state_id, 3> tails;
+
+    for (size_t i = 0, size = tails.size(); i < size; ++i) {
+      auto state = add_state();
+      tails[i] = state;
+
+      for (size_t j = 0; j < i; ++j) {
+        const auto next = add_state();
+        add_arc(state, next, 0x80, 0xBF);
+        state = next;
+      }
+
+      add_arc(state, to, 0x80, 0xBF);
+    }
+
+    it = utf8_tails_.emplace(to, tails).first;
+  }
+
+  auto& tails = it->second;
+  add_arc(from, to, 0x00, 0x7F); // single byte
+  add_arc(from, tails[0], 0xC0, 0xDF); // lead byte of 2 byte sequence
+  add_arc(from, tails[1], 0xE0, 0xEF); // lead byte of 3 byte sequence
+  add_arc(from, tails[2], 0xF0, 0xF7); // lead byte of 4 byte sequence
+}
+
+void automaton::builder::add_epsilon(state_id from, state_id to) {
+  assert(from < states_.size() && to < states_.size());
+  states_[from].epsilons.push_back(to);
+}
+
+void automaton::builder::final(state_id state, bool final) {
+  assert(state < states_.size());
+  states_[state].final = final;
+}
+
+automaton automaton::builder::build() const {
+  typedef std::vector<state_id> subset_t;
+
+  automaton dfa;
+
+  if (states_.empty()) {
+    return dfa;
+  }
+
+  std::map<subset_t, state_id> subsets;
+  std::vector<const subset_t*> queue; // subsets by dfa state
+  std::vector<bool> visited(states_.size());
+
+  // adds epsilon closure of 'subset' as a dfa state
+  auto insert = [&](subset_t& subset)->state_id {
+    if (subset.empty()) {
+      return INVALID;
+    }
+
+    for (auto s: subset) {
+      visited[s] = true;
+    }
+
+    for (size_t i = 0; i < subset.size(); ++i) {
+      for (auto to: states_[subset[i]].epsilons) {
+        if (!visited[to]) {
+          visited[to] = true;
+          subset.push_back(to);
+        }
+      }
+    }
+
+    bool final = false;
+
+    for (auto s: subset) {
+      visited[s] = false;
+      final |= states_[s].final;
+    }
+
+    std::sort(subset.begin(), subset.end());
+
+    const auto res = subsets.emplace(std::move(subset), state_id(queue.size()));
+
+    if (res.second) {
+      queue.push_back(&res.first->first);
+      dfa.transitions_.resize(dfa.transitions_.size() + ALPHABET_SIZE, INVALID);
+      dfa.finals_.push_back(final);
+    }
+
+    return res.first->second;
+  };
+
+  subset_t subset{ 0 };
+  dfa.start_ = insert(subset);
+
+  subset_t prev_subset;
+  for (size_t i = 0; i < queue.size(); ++i) {
+    state_id prev_target = INVALID;
+    prev_subset.clear();
+
+    for (size_t label = 0; label < ALPHABET_SIZE; ++label) {
+      subset.clear();
+
+      for (auto s: *queue[i]) {
+        for (auto& arc: states_[s].arcs) {
+          if (arc.min <= label && label <= arc.max) {
+            subset.push_back(arc.to);
+          }
+        }
+      }
+
+      // adjacent labels usually lead to the same subset
+      if (label && subset == prev_subset) {
+        dfa.transitions_[i * ALPHABET_SIZE + label] = prev_target;
+        continue;
+      }
+
+      prev_subset = subset;
+      std::sort(subset.begin(), subset.end());
+      subset.erase(std::unique(subset.begin(), subset.end()), subset.end());
+      prev_target = insert(subset);
+      dfa.transitions_[i * ALPHABET_SIZE + label] = prev_target;
+    }
+  }
+
+  // remove states that can't lead to a final state
+  std::vector<std::vector<state_id>> sources(queue.size());
+
+  for (size_t i = 0, count = dfa.transitions_.size(); i < count; ++i) {
+    const auto to = dfa.transitions_[i];
+
+    if (INVALID != to) {
+      sources[to].push_back(state_id(i / ALPHABET_SIZE));
+    }
+  }
+
+  std::vector<bool> live(queue.size());
+  std::vector<state_id> stack;
+
+  for (size_t i = 0; i < queue.size(); ++i) {
+    if (dfa.finals_[i]) {
+      live[i] = true;
+      stack.push_back(state_id(i));
+    }
+  }
+
+  while (!stack.empty()) {
+    const auto state = stack.back();
+    stack.pop_back();
+
+    for (auto from: sources[state]) {
+      if (!live[from]) {
+        live[from] = true;
+        stack.push_back(from);
+      }
+    }
+  }
+
+  if (!live[dfa.start_]) {
+    return automaton(); // accepts nothing
+  }
+
+  for (auto& to: dfa.transitions_) {
+    if (INVALID != to && !live[to]) {
+      to = INVALID;
+    }
+  }
+
+  return dfa;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  automaton
+// -----------------------------------------------------------------------------
+
+/*static*/ const automaton::state_id automaton::INVALID;
+/*static*/ const size_t automaton::ALPHABET_SIZE;
+
+automaton::state_id automaton::walk(const bytes_ref& term) const NOEXCEPT {
+  auto state = start_;
+
+  for (auto begin = term.begin(), end = term.end();
+       INVALID != state && begin != end;
+       ++begin) {
+    state = next(state, *begin);
+  }
+
+  return state;
+}
+
+void automaton::extend(state_id state, bstring& target) const {
+  std::vector<state_id> visited;
+
+  while (!final(state)) {
+    visited.push_back(state);
+
+    size_t label = 0;
+    while (label < ALPHABET_SIZE && INVALID == next(state, byte_type(label))) {
+      ++label;
+    }
+    assert(label < ALPHABET_SIZE); // every state is live
+
+    target.push_back(byte_type(label));
+    state = next(state, byte_type(label));
+
+    if (visited.end() != std::find(visited.begin(), visited.end(), state)) {
+      break; // a loop, any further string would be a valid bound as well
+    }
+  }
+}
+
+bool automaton::lower_bound(const bytes_ref& term, bstring& target) const {
+  target.clear();
+
+  if (empty()) {
+    return false;
+  }
+
+  // states visited along the longest live prefix of 'term'
+  std::vector<state_id> path;
+  path.reserve(term.size() + 1);
+  path.push_back(start_);
+
+  size_t i = 0;
+  for (; i < term.size(); ++i) {
+    const auto state = next(path.back(), term[i]);
+
+    if (INVALID == state) {
+      break;
+    }
+
+    path.push_back(state);
+  }
+
+  if (i == term.size()) {
+    target.assign(term.c_str(), term.size());
+    extend(path.back(), target);
+    return true;
+  }
+
+  // find the longest prefix of 'term' followed by a greater byte
+  for (;;) {
+    const auto state = path[i];
+
+    for (size_t label = size_t(term[i]) + 1; label < ALPHABET_SIZE; ++label) {
+      const auto to = next(state, byte_type(label));
+
+      if (INVALID != to) {
+        target.assign(term.c_str(), i);
+        target.push_back(byte_type(label));
+        extend(to, target);
+        return true;
+      }
+    }
+
+    if (!i) {
+      return false;
+    }
+
+    --i;
+  }
+}
+
+NS_END
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
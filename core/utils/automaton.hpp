@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_AUTOMATON_H
+#define IRESEARCH_AUTOMATON_H
+
+#include "string.hpp"
+#include "integer.hpp"
+
+#include <array>
+#include <map>
+#include <vector>
+
+NS_ROOT
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class automaton
+/// @brief deterministic finite automaton over bytes, states that can't lead to
+///        a final state are removed, i.e. every reachable state is 'live'
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API automaton {
+ public:
+  typedef uint32_t state_id;
+
+  static const state_id INVALID = integer_traits<state_id>::const_max;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @class builder
+  /// @brief non-deterministic automaton to be converted into 'automaton'
+  //////////////////////////////////////////////////////////////////////////////
+  class IRESEARCH_API builder {
+   public:
+    //////////////////////////////////////////////////////////////////////////
+    /// @brief adds a new state, the first added state is the start state
+    //////////////////////////////////////////////////////////////////////////
+    state_id add_state(bool final = false);
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @brief adds a transition over the bytes in range [min;max]
+    //////////////////////////////////////////////////////////////////////////
+    void add_arc(state_id from, state_id to, byte_type min, byte_type max);
+
+    void add_arc(state_id from, state_id to, byte_type label) {
+      add_arc(from, to, label, label);
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @brief adds transitions over exactly one UTF-8 encoded character
+    //////////////////////////////////////////////////////////////////////////
+    void add_utf8_arc(state_id from, state_id to);
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @brief adds a transition that doesn't consume any input
+    //////////////////////////////////////////////////////////////////////////
+    void add_epsilon(state_id from, state_id to);
+
+    void final(state_id state, bool final = true);
+
+    size_t size() const NOEXCEPT { return states_.size(); }
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @returns deterministic equivalent of the current automaton
+    //////////////////////////////////////////////////////////////////////////
+    automaton build() const;
+
+   private:
+    struct arc {
+      state_id to;
+      byte_type min;
+      byte_type max;
+    };
+
+    struct state {
+      std::vector<arc> arcs;
+      std::vector<state_id> epsilons;
+      bool final{};
+    };
+
+    IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+    std::vector<state> states_;
+    // states expecting 1, 2 or 3 continuation bytes of a UTF-8 character
+    // before reaching the target state, shared by all 'add_utf8_arc' calls
+    std::map<state_id, std::array<state_id, 3>> utf8_tails_;
+    IRESEARCH_API_PRIVATE_VARIABLES_END
+  }; // builder
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief creates an automaton accepting nothing
+  //////////////////////////////////////////////////////////////////////////////
+  automaton() = default;
+
+  bool empty() const NOEXCEPT { return INVALID == start_; }
+
+  state_id start() const NOEXCEPT { return start_; }
+
+  bool final(state_id state) const NOEXCEPT {
+    assert(state < finals_.size());
+    return finals_[state];
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns the state reachable from 'state' over 'label' or INVALID
+  //////////////////////////////////////////////////////////////////////////////
+  state_id next(state_id state, byte_type label) const NOEXCEPT {
+    assert(size_t(state) * ALPHABET_SIZE + label < transitions_.size());
+    return transitions_[size_t(state) * ALPHABET_SIZE + label];
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns the state reachable from the start state over 'term' or INVALID
+  //////////////////////////////////////////////////////////////////////////////
+  state_id walk(const bytes_ref& term) const NOEXCEPT;
+
+  bool accept(const bytes_ref& term) const NOEXCEPT {
+    const auto state = walk(term);
+    return INVALID != state && final(state);
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief finds a string that is not greater than any accepted string
+  ///        greater than or equal to 'term', suitable for seeking in the term
+  ///        dictionary past the terms that can't be accepted
+  /// @returns false if there are no accepted strings greater than 'term'
+  //////////////////////////////////////////////////////////////////////////////
+  bool lower_bound(const bytes_ref& term, bstring& target) const;
+
+ private:
+  static const size_t ALPHABET_SIZE = 256;
+
+  // appends the smallest bytes leading from 'state' towards a final state
+  void extend(state_id state, bstring& target) const;
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  std::vector<state_id> transitions_; // ALPHABET_SIZE transitions per state
+  std::vector<bool> finals_;
+  state_id start_{ INVALID };
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // automaton
+
+NS_END
+
+#endif
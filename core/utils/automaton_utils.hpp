@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_AUTOMATON_UTILS_H
+#define IRESEARCH_AUTOMATON_UTILS_H
+
+#include "automaton.hpp"
+#include "index/iterators.hpp"
+
+NS_ROOT
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief intersects the term dictionary with the specified automaton, i.e.
+///        calls 'visitor' for every term accepted by 'acceptor', the terms
+///        that can't be accepted are skipped by seeking to the next candidate
+///        through the term index rather than iterated one by one
+/// @param visitor called with 'terms' positioned at an accepted term
+////////////////////////////////////////////////////////////////////////////////
+template<typename Visitor>
+void visit(
+    seek_term_iterator& terms,
+    const automaton& acceptor,
+    Visitor& visitor) {
+  bstring target;
+
+  if (!acceptor.lower_bound(bytes_ref::EMPTY, target)
+      || SeekResult::END == terms.seek_ge(target)) {
+    return;
+  }
+
+  for (;;) {
+    const auto state = acceptor.walk(terms.value());
+
+    if (automaton::INVALID != state) {
+      // every term with a live prefix is a candidate, iterate
+      if (acceptor.final(state)) {
+        visitor(terms);
+      }
+
+      if (!terms.next()) {
+        return;
+      }
+    } else if (!acceptor.lower_bound(terms.value(), target)
+               || SeekResult::END == terms.seek_ge(target)) {
+      return;
+    }
+  }
+}
+
+NS_END
+
+#endif
@@ -23,10 +23,24 @@
 
 #include "shared.hpp"
 #include "bit_packing.hpp"
+#include "cpuinfo.hpp"
 
 #include <cassert>
 #include <cstring>
 
+#ifdef IRESEARCH_SIMD_DISPATCH
+  #if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized" // '_mm512_undefined_*' used by AVX-512 intrinsics
+  #endif
+
+  #include <immintrin.h>
+
+  #if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+  #endif
+#endif
+
 NS_LOCAL
 
 #if defined(_MSC_VER)
@@ -553,6 +567,287 @@ MSVC_ONLY(__pragma(warning(push)))
 
 NS_END // NS_LOCAL
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     SIMD kernels
+// -----------------------------------------------------------------------------
+
+#ifdef IRESEARCH_SIMD_DISPATCH
+
+NS_LOCAL
+
+using irs::byte_type;
+
+// SIMD kernels may read up to the specified number of bytes past the end of
+// the encoded block
+const size_t MAX_OVERREAD = 16;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief describes how to unpack a group of 4*'VALUES_PER_LANE' values
+///        encoded with the specified number of bits, each 128-bit lane of a
+///        vector is loaded from its byte offset within the group and values
+///        are extracted from it via byte shuffles followed by shifts
+/// @note a value may span one byte more than fits into a vector element,
+///       that byte is shuffled and shifted separately
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+struct unpack_table {
+  static const uint32_t VALUES_PER_LANE = 16 / sizeof(T);
+  static const uint32_t VALUES = 4*VALUES_PER_LANE;
+
+  ALIGNAS(64) byte_type lo[VALUES*sizeof(T)]; // shuffle control for value bytes
+  ALIGNAS(64) byte_type hi[VALUES*sizeof(T)]; // shuffle control for spilled byte
+  ALIGNAS(64) T lo_shift[VALUES];
+  ALIGNAS(64) T hi_shift[VALUES];
+  uint32_t offset[4]; // byte offsets of lanes within the group
+  bool valid; // every lane fits into 16 bytes
+
+  void init(const uint32_t bits) NOEXCEPT {
+    const uint32_t VALUE_BITS = 8*sizeof(T);
+    const byte_type ZERO = 0x80; // 'pshufb' zeroes the destination byte
+
+    valid = true;
+
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+      const uint32_t lane_bit = lane*VALUES_PER_LANE*bits;
+      offset[lane] = lane_bit / 8;
+
+      for (uint32_t i = 0; i < VALUES_PER_LANE; ++i) {
+        const uint32_t value = lane*VALUES_PER_LANE + i;
+        const uint32_t bit = lane_bit % 8 + i*bits; // relative to the lane
+        const uint32_t first = bit / 8;
+        const uint32_t last = (bit + bits - 1) / 8;
+        auto* value_lo = lo + value*sizeof(T);
+        auto* value_hi = hi + value*sizeof(T);
+
+        valid &= last < 16;
+
+        for (uint32_t j = 0; j < sizeof(T); ++j) {
+          value_lo[j] = first + j <= last ? byte_type(first + j) : ZERO;
+          value_hi[j] = ZERO;
+        }
+
+        if (first + sizeof(T) <= last) {
+          value_hi[0] = byte_type(first + sizeof(T));
+        }
+
+        lo_shift[value] = bit % 8;
+        hi_shift[value] = VALUE_BITS - bit % 8;
+      }
+    }
+  }
+}; // unpack_table
+
+typedef void(*unpack_block32_f)(
+  const uint32_t* RESTRICT in, uint32_t* RESTRICT out,
+  const unpack_table<uint32_t>& table, const uint32_t bits
+);
+
+typedef void(*unpack_block64_f)(
+  const uint64_t* RESTRICT in, uint64_t* RESTRICT out,
+  const unpack_table<uint64_t>& table, const uint32_t bits
+);
+
+IRESEARCH_TARGET_AVX2
+void unpack_block_avx2(
+    const uint32_t* RESTRICT in,
+    uint32_t* RESTRICT out,
+    const unpack_table<uint32_t>& table,
+    const uint32_t bits) NOEXCEPT {
+  const auto lo = _mm256_load_si256(reinterpret_cast<const __m256i*>(table.lo));
+  const auto hi = _mm256_load_si256(reinterpret_cast<const __m256i*>(table.hi));
+  const auto lo_shift = _mm256_load_si256(reinterpret_cast<const __m256i*>(table.lo_shift));
+  const auto hi_shift = _mm256_load_si256(reinterpret_cast<const __m256i*>(table.hi_shift));
+  const auto mask = _mm256_set1_epi32(int(irs::packed::max_value<uint32_t>(bits)));
+  const auto* src = reinterpret_cast<const byte_type*>(in);
+
+  // 8 values occupy 'bits' bytes
+  for (const auto* end = out + irs::packed::BLOCK_SIZE_32; out != end; out += 8, src += bits) {
+    const auto v = _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src))),
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + table.offset[1])), 1
+    );
+
+    const auto values = _mm256_or_si256(
+      _mm256_srlv_epi32(_mm256_shuffle_epi8(v, lo), lo_shift),
+      _mm256_sllv_epi32(_mm256_shuffle_epi8(v, hi), hi_shift)
+    );
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_and_si256(values, mask));
+  }
+}
+
+IRESEARCH_TARGET_AVX2
+void unpack_block_avx2(
+    const uint64_t* RESTRICT in,
+    uint64_t* RESTRICT out,
+    const unpack_table<uint64_t>& table,
+    const uint32_t bits) NOEXCEPT {
+  const auto* ctl_lo = reinterpret_cast<const __m256i*>(table.lo);
+  const auto* ctl_hi = reinterpret_cast<const __m256i*>(table.hi);
+  const auto* ctl_lo_shift = reinterpret_cast<const __m256i*>(table.lo_shift);
+  const auto* ctl_hi_shift = reinterpret_cast<const __m256i*>(table.hi_shift);
+  const __m256i lo[] { _mm256_load_si256(ctl_lo), _mm256_load_si256(ctl_lo + 1) };
+  const __m256i hi[] { _mm256_load_si256(ctl_hi), _mm256_load_si256(ctl_hi + 1) };
+  const __m256i lo_shift[] { _mm256_load_si256(ctl_lo_shift), _mm256_load_si256(ctl_lo_shift + 1) };
+  const __m256i hi_shift[] { _mm256_load_si256(ctl_hi_shift), _mm256_load_si256(ctl_hi_shift + 1) };
+  const auto mask = _mm256_set1_epi64x(int64_t(irs::packed::max_value<uint64_t>(bits)));
+  const auto* src = reinterpret_cast<const byte_type*>(in);
+
+  // 8 values occupy 'bits' bytes
+  for (const auto* end = out + irs::packed::BLOCK_SIZE_64; out != end; src += bits) {
+    for (size_t i = 0; i < 2; ++i, out += 4) {
+      const auto v = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + table.offset[2*i]))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + table.offset[2*i + 1])), 1
+      );
+
+      const auto values = _mm256_or_si256(
+        _mm256_srlv_epi64(_mm256_shuffle_epi8(v, lo[i]), lo_shift[i]),
+        _mm256_sllv_epi64(_mm256_shuffle_epi8(v, hi[i]), hi_shift[i])
+      );
+
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_and_si256(values, mask));
+    }
+  }
+}
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1911 // AVX-512 intrinsics since MSVC2017 15.3
+
+IRESEARCH_TARGET_AVX512
+FORCE_INLINE __m512i load_lanes(
+    const byte_type* src,
+    const uint32_t* offset) NOEXCEPT {
+  auto v = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+  v = _mm512_inserti32x4(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset[1])), 1);
+  v = _mm512_inserti32x4(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset[2])), 2);
+  return _mm512_inserti32x4(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset[3])), 3);
+}
+
+IRESEARCH_TARGET_AVX512
+void unpack_block_avx512(
+    const uint32_t* RESTRICT in,
+    uint32_t* RESTRICT out,
+    const unpack_table<uint32_t>& table,
+    const uint32_t bits) NOEXCEPT {
+  const auto lo = _mm512_load_si512(table.lo);
+  const auto hi = _mm512_load_si512(table.hi);
+  const auto lo_shift = _mm512_load_si512(table.lo_shift);
+  const auto hi_shift = _mm512_load_si512(table.hi_shift);
+  const auto mask = _mm512_set1_epi32(int(irs::packed::max_value<uint32_t>(bits)));
+  const auto* src = reinterpret_cast<const byte_type*>(in);
+
+  // 16 values occupy '2*bits' bytes
+  for (const auto* end = out + irs::packed::BLOCK_SIZE_32; out != end; out += 16, src += 2*bits) {
+    const auto v = load_lanes(src, table.offset);
+
+    const auto values = _mm512_or_si512(
+      _mm512_srlv_epi32(_mm512_shuffle_epi8(v, lo), lo_shift),
+      _mm512_sllv_epi32(_mm512_shuffle_epi8(v, hi), hi_shift)
+    );
+
+    _mm512_storeu_si512(out, _mm512_and_si512(values, mask));
+  }
+}
+
+IRESEARCH_TARGET_AVX512
+void unpack_block_avx512(
+    const uint64_t* RESTRICT in,
+    uint64_t* RESTRICT out,
+    const unpack_table<uint64_t>& table,
+    const uint32_t bits) NOEXCEPT {
+  const auto lo = _mm512_load_si512(table.lo);
+  const auto hi = _mm512_load_si512(table.hi);
+  const auto lo_shift = _mm512_load_si512(table.lo_shift);
+  const auto hi_shift = _mm512_load_si512(table.hi_shift);
+  const auto mask = _mm512_set1_epi64(int64_t(irs::packed::max_value<uint64_t>(bits)));
+  const auto* src = reinterpret_cast<const byte_type*>(in);
+
+  // 8 values occupy 'bits' bytes
+  for (const auto* end = out + irs::packed::BLOCK_SIZE_64; out != end; out += 8, src += bits) {
+    const auto v = load_lanes(src, table.offset);
+
+    const auto values = _mm512_or_si512(
+      _mm512_srlv_epi64(_mm512_shuffle_epi8(v, lo), lo_shift),
+      _mm512_sllv_epi64(_mm512_shuffle_epi8(v, hi), hi_shift)
+    );
+
+    _mm512_storeu_si512(out, _mm512_and_si512(values, mask));
+  }
+}
+
+#define IRESEARCH_SIMD_AVX512
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief kernels chosen for the running CPU, 'nullptr' == scalar version
+////////////////////////////////////////////////////////////////////////////////
+struct unpack_kernels {
+  unpack_kernels() NOEXCEPT {
+    unpack_block32_f kernel32 = nullptr;
+    unpack_block64_f kernel64 = nullptr;
+
+#ifdef IRESEARCH_SIMD_AVX512
+    if (irs::cpuinfo::support_avx512()) {
+      kernel32 = &unpack_block_avx512;
+      kernel64 = &unpack_block_avx512;
+    } else
+#endif
+    if (irs::cpuinfo::support_avx2()) {
+      kernel32 = &unpack_block_avx2;
+      kernel64 = &unpack_block_avx2;
+    }
+
+    // copying is faster than shuffling of full width values
+    for (uint32_t bits = 1; bits < irs::packed::BLOCK_SIZE_32; ++bits) {
+      table32[bits].init(bits);
+      block32[bits] = table32[bits].valid ? kernel32 : nullptr;
+    }
+
+    for (uint32_t bits = 1; bits < irs::packed::BLOCK_SIZE_64; ++bits) {
+      table64[bits].init(bits);
+      block64[bits] = table64[bits].valid ? kernel64 : nullptr;
+    }
+  }
+
+  unpack_table<uint32_t> table32[1 + irs::packed::BLOCK_SIZE_32];
+  unpack_table<uint64_t> table64[1 + irs::packed::BLOCK_SIZE_64];
+  unpack_block32_f block32[1 + irs::packed::BLOCK_SIZE_32]{};
+  unpack_block64_f block64[1 + irs::packed::BLOCK_SIZE_64]{};
+}; // unpack_kernels
+
+const unpack_kernels& kernels() {
+  static const unpack_kernels INSTANCE;
+  return INSTANCE;
+}
+
+template<typename T, typename Kernel>
+void unpack_simd(
+    T* first, T* last,
+    const T* in,
+    const uint32_t bits,
+    Kernel kernel,
+    const unpack_table<T>& table) NOEXCEPT {
+  const size_t BLOCK_SIZE = 8*sizeof(T);
+  const size_t PADDING = MAX_OVERREAD / sizeof(T);
+  const T* end = in + bits*((last - first) / BLOCK_SIZE);
+
+  for (; first < last && size_t(end - in) >= bits + PADDING; first += BLOCK_SIZE, in += bits) {
+    kernel(in, first, table, bits);
+  }
+
+  // trailing blocks are copied to avoid reading past the end of the input
+  for (; first < last; first += BLOCK_SIZE, in += bits) {
+    T buf[BLOCK_SIZE + PADDING]{};
+    std::memcpy(buf, in, sizeof(T)*bits);
+    kernel(buf, first, table, bits);
+  }
+}
+
+NS_END // NS_LOCAL
+
+#endif // IRESEARCH_SIMD_DISPATCH
+
 NS_ROOT
 NS_BEGIN(packed)
 
@@ -819,6 +1114,15 @@ void pack(
 void unpack(
   uint32_t* first, uint32_t* last, const uint32_t* in, const uint32_t bit
 ) NOEXCEPT {
+#ifdef IRESEARCH_SIMD_DISPATCH
+  auto& simd = kernels();
+
+  if (simd.block32[bit]) {
+    unpack_simd(first, last, in, bit, simd.block32[bit], simd.table32[bit]);
+    return;
+  }
+#endif
+
   for (; first < last; first += BLOCK_SIZE_32, in += bit) {
     unpack_block(in, first, bit);
   }
@@ -827,6 +1131,15 @@ void unpack(
 void unpack(
   uint64_t* first, uint64_t* last, const uint64_t* in, const uint32_t bit
 ) NOEXCEPT {
+#ifdef IRESEARCH_SIMD_DISPATCH
+  auto& simd = kernels();
+
+  if (simd.block64[bit]) {
+    unpack_simd(first, last, in, bit, simd.block64[bit], simd.table64[bit]);
+    return;
+  }
+#endif
+
   for (; first < last; first += BLOCK_SIZE_64, in += bit) {
     unpack_block(in, first, bit);
   }
@@ -130,7 +130,7 @@ class dynamic_bitset : public dynamic_bitset_base<Alloc> {
       return false;
     }
 
-    return 0 == std::memcmp(this->begin(), rhs.begin(), this->size());
+    return 0 == std::memcmp(this->begin(), rhs.begin(), sizeof(word_t)*this->words());
   }
 
   bool operator!=(const dynamic_bitset& rhs) const NOEXCEPT {
@@ -25,10 +25,187 @@
 #include "error/error.hpp"
 #include "compression.hpp"
 #include "utils/string_utils.hpp"
+#include "utils/object_pool.hpp"
 #include "utils/type_limits.hpp"
 
 #include <lz4.h>
 
+#include <cstring>
+#include <numeric>
+
+#ifdef IRESEARCH_ZSTD
+  #include <zstd.h>
+  #include <zdict.h>
+#endif
+
+NS_LOCAL
+
+using namespace irs;
+
+const size_t INVALID_SIZE = type_limits<type_t::address_t>::invalid();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                             none
+// -----------------------------------------------------------------------------
+
+class none_compressor final : public compression::compressor {
+ public:
+  virtual bytes_ref compress(const byte_type*, size_t) override {
+    return bytes_ref::NIL; // store as is
+  }
+}; // none_compressor
+
+class none_decompressor final : public compression::decompressor {
+ public:
+  virtual size_t decompress(
+      const byte_type* src, size_t src_size,
+      byte_type* dst, size_t dst_size) const override {
+    if (src_size > dst_size) {
+      return INVALID_SIZE;
+    }
+
+    std::memcpy(dst, src, src_size);
+    return src_size;
+  }
+}; // none_decompressor
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                              lz4
+// -----------------------------------------------------------------------------
+
+class lz4_compressor final : public compression::compressor {
+ public:
+  lz4_compressor() : impl_(0) { }
+
+  virtual bytes_ref compress(const byte_type* src, size_t size) override {
+    impl_.compress(reinterpret_cast<const char*>(src), size);
+    return impl_;
+  }
+
+ private:
+  irs::compressor impl_;
+}; // lz4_compressor
+
+class lz4_decompressor final : public compression::decompressor {
+ public:
+  virtual size_t decompress(
+      const byte_type* src, size_t src_size,
+      byte_type* dst, size_t dst_size) const override {
+    assert(src_size <= integer_traits<int>::const_max); // LZ4 API uses int
+
+    // irs::compressor reloads an empty dictionary before each call, i.e.
+    // blocks are independent and may be decoded without a stream
+    const auto lz4_size = LZ4_decompress_safe(
+      reinterpret_cast<const char*>(src),
+      reinterpret_cast<char*>(dst),
+      static_cast<int>(src_size), // LZ4 API uses int
+      static_cast<int>(std::min(dst_size, static_cast<size_t>(integer_traits<int>::const_max))) // LZ4 API uses int
+    );
+
+    return lz4_size < 0
+      ? INVALID_SIZE // corrupted index
+      : lz4_size;
+  }
+}; // lz4_decompressor
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                             zstd
+// -----------------------------------------------------------------------------
+
+#ifdef IRESEARCH_ZSTD
+
+const int ZSTD_LEVEL = 3; // default level of the zstd command line tool
+
+struct zstd_deleter {
+  void operator()(ZSTD_CCtx* p) NOEXCEPT { ZSTD_freeCCtx(p); }
+  void operator()(ZSTD_CDict* p) NOEXCEPT { ZSTD_freeCDict(p); }
+  void operator()(ZSTD_DCtx* p) NOEXCEPT { ZSTD_freeDCtx(p); }
+  void operator()(ZSTD_DDict* p) NOEXCEPT { ZSTD_freeDDict(p); }
+}; // zstd_deleter
+
+template<typename T>
+std::unique_ptr<T, zstd_deleter> make_zstd(T* p) {
+  if (!p) {
+    throw std::bad_alloc();
+  }
+
+  return std::unique_ptr<T, zstd_deleter>(p);
+}
+
+class zstd_compressor final : public compression::compressor {
+ public:
+  explicit zstd_compressor(const bytes_ref& dict)
+    : ctx_(make_zstd(ZSTD_createCCtx())) {
+    if (!dict.empty()) {
+      dict_ = make_zstd(ZSTD_createCDict(dict.c_str(), dict.size(), ZSTD_LEVEL));
+    }
+  }
+
+  virtual bytes_ref compress(const byte_type* src, size_t size) override {
+    string_utils::oversize(buf_, ZSTD_compressBound(size));
+
+    const auto zstd_size = dict_
+      ? ZSTD_compress_usingCDict(ctx_.get(), &buf_[0], buf_.size(), src, size, dict_.get())
+      : ZSTD_compressCCtx(ctx_.get(), &buf_[0], buf_.size(), src, size, ZSTD_LEVEL);
+
+    if (ZSTD_isError(zstd_size)) {
+      throw index_error(string_utils::to_string(
+        "while compressing, error: %s", ZSTD_getErrorName(zstd_size)
+      ));
+    }
+
+    return bytes_ref(reinterpret_cast<const byte_type*>(buf_.data()), zstd_size);
+  }
+
+ private:
+  std::string buf_;
+  std::unique_ptr<ZSTD_CCtx, zstd_deleter> ctx_;
+  std::unique_ptr<ZSTD_CDict, zstd_deleter> dict_;
+}; // zstd_compressor
+
+class zstd_decompressor final : public compression::decompressor {
+ public:
+  explicit zstd_decompressor(const bytes_ref& dict) {
+    if (!dict.empty()) {
+      dict_ = make_zstd(ZSTD_createDDict(dict.c_str(), dict.size()));
+    }
+  }
+
+  virtual size_t decompress(
+      const byte_type* src, size_t src_size,
+      byte_type* dst, size_t dst_size) const override {
+    auto ctx = contexts().emplace();
+
+    const auto zstd_size = dict_
+      ? ZSTD_decompress_usingDDict(ctx.get(), dst, dst_size, src, src_size, dict_.get())
+      : ZSTD_decompressDCtx(ctx.get(), dst, dst_size, src, src_size);
+
+    return ZSTD_isError(zstd_size)
+      ? INVALID_SIZE // corrupted index
+      : zstd_size;
+  }
+
+ private:
+  // decompression contexts are not bound to a dictionary,
+  // so they are shared among all decompressors
+  struct context {
+    typedef std::unique_ptr<ZSTD_DCtx, zstd_deleter> ptr;
+
+    static ptr make() { return make_zstd(ZSTD_createDCtx()); }
+  }; // context
+
+  static unbounded_object_pool<context>& contexts() {
+    static unbounded_object_pool<context> POOL(16); // arbitrary size
+    return POOL;
+  }
+
+  std::unique_ptr<ZSTD_DDict, zstd_deleter> dict_;
+}; // zstd_decompressor
+
+#endif // IRESEARCH_ZSTD
+
+NS_END
+
 NS_ROOT
 
 void compressor::deleter::operator()(void *p) NOEXCEPT {
@@ -115,4 +292,92 @@ size_t decompressor::deflate(
     : lz4_size;
 }
 
+NS_BEGIN(compression)
+
+bool supported(type codec) NOEXCEPT {
+  switch (codec) {
+    case type::NONE:
+    case type::LZ4:
+      return true;
+#ifdef IRESEARCH_ZSTD
+    case type::ZSTD:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+compressor::ptr get_compressor(type codec, const bytes_ref& dict /*= NIL*/) {
+  UNUSED(dict);
+
+  switch (codec) {
+    case type::NONE:
+      return memory::make_unique<none_compressor>();
+    case type::LZ4:
+      return memory::make_unique<lz4_compressor>();
+#ifdef IRESEARCH_ZSTD
+    case type::ZSTD:
+      return memory::make_unique<zstd_compressor>(dict);
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+decompressor::ptr get_decompressor(type codec, const bytes_ref& dict /*= NIL*/) {
+  UNUSED(dict);
+
+  switch (codec) {
+    case type::NONE: {
+      static none_decompressor INSTANCE; // stateless
+
+      return decompressor::ptr(decompressor::ptr(), &INSTANCE); // aliasing constructor
+    }
+    case type::LZ4: {
+      static lz4_decompressor INSTANCE; // stateless
+
+      return decompressor::ptr(decompressor::ptr(), &INSTANCE); // aliasing constructor
+    }
+#ifdef IRESEARCH_ZSTD
+    case type::ZSTD:
+      return memory::make_shared<zstd_decompressor>(dict);
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+bstring train_dictionary(
+    type codec,
+    const bytes_ref& samples,
+    const std::vector<size_t>& sizes,
+    size_t max_size) {
+#ifdef IRESEARCH_ZSTD
+  if (type::ZSTD == codec && !sizes.empty()) {
+    assert(samples.size() == std::accumulate(sizes.begin(), sizes.end(), size_t(0)));
+
+    bstring dict(max_size, 0);
+    const auto dict_size = ZDICT_trainFromBuffer(
+      &dict[0], dict.size(),
+      samples.c_str(), sizes.data(), static_cast<unsigned>(sizes.size())
+    );
+
+    if (!ZDICT_isError(dict_size)) {
+      dict.resize(dict_size);
+      return dict;
+    }
+  }
+#else
+  UNUSED(codec);
+  UNUSED(samples);
+  UNUSED(sizes);
+  UNUSED(max_size);
+#endif
+
+  return bstring(); // not enough samples or not supported
+}
+
+NS_END // compression
+
 NS_END
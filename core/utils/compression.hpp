@@ -26,8 +26,10 @@
 
 #include "string.hpp"
 #include "noncopyable.hpp"
+#include "memory.hpp"
 
 #include <memory>
+#include <vector>
 
 NS_ROOT
 
@@ -76,6 +78,95 @@ class IRESEARCH_API decompressor {
   IRESEARCH_API_PRIVATE_VARIABLES_END
 }; // decompressor
 
+NS_BEGIN(compression)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @enum type
+/// @brief identifiers of the block codecs, values are persisted in the index
+////////////////////////////////////////////////////////////////////////////////
+enum class type : uint32_t {
+  NONE = 0, // store data as is, e.g. already compressed values
+  LZ4 = 1, // default codec
+  ZSTD = 2, // Zstandard, with a trained dictionary if possible
+}; // type
+
+////////////////////////////////////////////////////////////////////////////////
+/// @returns true if the specified codec is available in the current build
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API bool supported(type codec) NOEXCEPT;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @struct compressor
+////////////////////////////////////////////////////////////////////////////////
+struct IRESEARCH_API compressor : private util::noncopyable {
+  DECLARE_UNIQUE_PTR(compressor);
+
+  virtual ~compressor() = default;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns compressed data valid until the next call,
+  ///          empty reference if the data should be stored as is
+  //////////////////////////////////////////////////////////////////////////////
+  virtual bytes_ref compress(const byte_type* src, size_t size) = 0;
+}; // compressor
+
+////////////////////////////////////////////////////////////////////////////////
+/// @struct decompressor
+/// @note implementations must be safe to use from multiple threads
+////////////////////////////////////////////////////////////////////////////////
+struct IRESEARCH_API decompressor : private util::noncopyable {
+  DECLARE_SHARED_PTR(decompressor);
+
+  virtual ~decompressor() = default;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns number of decompressed bytes,
+  ///          or integer_traits<size_t>::const_max in case of error
+  //////////////////////////////////////////////////////////////////////////////
+  virtual size_t decompress(
+    const byte_type* src, size_t src_size,
+    byte_type* dst, size_t dst_size
+  ) const = 0;
+}; // decompressor
+
+////////////////////////////////////////////////////////////////////////////////
+/// @param dict dictionary to compress the data with, ignored by the codecs
+///        without dictionary support
+/// @returns compressor for the specified codec or nullptr if the codec is not
+///          supported
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API compressor::ptr get_compressor(
+  type codec,
+  const bytes_ref& dict = bytes_ref::NIL
+);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @param dict dictionary the data was compressed with
+/// @returns decompressor for the specified codec or nullptr if the codec is
+///          not supported
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API decompressor::ptr get_decompressor(
+  type codec,
+  const bytes_ref& dict = bytes_ref::NIL
+);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief trains a dictionary on the specified samples
+/// @param samples samples stored one after another
+/// @param sizes sizes of the samples
+/// @param max_size maximum size of the dictionary
+/// @returns empty dictionary if the codec has no dictionary support or
+///          there isn't enough data to train on
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API bstring train_dictionary(
+  type codec,
+  const bytes_ref& samples,
+  const std::vector<size_t>& sizes,
+  size_t max_size
+);
+
+NS_END // compression
+
 NS_END // NS_ROOT
 
 #endif
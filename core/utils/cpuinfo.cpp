@@ -22,20 +22,75 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "cpuinfo.hpp"
+#include "bit_utils.hpp"
 
 #if defined(_MSC_VER)
+  #include <intrin.h>
+#endif
 
-#include "bit_utils.hpp"
+NS_LOCAL
 
-NS_ROOT
+struct cpu_features {
+  cpu_features() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int f1[4];
+    __cpuid(f1, 1);
+
+    // according to https://msdn.microsoft.com/en-us/library/bb385231.aspx
+    popcnt = irs::check_bit<23>(f1[2]);
+
+    // OS must save the extended registers on context switch
+    if (!irs::check_bit<27>(f1[2])) { // OSXSAVE
+      return;
+    }
 
-const cpuinfo cpuinfo::instance_;
+    const auto xcr0 = _xgetbv(0);
+    const bool ymm = 0x6 == (xcr0 & 0x6); // XMM + YMM state
+    const bool zmm = 0xE6 == (xcr0 & 0xE6); // XMM + YMM + opmask + ZMM state
+
+    int f7[4];
+    __cpuidex(f7, 7, 0);
+
+    avx2 = ymm && irs::check_bit<5>(f7[1]);
+    avx512 = zmm && irs::check_bit<16>(f7[1]) && irs::check_bit<30>(f7[1]);
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init(); // may be called before static constructors of libgcc
+    popcnt = __builtin_cpu_supports("popcnt");
+    avx2 = __builtin_cpu_supports("avx2");
+    avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+  }
+
+  bool popcnt{};
+  bool avx2{};
+  bool avx512{};
+}; // cpu_features
+
+// function-local static, since it may be accessed during static
+// initialization of other translation units
+const cpu_features& features() {
+  static const cpu_features INSTANCE;
+  return INSTANCE;
+}
+
+NS_END
+
+NS_ROOT
 
 /*static*/ bool cpuinfo::support_popcnt() {
-  // according to https://msdn.microsoft.com/en-us/library/bb385231.aspx
-  return check_bit<23>(instance_.f1_cpuinfo_[2]);
+  return features().popcnt;
+}
+
+/*static*/ bool cpuinfo::support_avx2() {
+  return features().avx2;
+}
+
+/*static*/ bool cpuinfo::support_avx512() {
+  return features().avx512;
 }
 
 NS_END
 
-#endif
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
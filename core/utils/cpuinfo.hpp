@@ -24,28 +24,32 @@
 #ifndef IRESEARCH_CPUID_ID
 #define IRESEARCH_CPUID_ID
 
-#if defined(_MSC_VER)
-
 #include "shared.hpp"
-#include <intrin.h>
 
 NS_ROOT
 
+////////////////////////////////////////////////////////////////////////////////
+/// @class cpuinfo
+/// @brief capabilities of the CPU the process is running on, used for runtime
+///        dispatch of kernels compiled for an instruction set which isn't
+///        enabled for the whole build
+////////////////////////////////////////////////////////////////////////////////
 class IRESEARCH_API cpuinfo {
  public:
   static bool support_popcnt();
- private:
-  static const cpuinfo instance_;
 
-  cpuinfo() {
-    __cpuid( f1_cpuinfo_, 1 );
-  }
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns true if AVX2 is supported by both the CPU and the OS
+  //////////////////////////////////////////////////////////////////////////////
+  static bool support_avx2();
 
-  int f1_cpuinfo_[4];
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns true if AVX-512F and AVX-512BW are supported by both the CPU
+  ///          and the OS
+  //////////////////////////////////////////////////////////////////////////////
+  static bool support_avx512();
 };
 
 NS_END
 
 #endif
-
-#endif
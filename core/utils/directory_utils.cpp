@@ -248,6 +248,41 @@ directory_cleaner::removal_acceptor_t remove_except_current_segments(
   return std::bind(acceptor, std::placeholders::_1, std::move(retain));
 }
 
+bool warmup(
+    const mmap_directory& dir,
+    const index_meta& meta,
+    const std::function<bool(const std::string& name)>& filter /*= {}*/,
+    bool wait /*= false*/) {
+  return meta.visit_files([&dir, &filter, wait](const std::string& file) {
+    return (filter && !filter(file)) || dir.warmup(file, wait);
+  });
+}
+
+bool residency(
+    mmap_directory::residency_stats& result,
+    const mmap_directory& dir,
+    const index_meta& meta,
+    const std::function<bool(const std::string& name)>& filter /*= {}*/) {
+  result = mmap_directory::residency_stats();
+
+  return meta.visit_files([&result, &dir, &filter](const std::string& file) {
+    if (filter && !filter(file)) {
+      return true;
+    }
+
+    mmap_directory::residency_stats stats;
+
+    if (!dir.residency(stats, file)) {
+      return false;
+    }
+
+    result.pages += stats.pages;
+    result.resident += stats.resident;
+
+    return true;
+  });
+}
+
 NS_END
 
 // -----------------------------------------------------------------------------
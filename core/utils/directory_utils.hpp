@@ -29,6 +29,7 @@
 #include "store/data_output.hpp"
 #include "store/directory.hpp"
 #include "store/directory_cleaner.hpp"
+#include "store/mmap_directory.hpp"
 
 NS_ROOT
 
@@ -98,6 +99,33 @@ IRESEARCH_API directory_cleaner::removal_acceptor_t remove_except_current_segmen
   const directory& dir, const format& codec
 );
 
+// ----------------------------------------------------------------------------
+// --SECTION--                                                     warmup utils
+// ----------------------------------------------------------------------------
+
+// brings files registered with index_meta and accepted by 'filter' (all files
+// if 'filter' is empty) into the page cache, e.g. term indexes and norms of
+// a freshly opened reader, 'wait' has the same meaning as in
+// mmap_directory::warmup(...)
+// return success
+IRESEARCH_API bool warmup(
+  const mmap_directory& dir,
+  const index_meta& meta,
+  const std::function<bool(const std::string& name)>& filter = {},
+  bool wait = false
+);
+
+// sums up page cache residency of files registered with index_meta and
+// accepted by 'filter' (all files if 'filter' is empty), i.e. warmup is
+// complete once 'result.resident' reaches 'result.pages'
+// return success
+IRESEARCH_API bool residency(
+  mmap_directory::residency_stats& result,
+  const mmap_directory& dir,
+  const index_meta& meta,
+  const std::function<bool(const std::string& name)>& filter = {}
+);
+
 NS_END
 
 //////////////////////////////////////////////////////////////////////////////
@@ -200,6 +200,10 @@ class IRESEARCH_API encrypted_input : public buffered_index_input, util::noncopy
 
   virtual int64_t checksum(size_t offset) const override final;
 
+  virtual void prefetch(size_t offset, size_t length) NOEXCEPT override final {
+    in_->prefetch(start_ + offset, length);
+  }
+
   const index_input& stream() const NOEXCEPT {
     return *in_;
   }
@@ -728,6 +728,55 @@ handle_t open(FILE* file, const file_path_t mode) NOEXCEPT {
   #endif
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     positional io
+// -----------------------------------------------------------------------------
+
+ptrdiff_t read_at(int fd, uint64_t offset, void* buf, size_t size) NOEXCEPT {
+  #ifdef _WIN32
+    HANDLE handle = HANDLE(::_get_osfhandle(fd));
+
+    if (INVALID_HANDLE_VALUE == handle) {
+      return -1;
+    }
+
+    // an explicit offset makes ReadFile(...) read from 'offset' regardless of
+    // the current file position, which it still moves past the data read
+    OVERLAPPED overlapped{};
+    overlapped.Offset = DWORD(offset);
+    overlapped.OffsetHigh = DWORD(offset >> 32);
+
+    DWORD read;
+
+    if (!::ReadFile(handle, buf, DWORD(size), &read, &overlapped)) {
+      return ERROR_HANDLE_EOF == GetLastError() ? 0 : -1;
+    }
+
+    return ptrdiff_t(read);
+  #else
+    ssize_t read;
+
+    do {
+      read = ::pread(fd, buf, size, off_t(offset));
+    } while (read < 0 && EINTR == errno);
+
+    return read;
+  #endif
+}
+
+int fadvise(int fd, uint64_t offset, uint64_t len, int advice) NOEXCEPT {
+  #if defined(_WIN32) || defined(__APPLE__)
+    UNUSED(fd);
+    UNUSED(offset);
+    UNUSED(len);
+    UNUSED(advice);
+
+    return 0; // no-op, access pattern hints are not supported
+  #else
+    return ::posix_fadvise(fd, off_t(offset), off_t(len), advice);
+  #endif
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                        path utils
 // -----------------------------------------------------------------------------
@@ -51,6 +51,7 @@
   #define IR_FADVICE_NORMAL 0
   #define IR_FADVICE_SEQUENTIAL 1
   #define IR_FADVICE_RANDOM 2
+  #define IR_FADVICE_WILLNEED 3
   #define IR_FADVICE_DONTNEED 4
   #define IR_FADVICE_NOREUSE 5
   #define IR_WSTR(x) L ## x // cannot use _T(...) macro when _MBCS is defined
@@ -78,6 +79,7 @@
   #define IR_FADVICE_NORMAL POSIX_FADV_NORMAL
   #define IR_FADVICE_SEQUENTIAL POSIX_FADV_SEQUENTIAL
   #define IR_FADVICE_RANDOM POSIX_FADV_RANDOM
+  #define IR_FADVICE_WILLNEED POSIX_FADV_WILLNEED
   #define IR_FADVICE_DONTNEED POSIX_FADV_DONTNEED
   #define IR_FADVICE_NOREUSE POSIX_FADV_NOREUSE
 #endif
@@ -135,6 +137,30 @@ typedef std::unique_ptr<FILE, file_deleter> handle_t;
 handle_t open(const file_path_t path, const file_path_t mode) NOEXCEPT;
 handle_t open(FILE* file, const file_path_t mode) NOEXCEPT;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     positional io
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads up to 'size' bytes at the specified 'offset', safe to call
+///        concurrently on the same 'fd' since every call passes its own
+///        offset instead of relying on the shared file position
+/// @note the file position is unspecified afterwards, e.g. on Windows
+///       ReadFile(...) with an OVERLAPPED offset moves it
+/// @returns number of bytes read, 0 at the end of file, negative on error
+////////////////////////////////////////////////////////////////////////////////
+ptrdiff_t read_at(int fd, uint64_t offset, void* buf, size_t size) NOEXCEPT;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief announces the access pattern for the specified range of the file,
+///        'len' == 0 denotes the range up to the end of the file
+/// @param advice one of IR_FADVICE_*
+/// @returns 0 on success, error number otherwise, as posix_fadvise(...)
+///          does not set 'errno'
+/// @note no-op on platforms without posix_fadvise(...)
+////////////////////////////////////////////////////////////////////////////////
+int fadvise(int fd, uint64_t offset, uint64_t len, int advice) NOEXCEPT;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                        path utils
 // -----------------------------------------------------------------------------
@@ -0,0 +1,277 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2019 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "metrics.hpp"
+#include "utils/math_utils.hpp"
+#include "utils/singleton.hpp"
+#include "utils/thread_utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+NS_LOCAL
+
+using irs::metrics::event;
+using irs::metrics::EVENTS;
+using irs::metrics::stat;
+
+const char* EVENT_NAMES[] = {
+  "term_seek",
+  "postings_refill",
+  "column_block_load",
+  "segment_flush",
+  "segment_merge",
+  "commit_start",
+  "commit_finish"
+};
+
+static_assert(
+  EVENTS == sizeof(EVENT_NAMES)/sizeof(EVENT_NAMES[0]),
+  "invalid number of event names"
+);
+
+inline size_t bucket(uint64_t value) NOEXCEPT {
+  return value ? size_t(irs::math::log2_64(value)) + 1 : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @struct thread_stats
+/// @brief measurements of a single thread, updated by the owning thread only,
+///        hence relaxed load/store instead of read-modify-write operations
+////////////////////////////////////////////////////////////////////////////////
+struct thread_stats : private irs::util::noncopyable {
+  struct entry {
+    std::atomic<uint64_t> count{};
+    std::atomic<uint64_t> sum{};
+    std::atomic<uint64_t> buckets[stat::BUCKETS]{};
+  }; // entry
+
+  static void add(std::atomic<uint64_t>& counter, uint64_t value) NOEXCEPT {
+    counter.store(
+      counter.load(std::memory_order_relaxed) + value,
+      std::memory_order_relaxed
+    );
+  }
+
+  void increment(event e) NOEXCEPT {
+    add(entries[size_t(e)].count, 1);
+  }
+
+  void record(event e, uint64_t value) NOEXCEPT {
+    auto& entry = entries[size_t(e)];
+    add(entry.count, 1);
+    add(entry.sum, value);
+    add(entry.buckets[bucket(value)], 1);
+  }
+
+  void collect(irs::metrics::snapshot& out) const NOEXCEPT {
+    for (size_t i = 0; i < EVENTS; ++i) {
+      auto& src = entries[i];
+      auto& dst = out[event(i)];
+
+      dst.count += src.count.load(std::memory_order_relaxed);
+      dst.sum += src.sum.load(std::memory_order_relaxed);
+
+      for (size_t j = 0; j < stat::BUCKETS; ++j) {
+        dst.buckets[j] += src.buckets[j].load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  entry entries[EVENTS];
+}; // thread_stats
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class registry
+/// @brief tracks measurements of live threads and accumulates measurements
+///        of exited threads
+////////////////////////////////////////////////////////////////////////////////
+class registry : public irs::singleton<registry> {
+ public:
+  void attach(thread_stats& stats) {
+    SCOPED_LOCK(mutex_);
+    threads_.push_back(&stats);
+  }
+
+  void detach(thread_stats& stats) NOEXCEPT {
+    SCOPED_LOCK(mutex_);
+    stats.collect(retired_);
+    threads_.erase(std::remove(threads_.begin(), threads_.end(), &stats), threads_.end());
+  }
+
+  irs::metrics::snapshot get() {
+    SCOPED_LOCK(mutex_);
+    auto result = collect();
+
+    for (size_t i = 0; i < EVENTS; ++i) {
+      auto& dst = result[event(i)];
+      auto& base = baseline_[event(i)];
+
+      dst.count -= base.count;
+      dst.sum -= base.sum;
+
+      for (size_t j = 0; j < stat::BUCKETS; ++j) {
+        dst.buckets[j] -= base.buckets[j];
+      }
+    }
+
+    return result;
+  }
+
+  void reset() {
+    SCOPED_LOCK(mutex_);
+    baseline_ = collect();
+  }
+
+ private:
+  irs::metrics::snapshot collect() const NOEXCEPT {
+    auto result = retired_;
+
+    for (auto* stats : threads_) {
+      stats->collect(result);
+    }
+
+    return result;
+  }
+
+  std::mutex mutex_;
+  std::vector<thread_stats*> threads_;
+  irs::metrics::snapshot retired_; // measurements of exited threads
+  irs::metrics::snapshot baseline_; // measurements as of the last reset()
+}; // registry
+
+thread_stats DISCARDED; // sink for events after thread-local cleanup
+thread_local thread_stats* LOCAL_STATS{}; // trivial, i.e. no access guard
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief registers measurements of the calling thread for its lifetime
+////////////////////////////////////////////////////////////////////////////////
+thread_stats& attach_thread() {
+  struct guard {
+    guard() {
+      registry::instance().attach(stats);
+    }
+
+    ~guard() {
+      registry::instance().detach(stats);
+      LOCAL_STATS = &DISCARDED;
+    }
+
+    thread_stats stats;
+  }; // guard
+
+  try {
+    thread_local guard GUARD;
+    LOCAL_STATS = &GUARD.stats;
+  } catch (...) {
+    LOCAL_STATS = &DISCARDED;
+  }
+
+  return *LOCAL_STATS;
+}
+
+FORCE_INLINE thread_stats& local_stats() {
+  return LOCAL_STATS ? *LOCAL_STATS : attach_thread();
+}
+
+NS_END // LOCAL
+
+NS_ROOT
+NS_BEGIN(metrics)
+
+const char* name(event e) NOEXCEPT {
+  return size_t(e) < EVENTS ? EVENT_NAMES[size_t(e)] : "";
+}
+
+uint64_t stat::percentile(double p) const NOEXCEPT {
+  uint64_t total = 0; // counter-only events aren't recorded in the histogram
+
+  for (auto value : buckets) {
+    total += value;
+  }
+
+  const auto rank = uint64_t(std::ceil(p / 100. * total));
+  uint64_t seen = 0;
+
+  for (size_t i = 0; i < BUCKETS; ++i) {
+    seen += buckets[i];
+
+    if (seen && seen >= rank) {
+      return i ? (i < 64 ? (UINT64_C(1) << i) - 1 : UINT64_MAX) : 0;
+    }
+  }
+
+  return 0;
+}
+
+bool snapshot::visit(
+    const std::function<bool(event, const stat&)>& visitor) const {
+  for (size_t i = 0; i < EVENTS; ++i) {
+    if (!visitor(event(i), stats_[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void snapshot::write(std::ostream& out) const {
+  visit([&out](event e, const stat& s)->bool {
+    out << name(e)
+        << " count=" << s.count
+        << " sum=" << s.sum
+        << " mean=" << s.mean()
+        << " p50=" << s.percentile(50)
+        << " p90=" << s.percentile(90)
+        << " p99=" << s.percentile(99)
+        << '\n';
+    return true;
+  });
+}
+
+void increment(event e) NOEXCEPT {
+  local_stats().increment(e);
+}
+
+void record(event e, uint64_t value) NOEXCEPT {
+  local_stats().record(e, value);
+}
+
+snapshot get_snapshot() {
+  return registry::instance().get();
+}
+
+void reset() {
+  registry::instance().reset();
+}
+
+NS_END // metrics
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
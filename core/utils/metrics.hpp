@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2019 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_METRICS_H
+#define IRESEARCH_METRICS_H
+
+#include "shared.hpp"
+#include "utils/noncopyable.hpp"
+
+#include <chrono>
+#include <functional>
+#include <iosfwd>
+
+NS_ROOT
+NS_BEGIN(metrics)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief catalog of instrumented events, the names returned by name(...)
+///        are stable, new events are appended before COUNT
+////////////////////////////////////////////////////////////////////////////////
+enum class event : size_t {
+  TERM_SEEK = 0, // term dictionary seeks (counter)
+  POSTINGS_REFILL, // decoded blocks of document postings (counter)
+  COLUMN_BLOCK_LOAD, // columnstore blocks read from storage (nanoseconds)
+  SEGMENT_FLUSH, // segments flushed by segment_writer (nanoseconds)
+  SEGMENT_MERGE, // segments written by merge_writer (nanoseconds)
+  COMMIT_START, // first phase of index_writer commit, i.e. flush (nanoseconds)
+  COMMIT_FINISH, // second phase of index_writer commit (nanoseconds)
+  COUNT // number of events, must be the last entry
+}; // event
+
+const size_t EVENTS = size_t(event::COUNT);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @returns stable name of the specified event, e.g. for export
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API const char* name(event e) NOEXCEPT;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @struct stat
+/// @brief aggregated measurements of a single event
+////////////////////////////////////////////////////////////////////////////////
+struct IRESEARCH_API stat {
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief bucket 0 counts values of 0, bucket 'i' counts values
+  ///        within [2^(i-1), 2^i)
+  //////////////////////////////////////////////////////////////////////////////
+  static const size_t BUCKETS = 65;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns upper bound of the bucket containing the 'p'-th percentile
+  ///          of recorded values, events counted via increment(...) have
+  ///          no value and are ignored
+  //////////////////////////////////////////////////////////////////////////////
+  uint64_t percentile(double p) const NOEXCEPT;
+
+  double mean() const NOEXCEPT {
+    return count ? double(sum) / count : 0.;
+  }
+
+  uint64_t count{}; // number of events
+  uint64_t sum{}; // sum of recorded values, e.g. nanoseconds
+  uint64_t buckets[BUCKETS]{}; // histogram of recorded values
+}; // stat
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class snapshot
+/// @brief measurements of all events aggregated over all threads
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API snapshot {
+ public:
+  const stat& operator[](event e) const NOEXCEPT {
+    return stats_[size_t(e)];
+  }
+
+  stat& operator[](event e) NOEXCEPT {
+    return stats_[size_t(e)];
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief visit measurements of every event in catalog order
+  /// @returns 'false' if visitor has returned 'false', 'true' otherwise
+  //////////////////////////////////////////////////////////////////////////////
+  bool visit(const std::function<bool(event, const stat&)>& visitor) const;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief export measurements, one line per event of the form:
+  ///        <name> count=<n> sum=<n> mean=<n> p50=<n> p90=<n> p99=<n>
+  //////////////////////////////////////////////////////////////////////////////
+  void write(std::ostream& out) const;
+
+ private:
+  stat stats_[EVENTS];
+}; // snapshot
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts an occurence of 'e' in the calling thread
+/// @note intended for frequent events, costs a few nanoseconds
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API void increment(event e) NOEXCEPT;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts an occurence of 'e' in the calling thread and records
+///        'value' in its histogram
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API void record(event e, uint64_t value) NOEXCEPT;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @returns measurements of all threads recorded since the last reset()
+/// @note thread-safe, values recorded concurrently may be partially visible
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API snapshot get_snapshot();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief subsequent snapshots exclude measurements recorded so far
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API void reset();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class scoped_timer
+/// @brief records duration of the enclosing scope in nanoseconds
+////////////////////////////////////////////////////////////////////////////////
+class scoped_timer : private util::noncopyable {
+ public:
+  explicit scoped_timer(event e) NOEXCEPT
+    : start_(clock_type::now()), event_(e) {
+  }
+
+  ~scoped_timer() {
+    record(event_, uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      clock_type::now() - start_
+    ).count()));
+  }
+
+ private:
+  typedef std::chrono::steady_clock clock_type;
+
+  clock_type::time_point start_;
+  event event_;
+}; // scoped_timer
+
+NS_END // metrics
+NS_END // ROOT
+
+#define SCOPED_METRIC__(e, line) \
+  ::iresearch::metrics::scoped_timer metric_timer ## _ ## line(e)
+#define SCOPED_METRIC_EXPANDER__(e, line) SCOPED_METRIC__(e, line)
+#define SCOPED_METRIC(e) SCOPED_METRIC_EXPANDER__(e, __LINE__)
+
+#endif // IRESEARCH_METRICS_H
@@ -25,7 +25,9 @@
 #include "mmap_utils.hpp"
 #include "utils/log.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <vector>
 
 NS_ROOT
 NS_BEGIN(mmap_utils)
@@ -59,6 +61,78 @@ int flush(int fd, void* addr, size_t size, int flags) NOEXCEPT {
   return 0;
 }
 
+size_t page_size() NOEXCEPT {
+#ifdef _MSC_VER
+  return 4096; // madvise(...) is a no-op on win32 anyway
+#else
+  static const size_t size = size_t(sysconf(_SC_PAGESIZE));
+  return size;
+#endif
+}
+
+bool mmap_handle::advise(size_t offset, size_t len, int advice) NOEXCEPT {
+  if (offset >= size_) {
+    return true; // nothing to advise
+  }
+
+  // madvise(...) requires a page aligned address
+  const auto begin = offset - offset % page_size();
+  const auto end = offset + std::min(len, size_ - offset);
+
+  return 0 == ::madvise(
+    static_cast<char*>(addr_) + begin, end - begin, advice
+  );
+}
+
+bool mmap_handle::resident(size_t& result) const NOEXCEPT {
+#ifdef _MSC_VER
+  UNUSED(result);
+  return false; // win32 has no mincore(...)
+#else
+  result = 0;
+
+  if (!size_) {
+    return true;
+  }
+
+#ifdef __APPLE__
+  typedef char vec_t;
+#else
+  typedef unsigned char vec_t;
+#endif
+
+  std::vector<vec_t> vec;
+
+  try {
+    vec.resize((size_ + page_size() - 1) / page_size());
+  } catch (...) {
+    IR_LOG_EXCEPTION();
+    return false;
+  }
+
+  if (0 != ::mincore(addr_, size_, vec.data())) {
+    return false;
+  }
+
+  for (const auto page : vec) {
+    result += page & 1; // the rest of the bits are reserved
+  }
+
+  return true;
+#endif
+}
+
+void mmap_handle::touch() const NOEXCEPT {
+  const volatile char* begin = static_cast<const char*>(addr_);
+  char sum = 0;
+
+  for (size_t i = 0; i < size_; i += page_size()) {
+    sum ^= begin[i];
+  }
+
+  UNUSED(sum);
+}
+
 void mmap_handle::close() NOEXCEPT {
   if (addr_ != MAP_FAILED) {
     if (dontneed_) {
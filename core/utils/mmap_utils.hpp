@@ -88,6 +88,11 @@ NS_BEGIN(mmap_utils)
 //////////////////////////////////////////////////////////////////////////////
 int flush(int fd, void* addr, size_t size, int flags) NOEXCEPT;
 
+//////////////////////////////////////////////////////////////////////////////
+/// @returns size of a virtual memory page
+//////////////////////////////////////////////////////////////////////////////
+size_t page_size() NOEXCEPT;
+
 //////////////////////////////////////////////////////////////////////////////
 /// @class mmap_handle
 //////////////////////////////////////////////////////////////////////////////
@@ -122,6 +127,24 @@ class mmap_handle : private util::noncopyable {
     return 0 == ::madvise(addr_, size_, advice);
   }
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief applies 'advice' to the pages spanning [offset, offset + len)
+  //////////////////////////////////////////////////////////////////////////////
+  bool advise(size_t offset, size_t len, int advice) NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief evaluates the number of pages of the mapping that are currently
+  ///        resident in memory
+  /// @returns false if residency can't be determined on the current platform
+  //////////////////////////////////////////////////////////////////////////////
+  bool resident(size_t& result) const NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief faults every page of the mapping in, blocks until all of them
+  ///        are resident in memory
+  //////////////////////////////////////////////////////////////////////////////
+  void touch() const NOEXCEPT;
+
   void dontneed(bool value) NOEXCEPT {
     dontneed_ = value;
   }
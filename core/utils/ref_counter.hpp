@@ -24,6 +24,7 @@
 #ifndef IRESEARCH_REF_COUNTER_H
 #define IRESEARCH_REF_COUNTER_H
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <unordered_set>
@@ -31,15 +32,25 @@
 #include "shared.hpp"
 #include "utils/noncopyable.hpp"
 #include "utils/thread_utils.hpp"
+#include "utils/math_utils.hpp"
 #include "utils/memory.hpp"
 
 NS_ROOT
 
+////////////////////////////////////////////////////////////////////////////////
+/// @class ref_counter
+/// @brief tracks references to interned keys, i.e. every reference to
+///        the same key shares a single instance of the key, keys are
+///        partitioned into independently locked shards so that concurrent
+///        callers only contend for the keys of the same shard
+////////////////////////////////////////////////////////////////////////////////
 template<typename Key, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>>
 class ref_counter : public util::noncopyable { // noncopyable because shared_ptr refs hold reference to internal map keys
  public:
   typedef std::shared_ptr<const Key> ref_t;
 
+  static const size_t DEFAULT_SHARDS = 16;
+
   struct equal_to : Equal {
     bool operator()(const ref_t& lhs, const ref_t& rhs) const NOEXCEPT {
       assert(lhs && rhs);
@@ -54,17 +65,27 @@ class ref_counter : public util::noncopyable { // noncopyable because shared_ptr
     }
   }; // hash
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @param shards number of independently locked partitions, rounded up to
+  ///        a power of 2
+  //////////////////////////////////////////////////////////////////////////////
+  explicit ref_counter(size_t shards = DEFAULT_SHARDS)
+    : shards_(new shard[math::roundup_power2((std::max)(size_t(1), shards))]),
+      mask_(math::roundup_power2((std::max)(size_t(1), shards)) - 1) {
+  }
+
   ref_t add(Key&& key) {
-    SCOPED_LOCK(lock_);
+    auto& shard = get_shard(key);
+    SCOPED_LOCK(shard.lock);
 
-    auto res = refs_.emplace(ref_t(), &key);
+    auto res = shard.refs.emplace(ref_t(), &key);
 
     if (res.second) {
       try {
         const_cast<ref_t&>(*res.first) = std::make_shared<const Key>(std::forward<Key>(key));
       } catch (...) {
         // rollback
-        refs_.erase(res.first);
+        shard.refs.erase(res.first);
         return ref_t();
       }
     }
@@ -74,50 +95,96 @@ class ref_counter : public util::noncopyable { // noncopyable because shared_ptr
 
   bool remove(const Key& key) {
     const ref_t ref(ref_t(), &key); // aliasing ctor
+    auto& shard = get_shard(key);
+
+    SCOPED_LOCK(shard.lock);
+    return shard.refs.erase(ref) > 0;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief removes 'key' if it isn't referenced and 'acceptor(key)' returns
+  ///        true, the acceptor is invoked under the lock of the key, i.e. no
+  ///        reference to the key may be acquired concurrently
+  /// @returns true if the key has been removed
+  //////////////////////////////////////////////////////////////////////////////
+  template<typename Acceptor>
+  bool remove_unused(const Key& key, const Acceptor& acceptor) {
+    const ref_t ref(ref_t(), &key); // aliasing ctor
+    auto& shard = get_shard(key);
 
-    SCOPED_LOCK(lock_);
-    return refs_.erase(ref) > 0;
+    SCOPED_LOCK(shard.lock);
+    auto itr = shard.refs.find(ref);
+
+    if (itr == shard.refs.end() || !itr->unique() || !acceptor(**itr)) {
+      return false;
+    }
+
+    shard.refs.erase(itr);
+
+    return true;
   }
 
   bool contains(const Key& key) const NOEXCEPT {
     const ref_t ref(ref_t(), &key); // aliasing ctor
+    auto& shard = get_shard(key);
 
-    SCOPED_LOCK(lock_);
-    return refs_.find(ref) != refs_.end();
+    SCOPED_LOCK(shard.lock);
+    return shard.refs.find(ref) != shard.refs.end();
   }
 
   size_t find(const Key& key) const NOEXCEPT {
     const ref_t ref(ref_t(), &key); // aliasing ctor
+    auto& shard = get_shard(key);
 
-    SCOPED_LOCK(lock_);
-    auto itr = refs_.find(ref);
+    SCOPED_LOCK(shard.lock);
+    auto itr = shard.refs.find(ref);
 
-    return itr == refs_.end() ? 0 : (itr->use_count() - 1); // -1 for usage by refs_ itself
+    return itr == shard.refs.end() ? 0 : (itr->use_count() - 1); // -1 for usage by refs itself
   }
 
   bool empty() const NOEXCEPT {
-    SCOPED_LOCK(lock_);
-    return refs_.empty();
+    for (size_t i = 0; i <= mask_; ++i) {
+      auto& shard = shards_[i];
+      SCOPED_LOCK(shard.lock);
+
+      if (!shard.refs.empty()) {
+        return false;
+      }
+    }
+
+    return true;
   }
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief visits keys a shard at a time, i.e. keys added to or removed
+  ///        from already visited shards during visitation aren't reflected
+  /// @note the visitor is invoked under the lock of the shard of the visited
+  ///       key, it may call back into 'this' only for the visited key, e.g.
+  ///       to add a reference retaining it; touching any other key may either
+  ///       invalidate the iteration of the shard or lock another shard and
+  ///       deadlock with a concurrent visitation
+  //////////////////////////////////////////////////////////////////////////////
   template<typename Visitor>
   bool visit(const Visitor& visitor, bool remove_unused = false) {
-    SCOPED_LOCK(lock_);
+    for (size_t i = 0; i <= mask_; ++i) {
+      auto& shard = shards_[i];
+      SCOPED_LOCK(shard.lock);
 
-    for (auto itr = refs_.begin(), end = refs_.end(); itr != end;) {
-      auto& ref = *itr;
-      assert(*itr);
+      for (auto itr = shard.refs.begin(), end = shard.refs.end(); itr != end;) {
+        auto& ref = *itr;
+        assert(*itr);
 
-      auto visit_next = visitor(*ref, ref.use_count() - 1); // -1 for usage by refs_ itself
+        auto visit_next = visitor(*ref, ref.use_count() - 1); // -1 for usage by refs itself
 
-      if (remove_unused && ref.unique()) {
-        itr = refs_.erase(itr);
-      } else {
-        ++itr;
-      }
+        if (remove_unused && ref.unique()) {
+          itr = shard.refs.erase(itr);
+        } else {
+          ++itr;
+        }
 
-      if (!visit_next) {
-        return false;
+        if (!visit_next) {
+          return false;
+        }
       }
     }
 
@@ -125,10 +192,26 @@ class ref_counter : public util::noncopyable { // noncopyable because shared_ptr
   }
 
  private:
-  mutable std::recursive_mutex lock_; // recursive to allow usage for 'this' from withing visit(...)
-  std::unordered_set<ref_t, hash, equal_to> refs_;
+  struct shard {
+    // recursive to allow the visitor of visit(...) to use the visited key
+    mutable std::recursive_mutex lock;
+    std::unordered_set<ref_t, hash, equal_to> refs;
+  }; // shard
+
+  shard& get_shard(const Key& key) const NOEXCEPT {
+    auto value = Hash()(key);
+    value ^= value >> 16; // std::hash of integers is usually the identity
+
+    return shards_[value & mask_];
+  }
+
+  std::unique_ptr<shard[]> shards_;
+  size_t mask_; // number of shards - 1
 }; // ref_counter
 
+template<typename Key, typename Hash, typename Equal>
+const size_t ref_counter<Key, Hash, Equal>::DEFAULT_SHARDS;
+
 NS_END
 
 #endif
\ No newline at end of file
@@ -265,3 +265,109 @@ TEST(numeric_token_stream_tests, value) {
     ASSERT_EQ(true, !ts.next());
   }
 }
+
+TEST(buffered_token_stream_tests, replay) {
+  struct token_stream_t final : token_stream {
+    token_stream_t() {
+      attrs.emplace(term);
+      attrs.emplace(inc);
+      attrs.emplace(offs);
+      attrs.emplace(pay);
+    }
+
+    virtual const attribute_view& attributes() const NOEXCEPT override {
+      return attrs;
+    }
+
+    virtual bool next() override {
+      if (i >= values.size()) {
+        offs.start = offs.end = 42; // state of the exhausted stream
+        return false;
+      }
+
+      buf = values[i]; // same buffer reused for all terms
+      term.value(ref_cast<byte_type>(string_ref(buf)));
+      inc.value = uint32_t(i % 2);
+      offs.start = uint32_t(2*i);
+      offs.end = uint32_t(2*i + 1);
+      pay.value = i % 2 ? bytes_ref::NIL : ref_cast<byte_type>(string_ref(values[i]));
+      ++i;
+      return true;
+    }
+
+    attribute_view attrs;
+    basic_term term;
+    increment inc;
+    offset offs;
+    payload pay;
+    std::vector<std::string> values{ "abc", "", "defgh", "ij" };
+    std::string buf;
+    size_t i{};
+  } src;
+
+  buffered_token_stream stream;
+  stream.reset(src);
+  ASSERT_EQ(src.values.size(), stream.size());
+  ASSERT_FALSE(src.next()); // source is exhausted
+
+  auto& term = stream.attributes().get<term_attribute>();
+  auto& inc = stream.attributes().get<increment>();
+  auto& offs = stream.attributes().get<offset>();
+  auto& pay = stream.attributes().get<payload>();
+  ASSERT_FALSE(!term);
+  ASSERT_FALSE(!inc);
+  ASSERT_FALSE(!offs);
+  ASSERT_FALSE(!pay);
+
+  for (size_t i = 0; i < src.values.size(); ++i) {
+    ASSERT_TRUE(stream.next());
+    ASSERT_EQ(ref_cast<byte_type>(string_ref(src.values[i])), term->value());
+    ASSERT_EQ(i % 2, inc->value);
+    ASSERT_EQ(2*i, offs->start);
+    ASSERT_EQ(2*i + 1, offs->end);
+
+    if (i % 2) {
+      ASSERT_TRUE(pay->value.null());
+    } else {
+      ASSERT_EQ(ref_cast<byte_type>(string_ref(src.values[i])), pay->value);
+    }
+  }
+
+  ASSERT_FALSE(stream.next());
+  ASSERT_EQ(42, offs->start);
+  ASSERT_EQ(42, offs->end);
+  ASSERT_FALSE(stream.next());
+
+  // reuse with a stream without offsets and payloads
+  numeric_token_stream numeric;
+  numeric.reset(int32_t(35));
+  stream.reset(numeric);
+  ASSERT_EQ(2, stream.size());
+  ASSERT_FALSE(!stream.attributes().get<term_attribute>());
+  ASSERT_FALSE(!stream.attributes().get<increment>());
+  ASSERT_TRUE(!stream.attributes().get<offset>());
+  ASSERT_TRUE(!stream.attributes().get<payload>());
+
+  bstring buf;
+  auto& numeric_term = stream.attributes().get<term_attribute>();
+  ASSERT_TRUE(stream.next());
+  ASSERT_EQ(numeric_token_stream::value(buf, int32_t(35)), numeric_term->value());
+  ASSERT_TRUE(stream.next());
+  ASSERT_FALSE(stream.next());
+
+  // exhausted source
+  stream.reset(src);
+  ASSERT_EQ(0, stream.size());
+  ASSERT_FALSE(stream.next());
+  ASSERT_EQ(42, stream.attributes().get<offset>()->end);
+
+  // release captured tokens
+  src.i = 0;
+  stream.reset(src);
+  ASSERT_EQ(src.values.size(), stream.size());
+  const auto reserved = stream.memory_reserved();
+  stream.clear();
+  ASSERT_EQ(0, stream.size());
+  ASSERT_GT(reserved, stream.memory_reserved());
+  ASSERT_FALSE(stream.next());
+}
@@ -25,6 +25,7 @@
 
 #include "index/field_meta.hpp"
 #include "utils/bit_packing.hpp"
+#include "utils/misc.hpp"
 #include "utils/type_limits.hpp"
 #include "formats/formats_10_attributes.hpp"
 #include "formats/formats_10.hpp"
@@ -232,6 +233,69 @@ class format_10_test_case : public tests::format_test_case {
           ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it->seek(docs.back() + 10)));
         }
 
+        // read documents in batches
+        for (size_t batch : { size_t(1), size_t(5), size_t(VERSION10_POSTINGS_WRITER_BLOCK_SIZE), size_t(3*VERSION10_POSTINGS_WRITER_BLOCK_SIZE + 1) }) {
+          auto it = reader->iterator(field.features, read_attrs, field.features);
+          ASSERT_FALSE(irs::type_limits<irs::type_t::doc_id_t>::valid(it->value()));
+          auto& freq = it->attributes().get<irs::frequency>();
+
+          std::vector<irs::doc_id_t> batch_docs(batch);
+          std::vector<uint32_t> batch_freqs(batch);
+          postings expected(docs.begin(), docs.end(), field.features);
+          size_t count;
+          size_t total = 0;
+
+          while ((count = it->next_batch(&batch_docs[0], &batch_freqs[0], batch))) {
+            ASSERT_LE(count, batch);
+
+            for (size_t i = 0; i < count; ++i) {
+              ASSERT_TRUE(expected.next());
+              ASSERT_EQ(expected.value(), batch_docs[i]);
+
+              if (freq) {
+                ASSERT_EQ(expected.attributes().get<irs::frequency>()->value, batch_freqs[i]);
+              } else {
+                ASSERT_EQ(0, batch_freqs[i]);
+              }
+            }
+
+            total += count;
+
+            if (count < batch) {
+              break;
+            }
+
+            ASSERT_EQ(batch_docs[count - 1], it->value());
+            assert_positions(expected, *it);
+          }
+
+          ASSERT_EQ(docs.size(), total);
+          ASSERT_FALSE(expected.next());
+          ASSERT_EQ(0, it->next_batch(&batch_docs[0], nullptr, batch));
+          ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it->value()));
+        }
+
+        // mix seek with next_batch
+        {
+          const size_t batch = 7;
+          auto it = reader->iterator(field.features, read_attrs, field.features);
+          std::vector<irs::doc_id_t> batch_docs(batch);
+
+          for (size_t i = 0, size = docs.size(); i < size; i += 2*batch + 1) {
+            ASSERT_EQ(docs[i], it->seek(docs[i]));
+            const auto count = it->next_batch(&batch_docs[0], nullptr, batch);
+            ASSERT_EQ(std::min(batch, size - i - 1), count);
+
+            for (size_t j = 0; j < count; ++j) {
+              ASSERT_EQ(docs[i + j + 1], batch_docs[j]);
+            }
+
+            if (count == batch) {
+              ASSERT_EQ(batch_docs[count - 1], it->value());
+            }
+          }
+        }
+
         // seek for backwards && next
         {
           for (auto doc = docs.rbegin(), end = docs.rend(); doc != end; ++doc) {
@@ -883,6 +947,472 @@ TEST_P(format_10_test_case, postings_seek) {
   }
 }
 
+TEST_P(format_10_test_case, postings_frequency_bound) {
+  const irs::flags features{ irs::frequency::type() };
+  const bool has_bound = get_codec()->type().name() != irs::string_ref("1_0");
+  auto dir = get_directory(*this);
+  auto codec = std::dynamic_pointer_cast<const irs::version10::format>(get_codec());
+  ASSERT_NE(nullptr, codec);
+
+  // 7 full blocks + tail
+  std::vector<irs::doc_id_t> docs;
+  {
+    const size_t count = 1000;
+    docs.reserve(count);
+    auto i = (irs::type_limits<irs::type_t::doc_id_t>::min)();
+    std::generate_n(std::back_inserter(docs), count,[&i]() {return i++;});
+  }
+
+  // write postings
+  auto writer = codec->get_postings_writer(false);
+  ASSERT_NE(nullptr, writer);
+  irs::postings_writer::state term_meta; // must be destroyed before the writer
+  {
+    irs::flush_state state;
+    state.dir = dir.get();
+    state.doc_count = docs.back() + 1;
+    state.name = "segment_name";
+    state.features = &features;
+
+    auto out = dir->create("attributes");
+    ASSERT_FALSE(!out);
+
+    writer->prepare(*out, state);
+    writer->begin_field(features);
+    postings it(docs.begin(), docs.end(), features);
+    term_meta = writer->write(it);
+    writer->encode(*out, *term_meta);
+    writer->end();
+  }
+
+  // read postings
+  irs::segment_meta meta;
+  meta.name = "segment_name";
+
+  irs::reader_state state;
+  state.dir = dir.get();
+  state.meta = &meta;
+
+  auto in = dir->open("attributes", irs::IOAdvice::NORMAL);
+  ASSERT_FALSE(!in);
+  auto reader = codec->get_postings_reader();
+  ASSERT_NE(nullptr, reader);
+  reader->prepare(*in, state, features);
+
+  irs::frequency freq;
+  irs::version10::term_meta read_meta;
+  irs::attribute_view read_attrs;
+  read_attrs.emplace(freq);
+  read_attrs.emplace(read_meta);
+  reader->decode(*in, features, read_attrs, read_meta);
+  ASSERT_EQ(has_bound ? 10 : 0, read_meta.max_freq);
+
+  auto it = reader->iterator(features, read_attrs, features);
+  auto& bound = it->attributes().get<irs::frequency_bound>();
+  ASSERT_EQ(has_bound, bool(bound));
+
+  if (!bound) {
+    return;
+  }
+
+  const auto block_size = irs::doc_id_t(VERSION10_POSTINGS_WRITER_BLOCK_SIZE);
+  uint32_t max = 0;
+  ASSERT_EQ(10, bound->max());
+  ASSERT_EQ(block_size, bound->shallow_seek(1, max));
+  ASSERT_EQ(10, max);
+  ASSERT_EQ(3*block_size, bound->shallow_seek(2*block_size + 44, max));
+  ASSERT_EQ(10, max);
+
+  // shallow seek doesn't move an iterator
+  ASSERT_FALSE(irs::doc_limits::valid(it->value()));
+  ASSERT_EQ(2*block_size + 44, it->seek(2*block_size + 44));
+  ASSERT_TRUE(it->next());
+  ASSERT_EQ(2*block_size + 45, it->value());
+
+  // the tail block isn't covered by skip-list
+  ASSERT_TRUE(irs::doc_limits::eof(bound->shallow_seek(7*block_size + 1, max)));
+  ASSERT_EQ(10, max);
+  ASSERT_EQ(2*block_size + 46, it->seek(2*block_size + 46));
+  ASSERT_EQ(5*block_size, it->seek(5*block_size));
+
+  for (auto expected = 5*block_size + 1; expected <= docs.back(); ++expected) {
+    ASSERT_TRUE(it->next());
+    ASSERT_EQ(expected, it->value());
+  }
+  ASSERT_FALSE(it->next());
+}
+
+TEST_P(format_10_test_case, postings_prefetch) {
+  typedef std::vector<std::pair<size_t, size_t>> ranges_t;
+  typedef std::map<std::string, ranges_t> hints_t;
+
+  // records prefetch hints issued by the readers
+  class hint_input final : public irs::index_input {
+   public:
+    hint_input(irs::index_input::ptr&& impl, ranges_t& hints)
+      : impl_(std::move(impl)), hints_(&hints) {
+    }
+    virtual irs::byte_type read_byte() override { return impl_->read_byte(); }
+    virtual size_t read_bytes(irs::byte_type* b, size_t count) override {
+      return impl_->read_bytes(b, count);
+    }
+    virtual size_t file_pointer() const override { return impl_->file_pointer(); }
+    virtual size_t length() const override { return impl_->length(); }
+    virtual bool eof() const override { return impl_->eof(); }
+    virtual ptr dup() const override {
+      return irs::memory::make_unique<hint_input>(impl_->dup(), *hints_);
+    }
+    virtual ptr reopen() const override {
+      return irs::memory::make_unique<hint_input>(impl_->reopen(), *hints_);
+    }
+    virtual void seek(size_t pos) override { impl_->seek(pos); }
+    virtual int64_t checksum(size_t offset) const override {
+      return impl_->checksum(offset);
+    }
+    virtual void prefetch(size_t offset, size_t length) NOEXCEPT override {
+      hints_->emplace_back(offset, length);
+      impl_->prefetch(offset, length);
+    }
+
+   private:
+    irs::index_input::ptr impl_;
+    ranges_t* hints_;
+  }; // hint_input
+
+  class hint_directory final : public tests::directory_mock {
+   public:
+    explicit hint_directory(irs::directory& impl)
+      : tests::directory_mock(impl) {
+    }
+
+    virtual irs::index_input::ptr open(
+        const std::string& name,
+        irs::IOAdvice advice) const NOEXCEPT override {
+      auto in = tests::directory_mock::open(name, advice);
+
+      if (!in) {
+        return nullptr;
+      }
+
+      const auto ext = name.substr(name.rfind('.') + 1);
+      return irs::memory::make_unique<hint_input>(std::move(in), hints[ext]);
+    }
+
+    mutable hints_t hints; // by file extension
+  }; // hint_directory
+
+  const irs::flags features{
+    irs::frequency::type(), irs::position::type(),
+    irs::offset::type(), irs::payload::type()
+  };
+  auto codec = std::dynamic_pointer_cast<const irs::version10::format>(get_codec());
+  ASSERT_NE(nullptr, codec);
+  auto impl = get_directory(*this);
+  hint_directory dir(*impl);
+
+  // postings spanning far more than a single prefetch window per stream
+  std::vector<irs::doc_id_t> docs;
+  {
+    const size_t count = 100000;
+    docs.reserve(count);
+    auto i = (irs::type_limits<irs::type_t::doc_id_t>::min)();
+    std::generate_n(std::back_inserter(docs), count, [&i]() {
+      return i += 1 + (i*7919) % 61; // varying deltas aren't packed as a single value
+    });
+  }
+
+  // write postings
+  auto writer = codec->get_postings_writer(false);
+  ASSERT_NE(nullptr, writer);
+  irs::postings_writer::state term_meta; // must be destroyed before the writer
+  {
+    irs::flush_state state;
+    state.dir = &dir;
+    state.doc_count = docs.back() + 1;
+    state.name = "segment_name";
+    state.features = &features;
+
+    auto out = dir.create("attributes");
+    ASSERT_FALSE(!out);
+
+    writer->prepare(*out, state);
+    writer->begin_field(features);
+    postings it(docs.begin(), docs.end(), features);
+    term_meta = writer->write(it);
+    writer->encode(*out, *term_meta);
+    writer->end();
+  }
+
+  // read postings
+  irs::segment_meta meta;
+  meta.name = "segment_name";
+
+  irs::reader_state state;
+  state.dir = &dir;
+  state.meta = &meta;
+
+  auto in = dir.open("attributes", irs::IOAdvice::NORMAL);
+  ASSERT_FALSE(!in);
+  auto reader = codec->get_postings_reader();
+  ASSERT_NE(nullptr, reader);
+  reader->prepare(*in, state, features);
+
+  irs::frequency freq;
+  irs::version10::term_meta read_meta;
+  irs::attribute_view read_attrs;
+  read_attrs.emplace(freq);
+  read_attrs.emplace(read_meta);
+  reader->decode(*in, features, read_attrs, read_meta);
+
+  auto it = reader->iterator(features, read_attrs, features);
+  auto& pos = it->attributes().get<irs::position>();
+  ASSERT_FALSE(!pos);
+
+  auto& doc_hints = dir.hints["doc"];
+  ASSERT_EQ(1, doc_hints.size()); // leading blocks are hinted upfront
+  ASSERT_EQ(read_meta.doc_start, doc_hints.front().first);
+
+  for (auto expected : docs) {
+    ASSERT_TRUE(it->next());
+    ASSERT_EQ(expected, it->value());
+    size_t count = 0;
+    for (; pos->next(); ++count) { }
+    ASSERT_EQ(10, count);
+  }
+  ASSERT_FALSE(it->next());
+
+  // hints follow the reader past the first block of every stream
+  for (auto& ext : { "doc", "pos", "pay" }) {
+    SCOPED_TRACE(ext);
+    auto& hints = dir.hints[ext];
+    ASSERT_LT(1, hints.size());
+
+    // contiguous ranges ahead of each other
+    for (size_t i = 1; i < hints.size(); ++i) {
+      ASSERT_EQ(hints[i - 1].first + hints[i - 1].second, hints[i].first);
+    }
+
+    // well past the first window
+    ASSERT_LT(65536, hints.back().first + hints.back().second - hints.front().first);
+  }
+
+  // skipping far ahead restarts hints from the target block
+  {
+    doc_hints.clear();
+    auto it = reader->iterator(features, read_attrs, features);
+    const auto target = docs[docs.size() - 200];
+    ASSERT_EQ(target, it->seek(target));
+    ASSERT_LE(2, doc_hints.size());
+    ASSERT_LT(doc_hints.front().first + doc_hints.front().second, doc_hints.back().first);
+  }
+}
+
+TEST_P(format_10_test_case, columnstore_block_cache) {
+  auto restore_limit = irs::make_finally([](){
+    irs::version10::columnstore_cache_limit(std::numeric_limits<size_t>::max());
+  });
+
+  irs::segment_meta seg("_1", codec());
+  const irs::doc_id_t MAX_DOC = 16384;
+  size_t column_id;
+
+  auto expected_value = [](irs::doc_id_t id) {
+    return std::to_string(id) + std::string(id % 7, 'x');
+  };
+
+  // write sparse column with variable length values
+  {
+    auto writer = codec()->get_columnstore_writer();
+    writer->prepare(dir(), seg);
+    auto column = writer->push_column();
+    column_id = column.first;
+    auto& column_handler = column.second;
+
+    for (irs::doc_id_t id = 1; id <= MAX_DOC; id += 2, ++seg.docs_count) {
+      const auto value = expected_value(id);
+      auto& stream = column_handler(id);
+      stream.write_bytes(reinterpret_cast<const irs::byte_type*>(value.c_str()), value.size());
+    }
+
+    ASSERT_TRUE(writer->commit());
+  }
+
+  const auto initial = irs::version10::columnstore_cache_statistics();
+
+  {
+    auto reader = codec()->get_columnstore_reader();
+    ASSERT_TRUE(reader->prepare(dir(), seg));
+    auto column = reader->column(column_id);
+    ASSERT_NE(nullptr, column);
+
+    // nothing could be cached
+    irs::version10::columnstore_cache_limit(0);
+
+    // random access
+    {
+      irs::bytes_ref actual_value;
+      auto values = column->values();
+
+      for (irs::doc_id_t i = MAX_DOC; i > 0; i -= 2) {
+        const irs::doc_id_t id = i - 1; // odd ids in reverse order
+        ASSERT_TRUE(values(id, actual_value));
+        ASSERT_EQ(expected_value(id), irs::ref_cast<char>(actual_value));
+        ASSERT_FALSE(values(id + 1, actual_value));
+      }
+
+      auto stats = irs::version10::columnstore_cache_statistics();
+      ASSERT_EQ(0, stats.limit);
+      ASSERT_EQ(0, stats.size);
+      ASSERT_EQ(0, stats.blocks);
+      ASSERT_LT(initial.misses, stats.misses);
+      ASSERT_LT(initial.evictions, stats.evictions);
+    }
+
+    // iteration
+    {
+      auto it = column->iterator();
+      ASSERT_NE(nullptr, it);
+      auto& payload = it->attributes().get<irs::payload>();
+      ASSERT_FALSE(!payload);
+
+      irs::doc_id_t expected_id = 1;
+      for (; it->next(); expected_id += 2) {
+        ASSERT_EQ(expected_id, it->value());
+        ASSERT_EQ(expected_value(expected_id), irs::ref_cast<char>(payload->value));
+      }
+      ASSERT_EQ(MAX_DOC + 1, expected_id);
+    }
+
+    // unbounded cache, blocks are cached on first access
+    irs::version10::columnstore_cache_limit(std::numeric_limits<size_t>::max());
+
+    {
+      irs::bytes_ref actual_value;
+      auto values = column->values();
+
+      for (irs::doc_id_t id = 1; id <= MAX_DOC; id += 2) {
+        ASSERT_TRUE(values(id, actual_value));
+        ASSERT_EQ(expected_value(id), irs::ref_cast<char>(actual_value));
+      }
+
+      const auto before = irs::version10::columnstore_cache_statistics();
+      ASSERT_LT(0, before.blocks);
+      ASSERT_LT(0, before.size);
+
+      for (irs::doc_id_t id = 1; id <= MAX_DOC; id += 2) {
+        ASSERT_TRUE(values(id, actual_value));
+        ASSERT_EQ(expected_value(id), irs::ref_cast<char>(actual_value));
+      }
+
+      const auto after = irs::version10::columnstore_cache_statistics();
+      ASSERT_EQ(before.misses, after.misses);
+      ASSERT_EQ(before.blocks, after.blocks);
+      ASSERT_LT(before.hits, after.hits);
+    }
+  }
+
+  // blocks are released together with the reader
+  const auto stats = irs::version10::columnstore_cache_statistics();
+  ASSERT_EQ(0, stats.blocks);
+  ASSERT_EQ(0, stats.size);
+}
+
+TEST_P(format_10_test_case, columnstore_compression) {
+  const irs::doc_id_t MAX_DOC = 16384;
+  const bool per_column_codec = "1_0" != codec()->type().name();
+
+  auto expected_value = [](irs::doc_id_t id) {
+    return "{ \"id\": " + std::to_string(id)
+      + ", \"name\": \"document_" + std::to_string(id % 97)
+      + "\", \"tags\": [ \"" + std::string(id % 13, 'a') + "\" ] }";
+  };
+
+  // returns total size of the files written for the specified segment
+  auto segment_size = [this](const irs::segment_meta& seg) {
+    uint64_t total = 0;
+    dir().visit([&seg, &total, this](std::string& name) {
+      uint64_t length;
+      if (irs::starts_with(name, seg.name + ".") && dir().length(length, name)) {
+        total += length;
+      }
+      return true;
+    });
+    return total;
+  };
+
+  auto write_read = [&](irs::segment_meta& seg, irs::compression::type codec) {
+    size_t column_id;
+
+    {
+      auto writer = this->codec()->get_columnstore_writer();
+      writer->prepare(dir(), seg);
+      auto column = writer->push_column(irs::column_info(codec));
+      column_id = column.first;
+      auto& column_handler = column.second;
+
+      for (irs::doc_id_t id = 1; id <= MAX_DOC; ++id, ++seg.docs_count) {
+        const auto value = expected_value(id);
+        auto& stream = column_handler(id);
+        stream.write_bytes(reinterpret_cast<const irs::byte_type*>(value.c_str()), value.size());
+      }
+
+      ASSERT_TRUE(writer->commit());
+    }
+
+    auto reader = this->codec()->get_columnstore_reader();
+    ASSERT_TRUE(reader->prepare(dir(), seg));
+    auto column = reader->column(column_id);
+    ASSERT_NE(nullptr, column);
+
+    // random access
+    {
+      irs::bytes_ref actual_value;
+      auto values = column->values();
+
+      for (irs::doc_id_t id = MAX_DOC; id > 0; --id) {
+        ASSERT_TRUE(values(id, actual_value));
+        ASSERT_EQ(expected_value(id), irs::ref_cast<char>(actual_value));
+      }
+    }
+
+    // iteration
+    {
+      auto it = column->iterator();
+      ASSERT_NE(nullptr, it);
+      auto& payload = it->attributes().get<irs::payload>();
+      ASSERT_FALSE(!payload);
+
+      irs::doc_id_t expected_id = 1;
+      for (; it->next(); ++expected_id) {
+        ASSERT_EQ(expected_id, it->value());
+        ASSERT_EQ(expected_value(expected_id), irs::ref_cast<char>(payload->value));
+      }
+      ASSERT_EQ(MAX_DOC + 1, expected_id);
+    }
+  };
+
+  irs::segment_meta none_seg("_1", codec());
+  write_read(none_seg, irs::compression::type::NONE);
+  irs::segment_meta lz4_seg("_2", codec());
+  write_read(lz4_seg, irs::compression::type::LZ4);
+
+  if (per_column_codec) {
+    ASSERT_LT(segment_size(lz4_seg), segment_size(none_seg));
+  } else {
+    // codec is not stored by the format, LZ4 is used for every column
+    ASSERT_EQ(segment_size(lz4_seg), segment_size(none_seg));
+  }
+
+  if (irs::compression::supported(irs::compression::type::ZSTD)) {
+    irs::segment_meta zstd_seg("_3", codec());
+    write_read(zstd_seg, irs::compression::type::ZSTD);
+
+    if (per_column_codec) {
+      ASSERT_LT(segment_size(zstd_seg), segment_size(none_seg));
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                        format specific test cases
 // -----------------------------------------------------------------------------
@@ -896,7 +1426,7 @@ INSTANTIATE_TEST_CASE_P(
       &tests::fs_directory,
       &tests::mmap_directory
     ),
-    ::testing::Values("1_0")
+    ::testing::Values("1_0", "1_1")
   ),
   tests::to_string
 );
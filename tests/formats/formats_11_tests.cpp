@@ -23,6 +23,7 @@
 
 #include "tests_shared.hpp"
 #include "formats_test_case_base.hpp"
+#include "formats/format_utils.hpp"
 #include "store/directory_attributes.hpp"
 
 NS_LOCAL
@@ -479,6 +480,73 @@ TEST_P(format_11_test_case, formats_10_11) {
   }
 }
 
+TEST_P(format_11_test_case, document_mask_read_corrupted) {
+  auto codec = irs::formats::get("1_1");
+  ASSERT_NE(nullptr, codec);
+
+  irs::segment_meta meta("_1", nullptr);
+  meta.version = 42;
+  meta.docs_count = 10000;
+
+  // write a dense document_mask
+  std::string filename;
+
+  {
+    irs::document_mask docs_mask;
+    for (irs::doc_id_t i = 1; i <= meta.docs_count; i += 3) {
+      ASSERT_TRUE(docs_mask.insert(i));
+    }
+
+    auto writer = codec->get_document_mask_writer();
+    writer->write(dir(), meta, docs_mask);
+    filename = writer->filename(meta);
+  }
+
+  // bitmap exceeds the number of documents in a segment
+  {
+    irs::segment_meta small_meta = meta;
+    small_meta.docs_count = 100;
+
+    auto reader = codec->get_document_mask_reader();
+    irs::document_mask docs_mask;
+    ASSERT_THROW(reader->read(dir(), small_meta, docs_mask), irs::index_error);
+  }
+
+  // bitmap doesn't match the number of masked documents, checksum is valid
+  {
+    std::vector<irs::byte_type> buf;
+
+    {
+      auto in = dir().open(filename, irs::IOAdvice::NORMAL);
+      ASSERT_NE(nullptr, in);
+      buf.resize(in->length() - irs::format_utils::FOOTER_LEN);
+      ASSERT_EQ(buf.size(), in->read_bytes(&buf[0], buf.size()));
+    }
+
+    // the number of masked documents precedes the number of bitmap words
+    const uint32_t count = 3334;
+    const uint32_t words = 157;
+    const auto pos = buf.size()
+      - words*sizeof(irs::document_mask::word_t)
+      - irs::bytes_io<uint32_t>::vsize(words)
+      - irs::bytes_io<uint32_t>::vsize(count);
+    ASSERT_EQ(0x80 | (count & 0x7F), buf[pos]);
+    --buf[pos]; // one document less than actually masked
+
+    {
+      ASSERT_TRUE(dir().remove(filename));
+      auto out = dir().create(filename);
+      ASSERT_NE(nullptr, out);
+      out->write_bytes(&buf[0], buf.size());
+      irs::format_utils::write_footer(*out);
+    }
+
+    auto reader = codec->get_document_mask_reader();
+    irs::document_mask docs_mask;
+    ASSERT_THROW(reader->read(dir(), meta, docs_mask), irs::index_error);
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(
   format_11_test,
   format_11_test_case,
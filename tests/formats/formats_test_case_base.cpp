@@ -2921,26 +2921,42 @@ TEST_P(format_test_case, columns_meta_rw) {
 }
 
 TEST_P(format_test_case, document_mask_rw) {
-  const std::unordered_set<irs::doc_id_t> mask_set = { 1, 4, 5, 7, 10, 12 };
-  irs::segment_meta meta("_1", nullptr);
-  meta.version = 42;
+  std::set<irs::doc_id_t> sparse_set = { 1, 4, 5, 7, 10, 12, 100000 };
+  std::set<irs::doc_id_t> dense_set;
+  for (irs::doc_id_t i = 1; i < 10000; i += 3) {
+    dense_set.emplace(i);
+  }
 
-  // write document_mask
-  {
-    auto writer = codec()->get_document_mask_writer();
+  size_t version = 42;
 
-    writer->write(dir(), meta, mask_set);
-  }
+  for (auto* mask_set : { &sparse_set, &dense_set }) {
+    irs::segment_meta meta("_1", nullptr);
+    meta.version = version++;
+    meta.docs_count = *mask_set->rbegin();
 
-  // read document_mask
-  {
-    auto reader = codec()->get_document_mask_reader();
-    irs::document_mask expected;
-    EXPECT_TRUE(reader->read(dir(), meta, expected));
-    for (auto id : mask_set) {
-      EXPECT_EQ(1, expected.erase(id));
+    // write document_mask
+    {
+      irs::document_mask docs_mask;
+      for (auto id : *mask_set) {
+        ASSERT_TRUE(docs_mask.insert(id));
+      }
+
+      auto writer = codec()->get_document_mask_writer();
+      writer->write(dir(), meta, docs_mask);
+    }
+
+    // read document_mask
+    {
+      auto reader = codec()->get_document_mask_reader();
+      irs::document_mask expected;
+      EXPECT_TRUE(reader->read(dir(), meta, expected));
+      EXPECT_EQ(mask_set->size(), expected.size());
+      EXPECT_TRUE(std::equal(mask_set->begin(), mask_set->end(), expected.begin()));
+      for (auto id : *mask_set) {
+        EXPECT_TRUE(expected.erase(id));
+      }
+      EXPECT_TRUE(expected.empty());
     }
-    EXPECT_TRUE(expected.empty());
   }
 }
 
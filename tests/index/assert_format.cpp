@@ -260,7 +260,7 @@ void document_mask_writer::write(
 ) {
   EXPECT_EQ(data_.doc_mask().size(), docs_mask.size());
   for (auto doc_id : docs_mask) {
-    EXPECT_EQ(true, data_.doc_mask().find(doc_id) != data_.doc_mask().end());
+    EXPECT_TRUE(data_.doc_mask().contains(doc_id));
   }
 }
 
@@ -702,7 +702,9 @@ void assert_term(
     {
       auto& expected_attrs = expected_docs->attributes();
       auto& actual_attrs = actual_docs->attributes();
-      ASSERT_EQ(expected_attrs.features(), actual_attrs.features());
+      auto actual_features = actual_attrs.features();
+      actual_features.remove<irs::frequency_bound>(); // format specific, not modeled
+      ASSERT_EQ(expected_attrs.features(), actual_features);
 
       auto& expected_freq = expected_attrs.get<irs::frequency>();
       auto& actual_freq = actual_attrs.get<irs::frequency>();
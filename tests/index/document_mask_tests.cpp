@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2019 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "index/document_mask.hpp"
+#include "utils/misc.hpp"
+
+#include <set>
+
+TEST(document_mask_test, ctor) {
+  const irs::document_mask mask;
+  ASSERT_TRUE(mask.empty());
+  ASSERT_EQ(0, mask.size());
+  ASSERT_EQ(mask.begin(), mask.end());
+  ASSERT_FALSE(mask.contains(irs::doc_limits::min()));
+  ASSERT_FALSE(mask.contains(irs::doc_limits::eof()));
+  ASSERT_EQ(irs::doc_limits::min(), mask.next_unmasked(irs::doc_limits::min()));
+}
+
+TEST(document_mask_test, insert_erase) {
+  irs::document_mask mask;
+  ASSERT_TRUE(mask.insert(1));
+  ASSERT_FALSE(mask.insert(1));
+  ASSERT_TRUE(mask.insert(64));
+  ASSERT_TRUE(mask.insert(100000));
+  ASSERT_FALSE(mask.insert(64));
+  ASSERT_EQ(3, mask.size());
+  ASSERT_FALSE(mask.empty());
+  ASSERT_TRUE(mask.contains(1));
+  ASSERT_TRUE(mask.contains(64));
+  ASSERT_TRUE(mask.contains(100000));
+  ASSERT_FALSE(mask.contains(2));
+  ASSERT_FALSE(mask.contains(100001));
+  ASSERT_FALSE(mask.contains(irs::doc_limits::eof()));
+
+  // masked documents are visited in ascending order
+  const std::vector<irs::doc_id_t> expected{ 1, 64, 100000 };
+  ASSERT_EQ(expected, std::vector<irs::doc_id_t>(mask.begin(), mask.end()));
+
+  ASSERT_TRUE(mask.erase(64));
+  ASSERT_FALSE(mask.erase(64));
+  ASSERT_FALSE(mask.erase(irs::doc_limits::eof()));
+  ASSERT_EQ(2, mask.size());
+  ASSERT_FALSE(mask.contains(64));
+
+  // copy
+  irs::document_mask copy(mask);
+  ASSERT_EQ(mask.size(), copy.size());
+  ASSERT_TRUE(std::equal(mask.begin(), mask.end(), copy.begin()));
+  ASSERT_TRUE(copy.erase(1));
+  ASSERT_TRUE(mask.contains(1));
+
+  // move
+  irs::document_mask moved(std::move(copy));
+  ASSERT_EQ(1, moved.size());
+  ASSERT_TRUE(moved.contains(100000));
+
+  mask.clear();
+  ASSERT_TRUE(mask.empty());
+  ASSERT_EQ(mask.begin(), mask.end());
+  ASSERT_FALSE(mask.contains(1));
+}
+
+TEST(document_mask_test, next_unmasked) {
+  irs::document_mask mask;
+
+  // mask a run spanning several words
+  for (irs::doc_id_t doc = 3; doc < 300; ++doc) {
+    ASSERT_TRUE(mask.insert(doc));
+  }
+  ASSERT_TRUE(mask.insert(301));
+
+  ASSERT_EQ(1, mask.next_unmasked(1));
+  ASSERT_EQ(2, mask.next_unmasked(2));
+  ASSERT_EQ(300, mask.next_unmasked(3));
+  ASSERT_EQ(300, mask.next_unmasked(128));
+  ASSERT_EQ(300, mask.next_unmasked(300));
+  ASSERT_EQ(302, mask.next_unmasked(301));
+  ASSERT_EQ(100000, mask.next_unmasked(100000));
+  ASSERT_EQ(irs::doc_limits::eof(), mask.next_unmasked(irs::doc_limits::eof()));
+
+  // run up to the end of the bitmap
+  irs::document_mask full;
+  full.reserve(128);
+  for (irs::doc_id_t doc = 0; doc < 128; ++doc) {
+    ASSERT_TRUE(full.insert(doc));
+  }
+  ASSERT_EQ(128, full.next_unmasked(0));
+}
+
+TEST(document_mask_test, merge) {
+  const irs::document_mask::word_t words[] { 0x5, 0, 0x8000000000000001 };
+
+  irs::document_mask mask;
+  ASSERT_TRUE(mask.insert(2));
+  ASSERT_TRUE(mask.insert(1000));
+  mask.merge(words, IRESEARCH_COUNTOF(words));
+
+  const std::vector<irs::doc_id_t> expected{ 0, 2, 128, 191, 1000 };
+  ASSERT_EQ(expected.size(), mask.size());
+  ASSERT_EQ(expected, std::vector<irs::doc_id_t>(mask.begin(), mask.end()));
+}
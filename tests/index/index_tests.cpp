@@ -10961,6 +10961,36 @@ TEST_P(index_test_case, arango_demo_docs) {
   assert_index();
 }
 
+TEST_P(index_test_case, arango_demo_docs_concurrent_analysis) {
+  irs::async_utils::thread_pool pool(4, 4);
+  irs::index_writer::init_options opts;
+  opts.analysis_pool = &pool;
+
+  {
+    tests::json_doc_generator gen(
+      resource("arango_demo.json"),
+      &tests::payloaded_json_field_factory);
+    add_segment(gen, irs::OM_CREATE, opts);
+  }
+  assert_index();
+
+  // a single field per document
+  {
+    tests::json_doc_generator gen(
+      resource("simple_sequential.json"),
+      [](tests::document& doc, const std::string& name, const tests::json_doc_generator::json_value& data) {
+        if (data.is_string() && name == "name") {
+          doc.insert(std::make_shared<tests::templates::string_field>(
+            irs::string_ref(name),
+            data.str
+          ));
+        }
+    });
+    add_segment(gen, irs::OM_APPEND, opts);
+  }
+  assert_index();
+}
+
 TEST_P(index_test_case, check_fields_order) {
   iterate_fields();
 }
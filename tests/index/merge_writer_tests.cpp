@@ -27,6 +27,7 @@
 #include "store/memory_directory.hpp"
 #include "utils/type_limits.hpp"
 #include "index/merge_writer.hpp"
+#include "search/term_filter.hpp"
 
 namespace tests {
   class merge_writer_tests: public ::testing::Test {
@@ -2428,6 +2429,140 @@ TEST_F(merge_writer_tests, test_merge_writer_field_features) {
   }
 }
 
+TEST_F(merge_writer_tests, test_merge_writer_concurrent) {
+  struct reverse_comparer : irs::comparer {
+    virtual bool less(const irs::bytes_ref& lhs, const irs::bytes_ref& rhs) const override {
+      return rhs < lhs;
+    }
+  } comparer;
+
+  auto codec_ptr = irs::formats::get("1_1");
+  ASSERT_NE(nullptr, codec_ptr);
+
+  auto read_file = [](irs::directory& dir, const std::string& name) {
+    auto in = dir.open(name, irs::IOAdvice::NORMAL);
+    EXPECT_NE(nullptr, in);
+    irs::bstring buf(in ? in->length() : 0, 0);
+
+    if (!buf.empty()) {
+      in->read_bytes(&buf[0], buf.size());
+    }
+
+    return buf;
+  };
+
+  for (const irs::comparer* comparator : { static_cast<const irs::comparer*>(nullptr), static_cast<const irs::comparer*>(&comparer) }) {
+    SCOPED_TRACE(comparator ? "sorted" : "unsorted");
+    irs::memory_directory data_dir;
+
+    // populate directory
+    {
+      tests::json_doc_generator gen(
+        test_base::resource("simple_sequential.json"),
+        [](tests::document& doc, const std::string& name, const tests::json_doc_generator::json_value& data) {
+          if (!data.is_string()) {
+            return;
+          }
+
+          auto field = std::make_shared<tests::templates::string_field>(
+            irs::string_ref(name),
+            data.str
+          );
+
+          doc.insert(field);
+
+          if (name == "name") {
+            doc.sorted = field;
+          }
+
+          // add 2 identical fields (without storing) to trigger non-default norm value
+          if (name == "duplicated") {
+            for (size_t i = 2; i; --i) {
+              doc.insert(std::make_shared<tests::templates::string_field>(
+                irs::string_ref("norm"),
+                data.str,
+                irs::flags({ irs::norm::type() })
+              ), true, false);
+            }
+          }
+      });
+
+      irs::index_writer::init_options opts;
+      opts.comparator = comparator;
+      auto writer = irs::index_writer::make(data_dir, codec_ptr, irs::OM_CREATE, opts);
+
+      for (size_t i = 0; auto* doc = gen.next(); ++i) {
+        if (comparator) {
+          ASSERT_TRUE(insert(
+            *writer,
+            doc->indexed.begin(), doc->indexed.end(),
+            doc->stored.begin(), doc->stored.end(),
+            doc->sorted
+          ));
+        } else {
+          ASSERT_TRUE(insert(
+            *writer,
+            doc->indexed.begin(), doc->indexed.end(),
+            doc->stored.begin(), doc->stored.end()
+          ));
+        }
+
+        if (i % 10 == 9) {
+          writer->commit(); // create segmentN
+        }
+      }
+
+      // remove documents having norms
+      auto query = std::make_shared<irs::by_term>();
+      query->field("name").term("A");
+      writer->documents().remove(query);
+      writer->commit();
+    }
+
+    auto reader = irs::directory_reader::open(data_dir, codec_ptr);
+    ASSERT_LT(1, reader.size());
+
+    irs::async_utils::thread_pool pool(2);
+    irs::memory_directory expected_dir;
+    irs::memory_directory actual_dir;
+    irs::index_meta::index_segment_t expected_segment;
+    irs::index_meta::index_segment_t actual_segment;
+    expected_segment.meta.codec = codec_ptr;
+    expected_segment.meta.name = "merged";
+    actual_segment.meta.codec = codec_ptr;
+    actual_segment.meta.name = "merged";
+
+    irs::merge_writer expected_writer(expected_dir, comparator);
+    irs::merge_writer actual_writer(actual_dir, comparator, &pool);
+
+    for (auto& segment : reader) {
+      expected_writer.add(segment);
+      actual_writer.add(segment);
+    }
+
+    ASSERT_TRUE(expected_writer.flush(expected_segment));
+    ASSERT_TRUE(actual_writer.flush(actual_segment));
+
+    // output is the same as of sequential merge
+    ASSERT_EQ(expected_segment.meta.docs_count, actual_segment.meta.docs_count);
+    ASSERT_EQ(expected_segment.meta.live_docs_count, actual_segment.meta.live_docs_count);
+    ASSERT_EQ(expected_segment.meta.column_store, actual_segment.meta.column_store);
+    ASSERT_EQ(expected_segment.meta.sort, actual_segment.meta.sort);
+    ASSERT_EQ(expected_segment.meta.files, actual_segment.meta.files);
+
+    for (auto& file : expected_segment.meta.files) {
+      ASSERT_EQ(read_file(expected_dir, file), read_file(actual_dir, file));
+    }
+
+    auto segment = irs::segment_reader::open(actual_dir, actual_segment.meta);
+    ASSERT_EQ(reader.live_docs_count(), segment.docs_count());
+    auto* field = segment.field("norm");
+    ASSERT_NE(nullptr, field);
+    ASSERT_TRUE(irs::field_limits::valid(field->meta().norm));
+    ASSERT_NE(nullptr, segment.column_reader(field->meta().norm));
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -23,12 +23,14 @@
 
 #include "tests_shared.hpp"
 
+#include "index/field_data.hpp"
 #include "index/postings.hpp"
 #include "store/store_utils.hpp"
 
 #include <iostream>
 #include <vector>
 #include <set>
+#include <algorithm>
 #include <memory>
 
 using namespace iresearch;
@@ -52,12 +54,12 @@ void insert_find_core(const std::vector<std::string>& src) {
     const std::string& s = src[i];
     const bytes_ref b = detail::to_bytes_ref(s);
     auto res = bh.emplace(b);
-    ASSERT_NE(bh.end(), res.first);
+    ASSERT_NE(nullptr, res.first);
     ASSERT_EQ(b, res.first->first);
     ASSERT_TRUE(res.second);
 
     res = bh.emplace(b);
-    ASSERT_NE(bh.end(), res.first);
+    ASSERT_NE(nullptr, res.first);
     ASSERT_EQ(b, res.first->first);
     ASSERT_FALSE(res.second);
   }
@@ -83,6 +85,7 @@ void insert_find_core(const std::vector<std::string>& src) {
   {
     const std::string too_long_str(1 + block_size, 'c');
     auto res = bh.emplace(detail::to_bytes_ref(too_long_str));
+    ASSERT_EQ(nullptr, res.first);
     ASSERT_FALSE(res.second);
   }
 }
@@ -159,3 +162,92 @@ TEST(postings_tests, slice_alignment) {
     ASSERT_EQ(tests::detail::to_bytes_ref("string1"), bh.begin()->first);
   }
 }
+
+TEST(postings_tests, grow_sort) {
+  const uint32_t block_size = 32768;
+  block_pool<byte_type, block_size> pool;
+  block_pool<byte_type, block_size>::inserter writer(pool.begin());
+  postings bh(writer);
+
+  std::vector<std::string> data;
+  for (size_t i = 0; i < 10000; ++i) {
+    data.emplace_back(std::to_string((i * 7919) % 10000));
+  }
+
+  // every term remains reachable while the table is being resized
+  for (size_t i = 0; i < data.size(); ++i) {
+    auto res = bh.emplace(tests::detail::to_bytes_ref(data[i]));
+    ASSERT_TRUE(res.second);
+    res.first->second.doc = irs::doc_id_t(i);
+
+    for (size_t j = 0; j <= i; j += 97) {
+      auto found = bh.emplace(tests::detail::to_bytes_ref(data[j]));
+      ASSERT_FALSE(found.second);
+      ASSERT_EQ(irs::doc_id_t(j), found.first->second.doc);
+    }
+  }
+  ASSERT_EQ(data.size(), bh.size());
+
+  // terms are ordered after sort
+  bh.sort();
+  ASSERT_EQ(data.size(), bh.size());
+  ASSERT_TRUE(std::is_sorted(
+    bh.begin(), bh.end(),
+    [](const postings::value_type& lhs, const postings::value_type& rhs) {
+      return irs::memcmp_less(lhs.first, rhs.first);
+  }));
+
+  // lookup still works after sort
+  for (size_t i = 0; i < data.size(); ++i) {
+    auto res = bh.emplace(tests::detail::to_bytes_ref(data[i]));
+    ASSERT_FALSE(res.second);
+    ASSERT_EQ(tests::detail::to_bytes_ref(data[i]), res.first->first);
+    ASSERT_EQ(irs::doc_id_t(i), res.first->second.doc);
+  }
+
+  auto res = bh.emplace(tests::detail::to_bytes_ref("new_term"));
+  ASSERT_TRUE(res.second);
+  ASSERT_EQ(data.size() + 1, bh.size());
+}
+
+TEST(postings_tests, stable_addresses) {
+  const uint32_t block_size = 32768;
+  block_pool<byte_type, block_size> pool;
+  block_pool<byte_type, block_size>::inserter writer(pool.begin());
+  postings bh(writer);
+
+  std::vector<std::string> data;
+  std::vector<const posting*> postings;
+  for (size_t i = 0; i < 5000; ++i) {
+    data.emplace_back(std::to_string(i));
+    auto res = bh.emplace(tests::detail::to_bytes_ref(data.back()));
+    ASSERT_TRUE(res.second);
+    res.first->second.doc = irs::doc_id_t(i);
+    postings.emplace_back(&res.first->second);
+  }
+
+  // postings don't move while the storage grows
+  for (size_t i = 0; i < data.size(); ++i) {
+    auto res = bh.emplace(tests::detail::to_bytes_ref(data[i]));
+    ASSERT_FALSE(res.second);
+    ASSERT_EQ(postings[i], &res.first->second);
+    ASSERT_EQ(irs::doc_id_t(i), postings[i]->doc);
+  }
+
+  // iteration follows the order of insertion
+  size_t i = 0;
+  for (auto& entry : bh) {
+    ASSERT_EQ(tests::detail::to_bytes_ref(data[i]), entry.first);
+    ++i;
+  }
+  ASSERT_EQ(data.size(), i);
+
+  // reused storage starts with fresh postings
+  bh.clear();
+  ASSERT_TRUE(bh.empty());
+  ASSERT_EQ(bh.begin(), bh.end());
+  auto res = bh.emplace(tests::detail::to_bytes_ref(data.back()));
+  ASSERT_TRUE(res.second);
+  ASSERT_EQ(1, res.first->second.size);
+  ASSERT_EQ(0, res.first->second.offs);
+}
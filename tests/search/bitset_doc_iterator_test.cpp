@@ -831,6 +831,77 @@ TEST(bitset_iterator_test, seek_next) {
   }
 }
 
+TEST(bitset_iterator_test, next_batch) {
+  auto& reader = irs::sub_reader::empty();
+  auto& filter_attrs = irs::attribute_store::empty_instance();
+
+  // empty bitset
+  {
+    irs::bitset bs;
+    irs::bitset_doc_iterator it(reader, filter_attrs, bs, irs::order::prepared::unordered());
+    irs::doc_id_t docs[4];
+    ASSERT_EQ(0, it.next_batch(docs, nullptr, 4));
+    ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it.value()));
+  }
+
+  // non-empty bitset
+  {
+    irs::bitset bs(13*irs::bits_required<irs::bitset::word_t>());
+    for (size_t i = 1; i < bs.size(); i += 3) {
+      bs.set(i);
+    }
+    bs.set(bs.size() - 1);
+
+    std::vector<irs::doc_id_t> expected;
+    {
+      irs::bitset_doc_iterator it(reader, filter_attrs, bs, irs::order::prepared::unordered());
+      while (it.next()) {
+        expected.push_back(it.value());
+      }
+    }
+
+    for (size_t batch : { 1, 7, 64, 100, 1000 }) {
+      irs::bitset_doc_iterator it(reader, filter_attrs, bs, irs::order::prepared::unordered());
+      std::vector<irs::doc_id_t> docs(batch);
+      std::vector<uint32_t> freqs(batch, 42);
+      std::vector<irs::doc_id_t> actual;
+
+      size_t count;
+      while ((count = it.next_batch(&docs[0], &freqs[0], batch))) {
+        ASSERT_LE(count, batch);
+        actual.insert(actual.end(), docs.begin(), docs.begin() + count);
+        ASSERT_TRUE(std::all_of(freqs.begin(), freqs.begin() + count, [](uint32_t f) { return 0 == f; }));
+
+        if (count < batch) {
+          ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it.value()));
+          break;
+        }
+
+        ASSERT_EQ(docs[count - 1], it.value());
+      }
+
+      ASSERT_EQ(expected, actual);
+      ASSERT_EQ(0, it.next_batch(&docs[0], nullptr, batch));
+      ASSERT_FALSE(it.next());
+      ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it.value()));
+    }
+
+    // mix seek with next_batch
+    {
+      irs::bitset_doc_iterator it(reader, filter_attrs, bs, irs::order::prepared::unordered());
+      irs::doc_id_t docs[3];
+      ASSERT_EQ(130, it.seek(129));
+      ASSERT_EQ(3, it.next_batch(docs, nullptr, 3));
+      ASSERT_EQ(133, docs[0]);
+      ASSERT_EQ(136, docs[1]);
+      ASSERT_EQ(139, docs[2]);
+      ASSERT_EQ(139, it.value());
+      ASSERT_TRUE(it.next());
+      ASSERT_EQ(142, it.value());
+    }
+  }
+}
+
 #endif
 
 // -----------------------------------------------------------------------------
@@ -24,6 +24,8 @@
 #include "tests_shared.hpp"
 #include "search/all_filter.hpp"
 #include "search/all_iterator.hpp"
+#include "search/bitset_doc_iterator.hpp"
+#include "search/block_max_disjunction.hpp"
 #include "search/boolean_filter.hpp"
 #include "search/disjunction.hpp"
 #include "search/min_match_disjunction.hpp"
@@ -35,6 +37,7 @@
 #include "search/term_query.hpp"
 
 #include <functional>
+#include <numeric>
 
 // ----------------------------------------------------------------------------
 // --SECTION--                                                   Iterator tests
@@ -3673,6 +3676,294 @@ TEST(disjunction_test, scored_seek_next) {
   }
 }
 
+// ----------------------------------------------------------------------------
+// --SECTION--                        Block-max WAND: iterator0 OR iterator1 ...
+// ----------------------------------------------------------------------------
+
+NS_BEGIN(detail)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief iterator over scored documents providing block score bounds
+////////////////////////////////////////////////////////////////////////////////
+class bounded_doc_iterator : public irs::doc_iterator {
+ public:
+  typedef std::vector<std::pair<irs::doc_id_t, size_t>> docs_t; // doc + score
+
+  bounded_doc_iterator(
+      const docs_t& docs,
+      const irs::order::prepared& ord,
+      size_t block_size)
+    : docs_(docs), block_size_(block_size) {
+    est_.value(docs_.size());
+    attrs_.emplace(est_);
+
+    score_.prepare(ord, [this](irs::byte_type* score) {
+      *reinterpret_cast<size_t*>(score) = docs_[pos_ - 1].second;
+    });
+    attrs_.emplace(score_);
+
+    bound_.prepare(
+      ord,
+      [this](irs::byte_type* max) {
+        for (auto& doc : docs_) {
+          auto& value = *reinterpret_cast<size_t*>(max);
+          value = std::max(value, doc.second);
+        }
+        return true;
+      },
+      [this](irs::doc_id_t target, irs::byte_type* bound) {
+        size_t i = 0;
+        while (i < docs_.size() && docs_[i].first < target) {
+          ++i;
+        }
+
+        if (i == docs_.size()) {
+          return irs::type_limits<irs::type_t::doc_id_t>::eof();
+        }
+
+        const auto begin = i - i % block_size_;
+        const auto end = std::min(begin + block_size_, docs_.size());
+        auto& value = *reinterpret_cast<size_t*>(bound);
+        value = 0;
+        for (i = begin; i < end; ++i) {
+          value = std::max(value, docs_[i].second);
+        }
+
+        return docs_[end - 1].first;
+    });
+    attrs_.emplace(bound_);
+  }
+
+  virtual irs::doc_id_t value() const override { return doc_; }
+
+  virtual bool next() override {
+    if (pos_ == docs_.size()) {
+      doc_ = irs::type_limits<irs::type_t::doc_id_t>::eof();
+      return false;
+    }
+
+    doc_ = docs_[pos_++].first;
+    return true;
+  }
+
+  virtual irs::doc_id_t seek(irs::doc_id_t target) override {
+    irs::seek(*this, target);
+    return doc_;
+  }
+
+  virtual const irs::attribute_view& attributes() const NOEXCEPT override {
+    return attrs_;
+  }
+
+ private:
+  irs::attribute_view attrs_;
+  irs::cost est_;
+  irs::score score_;
+  irs::score_bound bound_;
+  const docs_t& docs_;
+  size_t block_size_;
+  size_t pos_{};
+  irs::doc_id_t doc_{ irs::type_limits<irs::type_t::doc_id_t>::invalid() };
+}; // bounded_doc_iterator
+
+NS_END // detail
+
+TEST(block_max_disjunction_test, applicable) {
+  const detail::bounded_doc_iterator::docs_t docs{ { 1, 1 }, { 2, 2 } };
+  const std::vector<irs::doc_id_t> plain_docs{ 1, 2 };
+
+  // descending order
+  {
+    irs::order ord;
+    ord.add<detail::basic_sort>(true, 1);
+    auto prepared_order = ord.prepare();
+
+    irs::block_max_disjunction::doc_iterators_t itrs;
+    itrs.emplace_back(irs::doc_iterator::make<detail::bounded_doc_iterator>(docs, prepared_order, 2));
+    itrs.emplace_back(irs::doc_iterator::make<detail::bounded_doc_iterator>(docs, prepared_order, 2));
+    ASSERT_TRUE(irs::block_max_disjunction::applicable(itrs, prepared_order));
+    ASSERT_FALSE(irs::block_max_disjunction::applicable(itrs, irs::order::prepared::unordered()));
+
+    // sub-iterator without bounds
+    itrs.emplace_back(irs::doc_iterator::make<detail::basic_doc_iterator>(plain_docs.begin(), plain_docs.end()));
+    ASSERT_FALSE(irs::block_max_disjunction::applicable(itrs, prepared_order));
+  }
+
+  // ascending order
+  {
+    irs::order ord;
+    ord.add<detail::basic_sort>(false, 1);
+    auto prepared_order = ord.prepare();
+
+    irs::block_max_disjunction::doc_iterators_t itrs;
+    itrs.emplace_back(irs::doc_iterator::make<detail::bounded_doc_iterator>(docs, prepared_order, 2));
+    ASSERT_FALSE(irs::block_max_disjunction::applicable(itrs, prepared_order));
+  }
+}
+
+TEST(block_max_disjunction_test, top_k) {
+  const std::vector<detail::bounded_doc_iterator::docs_t> docs{
+    { { 1, 1 }, { 2, 7 }, { 5, 1 }, { 7, 2 }, { 9, 1 }, { 11, 1 }, { 45, 9 }, { 46, 1 } },
+    { { 1, 3 }, { 5, 1 }, { 6, 1 }, { 12, 1 }, { 29, 4 }, { 30, 1 }, { 31, 1 } },
+    { { 1, 1 }, { 5, 2 }, { 6, 1 }, { 7, 1 }, { 8, 1 }, { 13, 1 }, { 29, 1 }, { 45, 1 } }
+  };
+
+  irs::order ord;
+  ord.add<detail::basic_sort>(true, 0);
+  auto prepared_order = ord.prepare();
+
+  auto make_iterator = [&docs, &prepared_order](size_t block_size) {
+    irs::block_max_disjunction::doc_iterators_t itrs;
+    for (auto& entry : docs) {
+      itrs.emplace_back(irs::doc_iterator::make<detail::bounded_doc_iterator>(
+        entry, prepared_order, block_size
+      ));
+    }
+
+    return irs::doc_iterator::make<irs::block_max_disjunction>(
+      std::move(itrs), prepared_order
+    );
+  };
+
+  // exhaustive evaluation
+  std::map<irs::doc_id_t, size_t> expected;
+  for (auto& entry : docs) {
+    for (auto& doc : entry) {
+      expected[doc.first] += doc.second;
+    }
+  }
+
+  // no threshold
+  for (size_t block_size = 1; block_size < 4; ++block_size) {
+    auto it = make_iterator(block_size);
+    auto& threshold = it->attributes().get<irs::score_threshold>();
+    ASSERT_TRUE(bool(threshold));
+    ASSERT_EQ(nullptr, threshold->value);
+    ASSERT_EQ(23, irs::cost::extract(it->attributes()));
+
+    auto& score = irs::score::extract(it->attributes());
+    for (auto& entry : expected) {
+      ASSERT_TRUE(it->next());
+      ASSERT_EQ(entry.first, it->value());
+      score.evaluate();
+      ASSERT_EQ(entry.second, *reinterpret_cast<const size_t*>(score.c_str()));
+    }
+    ASSERT_FALSE(it->next());
+    ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it->value()));
+  }
+
+  // fixed threshold
+  for (size_t block_size = 1; block_size < 4; ++block_size) {
+    const size_t min_score = 3;
+    auto it = make_iterator(block_size);
+    it->attributes().get<irs::score_threshold>()->value
+      = reinterpret_cast<const irs::byte_type*>(&min_score);
+
+    // iterator may emit non-competitive candidates, but
+    // must not miss any of the competitive documents
+    std::map<irs::doc_id_t, size_t> expected_competitive;
+    for (auto& entry : expected) {
+      if (entry.second > min_score) {
+        expected_competitive.emplace(entry);
+      }
+    }
+
+    std::map<irs::doc_id_t, size_t> competitive;
+    size_t candidates = 0;
+    auto& score = irs::score::extract(it->attributes());
+    while (it->next()) {
+      ++candidates;
+      score.evaluate();
+      const auto value = *reinterpret_cast<const size_t*>(score.c_str());
+      ASSERT_EQ(expected[it->value()], value);
+
+      if (value > min_score) {
+        competitive.emplace(it->value(), value);
+      }
+    }
+    ASSERT_EQ(expected_competitive, competitive);
+    ASSERT_LT(candidates, expected.size());
+  }
+
+  // seek with and without threshold
+  for (size_t block_size = 1; block_size < 4; ++block_size) {
+    auto it = make_iterator(block_size);
+    ASSERT_EQ(5, it->seek(3));
+    ASSERT_EQ(5, it->seek(5));
+    ASSERT_EQ(5, it->seek(1)); // no backward moves
+    auto& score = irs::score::extract(it->attributes());
+    score.evaluate();
+    ASSERT_EQ(expected[5], *reinterpret_cast<const size_t*>(score.c_str()));
+    ASSERT_TRUE(it->next());
+    ASSERT_EQ(6, it->value());
+
+    // only document 45 beats the threshold after 12
+    const size_t min_score = 9;
+    it->attributes().get<irs::score_threshold>()->value
+      = reinterpret_cast<const irs::byte_type*>(&min_score);
+    ASSERT_EQ(45, it->seek(12));
+    score.evaluate();
+    ASSERT_EQ(expected[45], *reinterpret_cast<const size_t*>(score.c_str()));
+    while (it->next()) {
+      ASSERT_EQ(46, it->value()); // non-competitive candidate at most
+    }
+  }
+
+  // estimation is forwarded
+  {
+    irs::block_max_disjunction::doc_iterators_t itrs;
+    for (auto& entry : docs) {
+      itrs.emplace_back(irs::doc_iterator::make<detail::bounded_doc_iterator>(
+        entry, prepared_order, 1
+      ));
+    }
+
+    auto it = irs::doc_iterator::make<irs::block_max_disjunction>(
+      std::move(itrs), prepared_order, 42
+    );
+    ASSERT_EQ(42, irs::cost::extract(it->attributes()));
+  }
+
+  // threshold is raised during evaluation by a top-k consumer
+  for (size_t block_size = 1; block_size < 4; ++block_size) {
+    const size_t k = 3;
+    std::vector<size_t> expected_top;
+    for (auto& entry : expected) {
+      expected_top.push_back(entry.second);
+    }
+    std::sort(expected_top.rbegin(), expected_top.rend());
+    expected_top.resize(k);
+
+    auto it = make_iterator(block_size);
+    auto& threshold = it->attributes().get<irs::score_threshold>()->value;
+    auto& score = irs::score::extract(it->attributes());
+    std::vector<size_t> top; // min heap
+    size_t min_score;
+
+    while (it->next()) {
+      score.evaluate();
+      const auto value = *reinterpret_cast<const size_t*>(score.c_str());
+
+      if (top.size() < k) {
+        top.push_back(value);
+        std::push_heap(top.begin(), top.end(), std::greater<size_t>());
+      } else if (value > top.front()) {
+        std::pop_heap(top.begin(), top.end(), std::greater<size_t>());
+        top.back() = value;
+        std::push_heap(top.begin(), top.end(), std::greater<size_t>());
+      }
+
+      if (top.size() == k) {
+        min_score = top.front();
+        threshold = reinterpret_cast<const irs::byte_type*>(&min_score);
+      }
+    }
+
+    std::sort(top.rbegin(), top.rend());
+    ASSERT_EQ(expected_top, top);
+  }
+}
+
 // ----------------------------------------------------------------------------
 // --SECTION--  Minimum match count: iterator0 OR iterator1 OR iterator2 OR ...
 // ----------------------------------------------------------------------------
@@ -5558,6 +5849,139 @@ TEST(conjunction_test, scored_seek_next) {
   }
 }
 
+TEST(conjunction_test, adaptive_lead) {
+  using conjunction = irs::conjunction;
+
+  std::vector<std::vector<irs::doc_id_t>> docs(3);
+  for (irs::doc_id_t doc = 1; doc <= 10000; ++doc) {
+    docs[0].push_back(doc); // dense
+    if (0 == doc % 2) docs[1].push_back(doc); // medium
+    if (0 == doc % 100) docs[2].push_back(doc); // rare
+  }
+
+  auto itrs = detail::execute_all<irs::score_iterator_adapter>(docs);
+  const auto* rare = itrs[2].it.get();
+
+  // skewed estimation, dense iterator pretends to be the cheapest one
+  itrs[0]->attributes().get<irs::cost>()->value(1);
+
+  conjunction it(std::move(itrs));
+  ASSERT_EQ(1, irs::cost::extract(it.attributes()));
+  ASSERT_NE(rare, it.begin()->it.get());
+
+  std::vector<irs::doc_id_t> result;
+  while (it.next()) {
+    result.push_back(it.value());
+  }
+  ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it.value()));
+  ASSERT_EQ(docs[2], result);
+
+  // the rarest iterator eventually leads
+  ASSERT_EQ(rare, it.begin()->it.get());
+}
+
+TEST(conjunction_test, adaptive_seek) {
+  using conjunction = irs::conjunction;
+
+  std::vector<std::vector<irs::doc_id_t>> docs(3);
+  for (irs::doc_id_t doc = 1; doc <= 10000; ++doc) {
+    docs[0].push_back(doc);
+    if (0 == doc % 3) docs[1].push_back(doc);
+    if (0 == doc % 7) docs[2].push_back(doc);
+  }
+
+  auto itrs = detail::execute_all<irs::score_iterator_adapter>(docs);
+  itrs[0]->attributes().get<irs::cost>()->value(1);
+
+  conjunction it(std::move(itrs));
+
+  // interleave seeks and nexts while iterators are reordered
+  for (irs::doc_id_t target = 1; target < 10000; target += 50) {
+    const irs::doc_id_t expected = 21*((target + 20) / 21);
+    ASSERT_EQ(expected, it.seek(target));
+    ASSERT_EQ(expected, it.value());
+
+    if (expected + 21 <= 10000) {
+      ASSERT_TRUE(it.next());
+      ASSERT_EQ(expected + 21, it.value());
+    }
+  }
+
+  ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it.seek(10000)));
+}
+
+TEST(conjunction_test, bitset_intersection) {
+  using conjunction = irs::conjunction;
+
+  irs::bitset lhs(200), rhs(100);
+  std::vector<irs::doc_id_t> expected;
+  for (irs::doc_id_t doc = 1; doc < 200; ++doc) {
+    if (0 == doc % 2) lhs.set(doc);
+    if (doc < 100 && 0 == doc % 3) rhs.set(doc);
+    if (doc < 100 && 0 == doc % 6) expected.push_back(doc);
+  }
+
+  // bitsets and a regular iterator
+  {
+    std::vector<irs::doc_id_t> all(199);
+    std::iota(all.begin(), all.end(), 1);
+
+    conjunction::doc_iterators_t itrs;
+    itrs.emplace_back(irs::doc_iterator::make<detail::basic_doc_iterator>(all.begin(), all.end()));
+    itrs.emplace_back(irs::memory::make_unique<irs::bitset_doc_iterator>(lhs));
+    itrs.emplace_back(irs::memory::make_unique<irs::bitset_doc_iterator>(rhs));
+
+    conjunction it(std::move(itrs));
+    ASSERT_EQ(2, it.size()); // bitsets are merged
+    ASSERT_EQ(expected.size(), irs::cost::extract(it.attributes()));
+
+    std::vector<irs::doc_id_t> result;
+    while (it.next()) {
+      result.push_back(it.value());
+    }
+    ASSERT_EQ(expected, result);
+  }
+
+  // bitsets only
+  {
+    conjunction::doc_iterators_t itrs;
+    itrs.emplace_back(irs::memory::make_unique<irs::bitset_doc_iterator>(lhs));
+    itrs.emplace_back(irs::memory::make_unique<irs::bitset_doc_iterator>(rhs));
+
+    conjunction it(std::move(itrs));
+    ASSERT_EQ(1, it.size());
+    ASSERT_EQ(expected[3], it.seek(expected[3]));
+
+    std::vector<irs::doc_id_t> result{ it.value() };
+    while (it.next()) {
+      result.push_back(it.value());
+    }
+    ASSERT_EQ(std::vector<irs::doc_id_t>(expected.begin() + 3, expected.end()), result);
+  }
+
+  // scored bitsets aren't merged
+  {
+    irs::order ord;
+    ord.add<detail::basic_sort>(false, 1);
+    auto prepared_order = ord.prepare();
+
+    conjunction::doc_iterators_t itrs;
+    itrs.emplace_back(irs::memory::make_unique<irs::bitset_doc_iterator>(
+      irs::sub_reader::empty(), irs::attribute_store::empty_instance(), lhs, prepared_order
+    ));
+    itrs.emplace_back(irs::memory::make_unique<irs::bitset_doc_iterator>(rhs));
+
+    conjunction it(std::move(itrs));
+    ASSERT_EQ(2, it.size());
+
+    std::vector<irs::doc_id_t> result;
+    while (it.next()) {
+      result.push_back(it.value());
+    }
+    ASSERT_EQ(expected, result);
+  }
+}
+
 // ----------------------------------------------------------------------------
 // --SECTION--                                      iterator0 AND NOT iterator1
 // ----------------------------------------------------------------------------
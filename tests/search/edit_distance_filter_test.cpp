@@ -0,0 +1,268 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "filter_test_case_base.hpp"
+#include "search/edit_distance_filter.hpp"
+#include "utils/automaton.hpp"
+
+NS_LOCAL
+
+class edit_distance_filter_test_case : public tests::filter_test_case_base {
+ protected:
+  void by_edit_distance_order() {
+    // add segment
+    {
+      tests::json_doc_generator gen(
+        resource("simple_sequential.json"),
+        &tests::generic_json_field_factory);
+      add_segment( gen );
+    }
+
+    auto rdr = open_reader();
+
+    // test collector call count for field/term/finish and term boosts
+    {
+      docs_t docs{ 1, 4, 9, 21, 31, 32 };
+      irs::order order;
+
+      size_t collect_field_count = 0;
+      size_t collect_term_count = 0;
+      size_t finish_count = 0;
+      std::multiset<irs::boost::boost_t> boosts;
+      auto& scorer = order.add<tests::sort::custom_sort>(false);
+
+      scorer.collector_collect_field = [&collect_field_count](const irs::sub_reader&, const irs::term_reader&)->void{
+        ++collect_field_count;
+      };
+      scorer.collector_collect_term = [&collect_term_count](const irs::sub_reader&, const irs::term_reader&, const irs::attribute_view&)->void{
+        ++collect_term_count;
+      };
+      scorer.collectors_collect_ = [&finish_count](irs::attribute_store&, const irs::index_reader&, const irs::sort::field_collector*, const irs::sort::term_collector*)->void {
+        ++finish_count;
+      };
+      scorer.prepare_field_collector_ = [&scorer]()->irs::sort::field_collector::ptr {
+        return irs::memory::make_unique<tests::sort::custom_sort::prepared::collector>(scorer);
+      };
+      scorer.prepare_term_collector_ = [&scorer]()->irs::sort::term_collector::ptr {
+        return irs::memory::make_unique<tests::sort::custom_sort::prepared::collector>(scorer);
+      };
+      scorer.prepare_scorer = [&scorer, &boosts](
+          const irs::sub_reader& segment,
+          const irs::term_reader& field,
+          const irs::attribute_store& query_attrs,
+          const irs::attribute_view& doc_attrs)->irs::sort::scorer::ptr {
+        boosts.insert(irs::boost::extract(query_attrs));
+        return irs::sort::scorer::make<tests::sort::custom_sort::prepared::scorer>(
+          scorer, segment, field, query_attrs, doc_attrs
+        );
+      };
+      check_query(irs::by_edit_distance().max_distance(1).field("prefix").term("abcd"), order, docs, rdr);
+      ASSERT_EQ(5, collect_field_count); // 5 fields (1 per term since treated as a disjunction) in 1 segment
+      ASSERT_EQ(5, collect_term_count); // 5 different terms
+      ASSERT_EQ(5, finish_count); // 5 unque terms
+
+      // exact match gets the full boost
+      ASSERT_EQ((std::multiset<irs::boost::boost_t>{ 0.5f, 0.5f, 0.5f, 0.5f, 1.f }), boosts);
+    }
+  }
+
+  void by_edit_distance_sequential() {
+    // add segment
+    {
+      tests::json_doc_generator gen(
+        resource("simple_sequential.json"),
+        &tests::generic_json_field_factory);
+      add_segment( gen );
+    }
+
+    auto rdr = open_reader();
+
+    // empty query
+    check_query(irs::by_edit_distance(), docs_t{}, costs_t{0}, rdr);
+
+    // empty field
+    check_query(irs::by_edit_distance().max_distance(1).term("xyz"), docs_t{}, costs_t{0}, rdr);
+
+    // invalid field
+    check_query(irs::by_edit_distance().max_distance(1).field("same1").term("xyz"), docs_t{}, costs_t{0}, rdr);
+
+    // no matching terms
+    check_query(irs::by_edit_distance().max_distance(1).field("prefix").term("zzzz"), docs_t{}, costs_t{0}, rdr);
+
+    // exact match
+    check_query(irs::by_edit_distance().field("prefix").term("abcd"), docs_t{1}, costs_t{1}, rdr);
+
+    // whole field
+    {
+      docs_t result;
+      for(size_t i = 0; i < 32; ++i) {
+        result.push_back(irs::doc_id_t((irs::type_limits<irs::type_t::doc_id_t>::min)() + i));
+      }
+
+      costs_t costs{ result.size() };
+
+      check_query(irs::by_edit_distance().max_distance(1).field("same").term("xyy"), result, costs, rdr);
+      check_query(irs::by_edit_distance().max_distance(1).field("name").term(""), result, costs, rdr);
+    }
+
+    // distance 1
+    check_query(irs::by_edit_distance().max_distance(1).field("prefix").term("abcd"), docs_t{1, 4, 9, 21, 31, 32}, costs_t{6}, rdr);
+    check_query(irs::by_edit_distance().max_distance(1).field("prefix").term("abdc"), docs_t{16, 21}, costs_t{2}, rdr);
+
+    // distance 2
+    check_query(irs::by_edit_distance().max_distance(2).field("prefix").term("abcd"), docs_t{1, 4, 9, 16, 21, 31, 32}, costs_t{7}, rdr);
+
+    // transpositions
+    check_query(irs::by_edit_distance().max_distance(1).with_transpositions(true).field("prefix").term("abdc"), docs_t{1, 16, 21}, costs_t{3}, rdr);
+  }
+}; // edit_distance_filter_test_case
+
+TEST(by_edit_distance_test, ctor) {
+  irs::by_edit_distance q;
+  ASSERT_EQ(irs::by_edit_distance::type(), q.type());
+  ASSERT_EQ("", q.field());
+  ASSERT_TRUE(q.term().empty());
+  ASSERT_EQ(irs::boost::no_boost(), q.boost());
+  ASSERT_EQ(1024, q.scored_terms_limit());
+  ASSERT_EQ(0, q.max_distance());
+  ASSERT_FALSE(q.with_transpositions());
+}
+
+TEST(by_edit_distance_test, equal) {
+  irs::by_edit_distance q;
+  q.max_distance(1).field("field").term("term");
+
+  ASSERT_EQ(q, irs::by_edit_distance().max_distance(1).field("field").term("term"));
+  ASSERT_EQ(q.hash(), irs::by_edit_distance().max_distance(1).field("field").term("term").hash());
+  ASSERT_NE(q, irs::by_edit_distance().max_distance(1).field("field1").term("term"));
+  ASSERT_NE(q, irs::by_edit_distance().max_distance(2).field("field").term("term"));
+  ASSERT_NE(q, irs::by_edit_distance().max_distance(1).with_transpositions(true).field("field").term("term"));
+  ASSERT_NE(q, irs::by_edit_distance().max_distance(1).scored_terms_limit(100).field("field").term("term"));
+  ASSERT_NE(q, irs::by_term().field("field").term("term"));
+}
+
+TEST(by_edit_distance_test, boost) {
+  for (irs::byte_type distance : { 0, 1 }) {
+    // no boost
+    {
+      irs::by_edit_distance q;
+      q.max_distance(distance).field("field").term("term");
+
+      auto prepared = q.prepare(irs::sub_reader::empty());
+      ASSERT_EQ(irs::boost::no_boost(), irs::boost::extract(prepared->attributes()));
+    }
+
+    // with boost
+    {
+      iresearch::boost::boost_t boost = 1.5f;
+      irs::by_edit_distance q;
+      q.max_distance(distance).field("field").term("term");
+      q.boost(boost);
+
+      auto prepared = q.prepare(irs::sub_reader::empty());
+      ASSERT_EQ(boost, irs::boost::extract(prepared->attributes()));
+    }
+  }
+}
+
+TEST(by_edit_distance_test, edit_distance) {
+  auto distance = [](const irs::string_ref& lhs, const irs::string_ref& rhs, size_t max, bool transpositions) {
+    return irs::edit_distance(
+      irs::ref_cast<irs::byte_type>(lhs), irs::ref_cast<irs::byte_type>(rhs), max, transpositions
+    );
+  };
+
+  ASSERT_EQ(0, distance("", "", 2, false));
+  ASSERT_EQ(0, distance("mouse", "mouse", 2, false));
+  ASSERT_EQ(1, distance("mouse", "house", 2, false));
+  ASSERT_EQ(1, distance("mouse", "mose", 2, false));
+  ASSERT_EQ(1, distance("mouse", "mousse", 2, false));
+  ASSERT_EQ(2, distance("mouse", "muose", 2, false));
+  ASSERT_EQ(1, distance("mouse", "muose", 2, true));
+  ASSERT_EQ(3, distance("mouse", "", 2, false)); // exceeds the limit
+  ASSERT_EQ(3, distance("mouse", "cat", 2, false)); // exceeds the limit
+  ASSERT_EQ(1, distance("mouse", "m\xC3\xB6use", 2, false)); // 2 bytes character
+  ASSERT_EQ(1, distance("\xE2\x82\xAC", "$", 2, false)); // 3 bytes character
+}
+
+TEST(by_edit_distance_test, automaton) {
+  auto accept = [](const irs::automaton& a, const irs::string_ref& term) {
+    return a.accept(irs::ref_cast<irs::byte_type>(term));
+  };
+
+  {
+    auto a = irs::from_edit_distance(irs::ref_cast<irs::byte_type>(irs::string_ref("mouse")), 1, false);
+    ASSERT_TRUE(accept(a, "mouse"));
+    ASSERT_TRUE(accept(a, "house"));
+    ASSERT_TRUE(accept(a, "mose"));
+    ASSERT_TRUE(accept(a, "mousse"));
+    ASSERT_TRUE(accept(a, "mouses"));
+    ASSERT_TRUE(accept(a, "m\xC3\xB6use")); // 2 bytes character
+    ASSERT_TRUE(accept(a, "\xF0\x9F\x90\xADouse")); // 4 bytes character
+    ASSERT_FALSE(accept(a, "muose"));
+    ASSERT_FALSE(accept(a, "hose"));
+    ASSERT_FALSE(accept(a, "m\xC3\xB6\xC3\xB6se"));
+  }
+
+  {
+    auto a = irs::from_edit_distance(irs::ref_cast<irs::byte_type>(irs::string_ref("mouse")), 1, true);
+    ASSERT_TRUE(accept(a, "muose"));
+    ASSERT_TRUE(accept(a, "moues"));
+    ASSERT_FALSE(accept(a, "muoes"));
+  }
+
+  {
+    auto a = irs::from_edit_distance(irs::ref_cast<irs::byte_type>(irs::string_ref("m\xC3\xB6use")), 2, false);
+    ASSERT_TRUE(accept(a, "mouse"));
+    ASSERT_TRUE(accept(a, "mose"));
+    ASSERT_FALSE(accept(a, "hose"));
+    ASSERT_TRUE(accept(a, "m\xC3\xB6"  "use"));
+    ASSERT_FALSE(accept(a, "house\xC3\xB6"));
+  }
+}
+
+TEST_P(edit_distance_filter_test_case, by_edit_distance) {
+  by_edit_distance_order();
+  by_edit_distance_sequential();
+}
+
+INSTANTIATE_TEST_CASE_P(
+  edit_distance_filter_test,
+  edit_distance_filter_test_case,
+  ::testing::Combine(
+    ::testing::Values(
+      &tests::memory_directory,
+      &tests::fs_directory,
+      &tests::mmap_directory
+    ),
+    ::testing::Values("1_0")
+  ),
+  tests::to_string
+);
+
+NS_END
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
@@ -0,0 +1,366 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2019 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "filter_test_case_base.hpp"
+#include "search/filter_cache.hpp"
+#include "search/term_filter.hpp"
+
+#include <atomic>
+#include <thread>
+
+NS_LOCAL
+
+class filter_cache_test_case : public tests::filter_test_case_base {
+ protected:
+  void add_sequential_segment() {
+    tests::json_doc_generator gen(
+      resource("simple_sequential.json"),
+      &tests::generic_json_field_factory
+    );
+    add_segment(gen);
+  }
+
+  void cached_admission() {
+    add_sequential_segment();
+
+    auto rdr = open_reader();
+    irs::filter_cache cache(1 << 20, 2);
+
+    irs::by_cached q;
+    q.cache(&cache);
+    q.filter<irs::by_term>().field("duplicated").term("abcd");
+
+    const docs_t expected{ 1, 5, 11, 21, 27, 31 };
+
+    // first lookup, not admitted yet, only counted
+    check_query(q, expected, rdr);
+    ASSERT_EQ(0, cache.size());
+    ASSERT_EQ(0, cache.memory());
+
+    // second lookup, admitted and materialized
+    check_query(q, expected, rdr);
+    ASSERT_EQ(1, cache.size());
+    const auto cached = cache.memory();
+    ASSERT_LT(0, cached);
+
+    // served from the cache
+    check_query(q, expected, rdr);
+    ASSERT_EQ(1, cache.size());
+    ASSERT_EQ(cached, cache.memory());
+
+    // equal filter shares the cached result
+    {
+      irs::by_cached other;
+      other.cache(&cache);
+      other.filter<irs::by_term>().field("duplicated").term("abcd");
+      check_query(other, expected, rdr);
+      ASSERT_EQ(1, cache.size());
+      ASSERT_EQ(cached, cache.memory());
+    }
+
+    // different filter is tracked separately
+    {
+      irs::by_cached other;
+      other.cache(&cache);
+      other.filter<irs::by_term>().field("duplicated").term("vczc");
+      check_query(other, docs_t{ 2, 3, 8, 14, 17, 19, 24 }, rdr);
+      ASSERT_EQ(1, cache.size());
+      check_query(other, docs_t{ 2, 3, 8, 14, 17, 19, 24 }, rdr);
+      ASSERT_EQ(2, cache.size());
+    }
+
+    // no matches
+    {
+      irs::by_cached other;
+      other.cache(&cache);
+      other.filter<irs::by_term>().field("duplicated").term("invalid_term");
+      check_query(other, docs_t{}, rdr);
+      check_query(other, docs_t{}, rdr);
+      check_query(other, docs_t{}, rdr);
+      ASSERT_EQ(3, cache.size());
+    }
+
+    cache.clear();
+    ASSERT_EQ(0, cache.size());
+    ASSERT_EQ(0, cache.memory());
+    check_query(q, expected, rdr);
+  }
+
+  void cached_memory_limit() {
+    add_sequential_segment();
+
+    auto rdr = open_reader();
+    const docs_t expected{ 1, 5, 11, 21, 27, 31 };
+
+    // nothing fits
+    {
+      irs::filter_cache cache(0, 1);
+
+      irs::by_cached q;
+      q.cache(&cache);
+      q.filter<irs::by_term>().field("duplicated").term("abcd");
+
+      check_query(q, expected, rdr);
+      check_query(q, expected, rdr);
+      ASSERT_EQ(0, cache.size());
+      ASSERT_EQ(0, cache.memory());
+    }
+
+    // frequently used filter survives
+    {
+      irs::filter_cache cache(1 << 20, 1);
+
+      irs::by_cached hot;
+      hot.cache(&cache);
+      hot.filter<irs::by_term>().field("duplicated").term("abcd");
+
+      for (size_t i = 0; i < 4; ++i) {
+        check_query(hot, expected, rdr);
+      }
+      ASSERT_EQ(1, cache.size());
+
+      irs::by_cached cold;
+      cold.cache(&cache);
+      cold.filter<irs::by_term>().field("duplicated").term("vczc");
+      check_query(cold, docs_t{ 2, 3, 8, 14, 17, 19, 24 }, rdr);
+      ASSERT_EQ(2, cache.size());
+
+      // shrink the budget to a single entry
+      const auto memory = cache.memory();
+      irs::filter_cache limited(memory - 1, 1);
+      hot.cache(&limited);
+      cold.cache(&limited);
+
+      for (size_t i = 0; i < 4; ++i) {
+        check_query(hot, expected, rdr);
+      }
+      ASSERT_EQ(1, limited.size());
+      check_query(cold, docs_t{ 2, 3, 8, 14, 17, 19, 24 }, rdr);
+      ASSERT_EQ(1, limited.size());
+      ASSERT_GE(memory - 1, limited.memory());
+
+      // 'hot' is still cached
+      const auto hot_memory = limited.memory();
+      check_query(hot, expected, rdr);
+      ASSERT_EQ(hot_memory, limited.memory());
+
+      // a stream of one-off filters doesn't displace 'hot'
+      for (size_t i = 0; i < 26; ++i) {
+        irs::by_cached once;
+        once.cache(&limited);
+        once.filter<irs::by_term>().field("name").term(std::string(1, char('A' + i)));
+        check_query(once, docs_t{ irs::doc_id_t(1 + i) }, rdr);
+      }
+      ASSERT_EQ(1, limited.size());
+      ASSERT_EQ(hot_memory, limited.memory());
+      check_query(hot, expected, rdr);
+      ASSERT_EQ(hot_memory, limited.memory());
+
+      // a filter used more frequently than 'hot' replaces it
+      for (size_t i = 0; i < 8; ++i) {
+        check_query(cold, docs_t{ 2, 3, 8, 14, 17, 19, 24 }, rdr);
+      }
+      ASSERT_EQ(1, limited.size());
+      {
+        auto filter = irs::by_term::make();
+        static_cast<irs::by_term&>(*filter).field("duplicated").term("vczc");
+        bool admit = false;
+        ASSERT_NE(nullptr, limited.get((*rdr)[0], std::move(filter), admit));
+      }
+    }
+  }
+
+  void cached_sharded() {
+    add_sequential_segment();
+
+    auto rdr = open_reader();
+    irs::filter_cache cache(1 << 26, 1);
+    const std::string terms[] = { "abcd", "vczc", "invalid_term" };
+    const docs_t expected[] = {
+      { 1, 5, 11, 21, 27, 31 }, { 2, 3, 8, 14, 17, 19, 24 }, { }
+    };
+
+    std::vector<std::thread> threads;
+    std::atomic<bool> failed{false};
+
+    for (size_t i = 0; i < 4; ++i) {
+      threads.emplace_back([&]() {
+        for (size_t j = 0; j < 100; ++j) {
+          const auto k = j % 3;
+          irs::by_cached q;
+          q.cache(&cache);
+          q.filter<irs::by_term>().field("duplicated").term(terms[k]);
+
+          auto prepared = q.prepare(*rdr);
+          auto docs = prepared->execute((*rdr)[0]);
+          docs_t result;
+          while (docs->next()) {
+            result.push_back(docs->value());
+          }
+
+          if (result != expected[k]) {
+            failed = true;
+          }
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    ASSERT_FALSE(failed);
+    ASSERT_EQ(3, cache.size());
+  }
+
+  void cached_reopen() {
+    add_sequential_segment();
+
+    irs::filter_cache cache(1 << 20, 1);
+
+    irs::by_cached q;
+    q.cache(&cache);
+    q.filter<irs::by_term>().field("duplicated").term("abcd");
+
+    {
+      auto rdr = open_reader();
+      check_query(q, docs_t{ 1, 5, 11, 21, 27, 31 }, rdr);
+      ASSERT_EQ(1, cache.size());
+    }
+
+    // new segment readers aren't served from the cache of released ones
+    {
+      auto rdr = open_reader();
+      check_query(q, docs_t{ 1, 5, 11, 21, 27, 31 }, rdr);
+      ASSERT_EQ(2, cache.size());
+    }
+  }
+
+  void cached_order() {
+    add_sequential_segment();
+
+    auto rdr = open_reader();
+    irs::filter_cache cache(1 << 20, 1);
+
+    irs::by_cached q;
+    q.cache(&cache);
+    q.boost(1.5f);
+    q.filter<irs::by_term>().field("duplicated").term("abcd");
+
+    irs::order ord;
+    ord.add<tests::sort::boost>(false);
+    auto prepared_order = ord.prepare();
+
+    // miss and hit produce the same constant scores
+    for (size_t i = 0; i < 2; ++i) {
+      auto prepared = q.prepare(*rdr, prepared_order);
+      auto& segment = (*rdr)[0];
+      auto docs = prepared->execute(segment, prepared_order);
+      auto& score = docs->attributes().get<irs::score>();
+      ASSERT_TRUE(bool(score));
+
+      docs_t result;
+      while (docs->next()) {
+        score->evaluate();
+        ASSERT_EQ(
+          1.5f,
+          prepared_order.get<tests::sort::boost::score_t>(score->c_str(), 0)
+        );
+        result.push_back(docs->value());
+      }
+      ASSERT_EQ(docs_t({ 1, 5, 11, 21, 27, 31 }), result);
+    }
+    ASSERT_EQ(1, cache.size());
+  }
+}; // filter_cache_test_case
+
+NS_END
+
+TEST(by_cached_test, ctor) {
+  irs::by_cached q;
+  ASSERT_EQ(irs::by_cached::type(), q.type());
+  ASSERT_EQ(nullptr, q.filter());
+  ASSERT_EQ(nullptr, q.cache());
+  ASSERT_EQ(irs::boost::no_boost(), q.boost());
+}
+
+TEST(by_cached_test, equal) {
+  irs::filter_cache cache(1024);
+
+  irs::by_cached q;
+  q.filter<irs::by_term>().field("field").term("term");
+
+  irs::by_cached q1;
+  q1.cache(&cache);
+  q1.filter<irs::by_term>().field("field").term("term");
+  ASSERT_EQ(q, q1);
+  ASSERT_EQ(q.hash(), q1.hash());
+
+  irs::by_cached q2;
+  q2.filter<irs::by_term>().field("field").term("term1");
+  ASSERT_NE(q, q2);
+
+  ASSERT_NE(q, irs::by_cached());
+  ASSERT_EQ(irs::by_cached(), irs::by_cached());
+}
+
+TEST(by_cached_test, empty) {
+  irs::by_cached q;
+  auto prepared = q.prepare(irs::sub_reader::empty());
+  ASSERT_EQ(irs::doc_limits::eof(), prepared->execute(irs::sub_reader::empty())->value());
+}
+
+TEST_P(filter_cache_test_case, cached_admission) {
+  cached_admission();
+}
+
+TEST_P(filter_cache_test_case, cached_memory_limit) {
+  cached_memory_limit();
+}
+
+TEST_P(filter_cache_test_case, cached_sharded) {
+  cached_sharded();
+}
+
+TEST_P(filter_cache_test_case, cached_reopen) {
+  cached_reopen();
+}
+
+TEST_P(filter_cache_test_case, cached_order) {
+  cached_order();
+}
+
+INSTANTIATE_TEST_CASE_P(
+  filter_cache_test,
+  filter_cache_test_case,
+  ::testing::Combine(
+    ::testing::Values(
+      &tests::memory_directory,
+      &tests::fs_directory,
+      &tests::mmap_directory
+    ),
+    ::testing::Values("1_0")
+  ),
+  tests::to_string
+);
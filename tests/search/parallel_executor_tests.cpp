@@ -0,0 +1,233 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "filter_test_case_base.hpp"
+#include "search/all_filter.hpp"
+#include "search/boolean_filter.hpp"
+#include "search/parallel_executor.hpp"
+#include "search/scorers.hpp"
+#include "search/term_filter.hpp"
+#include "search/top_k_collector.hpp"
+
+NS_LOCAL
+
+typedef std::vector<std::pair<const irs::sub_reader*, irs::doc_id_t>> result_t;
+
+result_t collect(irs::top_k_collector& collector) {
+  result_t result;
+
+  collector.visit([&result](const irs::top_k_collector::entry& entry) {
+    result.emplace_back(entry.segment, entry.doc);
+    return true;
+  });
+
+  return result;
+}
+
+class parallel_executor_test_case : public tests::filter_test_case_base {
+ protected:
+  void populate() {
+    tests::json_doc_generator gen(
+      resource("simple_sequential.json"),
+      &tests::generic_json_field_factory
+    );
+
+    auto writer = open_writer();
+
+    // segment spanning multiple chunks
+    {
+      const tests::document* src;
+
+      for (size_t i = 0; i < 5; ++i) {
+        gen.reset();
+
+        while ((src = gen.next())) {
+          ASSERT_TRUE(insert(
+            *writer,
+            src->indexed.begin(), src->indexed.end(),
+            src->stored.begin(), src->stored.end()
+          ));
+        }
+      }
+
+      writer->commit();
+    }
+
+    for (size_t i = 0; i < 2; ++i) {
+      gen.reset();
+      add_segment(*writer, gen);
+    }
+  }
+
+  void execute() {
+    populate();
+
+    auto rdr = open_reader();
+    ASSERT_EQ(3, rdr.size());
+
+    irs::async_utils::thread_pool pool(3);
+    irs::parallel_executor executor(pool, 4, 1); // chunk per 64 documents
+    ASSERT_EQ(4, executor.concurrency());
+
+    irs::Or filter;
+    filter.add<irs::by_term>().field("duplicated").term("abcd");
+    filter.add<irs::by_term>().field("duplicated").term("vczc");
+    filter.add<irs::by_term>().field("name").term("A");
+
+    // count
+    {
+      auto prepared = filter.prepare(rdr);
+
+      uint64_t expected = 0;
+      for (auto& segment : rdr) {
+        auto docs = prepared->execute(segment);
+        while (docs->next()) {
+          ++expected;
+        }
+      }
+
+      ASSERT_NE(0, expected);
+      ASSERT_EQ(expected, executor.count(rdr, *prepared));
+    }
+
+    // matches
+    {
+      auto prepared = filter.prepare(rdr);
+
+      std::vector<irs::bitset> docs;
+      executor.matches(rdr, *prepared, docs);
+      ASSERT_EQ(rdr.size(), docs.size());
+
+      for (size_t i = 0; i < rdr.size(); ++i) {
+        auto& segment = rdr[i];
+        irs::bitset expected(irs::doc_limits::min() + segment.docs_count());
+
+        auto it = prepared->execute(segment);
+        while (it->next()) {
+          expected.set(it->value());
+        }
+
+        ASSERT_EQ(expected, docs[i]);
+      }
+    }
+
+    // top k
+    {
+      irs::order order;
+      order.add(true, irs::scorers::get("bm25", irs::text_format::json, irs::string_ref::NIL));
+      auto prepared_order = order.prepare();
+      auto prepared = filter.prepare(rdr, prepared_order);
+
+      for (size_t k : { 1, 5, 10, 100 }) {
+        irs::top_k_collector expected(prepared_order, k);
+        expected.collect(rdr, *prepared);
+
+        irs::top_k_collector actual(prepared_order, k);
+        executor.collect(rdr, *prepared, actual);
+        ASSERT_EQ(expected.size(), actual.size());
+        ASSERT_EQ(collect(expected), collect(actual));
+      }
+    }
+
+    // exception is propagated to the caller
+    {
+      auto prepared = irs::all().prepare(rdr);
+      std::atomic<size_t> visited{ 0 };
+
+      ASSERT_THROW(
+        executor.execute(
+          rdr, *prepared, irs::order::prepared::unordered(),
+          [&visited](size_t, size_t, irs::doc_iterator&)->void {
+            if (1 == ++visited) {
+              throw irs::io_error();
+            }
+        }),
+        irs::io_error
+      );
+    }
+
+    // all documents are visited exactly once
+    {
+      auto prepared = irs::all().prepare(rdr);
+      std::mutex mutex;
+      std::set<std::pair<size_t, irs::doc_id_t>> visited;
+      size_t count = 0;
+
+      executor.execute(
+        rdr, *prepared, irs::order::prepared::unordered(),
+        [&mutex, &visited, &count](size_t, size_t segment, irs::doc_iterator& docs)->void {
+          while (docs.next()) {
+            SCOPED_LOCK(mutex);
+            visited.emplace(segment, docs.value());
+            ++count;
+          }
+      });
+
+      size_t expected = 0;
+      for (auto& segment : rdr) {
+        expected += segment.live_docs_count();
+      }
+
+      ASSERT_EQ(expected, count);
+      ASSERT_EQ(expected, visited.size());
+    }
+
+    // stopped pool, the calling thread does all the work
+    {
+      pool.stop();
+
+      auto prepared = irs::all().prepare(rdr);
+      uint64_t expected = 0;
+      for (auto& segment : rdr) {
+        expected += segment.live_docs_count();
+      }
+
+      ASSERT_EQ(expected, executor.count(rdr, *prepared));
+    }
+  }
+}; // parallel_executor_test_case
+
+TEST_P(parallel_executor_test_case, execute) {
+  execute();
+}
+
+INSTANTIATE_TEST_CASE_P(
+  parallel_executor_test,
+  parallel_executor_test_case,
+  ::testing::Combine(
+    ::testing::Values(
+      &tests::memory_directory,
+      &tests::fs_directory,
+      &tests::mmap_directory
+    ),
+    ::testing::Values("1_0", "1_1")
+  ),
+  tests::to_string
+);
+
+NS_END
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
@@ -0,0 +1,240 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2019 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "filter_test_case_base.hpp"
+#include "search/term_cache.hpp"
+#include "search/term_filter.hpp"
+#include "search/phrase_filter.hpp"
+
+NS_LOCAL
+
+class term_cache_test_case : public tests::filter_test_case_base {
+ protected:
+  void add_sequential_segment() {
+    tests::json_doc_generator gen(
+      resource("simple_sequential.json"),
+      &tests::generic_json_field_factory
+    );
+    add_segment(gen);
+  }
+
+  void check_cached_query(
+      const irs::filter& filter,
+      irs::term_cache& cache,
+      const docs_t& expected,
+      const costs_t& expected_costs,
+      const irs::index_reader& rdr) {
+    irs::attribute_view ctx;
+    ctx.emplace(cache);
+
+    auto prepared = filter.prepare(rdr, irs::order::prepared::unordered(), ctx);
+
+    docs_t result;
+    costs_t result_costs;
+
+    for (const auto& sub : rdr) {
+      auto docs = prepared->execute(sub);
+      result_costs.push_back(irs::cost::extract(docs->attributes()));
+
+      while (docs->next()) {
+        result.push_back(docs->value());
+      }
+    }
+
+    ASSERT_EQ(expected, result);
+    ASSERT_EQ(expected_costs, result_costs);
+  }
+
+  void by_term_cached() {
+    add_sequential_segment();
+
+    auto rdr = open_reader();
+    irs::term_cache cache(1 << 20);
+    const docs_t expected{ 2, 3, 8, 14, 17, 19, 24 };
+
+    irs::by_term q;
+    q.field("duplicated").term("vczc");
+
+    // miss
+    check_cached_query(q, cache, expected, costs_t{ 7 }, rdr);
+    auto stats = cache.statistics();
+    ASSERT_EQ(0, stats.hits);
+    ASSERT_EQ(1, stats.misses);
+    ASSERT_EQ(1, stats.entries);
+    ASSERT_LT(0, stats.memory);
+
+    // hit, same docs and estimation
+    check_cached_query(q, cache, expected, costs_t{ 7 }, rdr);
+    stats = cache.statistics();
+    ASSERT_EQ(1, stats.hits);
+    ASSERT_EQ(1, stats.misses);
+    ASSERT_EQ(1, stats.entries);
+    ASSERT_DOUBLE_EQ(0.5, stats.hit_rate());
+
+    // absent term is cached as well
+    {
+      irs::by_term absent;
+      absent.field("duplicated").term("invalid_term");
+      check_cached_query(absent, cache, docs_t{}, costs_t{ 0 }, rdr);
+      check_cached_query(absent, cache, docs_t{}, costs_t{ 0 }, rdr);
+      stats = cache.statistics();
+      ASSERT_EQ(2, stats.hits);
+      ASSERT_EQ(2, stats.misses);
+      ASSERT_EQ(2, stats.entries);
+    }
+
+    // absent field isn't looked up
+    {
+      irs::by_term absent;
+      absent.field("invalid_field").term("vczc");
+      check_cached_query(absent, cache, docs_t{}, costs_t{ 0 }, rdr);
+      stats = cache.statistics();
+      ASSERT_EQ(2, stats.hits);
+      ASSERT_EQ(2, stats.misses);
+    }
+
+    // single term phrase shares the entry
+    {
+      irs::by_phrase phrase;
+      phrase.field("duplicated").push_back("vczc");
+      check_cached_query(phrase, cache, expected, costs_t{ 7 }, rdr);
+      stats = cache.statistics();
+      ASSERT_EQ(3, stats.hits);
+      ASSERT_EQ(2, stats.misses);
+    }
+
+    // new segment readers aren't served from the cache of released ones
+    {
+      auto reopened = open_reader();
+      check_cached_query(q, cache, expected, costs_t{ 7 }, reopened);
+      stats = cache.statistics();
+      ASSERT_EQ(3, stats.hits);
+      ASSERT_EQ(3, stats.misses);
+      ASSERT_EQ(3, stats.entries);
+    }
+
+    // without cache
+    check_query(q, expected, costs_t{ 7 }, rdr);
+    ASSERT_EQ(3, cache.statistics().hits);
+
+    cache.clear();
+    stats = cache.statistics();
+    ASSERT_EQ(0, stats.hits);
+    ASSERT_EQ(0, stats.misses);
+    ASSERT_EQ(0, stats.entries);
+    ASSERT_EQ(0, stats.memory);
+  }
+
+  void by_term_cached_memory_limit() {
+    add_sequential_segment();
+
+    auto rdr = open_reader();
+
+    // nothing fits
+    {
+      irs::term_cache cache(0);
+
+      irs::by_term q;
+      q.field("name").term("A");
+      check_cached_query(q, cache, docs_t{ 1 }, costs_t{ 1 }, rdr);
+      check_cached_query(q, cache, docs_t{ 1 }, costs_t{ 1 }, rdr);
+
+      const auto stats = cache.statistics();
+      ASSERT_EQ(0, stats.hits);
+      ASSERT_EQ(2, stats.misses);
+      ASSERT_EQ(0, stats.entries);
+      ASSERT_EQ(0, stats.memory);
+    }
+
+    // least recently used term is evicted
+    {
+      size_t entry_memory;
+      {
+        irs::term_cache cache(1 << 20, 1);
+        check_cached_query(irs::by_term().field("name").term("A"), cache, docs_t{ 1 }, costs_t{ 1 }, rdr);
+        entry_memory = cache.statistics().memory;
+      }
+
+      irs::term_cache cache(2*entry_memory, 1);
+      check_cached_query(irs::by_term().field("name").term("A"), cache, docs_t{ 1 }, costs_t{ 1 }, rdr);
+      check_cached_query(irs::by_term().field("name").term("B"), cache, docs_t{ 2 }, costs_t{ 1 }, rdr);
+      check_cached_query(irs::by_term().field("name").term("A"), cache, docs_t{ 1 }, costs_t{ 1 }, rdr); // hit
+      check_cached_query(irs::by_term().field("name").term("C"), cache, docs_t{ 3 }, costs_t{ 1 }, rdr); // evicts 'B'
+
+      auto stats = cache.statistics();
+      ASSERT_EQ(1, stats.hits);
+      ASSERT_EQ(3, stats.misses);
+      ASSERT_EQ(2, stats.entries);
+      ASSERT_EQ(2*entry_memory, stats.memory);
+
+      check_cached_query(irs::by_term().field("name").term("A"), cache, docs_t{ 1 }, costs_t{ 1 }, rdr); // hit
+      check_cached_query(irs::by_term().field("name").term("B"), cache, docs_t{ 2 }, costs_t{ 1 }, rdr); // miss
+
+      stats = cache.statistics();
+      ASSERT_EQ(2, stats.hits);
+      ASSERT_EQ(4, stats.misses);
+      ASSERT_EQ(2, stats.entries);
+    }
+  }
+}; // term_cache_test_case
+
+NS_END
+
+TEST(term_cache_test, empty) {
+  irs::term_cache cache(1024);
+  irs::term_cache::cookie_ptr cookie;
+
+  // not a segment
+  ASSERT_FALSE(cache.get(irs::sub_reader::empty(), "field", irs::ref_cast<irs::byte_type>(irs::string_ref("term")), cookie));
+  cache.put(irs::sub_reader::empty(), "field", irs::ref_cast<irs::byte_type>(irs::string_ref("term")), nullptr);
+
+  const auto stats = cache.statistics();
+  ASSERT_EQ(0, stats.hits);
+  ASSERT_EQ(0, stats.misses);
+  ASSERT_EQ(0, stats.entries);
+  ASSERT_EQ(0, stats.memory);
+  ASSERT_EQ(0., stats.hit_rate());
+}
+
+TEST_P(term_cache_test_case, by_term_cached) {
+  by_term_cached();
+}
+
+TEST_P(term_cache_test_case, by_term_cached_memory_limit) {
+  by_term_cached_memory_limit();
+}
+
+INSTANTIATE_TEST_CASE_P(
+  term_cache_test,
+  term_cache_test_case,
+  ::testing::Combine(
+    ::testing::Values(
+      &tests::memory_directory,
+      &tests::fs_directory,
+      &tests::mmap_directory
+    ),
+    ::testing::Values("1_0")
+  ),
+  tests::to_string
+);
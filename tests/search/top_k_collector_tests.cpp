@@ -0,0 +1,472 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "filter_test_case_base.hpp"
+#include "index/comparer.hpp"
+#include "search/all_filter.hpp"
+#include "search/boolean_filter.hpp"
+#include "search/score.hpp"
+#include "search/scorers.hpp"
+#include "search/term_filter.hpp"
+#include "search/top_k_collector.hpp"
+
+NS_LOCAL
+
+typedef std::vector<std::pair<const irs::sub_reader*, irs::doc_id_t>> result_t;
+
+result_t collect(irs::top_k_collector& collector) {
+  result_t result;
+
+  collector.visit([&result](const irs::top_k_collector::entry& entry) {
+    result.emplace_back(entry.segment, entry.doc);
+    return true;
+  });
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief iterator over documents with predefined scores
+////////////////////////////////////////////////////////////////////////////////
+class scored_doc_iterator : public irs::doc_iterator {
+ public:
+  typedef std::vector<std::pair<irs::doc_id_t, float_t>> docs_t;
+
+  scored_doc_iterator(const docs_t& docs, const irs::order::prepared& ord)
+    : docs_(docs) {
+    score_.prepare(ord, [this](irs::byte_type* score) {
+      *reinterpret_cast<float_t*>(score) = docs_[pos_ - 1].second;
+    });
+    attrs_.emplace(score_);
+    attrs_.emplace(threshold_);
+  }
+
+  virtual irs::doc_id_t value() const override { return doc_; }
+
+  virtual bool next() override {
+    if (pos_ == docs_.size()) {
+      doc_ = irs::type_limits<irs::type_t::doc_id_t>::eof();
+      return false;
+    }
+
+    // threshold is updated by collector after each document
+    if (pos_ >= k_) {
+      EXPECT_NE(nullptr, threshold_.value);
+    }
+
+    doc_ = docs_[pos_++].first;
+    return true;
+  }
+
+  virtual irs::doc_id_t seek(irs::doc_id_t target) override {
+    irs::seek(*this, target);
+    return doc_;
+  }
+
+  virtual const irs::attribute_view& attributes() const NOEXCEPT override {
+    return attrs_;
+  }
+
+  const irs::score_threshold& threshold() const NOEXCEPT { return threshold_; }
+
+  void expect_threshold_after(size_t k) { k_ = k; }
+
+ private:
+  irs::attribute_view attrs_;
+  irs::score score_;
+  irs::score_threshold threshold_;
+  const docs_t& docs_;
+  size_t pos_{};
+  size_t k_{ std::numeric_limits<size_t>::max() };
+  irs::doc_id_t doc_{ irs::type_limits<irs::type_t::doc_id_t>::invalid() };
+}; // scored_doc_iterator
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lexicographical order of the stored values, missing values go last
+////////////////////////////////////////////////////////////////////////////////
+struct bytes_comparer final : irs::comparer {
+  virtual bool less(const irs::bytes_ref& lhs, const irs::bytes_ref& rhs) const override {
+    if (lhs.null() != rhs.null()) {
+      return rhs.null();
+    }
+
+    return lhs < rhs;
+  }
+}; // bytes_comparer
+
+class top_k_collector_test_case : public tests::filter_test_case_base {
+ protected:
+  void collect_ordered() {
+    // add segments
+    {
+      tests::json_doc_generator gen(
+        resource("simple_sequential.json"),
+        &tests::generic_json_field_factory
+      );
+      add_segment(gen);
+      gen.reset();
+      add_segment(gen);
+    }
+
+    auto rdr = open_reader();
+
+    irs::Or filter;
+    filter.add<irs::by_term>().field("duplicated").term("abcd");
+    filter.add<irs::by_term>().field("duplicated").term("vczc");
+    filter.add<irs::by_term>().field("prefix").term("abcd");
+    filter.add<irs::by_term>().field("name").term("A");
+
+    irs::order order;
+    order.add(true, irs::scorers::get("tfidf", irs::text_format::json, irs::string_ref::NIL));
+    auto prepared_order = order.prepare();
+    auto prepared_filter = filter.prepare(rdr, prepared_order);
+
+    // documents are skipped only if a consumer is going to drive the threshold
+    for (auto& segment : rdr) {
+      auto docs = prepared_filter->execute(segment, prepared_order);
+      ASSERT_FALSE(docs->attributes().contains<irs::score_threshold>());
+
+      irs::attribute_view ctx;
+      irs::score_threshold threshold;
+      ctx.emplace(threshold);
+      docs = prepared_filter->execute(segment, prepared_order, ctx);
+      ASSERT_EQ(
+        "1_1" == codec()->type().name(),
+        docs->attributes().contains<irs::score_threshold>()
+      );
+    }
+
+    // exhaustive evaluation
+    std::vector<std::pair<irs::bstring, result_t::value_type>> expected;
+    for (auto& segment : rdr) {
+      auto docs = prepared_filter->execute(segment, prepared_order);
+      auto& score = irs::score::extract(docs->attributes());
+
+      while (docs->next()) {
+        score.evaluate();
+        expected.emplace_back(score.value(), std::make_pair(&segment, docs->value()));
+      }
+    }
+
+    // documents with equal scores are ordered by segment and id
+    std::stable_sort(
+      expected.begin(), expected.end(),
+      [&prepared_order](
+          const std::pair<irs::bstring, result_t::value_type>& lhs,
+          const std::pair<irs::bstring, result_t::value_type>& rhs) {
+        return prepared_order.less(lhs.first.c_str(), rhs.first.c_str());
+    });
+
+    for (size_t k : { 0, 1, 3, 7, 100 }) {
+      irs::top_k_collector collector(prepared_order, k);
+      ASSERT_EQ(nullptr, collector.threshold());
+      collector.collect(rdr, *prepared_filter);
+      // non-competitive documents may be skipped once threshold is known
+      if (k) {
+        ASSERT_LE(collector.size(), collector.hits());
+        ASSERT_GE(expected.size(), collector.hits());
+      } else {
+        ASSERT_EQ(expected.size(), collector.hits());
+      }
+      ASSERT_EQ(std::min(k, expected.size()), collector.size());
+
+      if (k && k <= expected.size()) {
+        ASSERT_NE(nullptr, collector.threshold());
+        ASSERT_FALSE(prepared_order.less(collector.threshold(), expected[k - 1].first.c_str()));
+        ASSERT_FALSE(prepared_order.less(expected[k - 1].first.c_str(), collector.threshold()));
+      }
+
+      result_t expected_top;
+      for (size_t i = 0, size = std::min(k, expected.size()); i < size; ++i) {
+        expected_top.emplace_back(expected[i].second);
+      }
+
+      ASSERT_EQ(expected_top, collect(collector));
+
+      // collector is reusable
+      collector.clear();
+      ASSERT_EQ(0, collector.size());
+      ASSERT_EQ(0, collector.hits());
+      collector.collect(rdr, *prepared_filter);
+      ASSERT_EQ(expected_top.size(), collector.size());
+      ASSERT_EQ(expected_top, collect(collector));
+    }
+  }
+
+  void collect_tie_breaker() {
+    // add segment
+    {
+      tests::json_doc_generator gen(
+        resource("simple_sequential.json"),
+        &tests::generic_json_field_factory
+      );
+      add_segment(gen);
+    }
+
+    auto rdr = open_reader();
+    ASSERT_EQ(1, rdr.size());
+    auto& segment = rdr[0];
+    auto* column = segment.column_reader("duplicated");
+    ASSERT_NE(nullptr, column);
+    auto values = column->values();
+
+    // exhaustive evaluation, all scores are equal
+    std::vector<std::pair<irs::bstring, irs::doc_id_t>> expected; // value + doc
+    {
+      auto docs = segment.docs_iterator();
+      irs::bytes_ref value;
+
+      while (docs->next()) {
+        expected.emplace_back(
+          values(docs->value(), value) ? irs::bstring(value.c_str(), value.size()) : irs::bstring(),
+          docs->value()
+        );
+      }
+    }
+
+    // documents without values go last
+    std::stable_sort(
+      expected.begin(), expected.end(),
+      [](const std::pair<irs::bstring, irs::doc_id_t>& lhs,
+         const std::pair<irs::bstring, irs::doc_id_t>& rhs) {
+        if (lhs.first.empty() != rhs.first.empty()) {
+          return rhs.first.empty();
+        }
+
+        return lhs.first < rhs.first;
+    });
+
+    irs::order order;
+    order.add(true, irs::scorers::get("bm25", irs::text_format::json, irs::string_ref::NIL));
+    auto prepared_order = order.prepare();
+    auto prepared_filter = irs::all().prepare(rdr, prepared_order);
+
+    const size_t k = 10;
+    irs::top_k_collector collector(prepared_order, k, "duplicated");
+    collector.collect(rdr, *prepared_filter);
+    ASSERT_EQ(expected.size(), collector.hits());
+
+    result_t expected_top;
+    for (size_t i = 0; i < k; ++i) {
+      expected_top.emplace_back(&segment, expected[i].second);
+    }
+
+    ASSERT_EQ(expected_top, collect(collector));
+  }
+
+  void collect_sorted() {
+    const irs::string_ref sorted_column = "name";
+    bytes_comparer less;
+
+    // add sorted segments
+    {
+      tests::json_doc_generator gen(
+        resource("simple_sequential.json"),
+        [&sorted_column](tests::document& doc, const std::string& name, const tests::json_doc_generator::json_value& data) {
+          tests::generic_json_field_factory(doc, name, data);
+
+          if (name == sorted_column) {
+            auto fields = doc.indexed.find(name);
+
+            if (!fields.empty()) {
+              doc.sorted = fields.back();
+            }
+          }
+      });
+
+      irs::index_writer::init_options opts;
+      opts.comparator = &less;
+      add_segment(gen, irs::OM_CREATE, opts);
+      gen.reset();
+      add_segment(gen, irs::OM_APPEND, opts);
+    }
+
+    auto rdr = open_reader();
+    ASSERT_EQ(2, rdr.size());
+
+    irs::order order;
+    order.add(true, irs::scorers::get("bm25", irs::text_format::json, irs::string_ref::NIL));
+    auto prepared_order = order.prepare();
+
+    irs::Or filter;
+    filter.add<irs::by_term>().field("same").term("xyz");
+    filter.add<irs::by_term>().field("prefix").term("abcd");
+    auto prepared_filter = filter.prepare(rdr, prepared_order);
+
+    // exhaustive evaluation
+    std::vector<std::pair<irs::bstring, result_t::value_type>> expected; // value + doc
+    // formats without sorting support produce unsorted segments
+    const bool sorted = nullptr != rdr[0].sort();
+
+    for (auto& segment : rdr) {
+      ASSERT_EQ(sorted, nullptr != segment.sort());
+      auto values = sorted
+        ? segment.sort()->values()
+        : irs::columnstore_reader::empty_reader();
+      auto docs = prepared_filter->execute(segment, prepared_order);
+      irs::bytes_ref value;
+
+      while (docs->next()) {
+        ASSERT_EQ(sorted, values(docs->value(), value));
+        expected.emplace_back(
+          irs::bstring(value.c_str(), value.size()),
+          std::make_pair(&segment, docs->value())
+        );
+      }
+    }
+
+    // documents with equal values are ordered by segment and id
+    std::stable_sort(
+      expected.begin(), expected.end(),
+      [&less](const std::pair<irs::bstring, result_t::value_type>& lhs,
+              const std::pair<irs::bstring, result_t::value_type>& rhs) {
+        return less(lhs.first, rhs.first);
+    });
+
+    for (size_t k : { 1, 3, 7, 100 }) {
+      irs::top_k_collector collector(prepared_order, k, less);
+      ASSERT_EQ(&less, collector.comparator());
+      collector.collect(rdr, *prepared_filter);
+      ASSERT_EQ(nullptr, collector.threshold());
+      ASSERT_EQ(std::min(k, expected.size()), collector.size());
+
+      // each sorted segment is terminated after the first rejected document
+      if (sorted && k < expected.size()) {
+        ASSERT_LE(collector.size(), collector.hits());
+        ASSERT_GE(2*(k + 1), collector.hits());
+      } else {
+        ASSERT_EQ(expected.size(), collector.hits());
+      }
+
+      result_t expected_top;
+      for (size_t i = 0, size = std::min(k, expected.size()); i < size; ++i) {
+        expected_top.emplace_back(expected[i].second);
+      }
+
+      ASSERT_EQ(expected_top, collect(collector));
+
+      // scores are still evaluated for the collected documents
+      collector.visit([](const irs::top_k_collector::entry& entry) {
+        EXPECT_NE(0.f, *reinterpret_cast<const float_t*>(entry.score));
+        return true;
+      });
+    }
+  }
+}; // top_k_collector_test_case
+
+TEST_P(top_k_collector_test_case, collect) {
+  collect_ordered();
+}
+
+TEST_P(top_k_collector_test_case, tie_breaker) {
+  collect_tie_breaker();
+}
+
+TEST_P(top_k_collector_test_case, sorted_segments) {
+  collect_sorted();
+}
+
+INSTANTIATE_TEST_CASE_P(
+  top_k_collector_test,
+  top_k_collector_test_case,
+  ::testing::Combine(
+    ::testing::Values(
+      &tests::memory_directory,
+      &tests::fs_directory,
+      &tests::mmap_directory
+    ),
+    ::testing::Values("1_0", "1_1")
+  ),
+  tests::to_string
+);
+
+TEST(top_k_collector_test, threshold) {
+  irs::order order;
+  order.add(true, irs::scorers::get("tfidf", irs::text_format::json, irs::string_ref::NIL));
+  auto prepared_order = order.prepare();
+
+  const scored_doc_iterator::docs_t docs{
+    { 1, 1.f }, { 2, 5.f }, { 3, 2.f }, { 4, 7.f }, { 5, 3.f }, { 6, 5.f }, { 7, 0.5f }
+  };
+
+  // threshold is reported once 'k' documents are collected
+  {
+    irs::top_k_collector collector(prepared_order, 3);
+    scored_doc_iterator it(docs, prepared_order);
+    it.expect_threshold_after(3);
+    collector.collect(irs::sub_reader::empty(), it);
+    ASSERT_EQ(7, collector.hits());
+    ASSERT_EQ(collector.threshold(), it.threshold().value);
+    ASSERT_EQ(5.f, *reinterpret_cast<const float_t*>(collector.threshold()));
+
+    // the first document with equal score wins
+    result_t expected{ { &irs::sub_reader::empty(), 4 }, { &irs::sub_reader::empty(), 2 }, { &irs::sub_reader::empty(), 6 } };
+    ASSERT_EQ(expected, collect(collector));
+  }
+
+  // threshold isn't exposed if ties are resolved by a stored column
+  {
+    irs::top_k_collector collector(prepared_order, 3, "name");
+    scored_doc_iterator it(docs, prepared_order);
+    collector.collect(irs::sub_reader::empty(), it);
+    ASSERT_NE(nullptr, collector.threshold());
+    ASSERT_EQ(nullptr, it.threshold().value);
+  }
+
+  // merge collectors
+  {
+    const scored_doc_iterator::docs_t lhs_docs(docs.begin(), docs.begin() + 3);
+    const scored_doc_iterator::docs_t rhs_docs(docs.begin() + 3, docs.end());
+
+    irs::top_k_collector lhs(prepared_order, 2);
+    scored_doc_iterator lhs_it(lhs_docs, prepared_order);
+    lhs.collect(irs::sub_reader::empty(), lhs_it);
+
+    irs::top_k_collector rhs(prepared_order, 2);
+    scored_doc_iterator rhs_it(rhs_docs, prepared_order);
+    rhs.collect(irs::sub_reader::empty(), rhs_it);
+
+    lhs.merge(rhs);
+    ASSERT_EQ(7, lhs.hits());
+    result_t expected{ { &irs::sub_reader::empty(), 4 }, { &irs::sub_reader::empty(), 2 } };
+    ASSERT_EQ(expected, collect(lhs));
+  }
+
+  // nothing is collected
+  {
+    irs::top_k_collector collector(prepared_order, 0);
+    scored_doc_iterator it(docs, prepared_order);
+    collector.collect(irs::sub_reader::empty(), it);
+    ASSERT_EQ(7, collector.hits());
+    ASSERT_EQ(0, collector.size());
+    ASSERT_EQ(nullptr, collector.threshold());
+    ASSERT_TRUE(collect(collector).empty());
+  }
+}
+
+NS_END
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
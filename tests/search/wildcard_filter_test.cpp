@@ -0,0 +1,270 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "filter_test_case_base.hpp"
+#include "search/prefix_filter.hpp"
+#include "search/wildcard_filter.hpp"
+#include "utils/automaton.hpp"
+
+NS_LOCAL
+
+class wildcard_filter_test_case : public tests::filter_test_case_base {
+ protected:
+  void by_wildcard_order() {
+    // add segment
+    {
+      tests::json_doc_generator gen(
+        resource("simple_sequential.json"),
+        &tests::generic_json_field_factory);
+      add_segment( gen );
+    }
+
+    auto rdr = open_reader();
+
+    // test collector call count for field/term/finish
+    {
+      docs_t docs{ 1, 31, 32 };
+      irs::order order;
+
+      size_t collect_field_count = 0;
+      size_t collect_term_count = 0;
+      size_t finish_count = 0;
+      auto& scorer = order.add<tests::sort::custom_sort>(false);
+
+      scorer.collector_collect_field = [&collect_field_count](const irs::sub_reader&, const irs::term_reader&)->void{
+        ++collect_field_count;
+      };
+      scorer.collector_collect_term = [&collect_term_count](const irs::sub_reader&, const irs::term_reader&, const irs::attribute_view&)->void{
+        ++collect_term_count;
+      };
+      scorer.collectors_collect_ = [&finish_count](irs::attribute_store&, const irs::index_reader&, const irs::sort::field_collector*, const irs::sort::term_collector*)->void {
+        ++finish_count;
+      };
+      scorer.prepare_field_collector_ = [&scorer]()->irs::sort::field_collector::ptr {
+        return irs::memory::make_unique<tests::sort::custom_sort::prepared::collector>(scorer);
+      };
+      scorer.prepare_term_collector_ = [&scorer]()->irs::sort::term_collector::ptr {
+        return irs::memory::make_unique<tests::sort::custom_sort::prepared::collector>(scorer);
+      };
+      check_query(irs::by_wildcard().field("prefix").term("?bc?"), order, docs, rdr);
+      ASSERT_EQ(2, collect_field_count); // 2 fields (1 per term since treated as a disjunction) in 1 segment
+      ASSERT_EQ(2, collect_term_count); // 2 different terms
+      ASSERT_EQ(2, finish_count); // 2 unque terms
+    }
+
+    // matching terms aren't adjacent
+    {
+      docs_t docs{ 1, 9 };
+      irs::order order;
+
+      order.add<tests::sort::frequency_sort>(false);
+      check_query(irs::by_wildcard().field("prefix").term("*d"), order, docs, rdr);
+    }
+
+    // trailing '*' only
+    {
+      docs_t docs{ 31, 32, 1, 4, 16, 21, 26, 29 };
+      irs::order order;
+
+      order.add<tests::sort::frequency_sort>(false);
+      check_query(irs::by_wildcard().field("prefix").term("a*"), order, docs, rdr);
+    }
+  }
+
+  void by_wildcard_sequential() {
+    // add segment
+    {
+      tests::json_doc_generator gen(
+        resource("simple_sequential.json"),
+        &tests::generic_json_field_factory);
+      add_segment( gen );
+    }
+
+    auto rdr = open_reader();
+
+    // empty query
+    check_query(irs::by_wildcard(), docs_t{}, costs_t{0}, rdr);
+
+    // empty field
+    check_query(irs::by_wildcard().term("xyz*"), docs_t{}, costs_t{0}, rdr);
+
+    // invalid field
+    check_query(irs::by_wildcard().field("same1").term("x?z"), docs_t{}, costs_t{0}, rdr);
+
+    // no matching terms
+    check_query(irs::by_wildcard().field("prefix").term("*z*"), docs_t{}, costs_t{0}, rdr);
+    check_query(irs::by_wildcard().field("prefix").term("?"), docs_t{}, costs_t{0}, rdr);
+
+    // whole field
+    {
+      docs_t result;
+      for(size_t i = 0; i < 32; ++i) {
+        result.push_back(irs::doc_id_t((irs::type_limits<irs::type_t::doc_id_t>::min)() + i));
+      }
+
+      costs_t costs{ result.size() };
+
+      check_query(irs::by_wildcard().field("same").term("x?z"), result, costs, rdr);
+      check_query(irs::by_wildcard().field("same").term("*"), result, costs, rdr);
+      check_query(irs::by_wildcard().field("same").term("**"), result, costs, rdr);
+      check_query(irs::by_wildcard().field("same").term("*y*"), result, costs, rdr);
+      check_query(irs::by_wildcard().field("name").term("?"), result, costs, rdr);
+    }
+
+    // no wildcards
+    check_query(irs::by_wildcard().field("prefix").term("abcd"), docs_t{1}, costs_t{1}, rdr);
+    check_query(irs::by_wildcard().field("prefix").term("ab\\cd"), docs_t{1}, costs_t{1}, rdr);
+    check_query(irs::by_wildcard().field("prefix").term("abc\\*"), docs_t{}, costs_t{0}, rdr);
+    check_query(irs::by_wildcard().field("prefix").term("abc\\?"), docs_t{}, costs_t{0}, rdr);
+
+    // trailing '*' only
+    {
+      docs_t docs{ 1, 4, 21, 26, 31, 32 };
+      costs_t costs{ docs.size() };
+
+      check_query(irs::by_wildcard().field("prefix").term("abc*"), docs, costs, rdr);
+      check_query(irs::by_wildcard().field("prefix").term("abc**"), docs, costs, rdr);
+    }
+
+    // leading wildcard
+    check_query(irs::by_wildcard().field("prefix").term("*d"), docs_t{1, 9}, costs_t{2}, rdr);
+    check_query(irs::by_wildcard().field("prefix").term("*de"), docs_t{4, 16}, costs_t{2}, rdr);
+    check_query(irs::by_wildcard().field("prefix").term("?bc?"), docs_t{1, 31, 32}, costs_t{3}, rdr);
+
+    // wildcards in the middle
+    check_query(irs::by_wildcard().field("prefix").term("a?c*"), docs_t{1, 4, 21, 26, 31, 32}, costs_t{6}, rdr);
+    check_query(irs::by_wildcard().field("prefix").term("a*r*"), docs_t{26, 29}, costs_t{2}, rdr);
+    check_query(irs::by_wildcard().field("prefix").term("b?t*f"), docs_t{24}, costs_t{1}, rdr);
+    check_query(irs::by_wildcard().field("duplicated").term("v*c"), docs_t{2, 3, 8, 14, 17, 19, 24}, costs_t{7}, rdr);
+  }
+}; // wildcard_filter_test_case
+
+TEST(by_wildcard_test, ctor) {
+  irs::by_wildcard q;
+  ASSERT_EQ(irs::by_wildcard::type(), q.type());
+  ASSERT_EQ("", q.field());
+  ASSERT_TRUE(q.term().empty());
+  ASSERT_EQ(irs::boost::no_boost(), q.boost());
+  ASSERT_EQ(1024, q.scored_terms_limit());
+}
+
+TEST(by_wildcard_test, equal) {
+  irs::by_wildcard q;
+  q.field("field").term("t?rm*");
+
+  ASSERT_EQ(q, irs::by_wildcard().field("field").term("t?rm*"));
+  ASSERT_EQ(q.hash(), irs::by_wildcard().field("field").term("t?rm*").hash());
+  ASSERT_NE(q, irs::by_wildcard().field("field1").term("t?rm*"));
+  ASSERT_NE(q, irs::by_wildcard().scored_terms_limit(100).field("field").term("t?rm*"));
+  ASSERT_NE(q, irs::by_prefix().field("field").term("t?rm*"));
+  ASSERT_NE(q, irs::by_term().field("field").term("t?rm*"));
+}
+
+TEST(by_wildcard_test, boost) {
+  // no boost
+  for (auto& pattern : { "term", "term*", "t?rm" }) {
+    irs::by_wildcard q;
+    q.field("field").term(pattern);
+
+    auto prepared = q.prepare(irs::sub_reader::empty());
+    ASSERT_EQ(irs::boost::no_boost(), irs::boost::extract(prepared->attributes()));
+  }
+
+  // with boost
+  for (auto& pattern : { "term", "term*", "t?rm" }) {
+    iresearch::boost::boost_t boost = 1.5f;
+    irs::by_wildcard q;
+    q.field("field").term(pattern);
+    q.boost(boost);
+
+    auto prepared = q.prepare(irs::sub_reader::empty());
+    ASSERT_EQ(boost, irs::boost::extract(prepared->attributes()));
+  }
+}
+
+TEST(by_wildcard_test, automaton) {
+  auto accept = [](const irs::automaton& a, const irs::string_ref& term) {
+    return a.accept(irs::ref_cast<irs::byte_type>(term));
+  };
+
+  {
+    auto a = irs::from_wildcard(irs::ref_cast<irs::byte_type>(irs::string_ref("foo*bar")));
+    ASSERT_TRUE(accept(a, "foobar"));
+    ASSERT_TRUE(accept(a, "foo_bar"));
+    ASSERT_TRUE(accept(a, "foobarbar"));
+    ASSERT_FALSE(accept(a, "fooba"));
+    ASSERT_FALSE(accept(a, "foobarb"));
+    ASSERT_FALSE(accept(a, "fobar"));
+  }
+
+  {
+    auto a = irs::from_wildcard(irs::ref_cast<irs::byte_type>(irs::string_ref("?ouse")));
+    ASSERT_TRUE(accept(a, "mouse"));
+    ASSERT_TRUE(accept(a, "house"));
+    ASSERT_TRUE(accept(a, "\xD0\xBCouse")); // 2 bytes character
+    ASSERT_TRUE(accept(a, "\xE2\x82\xACouse")); // 3 bytes character
+    ASSERT_TRUE(accept(a, "\xF0\x9F\x90\xADouse")); // 4 bytes character
+    ASSERT_FALSE(accept(a, "ouse"));
+    ASSERT_FALSE(accept(a, "mmouse"));
+    ASSERT_FALSE(accept(a, "\xD0\xBC\xD0\xBCouse"));
+  }
+
+  {
+    auto a = irs::from_wildcard(irs::ref_cast<irs::byte_type>(irs::string_ref("a\\*\\?\\\\")));
+    ASSERT_TRUE(accept(a, "a*?\\"));
+    ASSERT_FALSE(accept(a, "ab?\\"));
+    ASSERT_FALSE(accept(a, "a*b\\"));
+  }
+
+  {
+    auto a = irs::from_wildcard(irs::ref_cast<irs::byte_type>(irs::string_ref("")));
+    ASSERT_TRUE(accept(a, ""));
+    ASSERT_FALSE(accept(a, "a"));
+  }
+}
+
+TEST_P(wildcard_filter_test_case, by_wildcard) {
+  by_wildcard_order();
+  by_wildcard_sequential();
+}
+
+INSTANTIATE_TEST_CASE_P(
+  wildcard_filter_test,
+  wildcard_filter_test_case,
+  ::testing::Combine(
+    ::testing::Values(
+      &tests::memory_directory,
+      &tests::fs_directory,
+      &tests::mmap_directory
+    ),
+    ::testing::Values("1_0")
+  ),
+  tests::to_string
+);
+
+NS_END
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
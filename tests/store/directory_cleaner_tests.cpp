@@ -31,6 +31,8 @@
 #include "store/memory_directory.hpp"
 #include "utils/directory_utils.hpp"
 
+#include <thread>
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                        test suite
 // -----------------------------------------------------------------------------
@@ -345,6 +347,138 @@ TEST(directory_cleaner_tests, test_directory_cleaner_current_segment) {
   }
 }
 
+NS_LOCAL
+
+void create_file(irs::directory& dir, const std::string& name, size_t length) {
+  auto out = dir.create(name);
+  ASSERT_FALSE(!out);
+  const std::string data(length, 'x');
+  out->write_bytes(reinterpret_cast<const irs::byte_type*>(data.c_str()), data.size());
+}
+
+bool exists(const irs::directory& dir, const std::string& name) {
+  bool result;
+  return dir.exists(result, name) && result;
+}
+
+// wait until 'cleaner' removes 'count' files or the timeout expires
+bool wait_removed(const irs::background_directory_cleaner& cleaner, size_t count) {
+  for (size_t i = 0; i < 500; ++i) {
+    if (cleaner.stats().removed >= count) {
+      return true;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  return false;
+}
+
+NS_END
+
+TEST(directory_cleaner_tests, test_background_directory_cleaner) {
+  irs::memory_directory dir;
+  auto& refs = irs::directory_cleaner::init(dir);
+
+  create_file(dir, "untracked.file", 10);
+  create_file(dir, "tracked.file.1", 10);
+  create_file(dir, "tracked.file.2", 20);
+  create_file(dir, "retained.file", 30);
+  auto ref1 = refs.add("tracked.file.1");
+  auto ref2 = refs.add("tracked.file.2");
+  auto ref3 = refs.add("retained.file");
+
+  irs::background_directory_cleaner cleaner(
+    dir, 0, std::chrono::milliseconds(3600000),
+    [](const std::string& name) { return name != "retained.file"; }
+  );
+
+  // nothing to remove
+  cleaner.notify();
+  ref1.reset();
+  cleaner.notify();
+  ASSERT_TRUE(wait_removed(cleaner, 1));
+  ASSERT_FALSE(exists(dir, "tracked.file.1"));
+  ASSERT_TRUE(exists(dir, "tracked.file.2"));
+  ASSERT_TRUE(exists(dir, "untracked.file")); // files without refs are never collected
+  ASSERT_EQ(0, refs.find("tracked.file.1"));
+  ASSERT_FALSE(refs.contains("tracked.file.1"));
+
+  ref2.reset();
+  ref3.reset();
+  cleaner.notify();
+  ASSERT_TRUE(wait_removed(cleaner, 2));
+  ASSERT_FALSE(exists(dir, "tracked.file.2"));
+  ASSERT_TRUE(exists(dir, "retained.file")); // rejected by acceptor
+
+  auto stats = cleaner.stats();
+  ASSERT_EQ(2, stats.removed);
+  ASSERT_EQ(30, stats.reclaimed);
+  ASSERT_EQ(0, stats.pending);
+
+  cleaner.stop();
+  cleaner.stop(); // stop twice
+}
+
+TEST(directory_cleaner_tests, test_background_directory_cleaner_rate_limit) {
+  irs::memory_directory dir;
+  auto& refs = irs::directory_cleaner::init(dir);
+
+  create_file(dir, "file.1", 100);
+  create_file(dir, "file.2", 100);
+  create_file(dir, "file.3", 100);
+  refs.add("file.1");
+  refs.add("file.2");
+  refs.add("file.3");
+
+  // 100 bytes per second, i.e. at most a file per second
+  irs::background_directory_cleaner cleaner(dir, 100, std::chrono::milliseconds(3600000));
+  cleaner.notify();
+
+  ASSERT_TRUE(wait_removed(cleaner, 1));
+  auto stats = cleaner.stats();
+  ASSERT_EQ(1, stats.removed);
+  ASSERT_EQ(100, stats.reclaimed);
+  ASSERT_EQ(2, stats.pending);
+
+  // stop before the budget allows removal of the remaining files
+  cleaner.stop();
+  stats = cleaner.stats();
+  ASSERT_EQ(1, stats.removed);
+  ASSERT_EQ(2, stats.pending);
+
+  size_t files = 0;
+  dir.visit([&files](std::string&) { ++files; return true; });
+  ASSERT_EQ(2, files);
+
+  // remaining files are removed by directory_cleaner
+  ASSERT_EQ(2, irs::directory_cleaner::clean(dir));
+}
+
+TEST(directory_cleaner_tests, test_background_directory_cleaner_ref_acquired) {
+  irs::memory_directory dir;
+  auto& refs = irs::directory_cleaner::init(dir);
+
+  create_file(dir, "file.1", 100);
+  create_file(dir, "file.2", 100);
+  refs.add("file.1");
+  refs.add("file.2");
+
+  // budget delays removal of 'file.2' by a second
+  irs::background_directory_cleaner cleaner(dir, 100, std::chrono::milliseconds(3600000));
+  cleaner.notify();
+  ASSERT_TRUE(wait_removed(cleaner, 1));
+
+  // acquire a reference to the queued file
+  auto ref = refs.add(exists(dir, "file.1") ? "file.1" : "file.2");
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+
+  auto stats = cleaner.stats();
+  ASSERT_EQ(1, stats.removed);
+  ASSERT_EQ(0, stats.pending);
+  ASSERT_TRUE(exists(dir, *ref));
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
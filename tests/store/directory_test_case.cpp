@@ -27,8 +27,10 @@
 #include "store/store_utils.hpp"
 #include "store/fs_directory.hpp"
 #include "store/memory_directory.hpp"
+#include "store/mmap_directory.hpp"
 #include "store/data_output.hpp"
 #include "store/data_input.hpp"
+#include "index/index_meta.hpp"
 #include "utils/async_utils.hpp"
 #include "utils/crc.hpp"
 #include "utils/utf8_path.hpp"
@@ -37,10 +39,12 @@
 #include "utils/network_utils.hpp"
 
 #include <cstdio>
+#include <cstring>
 #include <vector>
 #include <string>
 #include <algorithm>
 #include <fstream>
+#include <thread>
 
 NS_LOCAL
 
@@ -459,6 +463,86 @@ TEST_P(directory_test_case, read_multiple_streams) {
 
     pool.stop();
   }
+
+  // read data using dup async with interleaved seeks
+  {
+    {
+      auto out = dir_->create("test_async_seek");
+      ASSERT_FALSE(!out);
+
+      for (uint32_t i = 0; i < 10000; ++i) {
+        out->write_int(i);
+      }
+    }
+
+    auto in = dir_->open("test_async_seek", irs::IOAdvice::RANDOM);
+    ASSERT_FALSE(!in);
+    std::mutex mutex;
+    irs::async_utils::thread_pool pool(16, 16);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+
+      for (size_t thread = pool.max_threads(); thread; --thread) {
+        pool.run([&in, &mutex, thread]()->void {
+          auto input = in->dup();
+
+          {
+            // wait for all threads to be registered
+            std::lock_guard<std::mutex> lock(mutex);
+          }
+
+          for (size_t i = 0; i < 10000; ++i) {
+            const auto value = (i * 7919 + thread) % 10000;
+            input->seek(value * sizeof(uint32_t));
+            ASSERT_EQ(value, uint32_t(input->read_int()));
+          }
+        });
+      }
+    }
+
+    pool.stop();
+  }
+}
+
+TEST_P(directory_test_case, prefetch) {
+  {
+    auto out = dir_->create("test");
+    ASSERT_FALSE(!out);
+
+    for (uint32_t i = 0; i < 10000; ++i) {
+      out->write_int(i);
+    }
+  }
+
+  auto in = dir_->open("test", irs::IOAdvice::NORMAL);
+  ASSERT_FALSE(!in);
+  const auto length = in->length();
+  ASSERT_EQ(10000*sizeof(uint32_t), length);
+
+  for (uint32_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(i, uint32_t(in->read_int()));
+  }
+
+  // prefetch is a hint, it must never change the position
+  in->prefetch(0, length);
+  in->prefetch(length / 2, length); // past the end
+  in->prefetch(length, 4096); // starts at the end
+  in->prefetch(2*length, 4096); // starts past the end
+  in->prefetch(4097, 0);
+  ASSERT_EQ(100*sizeof(uint32_t), in->file_pointer());
+
+  auto dup = in->dup();
+  ASSERT_FALSE(!dup);
+  dup->prefetch(length - 1, 1);
+
+  for (uint32_t i = 100; i < 10000; ++i) {
+    ASSERT_EQ(i, uint32_t(in->read_int()));
+    ASSERT_EQ(i, uint32_t(dup->read_int()));
+  }
+
+  ASSERT_TRUE(in->eof());
+  ASSERT_TRUE(dup->eof());
 }
 
 TEST_P(directory_test_case, string_read_write) {
@@ -1327,6 +1411,118 @@ TEST_F(fs_directory_test, utf8_chars_native) {
   }
 }
 
+TEST_F(fs_directory_test, prefetch_enabled) {
+  ASSERT_FALSE(dir_->prefetch());
+
+  {
+    auto out = dir_->create("test");
+    ASSERT_FALSE(!out);
+
+    for (uint32_t i = 0; i < 10000; ++i) {
+      out->write_int(i);
+    }
+  }
+
+  irs::async_utils::thread_pool pool(2, 2);
+  irs::fs_directory fs_dir(path_.utf8(), true);
+  irs::fs_directory pooled_dir(path_.utf8(), true, &pool); // ranges read by the pool
+  irs::mmap_directory mmap_dir(path_.utf8(), true);
+  ASSERT_TRUE(fs_dir.prefetch());
+  ASSERT_TRUE(pooled_dir.prefetch());
+  ASSERT_TRUE(mmap_dir.prefetch());
+
+  for (const irs::directory* dir : {
+         (irs::directory*)&fs_dir, (irs::directory*)&pooled_dir, (irs::directory*)&mmap_dir }) {
+    auto in = dir->open("test", irs::IOAdvice::NORMAL);
+    ASSERT_FALSE(!in);
+    const auto length = in->length();
+
+    for (uint32_t i = 0; i < 100; ++i) {
+      ASSERT_EQ(i, uint32_t(in->read_int()));
+    }
+
+    // hints are honored but must never change the position
+    in->prefetch(0, length);
+    in->prefetch(length / 2, length); // past the end
+    in->prefetch(2*length, 4096); // starts past the end
+    ASSERT_EQ(100*sizeof(uint32_t), in->file_pointer());
+
+    auto dup = in->dup();
+    ASSERT_FALSE(!dup);
+    dup->prefetch(length - 1, 1);
+
+    for (uint32_t i = 100; i < 10000; ++i) {
+      ASSERT_EQ(i, uint32_t(in->read_int()));
+      ASSERT_EQ(i, uint32_t(dup->read_int()));
+    }
+
+    ASSERT_TRUE(in->eof());
+  }
+
+  pool.stop(); // pooled reads keep the file open, wait for them to finish
+  ASSERT_EQ(0, pool.tasks_pending());
+}
+
+TEST_F(fs_directory_test, mmap_warmup) {
+  irs::mmap_directory dir(path_.utf8());
+
+  for (auto& name : { "segment", "terms", "postings" }) {
+    auto out = dir.create(name);
+    ASSERT_FALSE(!out);
+
+    for (uint32_t i = 0; i < 100000; ++i) {
+      out->write_int(i);
+    }
+  }
+
+  // single file
+  {
+    irs::mmap_directory::residency_stats stats;
+    ASSERT_TRUE(dir.warmup("terms"));
+    ASSERT_TRUE(dir.warmup("terms", true));
+    ASSERT_TRUE(dir.residency(stats, "terms"));
+    ASSERT_LT(0, stats.pages);
+    ASSERT_EQ(stats.pages, stats.resident); // just faulted in
+    ASSERT_FALSE(dir.warmup("missing"));
+    ASSERT_FALSE(dir.residency(stats, "missing"));
+  }
+
+  // files of an index
+  {
+    irs::segment_meta segment;
+    segment.files.emplace("terms");
+    segment.files.emplace("postings");
+
+    irs::index_meta::index_segment_t index_segment(std::move(segment));
+    index_segment.filename = "segment";
+
+    irs::index_meta meta;
+    meta.add(std::move(index_segment));
+
+    auto terms_only = [](const std::string& name) {
+      return name == "terms";
+    };
+
+    irs::mmap_directory::residency_stats terms;
+    ASSERT_TRUE(irs::directory_utils::warmup(dir, meta, terms_only, true));
+    ASSERT_TRUE(irs::directory_utils::residency(terms, dir, meta, terms_only));
+    ASSERT_LT(0, terms.pages);
+    ASSERT_EQ(terms.pages, terms.resident);
+
+    irs::mmap_directory::residency_stats all;
+    ASSERT_TRUE(irs::directory_utils::warmup(dir, meta, {}, true));
+    ASSERT_TRUE(irs::directory_utils::residency(all, dir, meta));
+    ASSERT_EQ(3*terms.pages, all.pages);
+    ASSERT_EQ(all.pages, all.resident);
+
+    // missing file fails the whole warmup
+    ASSERT_TRUE(dir.remove("postings"));
+    ASSERT_FALSE(irs::directory_utils::warmup(dir, meta));
+    ASSERT_FALSE(irs::directory_utils::residency(all, dir, meta));
+    ASSERT_TRUE(irs::directory_utils::residency(terms, dir, meta, terms_only));
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 fs_directory_test
 // -----------------------------------------------------------------------------
@@ -1386,6 +1582,179 @@ TEST(memory_directory_test, file_reset_allocator) {
   ASSERT_NE(buf0.data, buf1.data);
 }
 
+TEST(memory_directory_test, file_memory) {
+  memory_allocator alloc(1);
+  memory_file file(alloc);
+  ASSERT_EQ(0, file.memory());
+
+  file.push_buffer();
+  ASSERT_EQ(256, file.memory());
+  file.push_buffer();
+  ASSERT_EQ(256 + 512, file.memory());
+  file.length(1); // length doesn't affect allocated memory
+  ASSERT_EQ(256 + 512, file.memory());
+  file.pop_buffer();
+  ASSERT_EQ(256, file.memory());
+
+  memory_file moved(std::move(file));
+  ASSERT_EQ(256, moved.memory());
+  ASSERT_EQ(0, file.memory());
+
+  moved.clear();
+  ASSERT_EQ(0, moved.memory());
+}
+
+TEST(memory_directory_test, directory_memory) {
+  irs::memory_directory dir;
+  uint64_t size;
+  ASSERT_EQ(0, dir.memory());
+  ASSERT_FALSE(dir.memory(size, "nonexistent"));
+
+  {
+    auto out = dir.create("file0");
+    ASSERT_NE(nullptr, out);
+    out->write_byte(1);
+    out->flush();
+  }
+
+  {
+    auto out = dir.create("file1");
+    ASSERT_NE(nullptr, out);
+    const std::vector<irs::byte_type> data(1000, 42);
+    out->write_bytes(data.data(), data.size());
+    out->flush();
+  }
+
+  ASSERT_TRUE(dir.memory(size, "file0"));
+  ASSERT_EQ(256, size);
+  ASSERT_TRUE(dir.length(size, "file0"));
+  ASSERT_EQ(1, size);
+  ASSERT_TRUE(dir.memory(size, "file1"));
+  ASSERT_EQ(256 + 512 + 1024, size);
+  ASSERT_EQ(256 + 256 + 512 + 1024, dir.memory());
+
+  ASSERT_TRUE(dir.rename("file1", "file2"));
+  ASSERT_FALSE(dir.memory(size, "file1"));
+  ASSERT_TRUE(dir.memory(size, "file2"));
+  ASSERT_EQ(256 + 512 + 1024, size);
+
+  ASSERT_TRUE(dir.remove("file0"));
+  ASSERT_EQ(256 + 512 + 1024, dir.memory());
+}
+
+TEST(memory_directory_test, read_view) {
+  irs::memory_directory dir;
+  std::vector<irs::byte_type> data(1000);
+
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = irs::byte_type(i);
+  }
+
+  {
+    auto out = dir.create("file");
+    ASSERT_NE(nullptr, out);
+    out->write_bytes(data.data(), data.size());
+    out->flush();
+  }
+
+  auto in = dir.open("file", irs::IOAdvice::NORMAL);
+  ASSERT_NE(nullptr, in);
+  auto& mem_in = dynamic_cast<irs::memory_index_input&>(*in);
+
+  // empty view
+  ASSERT_EQ(irs::bytes_ref::EMPTY, mem_in.read_view(0));
+  ASSERT_EQ(0, mem_in.file_pointer());
+
+  // view within the first buffer
+  auto view = mem_in.read_view(200);
+  ASSERT_EQ(200, view.size());
+  ASSERT_EQ(0, std::memcmp(data.data(), view.c_str(), view.size()));
+  ASSERT_EQ(200, mem_in.file_pointer());
+
+  // range crossing buffer boundary, position is left intact
+  ASSERT_TRUE(mem_in.read_view(100).null());
+  ASSERT_EQ(200, mem_in.file_pointer());
+
+  // remainder of the first buffer
+  view = mem_in.read_view(56);
+  ASSERT_EQ(56, view.size());
+  ASSERT_EQ(0, std::memcmp(data.data() + 200, view.c_str(), view.size()));
+
+  // next buffer
+  view = mem_in.read_view(512);
+  ASSERT_EQ(512, view.size());
+  ASSERT_EQ(0, std::memcmp(data.data() + 256, view.c_str(), view.size()));
+  ASSERT_EQ(768, mem_in.file_pointer());
+
+  // range past eof
+  ASSERT_TRUE(mem_in.read_view(233).null());
+  ASSERT_EQ(768, mem_in.file_pointer());
+
+  // fall back to the regular read
+  std::vector<irs::byte_type> tail(232);
+  ASSERT_EQ(tail.size(), mem_in.read_bytes(tail.data(), tail.size()));
+  ASSERT_EQ(0, std::memcmp(data.data() + 768, tail.data(), tail.size()));
+  ASSERT_TRUE(mem_in.eof());
+  ASSERT_TRUE(mem_in.read_view(1).null());
+
+  // view after seek
+  mem_in.seek(300);
+  view = mem_in.read_view(10);
+  ASSERT_EQ(10, view.size());
+  ASSERT_EQ(0, std::memcmp(data.data() + 300, view.c_str(), view.size()));
+}
+
+TEST(memory_directory_test, concurrent_access) {
+  irs::memory_directory dir;
+  const size_t THREADS = 8;
+  const size_t FILES = 100;
+  std::vector<std::thread> threads;
+  std::atomic<bool> failed{ false };
+
+  for (size_t t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&dir, &failed, t, FILES]()->void {
+      for (size_t i = 0; i < FILES; ++i) {
+        const auto name = std::to_string(t) + "_" + std::to_string(i);
+        const auto dst = name + "_renamed";
+        uint64_t size;
+
+        {
+          auto out = dir.create(name);
+          if (!out) { failed = true; return; }
+          out->write_vlong(i);
+          out->flush();
+        }
+
+        // rename across stripes, other threads do the same concurrently
+        if (!dir.rename(name, dst)) { failed = true; return; }
+
+        auto in = dir.open(dst, irs::IOAdvice::NORMAL);
+        if (!in || i != in->read_vlong()) { failed = true; return; }
+        in.reset();
+
+        if (!dir.memory(size, dst) || 256 != size) { failed = true; return; }
+
+        if (i % 2 && !dir.remove(dst)) { failed = true; return; }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_FALSE(failed);
+
+  size_t count = 0;
+  auto visitor = [&count](const std::string& name)->bool {
+    ++count;
+    return name.find("_renamed") != std::string::npos;
+  };
+  ASSERT_TRUE(dir.visit(visitor));
+  ASSERT_EQ(THREADS * FILES / 2, count);
+  ASSERT_EQ(THREADS * FILES / 2 * 256, dir.memory());
+}
+
 NS_END
 
 // -----------------------------------------------------------------------------
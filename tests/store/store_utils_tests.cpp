@@ -25,6 +25,8 @@
 #include "store/store_utils.hpp"
 #include "utils/bytes_utils.hpp"
 
+#include <numeric>
+
 using namespace iresearch;
 
 namespace tests {
@@ -632,6 +634,23 @@ TEST(store_utils_tests, delta_encode_decode) {
   tests::detail::delta_encode_decode_core(1000, 1); // step = 1000, count = 1
 }
 
+TEST(store_utils_tests, delta_decode_32) {
+  std::vector<uint32_t> deltas(130);
+  for (size_t i = 0; i < deltas.size(); ++i) {
+    deltas[i] = uint32_t(1 + (i*7919) % 113);
+  }
+
+  // vectorized kernel processes 8 values at a time
+  for (size_t size = 1; size <= deltas.size(); ++size) {
+    std::vector<uint32_t> expected(deltas.begin(), deltas.begin() + size);
+    std::partial_sum(expected.begin(), expected.end(), expected.begin());
+
+    std::vector<uint32_t> actual(deltas.begin(), deltas.begin() + size);
+    irs::encode::delta::decode(actual.data(), actual.data() + actual.size());
+    ASSERT_EQ(expected, actual);
+  }
+}
+
 TEST(store_utils_tests, avg_encode_decode) {
   tests::detail::avg_encode_decode_core(1, 1000); // step = 1, count = 1000
   tests::detail::avg_encode_decode_core(128, 1000); // step = 128, count = 1000
@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "utils/automaton.hpp"
+
+NS_LOCAL
+
+irs::bytes_ref ref(const irs::string_ref& str) {
+  return irs::ref_cast<irs::byte_type>(str);
+}
+
+std::string lower_bound(const irs::automaton& a, const irs::string_ref& term) {
+  irs::bstring target;
+  EXPECT_TRUE(a.lower_bound(ref(term), target));
+  return irs::ref_cast<char>(target);
+}
+
+NS_END
+
+TEST(automaton_test, empty) {
+  irs::automaton a;
+  ASSERT_TRUE(a.empty());
+  ASSERT_EQ(irs::automaton::INVALID, a.start());
+  ASSERT_EQ(irs::automaton::INVALID, a.walk(ref("")));
+  ASSERT_FALSE(a.accept(ref("")));
+
+  irs::bstring target;
+  ASSERT_FALSE(a.lower_bound(ref(""), target));
+
+  // no states
+  ASSERT_TRUE(irs::automaton::builder().build().empty());
+
+  // no final states
+  {
+    irs::automaton::builder builder;
+    const auto start = builder.add_state();
+    builder.add_arc(start, builder.add_state(), 'a');
+    ASSERT_TRUE(builder.build().empty());
+  }
+}
+
+TEST(automaton_test, build) {
+  // (ab|ac)d*
+  irs::automaton::builder builder;
+  const auto start = builder.add_state();
+  const auto a0 = builder.add_state();
+  const auto a1 = builder.add_state();
+  const auto last = builder.add_state(true);
+  builder.add_arc(start, a0, 'a');
+  builder.add_arc(start, a1, 'a');
+  builder.add_arc(a0, last, 'b');
+  builder.add_arc(a1, last, 'c');
+  builder.add_arc(last, last, 'd');
+
+  // dead end
+  const auto dead = builder.add_state();
+  builder.add_arc(start, dead, 'e', 'z');
+  ASSERT_EQ(5, builder.size());
+
+  const auto a = builder.build();
+  ASSERT_FALSE(a.empty());
+  ASSERT_FALSE(a.final(a.start()));
+  ASSERT_TRUE(a.accept(ref("ab")));
+  ASSERT_TRUE(a.accept(ref("ac")));
+  ASSERT_TRUE(a.accept(ref("acddd")));
+  ASSERT_FALSE(a.accept(ref("a")));
+  ASSERT_FALSE(a.accept(ref("ad")));
+  ASSERT_FALSE(a.accept(ref("abc")));
+  ASSERT_EQ(irs::automaton::INVALID, a.next(a.start(), 'e')); // dead states are removed
+  ASSERT_NE(irs::automaton::INVALID, a.walk(ref("a")));
+  ASSERT_EQ(irs::automaton::INVALID, a.walk(ref("e")));
+}
+
+TEST(automaton_test, epsilon) {
+  // a?b+
+  irs::automaton::builder builder;
+  const auto start = builder.add_state();
+  const auto mid = builder.add_state();
+  const auto last = builder.add_state(true);
+  builder.add_arc(start, mid, 'a');
+  builder.add_epsilon(start, mid);
+  builder.add_arc(mid, last, 'b');
+  builder.add_epsilon(last, mid);
+
+  const auto a = builder.build();
+  ASSERT_TRUE(a.accept(ref("b")));
+  ASSERT_TRUE(a.accept(ref("ab")));
+  ASSERT_TRUE(a.accept(ref("abbb")));
+  ASSERT_FALSE(a.accept(ref("")));
+  ASSERT_FALSE(a.accept(ref("a")));
+  ASSERT_FALSE(a.accept(ref("aab")));
+}
+
+TEST(automaton_test, lower_bound) {
+  // a[b-d]x*y
+  irs::automaton::builder builder;
+  const auto start = builder.add_state();
+  const auto s1 = builder.add_state();
+  const auto s2 = builder.add_state();
+  const auto last = builder.add_state(true);
+  builder.add_arc(start, s1, 'a');
+  builder.add_arc(s1, s2, 'b', 'd');
+  builder.add_arc(s2, s2, 'x');
+  builder.add_arc(s2, last, 'y');
+
+  const auto a = builder.build();
+
+  ASSERT_EQ("abx", lower_bound(a, "")); // loop over 'x' isn't followed
+  ASSERT_EQ("abx", lower_bound(a, "a"));
+  ASSERT_EQ("abx", lower_bound(a, "aa"));
+  ASSERT_EQ("aby", lower_bound(a, "aby")); // accepted term itself
+  ASSERT_EQ("acx", lower_bound(a, "abz"));
+  ASSERT_EQ("acx", lower_bound(a, "ac"));
+  ASSERT_EQ("adx", lower_bound(a, "acz"));
+  ASSERT_EQ("adxxx", lower_bound(a, "adxx"));
+
+  irs::bstring target;
+  ASSERT_FALSE(a.lower_bound(ref("adz"), target));
+  ASSERT_FALSE(a.lower_bound(ref("b"), target));
+}
@@ -27,6 +27,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <random>
   
 using namespace iresearch;
 
@@ -264,6 +265,50 @@ TEST(bit_packing_tests, pack_unpack_64) {
   }
 }
 
+TEST(bit_packing_tests, unpack_random) {
+  // full width values, vectorized kernels are chosen at runtime
+  std::mt19937_64 rng(42);
+
+  for (size_t blocks : { 1, 2, 5 }) {
+    // 32
+    {
+      std::vector<uint32_t> src(blocks*packed::BLOCK_SIZE_32);
+
+      for (uint32_t bits = 1; bits <= 32; ++bits) {
+        for (auto& v : src) {
+          v = uint32_t(rng()) & packed::max_value<uint32_t>(bits);
+        }
+
+        // exact size, the last block must not be read past its end
+        std::vector<uint32_t> packed(packed::blocks_required_32(uint32_t(src.size()), bits), 0);
+        packed::pack(src.data(), src.data() + src.size(), packed.data(), bits);
+
+        std::vector<uint32_t> unpacked(src.size());
+        packed::unpack(unpacked.data(), unpacked.data() + unpacked.size(), packed.data(), bits);
+        ASSERT_EQ(src, unpacked);
+      }
+    }
+
+    // 64
+    {
+      std::vector<uint64_t> src(blocks*packed::BLOCK_SIZE_64);
+
+      for (uint32_t bits = 1; bits <= 64; ++bits) {
+        for (auto& v : src) {
+          v = rng() & packed::max_value<uint64_t>(bits);
+        }
+
+        std::vector<uint64_t> packed(packed::blocks_required_64(src.size(), bits), 0);
+        packed::pack(src.data(), src.data() + src.size(), packed.data(), bits);
+
+        std::vector<uint64_t> unpacked(src.size());
+        packed::unpack(unpacked.data(), unpacked.data() + unpacked.size(), packed.data(), bits);
+        ASSERT_EQ(src, unpacked);
+      }
+    }
+  }
+}
+
 TEST(bit_packing_tests, iterator32) {
   std::vector<uint32_t> src{
     14410, 21766, 15994, 29493, 20819,
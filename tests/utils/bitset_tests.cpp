@@ -396,6 +396,64 @@ TEST(bitset_tests, memset) {
   }
 }
 
+TEST(bitset_tests, equality) {
+  // compare only the words actually allocated, 'size()' is in bits
+  {
+    const bitset::index_t size = 1000;
+    irs::bitset lhs(size);
+    irs::bitset rhs(size);
+    ASSERT_EQ(bitset::word(size - 1) + 1, lhs.words());
+    ASSERT_TRUE(lhs == rhs);
+    ASSERT_FALSE(lhs != rhs);
+
+    for (size_t i = 0; i < size; i += 7) {
+      lhs.set(i);
+      rhs.set(i);
+    }
+    ASSERT_TRUE(lhs == rhs);
+
+    // difference in the last word
+    rhs.unset(994);
+    ASSERT_FALSE(lhs == rhs);
+    ASSERT_TRUE(lhs != rhs);
+    rhs.set(994);
+    ASSERT_TRUE(lhs == rhs);
+
+    // difference in the first word
+    lhs.set(1);
+    ASSERT_TRUE(lhs != rhs);
+  }
+
+  // size less than a word
+  {
+    irs::bitset lhs(9);
+    irs::bitset rhs(9);
+    ASSERT_EQ(1, lhs.words());
+    lhs.set(8);
+    rhs.set(8);
+    ASSERT_TRUE(lhs == rhs);
+    rhs.unset(8);
+    ASSERT_TRUE(lhs != rhs);
+  }
+
+  // different sizes
+  {
+    irs::bitset lhs(64);
+    irs::bitset rhs(65);
+    ASSERT_TRUE(lhs != rhs);
+  }
+
+  // shrunk via reset, stale words beyond 'words()' are ignored
+  {
+    irs::bitset lhs(256);
+    lhs.set(200);
+    lhs.reset(64);
+    irs::bitset rhs(64);
+    ASSERT_EQ(1, lhs.words());
+    ASSERT_TRUE(lhs == rhs);
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
\ No newline at end of file
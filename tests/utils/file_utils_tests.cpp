@@ -361,6 +361,17 @@ TEST(file_utils_tests, path_parts) {
   #endif
 }
 
+TEST(file_utils_tests, fadvise) {
+  #if defined(_WIN32) || defined(__APPLE__)
+    ASSERT_EQ(0, irs::file_utils::fadvise(-1, 0, 0, IR_FADVICE_WILLNEED));
+  #else
+    // error is returned rather than reported via 'errno'
+    errno = 0;
+    ASSERT_EQ(EBADF, irs::file_utils::fadvise(-1, 0, 0, IR_FADVICE_WILLNEED));
+    ASSERT_EQ(0, errno);
+  #endif
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
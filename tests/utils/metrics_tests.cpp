@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2019 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "formats/formats.hpp"
+#include "index/directory_reader.hpp"
+#include "index/doc_generator.hpp"
+#include "index/index_tests.hpp"
+#include "index/index_writer.hpp"
+#include "store/memory_directory.hpp"
+#include "utils/metrics.hpp"
+
+#include <set>
+#include <sstream>
+#include <thread>
+
+TEST(metrics_test, names) {
+  std::set<std::string> names;
+
+  for (size_t i = 0; i < irs::metrics::EVENTS; ++i) {
+    const std::string name = irs::metrics::name(irs::metrics::event(i));
+    ASSERT_FALSE(name.empty());
+    ASSERT_TRUE(names.insert(name).second);
+  }
+
+  ASSERT_EQ(std::string("term_seek"), irs::metrics::name(irs::metrics::event::TERM_SEEK));
+  ASSERT_EQ(std::string("commit_finish"), irs::metrics::name(irs::metrics::event::COMMIT_FINISH));
+  ASSERT_EQ(std::string(), irs::metrics::name(irs::metrics::event::COUNT));
+}
+
+TEST(metrics_test, increment_record) {
+  const auto e = irs::metrics::event::SEGMENT_MERGE;
+  irs::metrics::reset();
+
+  irs::metrics::increment(e);
+  irs::metrics::record(e, 0);
+  irs::metrics::record(e, 1);
+  irs::metrics::record(e, 100);
+  irs::metrics::record(e, 1000);
+
+  auto snapshot = irs::metrics::get_snapshot();
+  auto& stat = snapshot[e];
+  ASSERT_EQ(5, stat.count);
+  ASSERT_EQ(1101, stat.sum);
+  ASSERT_EQ(1, stat.buckets[0]); // 0
+  ASSERT_EQ(1, stat.buckets[1]); // [1, 2)
+  ASSERT_EQ(1, stat.buckets[7]); // [64, 128)
+  ASSERT_EQ(1, stat.buckets[10]); // [512, 1024)
+  ASSERT_EQ(1, stat.percentile(50)); // counter-only event is ignored
+  ASSERT_EQ(1023, stat.percentile(100));
+
+  // reset
+  irs::metrics::reset();
+  snapshot = irs::metrics::get_snapshot();
+  ASSERT_EQ(0, snapshot[e].count);
+  ASSERT_EQ(0, snapshot[e].sum);
+  ASSERT_EQ(0, snapshot[e].percentile(50));
+
+  irs::metrics::record(e, 3);
+  snapshot = irs::metrics::get_snapshot();
+  ASSERT_EQ(1, snapshot[e].count);
+  ASSERT_EQ(3, snapshot[e].sum);
+  ASSERT_EQ(1, snapshot[e].buckets[2]); // [2, 4)
+}
+
+TEST(metrics_test, threads) {
+  const auto e = irs::metrics::event::SEGMENT_MERGE;
+  const size_t THREADS = 8;
+  const size_t EVENTS = 10000;
+  irs::metrics::reset();
+
+  {
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < THREADS; ++i) {
+      threads.emplace_back([e, EVENTS]() {
+        for (size_t j = 0; j < EVENTS; ++j) {
+          irs::metrics::record(e, 2);
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  // measurements of exited threads are retained
+  auto snapshot = irs::metrics::get_snapshot();
+  ASSERT_EQ(THREADS*EVENTS, snapshot[e].count);
+  ASSERT_EQ(2*THREADS*EVENTS, snapshot[e].sum);
+  ASSERT_EQ(THREADS*EVENTS, snapshot[e].buckets[2]);
+}
+
+TEST(metrics_test, scoped_timer) {
+  const auto e = irs::metrics::event::SEGMENT_FLUSH;
+  irs::metrics::reset();
+
+  {
+    SCOPED_METRIC(e);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  auto snapshot = irs::metrics::get_snapshot();
+  ASSERT_EQ(1, snapshot[e].count);
+  ASSERT_LE(1000000, snapshot[e].sum);
+
+  // export
+  std::stringstream out;
+  snapshot.write(out);
+
+  size_t lines = 0;
+  for (std::string line; std::getline(out, line); ++lines) {
+    ASSERT_EQ(0, line.find(irs::metrics::name(irs::metrics::event(lines))));
+  }
+  ASSERT_EQ(irs::metrics::EVENTS, lines);
+  ASSERT_NE(std::string::npos, out.str().find("segment_flush count=1 "));
+}
+
+TEST(metrics_test, instrumented_index) {
+  irs::metrics::reset();
+
+  tests::json_doc_generator gen(
+    test_base::resource("simple_sequential.json"),
+    &tests::generic_json_field_factory
+  );
+  irs::memory_directory dir;
+  auto writer = irs::index_writer::make(dir, irs::formats::get("1_0"), irs::OM_CREATE);
+  ASSERT_NE(nullptr, writer);
+
+  for (const tests::document* doc; (doc = gen.next()) != nullptr;) {
+    ASSERT_TRUE(insert(*writer, doc->indexed.begin(), doc->indexed.end(), doc->stored.begin(), doc->stored.end()));
+  }
+  writer->commit();
+
+  auto reader = irs::directory_reader::open(dir);
+  auto& segment = reader[0];
+  auto* field = segment.field("name");
+  ASSERT_NE(nullptr, field);
+  auto terms = field->iterator();
+  ASSERT_TRUE(terms->seek(irs::ref_cast<irs::byte_type>(irs::string_ref("A"))));
+  terms->read();
+  auto docs = terms->postings(irs::flags::empty_instance());
+  ASSERT_TRUE(docs->next());
+
+  auto snapshot = irs::metrics::get_snapshot();
+  ASSERT_EQ(1, snapshot[irs::metrics::event::TERM_SEEK].count);
+  ASSERT_EQ(1, snapshot[irs::metrics::event::POSTINGS_REFILL].count);
+  ASSERT_EQ(1, snapshot[irs::metrics::event::SEGMENT_FLUSH].count);
+  ASSERT_EQ(1, snapshot[irs::metrics::event::COMMIT_START].count);
+  ASSERT_EQ(1, snapshot[irs::metrics::event::COMMIT_FINISH].count);
+  ASSERT_EQ(0, snapshot[irs::metrics::event::SEGMENT_MERGE].count);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
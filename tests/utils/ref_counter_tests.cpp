@@ -23,6 +23,7 @@
 
 #include "gtest/gtest.h"
 #include "utils/ref_counter.hpp"
+#include <thread>
 #include <unordered_map>
 
 namespace tests {
@@ -220,6 +221,104 @@ TEST_F(ref_counter_tests, test_ref_counter_visit) {
   }
 }
 
+TEST_F(ref_counter_tests, test_ref_counter_shards) {
+  for (size_t shards : { 0, 1, 3, 16 }) {
+    iresearch::ref_counter<int> refs(shards);
+    std::vector<iresearch::ref_counter<int>::ref_t> held;
+
+    for (int i = 0; i < 100; ++i) {
+      held.emplace_back(refs.add(int(i)));
+    }
+
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_TRUE(refs.contains(i));
+      ASSERT_EQ(1, refs.find(i));
+      ASSERT_EQ(held[i].get(), refs.add(int(i)).get());
+    }
+
+    size_t visited = 0;
+    ASSERT_TRUE(refs.visit([&visited](const int&, size_t count)->bool {
+      EXPECT_EQ(1, count);
+      ++visited;
+      return true;
+    }));
+    ASSERT_EQ(100, visited);
+
+    held.clear();
+    ASSERT_FALSE(refs.empty());
+    ASSERT_TRUE(refs.visit([](const int&, size_t)->bool { return true; }, true));
+    ASSERT_TRUE(refs.empty());
+  }
+}
+
+TEST_F(ref_counter_tests, test_ref_counter_visit_reentrant) {
+  // directory_cleaner retains files by referencing the visited key
+  for (size_t shards : { 1, 16 }) {
+    iresearch::ref_counter<int> refs(shards);
+    iresearch::ref_counter<int>::ref_t tmp_ref;
+
+    for (int i = 0; i < 100; ++i) {
+      refs.add(int(i));
+    }
+
+    size_t visited = 0;
+    ASSERT_TRUE(refs.visit([&refs, &tmp_ref, &visited](const int& key, size_t count)->bool {
+      EXPECT_EQ(0, count);
+      EXPECT_TRUE(refs.contains(key));
+
+      if (0 == key % 2) {
+        tmp_ref = refs.add(int(key)); // retain
+        EXPECT_EQ(1, refs.find(key));
+      }
+
+      ++visited;
+      return true;
+    }, true));
+    ASSERT_EQ(100, visited);
+
+    tmp_ref.reset();
+
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_EQ(0 == i % 2, refs.contains(i));
+    }
+  }
+}
+
+TEST_F(ref_counter_tests, test_ref_counter_concurrent) {
+  const size_t THREADS = 8;
+  const size_t KEYS = 1000;
+  iresearch::ref_counter<std::string> refs;
+  std::vector<std::thread> threads;
+
+  for (size_t i = 0; i < THREADS; ++i) {
+    threads.emplace_back([&refs, KEYS]() {
+      std::vector<iresearch::ref_counter<std::string>::ref_t> held;
+
+      for (size_t j = 0; j < KEYS; ++j) {
+        held.emplace_back(refs.add(std::to_string(j)));
+      }
+
+      for (size_t j = 0; j < KEYS; ++j) {
+        EXPECT_EQ(std::to_string(j), *held[j]);
+        EXPECT_EQ(held[j].get(), refs.add(std::to_string(j)).get()); // interned
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  size_t visited = 0;
+  ASSERT_TRUE(refs.visit([&visited](const std::string&, size_t count)->bool {
+    EXPECT_EQ(0, count);
+    ++visited;
+    return true;
+  }, true));
+  ASSERT_EQ(KEYS, visited);
+  ASSERT_TRUE(refs.empty());
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -34,8 +34,17 @@
 #endif
 
 #include <fstream>
+#include <iomanip>
 #include <memory>
 
+#if defined(_WIN32)
+  #include <windows.h>
+  #include <psapi.h> // for GetProcessMemoryInfo(...)
+  #pragma comment(lib, "psapi.lib")
+#else
+  #include <sys/resource.h> // for getrusage(...)
+#endif
+
 #if defined(_MSC_VER)
   #pragma warning(disable: 4229)
 #endif
@@ -50,9 +59,12 @@
 #include "analysis/analyzers.hpp"
 #include "analysis/token_attributes.hpp"
 #include "analysis/token_streams.hpp"
+#include "index/directory_reader.hpp"
 #include "index/index_writer.hpp"
 #include "store/store_utils.hpp"
 #include "utils/index_utils.hpp"
+#include "utils/iterator.hpp"
+#include "utils/math_utils.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/text_format.hpp"
 
@@ -68,9 +80,12 @@ const std::string OUTPUT = "out";
 const std::string INPUT = "in";
 const std::string MAX = "max-lines";
 const std::string THR = "threads";
+const std::string ANALYSIS_THR = "analysis-threads";
 const std::string CPR = "commit-period";
 const std::string DIR_TYPE = "dir-type";
 const std::string FORMAT = "format";
+const std::string BENCH = "benchmark";
+const std::string SEED = "seed";
 
 typedef std::unique_ptr<std::string> ustringp;
 
@@ -91,6 +106,365 @@ const irs::flags numeric_features{
   irs::granularity_prefix::type()
 };
 
+typedef std::chrono::steady_clock steady_clock_t;
+
+uint64_t elapsed_ns(const steady_clock_t::time_point& start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    steady_clock_t::now() - start
+  ).count();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @returns peak resident set size of the process in bytes, 0 if unknown
+////////////////////////////////////////////////////////////////////////////////
+size_t peak_rss() {
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+
+  return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof counters)
+    ? counters.PeakWorkingSetSize : 0;
+#else
+  struct rusage usage;
+
+  if (getrusage(RUSAGE_SELF, &usage)) {
+    return 0;
+  }
+
+  #if defined(__APPLE__)
+    return size_t(usage.ru_maxrss); // bytes
+  #else
+    return size_t(usage.ru_maxrss) * 1024; // kilobytes
+  #endif
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief deterministic value derived from 'seed' and 'value' (splitmix64)
+////////////////////////////////////////////////////////////////////////////////
+uint64_t mix(uint64_t seed, uint64_t value) {
+  auto z = seed + value * UINT64_C(0x9E3779B97F4A7C15);
+  z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+  z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+  return z ^ (z >> 31);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class histogram
+/// @brief log-linear histogram of durations in nanoseconds, every power of 2
+///        range is split into SUB_BUCKETS linear buckets, i.e. the reported
+///        percentiles are within 1/SUB_BUCKETS of the recorded values
+/// @note not thread-safe, use one instance per thread and merge(...) them
+////////////////////////////////////////////////////////////////////////////////
+class histogram {
+ public:
+  histogram(): buckets_(bucket(std::numeric_limits<uint64_t>::max()) + 1) { }
+
+  void add(uint64_t value) {
+    ++buckets_[bucket(value)];
+    ++count_;
+    sum_ += value;
+    max_ = (std::max)(max_, value);
+  }
+
+  void merge(const histogram& other) {
+    for (size_t i = 0, size = buckets_.size(); i < size; ++i) {
+      buckets_[i] += other.buckets_[i];
+    }
+
+    count_ += other.count_;
+    sum_ += other.sum_;
+    max_ = (std::max)(max_, other.max_);
+  }
+
+  size_t count() const { return count_; }
+  uint64_t max() const { return max_; }
+  double mean() const { return count_ ? double(sum_) / count_ : 0.; }
+  uint64_t sum() const { return sum_; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns upper bound of the bucket containing the 'p'-th percentile
+  //////////////////////////////////////////////////////////////////////////////
+  uint64_t percentile(double p) const {
+    const auto rank = size_t(std::ceil(p / 100. * count_));
+    size_t seen = 0;
+
+    for (size_t i = 0, size = buckets_.size(); i < size; ++i) {
+      seen += buckets_[i];
+
+      if (seen && seen >= rank) {
+        return (std::min)(upper_bound(i), max_);
+      }
+    }
+
+    return max_;
+  }
+
+  void print(std::ostream& out, const std::string& name) const {
+    out << name << " count:" << count_;
+
+    if (count_) {
+      out << ", mean: " << mean()/1000. << " us";
+
+      for (auto p : { 50., 90., 99., 99.9 }) {
+        out << ", p" << p << ": " << percentile(p)/1000. << " us";
+      }
+
+      out << ", max: " << max_/1000. << " us";
+    }
+
+    out << std::endl;
+  }
+
+ private:
+  static const size_t SUB_BUCKETS_BITS = 4;
+  static const size_t SUB_BUCKETS = size_t(1) << SUB_BUCKETS_BITS;
+
+  static size_t bucket(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+      return size_t(value);
+    }
+
+    const auto shift = size_t(irs::math::log2_64(value)) - SUB_BUCKETS_BITS;
+
+    return (shift + 1) * SUB_BUCKETS + size_t(value >> shift) - SUB_BUCKETS;
+  }
+
+  static uint64_t upper_bound(size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+      return bucket;
+    }
+
+    const auto shift = bucket / SUB_BUCKETS - 1;
+    const uint64_t base = bucket % SUB_BUCKETS + SUB_BUCKETS;
+
+    return ((base + 1) << shift) - 1;
+  }
+
+  std::vector<size_t> buckets_;
+  size_t count_{};
+  uint64_t sum_{};
+  uint64_t max_{};
+}; // histogram
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class counting_output
+/// @brief counts bytes written to the wrapped output, the count is updated on
+///        bulk writes, flush and close so that long-lived outputs are
+///        accounted to the phase that wrote them
+////////////////////////////////////////////////////////////////////////////////
+class counting_output final : public irs::index_output {
+ public:
+  counting_output(
+      irs::index_output::ptr&& impl,
+      std::atomic<uint64_t>& bytes
+  ) NOEXCEPT
+    : impl_(std::move(impl)), bytes_(&bytes) {
+  }
+
+  virtual void close() override {
+    if (impl_) {
+      count();
+      impl_.reset(); // closes output
+    }
+  }
+
+  virtual void flush() override {
+    impl_->flush();
+    count();
+  }
+
+  virtual size_t file_pointer() const override { return impl_->file_pointer(); }
+  virtual int64_t checksum() const override { return impl_->checksum(); }
+  virtual void write_byte(irs::byte_type b) override { impl_->write_byte(b); }
+  virtual void write_bytes(const irs::byte_type* b, size_t len) override {
+    impl_->write_bytes(b, len);
+    count();
+  }
+  virtual void write_int(int32_t v) override { impl_->write_int(v); }
+  virtual void write_long(int64_t v) override { impl_->write_long(v); }
+  virtual void write_vint(uint32_t v) override { impl_->write_vint(v); }
+  virtual void write_vlong(uint64_t v) override { impl_->write_vlong(v); }
+
+ private:
+  // adds bytes written since the previous call to the total
+  void count() {
+    const uint64_t written = impl_->file_pointer();
+    *bytes_ += written - counted_;
+    counted_ = written;
+  }
+
+  irs::index_output::ptr impl_;
+  std::atomic<uint64_t>* bytes_;
+  uint64_t counted_{}; // bytes already added to 'bytes_'
+}; // counting_output
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class counting_directory
+/// @brief tracks the total number of bytes written via the wrapped directory
+////////////////////////////////////////////////////////////////////////////////
+class counting_directory final : public irs::directory {
+ public:
+  explicit counting_directory(irs::directory& impl) NOEXCEPT
+    : impl_(impl) {
+  }
+
+  uint64_t bytes_written() const NOEXCEPT { return bytes_.load(); }
+
+  using irs::directory::attributes;
+  virtual irs::attribute_store& attributes() NOEXCEPT override {
+    return impl_.attributes();
+  }
+
+  virtual irs::index_output::ptr create(const std::string& name) NOEXCEPT override {
+    auto out = impl_.create(name);
+
+    if (!out) {
+      return nullptr;
+    }
+
+    try {
+      return irs::index_output::make<counting_output>(std::move(out), bytes_);
+    } catch (...) {
+      return nullptr;
+    }
+  }
+
+  virtual bool exists(bool& result, const std::string& name) const NOEXCEPT override {
+    return impl_.exists(result, name);
+  }
+
+  virtual bool length(uint64_t& result, const std::string& name) const NOEXCEPT override {
+    return impl_.length(result, name);
+  }
+
+  virtual irs::index_lock::ptr make_lock(const std::string& name) NOEXCEPT override {
+    return impl_.make_lock(name);
+  }
+
+  virtual bool mtime(std::time_t& result, const std::string& name) const NOEXCEPT override {
+    return impl_.mtime(result, name);
+  }
+
+  virtual irs::index_input::ptr open(
+      const std::string& name,
+      irs::IOAdvice advice
+  ) const NOEXCEPT override {
+    return impl_.open(name, advice);
+  }
+
+  virtual bool remove(const std::string& name) NOEXCEPT override {
+    return impl_.remove(name);
+  }
+
+  virtual bool rename(const std::string& src, const std::string& dst) NOEXCEPT override {
+    return impl_.rename(src, dst);
+  }
+
+  virtual bool sync(const std::string& name) NOEXCEPT override {
+    return impl_.sync(name);
+  }
+
+  virtual bool visit(const visitor_f& visitor) const override {
+    return impl_.visit(visitor);
+  }
+
+ private:
+  irs::directory& impl_;
+  std::atomic<uint64_t> bytes_{};
+}; // counting_directory
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class ingest_stats
+/// @brief measurements collected in benchmark mode
+////////////////////////////////////////////////////////////////////////////////
+class ingest_stats {
+ public:
+  struct phase {
+    std::string name;
+    uint64_t duration_ns;
+    uint64_t bytes_written;
+    size_t peak_rss; // process peak so far, not specific to the phase
+  }; // phase
+
+  struct sample {
+    uint64_t time_ms;
+    uint64_t docs;
+    size_t segments;
+  }; // sample
+
+  explicit ingest_stats(const counting_directory* dir)
+    : dir_(dir), start_(steady_clock_t::now()), phase_start_(start_) {
+  }
+
+  void add_inserts(const histogram& inserts) {
+    SCOPED_LOCK(mutex_);
+    inserts_.merge(inserts);
+  }
+
+  void add_commit(uint64_t flush_ns, uint64_t commit_ns, size_t segments) {
+    SCOPED_LOCK(mutex_);
+    flushes_.add(flush_ns);
+    commits_.add(commit_ns);
+    segments_.push_back(sample{
+      std::chrono::duration_cast<std::chrono::milliseconds>(steady_clock_t::now() - start_).count(),
+      docs_.load(),
+      segments
+    });
+  }
+
+  void add_docs(size_t count) { docs_ += count; }
+
+  void end_phase(const std::string& name) {
+    const auto bytes = bytes_written();
+
+    phases_.push_back(phase{
+      name, elapsed_ns(phase_start_), bytes - phase_bytes_, peak_rss()
+    });
+    phase_start_ = steady_clock_t::now();
+    phase_bytes_ = bytes;
+  }
+
+  void print(std::ostream& out) const {
+    out << "Benchmark results:" << std::endl;
+    inserts_.print(out, "Document insert latency");
+    flushes_.print(out, "Flush latency");
+    commits_.print(out, "Commit latency");
+
+    out << "Segments over time (ms, docs, segments):" << std::endl;
+    for (auto& entry : segments_) {
+      out << "  " << entry.time_ms << ", " << entry.docs << ", " << entry.segments << std::endl;
+    }
+
+    out << "Phases:" << std::endl;
+    for (auto& entry : phases_) {
+      out << "  " << entry.name
+          << " time: " << entry.duration_ns/1000000 << " ms"
+          << ", bytes written: " << entry.bytes_written
+          << ", peak RSS so far (ru_maxrss): " << entry.peak_rss << std::endl;
+    }
+
+    out << "Total bytes written: " << bytes_written() << std::endl;
+    out << "Peak RSS (ru_maxrss): " << peak_rss() << std::endl;
+  }
+
+ private:
+  uint64_t bytes_written() const NOEXCEPT {
+    return dir_ ? dir_->bytes_written() : 0;
+  }
+
+  const counting_directory* dir_; // nullptr if bytes are not counted
+  steady_clock_t::time_point start_;
+  steady_clock_t::time_point phase_start_;
+  uint64_t phase_bytes_{};
+  std::mutex mutex_;
+  std::atomic<uint64_t> docs_{}; // number of inserted documents
+  histogram inserts_;
+  histogram flushes_;
+  histogram commits_;
+  std::vector<sample> segments_;
+  std::vector<phase> phases_;
+}; // ingest_stats
+
 NS_END
 
 struct Doc {
@@ -282,7 +656,9 @@ const std::string& Doc::TextField::aignore = std::string("{\"locale\":\"en\", \"
 const irs::text_format::type_id& Doc::TextField::aignore_format = irs::text_format::json;
 
 struct WikiDoc : Doc {
-  WikiDoc() {
+  // @param seed non-zero to fill the numeric field with values derived from
+  //        the seed and the document identifier instead of 0
+  explicit WikiDoc(uint64_t seed = 0): seed(seed) {
     // id
     elements.emplace_back(id = std::make_shared<StringField>(n_id, irs::flags::empty_instance()));
     store.emplace_back(elements.back());
@@ -321,7 +697,7 @@ struct WikiDoc : Doc {
     std::getline(lineStream, date->f, '\t');
 
     // +date: uint64_t
-    uint64_t t = 0; //boost::posix_time::microsec_clock::local_time().total_milliseconds();
+    uint64_t t = seed ? mix(seed, id) % UINT64_C(0x80000000) : 0; // seconds since epoch
     ndate->value = t;
 
     // body: text
@@ -333,6 +709,7 @@ struct WikiDoc : Doc {
   std::shared_ptr<StringField> date;
   std::shared_ptr<NumericField> ndate;
   std::shared_ptr<TextField> body;
+  uint64_t seed;
 };
 
 int put(
@@ -342,17 +719,31 @@ int put(
     std::istream& stream,
     size_t lines_max,
     size_t indexer_threads,
+    size_t analysis_threads,
     size_t commit_interval_ms,
     size_t batch_size,
-    bool consolidate
+    bool consolidate,
+    bool benchmark,
+    uint64_t seed
 ) {
-  auto dir = create_directory(dir_type, path);
+  auto impl = create_directory(dir_type, path);
 
-  if (!dir) {
+  if (!impl) {
     std::cerr << "Unable to create directory of type '" << dir_type << "'" << std::endl;
     return 1;
   }
 
+  // counts bytes written in benchmark mode only
+  std::unique_ptr<counting_directory> counting_dir;
+  irs::directory* dir = impl.get();
+
+  if (benchmark) {
+    counting_dir = irs::memory::make_unique<counting_directory>(*impl);
+    dir = counting_dir.get();
+  }
+
+  ingest_stats stats(counting_dir.get());
+
   auto codec = irs::formats::get(format);
 
   if (!codec) {
@@ -360,7 +751,18 @@ int put(
     return 1;
   }
 
-  auto writer = irs::index_writer::make(*dir, codec, irs::OM_CREATE);
+  // analyzes fields of a document concurrently, must outlive the writer
+  std::unique_ptr<irs::async_utils::thread_pool> analysis_pool;
+  irs::index_writer::init_options options;
+
+  if (analysis_threads) {
+    analysis_pool = irs::memory::make_unique<irs::async_utils::thread_pool>(
+      analysis_threads, analysis_threads
+    );
+    options.analysis_pool = analysis_pool.get();
+  }
+
+  auto writer = irs::index_writer::make(*dir, codec, irs::OM_CREATE, options);
 
   indexer_threads = (std::max)(size_t(1), (std::min)(indexer_threads, (std::numeric_limits<size_t>::max)() - 1 - 1)); // -1 for commiter thread -1 for stream reader thread
 
@@ -373,9 +775,31 @@ int put(
   std::cout << FORMAT << "=" << format << std::endl;
   std::cout << MAX << "=" << lines_max << std::endl;
   std::cout << THR << "=" << indexer_threads << std::endl;
+  std::cout << ANALYSIS_THR << "=" << analysis_threads << std::endl;
   std::cout << CPR << "=" << commit_interval_ms << std::endl;
   std::cout << BATCH_SIZE << "=" << batch_size << std::endl;
   std::cout << CONSOLIDATE << "=" << consolidate << std::endl;
+  std::cout << BENCH << "=" << benchmark << std::endl;
+  std::cout << SEED << "=" << seed << std::endl;
+
+  // reports segment count after each commit in benchmark mode
+  irs::directory_reader reader;
+  auto commit = [benchmark, &writer, &stats, &reader, dir]()->void {
+    if (!benchmark) {
+      writer->commit();
+      return;
+    }
+
+    const auto start = steady_clock_t::now();
+    writer->begin(); // flush buffered segments
+    const auto flush_ns = elapsed_ns(start);
+    const auto commit_start = steady_clock_t::now();
+    writer->commit(); // publish index meta
+    const auto commit_ns = elapsed_ns(commit_start);
+
+    reader = reader ? reader.reopen() : irs::directory_reader::open(*dir);
+    stats.add_commit(flush_ns, commit_ns, reader.size());
+  };
 
   struct {
     std::condition_variable cond_;
@@ -440,12 +864,16 @@ int put(
 
   // commiter thread
   if (commit_interval_ms) {
-    thread_pool.run([&batch_provider, commit_interval_ms, &writer]()->void {
+    thread_pool.run([&batch_provider, commit_interval_ms, benchmark, &commit]()->void {
       while (!batch_provider.done_.load()) {
         {
           SCOPED_TIMER("Commit time");
-          std::cout << "COMMIT" << std::endl; // break indexer thread output by commit
-          writer->commit();
+
+          if (!benchmark) {
+            std::cout << "COMMIT" << std::endl; // break indexer thread output by commit
+          }
+
+          commit();
         }
 
         std::this_thread::sleep_for(std::chrono::milliseconds(commit_interval_ms));
@@ -455,9 +883,10 @@ int put(
 
   // indexer threads
   for (size_t i = indexer_threads; i; --i) {
-    thread_pool.run([&batch_provider, &writer]()->void {
+    thread_pool.run([&batch_provider, &writer, &stats, benchmark, seed]()->void {
       std::vector<std::string> buf;
-      WikiDoc doc;
+      WikiDoc doc(seed);
+      histogram inserts;
 
       while (batch_provider.swap(buf)) {
         SCOPED_TIMER(std::string("Index batch ") + std::to_string(buf.size()));
@@ -465,41 +894,66 @@ int put(
         size_t i = 0;
 
         do {
-          auto builder = ctx.insert();
+          const auto start = steady_clock_t::now();
 
-          doc.fill(&(buf[i]));
+          {
+            auto builder = ctx.insert();
 
-          for (auto& field: doc.elements) {
-            builder.insert<irs::Action::INDEX>(*field);
-          }
+            doc.fill(&(buf[i]));
+
+            typedef irs::ptr_iterator<decltype(doc.elements)::iterator> fields_itr;
+
+            // inserted as a range to allow concurrent analysis of the fields
+            builder.insert<irs::Action::INDEX>(
+              fields_itr(doc.elements.begin()), fields_itr(doc.elements.end())
+            );
 
-          for (auto& field : doc.store) {
-            builder.insert<irs::Action::STORE>(*field);
+            for (auto& field : doc.store) {
+              builder.insert<irs::Action::STORE>(*field);
+            }
           }
 
+          if (benchmark) {
+            inserts.add(elapsed_ns(start));
+          }
         } while (++i < buf.size());
 
-        std::cout << "." << std::flush; // newline in commit thread
+        if (benchmark) {
+          stats.add_docs(buf.size());
+        } else {
+          std::cout << "." << std::flush; // newline in commit thread
+        }
       }
+
+      stats.add_inserts(inserts);
     });
   }
 
   thread_pool.stop();
+  stats.end_phase("ingest");
 
   {
     SCOPED_TIMER("Commit time");
     std::cout << "COMMIT" << std::endl; // break indexer thread output by commit
-    writer->commit();
+    commit();
   }
 
+  stats.end_phase("commit");
+
   if (consolidate) {
     // merge all segments into a single segment
 
     SCOPED_TIMER("Merge time");
     std::cout << "Merging segments:" << std::endl;
     writer->consolidate(irs::index_utils::consolidation_policy(irs::index_utils::consolidate_count()));
-    writer->commit();
+    commit();
     irs::directory_utils::remove_all_unreferenced(*dir);
+    stats.end_phase("consolidate");
+  }
+
+  if (benchmark) {
+    reader = irs::directory_reader(); // release index files before reporting
+    stats.print(std::cout);
   }
 
   u_cleanup();
@@ -522,9 +976,12 @@ int put(const cmdline::parser& args) {
   auto consolidate = args.exist(CONSOLIDATE) ? args.get<bool>(CONSOLIDATE) : false;
   auto commit_interval_ms = args.exist(CPR) ? args.get<size_t>(CPR) : size_t(0);
   auto indexer_threads = args.exist(THR) ? args.get<size_t>(THR) : size_t(0);
+  auto analysis_threads = args.exist(ANALYSIS_THR) ? args.get<size_t>(ANALYSIS_THR) : size_t(0);
   auto lines_max = args.exist(MAX) ? args.get<size_t>(MAX) : size_t(0);
   auto dir_type = args.exist(DIR_TYPE) ? args.get<std::string>(DIR_TYPE) : std::string("fs");
   auto format = args.exist(FORMAT) ? args.get<std::string>(FORMAT) : std::string("1_0");
+  auto benchmark = args.exist(BENCH);
+  auto seed = args.exist(SEED) ? args.get<size_t>(SEED) : size_t(0);
 
   if (args.exist(INPUT)) {
     const auto& file = args.get<std::string>(INPUT);
@@ -534,10 +991,10 @@ int put(const cmdline::parser& args) {
       return 1;
     }
 
-    return put(path, dir_type, format, in, lines_max, indexer_threads, commit_interval_ms, batch_size, consolidate);
+    return put(path, dir_type, format, in, lines_max, indexer_threads, analysis_threads, commit_interval_ms, batch_size, consolidate, benchmark, seed);
   }
 
-  return put(path, dir_type, format, std::cin, lines_max, indexer_threads, commit_interval_ms, batch_size, consolidate);
+  return put(path, dir_type, format, std::cin, lines_max, indexer_threads, analysis_threads, commit_interval_ms, batch_size, consolidate, benchmark, seed);
 }
 
 int put(int argc, char* argv[]) {
@@ -552,7 +1009,10 @@ int put(int argc, char* argv[]) {
   cmdput.add(CONSOLIDATE, 0, "Consolidate segments", false, false);
   cmdput.add(MAX, 0, "Maximum lines", false, size_t(0));
   cmdput.add(THR, 0, "Number of insert threads", false, size_t(0));
+  cmdput.add(ANALYSIS_THR, 0, "Number of threads analyzing fields of a document, 0 to analyze on insert threads", false, size_t(0));
   cmdput.add(CPR, 0, "Commit period in lines", false, size_t(0));
+  cmdput.add(BENCH, 0, "Report insert latency percentiles, flush/commit latencies, segments over time, bytes written per phase and peak RSS");
+  cmdput.add(SEED, 0, "Seed of generated field values, 0 to disable", false, size_t(0));
 
   cmdput.parse(argc, argv);
 
@@ -48,6 +48,7 @@
 #include "index-put.hpp"
 #include "utils/timer_utils.hpp"
 #include "utils/log.hpp"
+#include "utils/metrics.hpp"
 #include "utils/misc.hpp"
 
 #include <unordered_map>
@@ -91,6 +92,7 @@ int main(int argc, char* argv[]) {
       std::cout << key << " calls:" << count << ", time: " << time_us << " us, avg call: " << time_us/double(count) << " us"<< std::endl;
       return true;
     });
+    irs::metrics::get_snapshot().write(std::cout);
   });
 
   // set error level